@@ -0,0 +1,288 @@
+/*
+    Frame download and streaming pipeline shared by the CCD drivers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+#include "frame_kernels.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+    CameraPipeline::Pipeline<Traits> moves frames from a camera SDK to INDI. Traits wraps the SDK
+    calls of one driver:
+
+        // Reads the next video frame, waiting up to the SDK timeout
+        CameraPipeline::ReadStatus readVideo(uint8_t *buffer, size_t bytes);
+        // Reads the image of a finished exposure
+        CameraPipeline::ReadStatus readImage(uint8_t *buffer, size_t bytes);
+
+    Streaming runs on the driver's worker thread, which only reads frames from the SDK into pooled
+    buffers, while a publisher thread converts them and hands them to the stream manager. A slow
+    publisher drops the oldest queued frame instead of holding the SDK back. Exposures read
+    interleaved RGB into a pooled staging buffer and de-interleave it into the frame buffer.
+*/
+namespace CameraPipeline
+{
+
+enum class ReadStatus
+{
+    Ok,
+    Timeout,
+    Failed
+};
+
+/* Buffers reused across frames and streams, reallocated only when the frame grows. */
+class BufferPool
+{
+    public:
+        void reserve(size_t count, size_t bytes)
+        {
+            if (buffers.size() < count)
+                buffers.resize(count);
+            for (auto &buffer : buffers)
+            {
+                if (buffer.size() < bytes)
+                    buffer.resize(bytes);
+            }
+        }
+
+        size_t size() const
+        {
+            return buffers.size();
+        }
+
+        uint8_t *at(size_t index)
+        {
+            return buffers[index].data();
+        }
+
+    private:
+        std::vector<std::vector<uint8_t>> buffers;
+};
+
+/* Timing of a stream, for the debug log when it stops. */
+struct StreamStats
+{
+    uint64_t captured {0};
+    uint64_t frames {0};
+    uint64_t dropped {0};
+    uint64_t timeouts {0};
+    double readMS {0};
+    double publishMS {0};
+
+    std::string summary() const
+    {
+        char text[192];
+        snprintf(text, sizeof(text), "%llu frames published of %llu read, %llu dropped, %llu timeouts, "
+                 "read %.1f ms and publish %.1f ms per frame",
+                 static_cast<unsigned long long>(frames), static_cast<unsigned long long>(captured),
+                 static_cast<unsigned long long>(dropped), static_cast<unsigned long long>(timeouts),
+                 captured ? readMS / captured : 0.0, frames ? publishMS / frames : 0.0);
+        return text;
+    }
+};
+
+template <typename Traits>
+class Pipeline
+{
+    public:
+        // One buffer the SDK reads into, one queued and one being published
+        static constexpr size_t STREAM_BUFFERS = 3;
+
+        explicit Pipeline(Traits traits) : sdk(std::move(traits)) {}
+
+        Traits &traits()
+        {
+            return sdk;
+        }
+
+        /**
+         * @brief Streams until isAboutToQuit is set or the SDK fails. publish(frame, bytes) is called
+         * on the publisher thread with frames in order, RGB already swapped to RGB order.
+         * @param rgbChannels channels of interleaved BGR(A) frames, 0 for mono and raw formats
+         * @return false if the SDK failed, true once asked to quit
+         */
+        template <typename Publish>
+        bool stream(const std::atomic_bool &isAboutToQuit, size_t frameBytes, int rgbChannels, Publish publish)
+        {
+            pool.reserve(STREAM_BUFFERS, frameBytes);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                free.clear();
+                queued.clear();
+                for (size_t i = 0; i < STREAM_BUFFERS; i++)
+                    free.push_back(pool.at(i));
+                publishing = true;
+                stats = StreamStats();
+            }
+
+            std::thread publisher([&]
+            {
+                publishLoop(frameBytes, rgbChannels, publish);
+            });
+
+            bool ok = true;
+            while (!isAboutToQuit)
+            {
+                uint8_t *buffer = takeFree();
+                auto start = Clock::now();
+                ReadStatus rc = sdk.readVideo(buffer, frameBytes);
+                double readMS = elapsedMS(start);
+
+                std::lock_guard<std::mutex> guard(lock);
+                if (rc != ReadStatus::Ok)
+                {
+                    free.push_back(buffer);
+                    if (rc == ReadStatus::Timeout)
+                    {
+                        stats.timeouts++;
+                        continue;
+                    }
+                    ok = false;
+                    break;
+                }
+
+                stats.captured++;
+                stats.readMS += readMS;
+                queued.push_back(buffer);
+                condition.notify_all();
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                publishing = false;
+            }
+            condition.notify_all();
+            publisher.join();
+            return ok;
+        }
+
+        /**
+         * @brief Reads the image of a finished exposure into image. Interleaved BGR(A) is read into a
+         * pooled staging buffer and de-interleaved into planes.
+         * @param pixels pixels of the frame, used for RGB only
+         * @param rgbChannels channels of interleaved BGR(A) frames, 0 for mono and raw formats
+         */
+        ReadStatus download(uint8_t *image, size_t frameBytes, size_t pixels, int rgbChannels)
+        {
+            auto start = Clock::now();
+            uint8_t *buffer = image;
+            if (rgbChannels > 0)
+            {
+                pool.reserve(1, frameBytes);
+                buffer = pool.at(0);
+            }
+
+            ReadStatus rc = sdk.readImage(buffer, frameBytes);
+            if (rc == ReadStatus::Ok && rgbChannels > 0)
+                FrameKernels::bgrToPlanar(buffer, image, pixels, rgbChannels);
+
+            downloadMS = elapsedMS(start);
+            return rc;
+        }
+
+        /* Duration of the last download() in ms. */
+        double lastDownloadMS() const
+        {
+            return downloadMS;
+        }
+
+        /* Timing of the last stream, complete once stream() returned. */
+        StreamStats streamStats()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            return stats;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static double elapsedMS(Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
+        /* A free buffer, or the oldest queued frame if the publisher is behind. */
+        uint8_t *takeFree()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            uint8_t *buffer;
+            if (!free.empty())
+            {
+                buffer = free.front();
+                free.pop_front();
+            }
+            else
+            {
+                buffer = queued.front();
+                queued.pop_front();
+                stats.dropped++;
+            }
+            return buffer;
+        }
+
+        template <typename Publish>
+        void publishLoop(size_t frameBytes, int rgbChannels, Publish &publish)
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            while (true)
+            {
+                // Frames still queued when the stream stops are dropped
+                condition.wait(guard, [this] { return !queued.empty() || !publishing; });
+                if (!publishing)
+                {
+                    stats.dropped += queued.size();
+                    break;
+                }
+
+                uint8_t *buffer = queued.front();
+                queued.pop_front();
+                guard.unlock();
+
+                auto start = Clock::now();
+                if (rgbChannels > 0)
+                    FrameKernels::swapRedBlue(buffer, frameBytes, rgbChannels);
+                publish(buffer, frameBytes);
+                double publishMS = elapsedMS(start);
+
+                guard.lock();
+                stats.frames++;
+                stats.publishMS += publishMS;
+                free.push_back(buffer);
+            }
+        }
+
+        Traits sdk;
+        BufferPool pool;
+        double downloadMS {0};
+
+        std::mutex lock;
+        std::condition_variable condition;
+        std::deque<uint8_t *> free;
+        std::deque<uint8_t *> queued;
+        bool publishing {false};
+        StreamStats stats;
+};
+
+}
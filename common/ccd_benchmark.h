@@ -0,0 +1,426 @@
+/*
+    Offline download benchmark shared by the CCD drivers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+#include "sdk_mock.h"
+
+#include <indiccd.h>
+#include <indidevapi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+/*
+    A driver benchmark links the real driver sources against the mock SDK in the driver's mock/
+    directory and drives the camera through its INDI properties, like a client would: CONNECTION,
+    CCD_CAPTURE_FORMAT, then CCD_EXPOSURE for single exposures and CCD_VIDEO_STREAM for streaming.
+    No camera or INDI server is needed.
+
+    Exposure latency runs from the CCD_EXPOSURE request to ExposureComplete(), and includes the
+    exposure itself and the mock transfer time (<DRIVER>_MOCK_BANDWIDTH). The time spent in
+    INDI::CCD::ExposureComplete() (FITS encoding and upload) is reported separately.
+
+    Passes over the frame are counted, not assumed:
+      - sdk: bytes the mock SDK wrote into driver buffers,
+      - kernels: bytes written by the common/frame_kernels.h kernels (FRAME_KERNELS_TRACE),
+      - memcpy: memcpy calls of 4 KiB or more made by the driver (linked with --wrap=memcpy).
+    Copies made inside libindi (FITS encoding, stream queue) are not counted.
+
+    The driver's INDI messages are discarded, results are printed as JSON on stdout. The
+    benchmark's main file includes this header once and calls CCDBenchmark::run().
+*/
+namespace CCDBenchmark
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Copies smaller than this are property and header bookkeeping, not frame data
+#define MEMCPY_FRAME_MIN 4096
+
+static std::atomic<uint64_t> kernelBytes {0};
+static std::atomic<uint64_t> memcpyBytes {0};
+
+/* A capture format of the driver, as offered by the --format option. */
+struct Format
+{
+    const char *option;     // --format value
+    const char *element;    // CCD_CAPTURE_FORMAT element
+    size_t bytesPerPixel;
+    size_t streamBytesPerPixel {0}; // if the driver streams in another depth
+};
+
+/* The driver under test and its mock SDK. */
+struct Driver
+{
+    const char *name;           // driver executable, for the report
+    const char *mockPrefix;     // <DRIVER>_MOCK_ environment prefix of the mock
+    const Format *formats;      // the first one is the default
+    size_t formatCount;
+    void (*getStats)(SDKMock::Stats *stats);
+    void (*resetStats)();
+};
+
+struct Config
+{
+    uint32_t width {1920};
+    uint32_t height {1080};
+    const Format *format {nullptr};
+    uint32_t exposures {20};
+    double exposure {0.01};
+    double streamSeconds {5};
+    double bandwidth {300}; // MB/s
+};
+
+struct PathResult
+{
+    const char *name;
+    uint32_t frames {0};
+    double seconds {0};
+    double latencyMin {1e9}, latencyMax {0}, latencySum {0};
+    double uploadSum {0};
+    uint64_t skipped {0};
+    double sdkCopies {0}, kernelCopies {0}, memcpyCopies {0};
+};
+
+/**
+ * @brief The driver's camera class, reporting when ExposureComplete() is reached.
+ */
+template <typename Base>
+class Camera : public Base
+{
+    public:
+        using Base::Base;
+
+        /** Waits for the next ExposureComplete(), false on timeout. */
+        bool waitComplete(Clock::time_point &completeTime, Clock::duration &uploadTime, int timeoutMS)
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            if (!m_Condition.wait_for(lock, std::chrono::milliseconds(timeoutMS), [this] { return m_Completed; }))
+                return false;
+
+            m_Completed = false;
+            completeTime = m_CompleteTime;
+            uploadTime = m_UploadTime;
+            return true;
+        }
+
+    protected:
+        virtual bool ExposureComplete(INDI::CCDChip *targetChip) override
+        {
+            auto completeTime = Clock::now();
+            bool rc = Base::ExposureComplete(targetChip);
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_CompleteTime = completeTime;
+            m_UploadTime = Clock::now() - completeTime;
+            m_Completed = true;
+            m_Condition.notify_all();
+            return rc;
+        }
+
+    private:
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        bool m_Completed {false};
+        Clock::time_point m_CompleteTime;
+        Clock::duration m_UploadTime;
+};
+
+static double toMS(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static void setSwitch(const char *dev, const char *property, const char *element)
+{
+    ISState state = ISS_ON;
+    char *names[] = {const_cast<char *>(element)};
+    ::ISNewSwitch(dev, property, &state, names, 1);
+}
+
+static void setNumbers(const char *dev, const char *property, const char *elements[], double values[], int n)
+{
+    ::ISNewNumber(dev, property, values, const_cast<char **>(elements), n);
+}
+
+static void resetCounters(const Driver &driver)
+{
+    driver.resetStats();
+    kernelBytes = 0;
+    memcpyBytes = 0;
+}
+
+static SDKMock::Stats countCopies(const Driver &driver, PathResult &result, uint64_t frames, size_t frameBytes)
+{
+    SDKMock::Stats stats;
+    driver.getStats(&stats);
+    result.skipped = stats.videoSkipped;
+
+    if (frames > 0)
+    {
+        double total = static_cast<double>(frames) * frameBytes;
+        result.sdkCopies = stats.bytesCopied / total;
+        result.kernelCopies = kernelBytes / total;
+        result.memcpyCopies = memcpyBytes / total;
+    }
+    return stats;
+}
+
+// StartExposure to ExposureComplete, one exposure at a time.
+template <typename CameraT>
+PathResult runExposurePath(CameraT &camera, const Driver &driver, const Config &config, size_t frameBytes)
+{
+    PathResult result;
+    result.name = "exposure";
+
+    const char *dev = camera.getDeviceName();
+    const char *elements[] = {"CCD_EXPOSURE_VALUE"};
+    // Exposure plus transfer, with a generous margin for slow machines
+    int timeoutMS = static_cast<int>(config.exposure * 1000 + frameBytes / (config.bandwidth * 1000)) * 10 + 5000;
+
+    resetCounters(driver);
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < config.exposures; i++)
+    {
+        double value = config.exposure;
+        auto requestTime = Clock::now();
+        setNumbers(dev, "CCD_EXPOSURE", elements, &value, 1);
+
+        Clock::time_point completeTime;
+        Clock::duration uploadTime;
+        if (!camera.waitComplete(completeTime, uploadTime, timeoutMS))
+        {
+            fprintf(stderr, "Exposure %u did not complete.\n", i + 1);
+            break;
+        }
+
+        double latency = toMS(completeTime - requestTime);
+        result.latencyMin = std::min(result.latencyMin, latency);
+        result.latencyMax = std::max(result.latencyMax, latency);
+        result.latencySum += latency;
+        result.uploadSum += toMS(uploadTime);
+        result.frames++;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    countCopies(driver, result, result.frames, frameBytes);
+    return result;
+}
+
+// StartStreaming to StopStreaming, frames counted by the mock SDK.
+template <typename CameraT>
+PathResult runStreamingPath(CameraT &camera, const Driver &driver, const Config &config, size_t frameBytes)
+{
+    PathResult result;
+    result.name = "streaming";
+
+    const char *dev = camera.getDeviceName();
+    const char *elements[] = {"STREAMING_EXPOSURE_VALUE", "STREAMING_DIVISOR_VALUE"};
+    double values[] = {config.exposure, 1};
+    setNumbers(dev, "STREAMING_EXPOSURE", elements, values, 2);
+
+    resetCounters(driver);
+    auto start = Clock::now();
+    setSwitch(dev, "CCD_VIDEO_STREAM", "STREAM_ON");
+    std::this_thread::sleep_for(std::chrono::duration<double>(config.streamSeconds));
+    setSwitch(dev, "CCD_VIDEO_STREAM", "STREAM_OFF");
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    SDKMock::Stats stats;
+    driver.getStats(&stats);
+    result.frames = stats.videoFrames;
+    countCopies(driver, result, result.frames, frameBytes);
+    return result;
+}
+
+static void printResult(FILE *out, const PathResult &result, bool latency, bool last)
+{
+    fprintf(out, "    \"%s\": {\"frames\": %u, \"fps\": %.2f, ", result.name, result.frames,
+            result.seconds > 0 ? result.frames / result.seconds : 0);
+    if (latency)
+        fprintf(out, "\"latency_ms\": {\"min\": %.3f, \"mean\": %.3f, \"max\": %.3f}, \"exposure_complete_ms\": %.3f, ",
+                result.frames ? result.latencyMin : 0, result.frames ? result.latencySum / result.frames : 0, result.latencyMax,
+                result.frames ? result.uploadSum / result.frames : 0);
+    else
+        fprintf(out, "\"skipped\": %llu, ", static_cast<unsigned long long>(result.skipped));
+    fprintf(out, "\"copies_per_frame\": %.2f, \"copies\": {\"sdk\": %.2f, \"kernels\": %.2f, \"memcpy\": %.2f}}%s\n",
+            result.sdkCopies + result.kernelCopies + result.memcpyCopies,
+            result.sdkCopies, result.kernelCopies, result.memcpyCopies, last ? "" : ",");
+}
+
+static void printUsage(const char *progName, const Driver &driver)
+{
+    fprintf(stderr, "Usage: %s [--width w] [--height h] [--format ", progName);
+    for (size_t i = 0; i < driver.formatCount; i++)
+        fprintf(stderr, "%s%s", i ? "|" : "", driver.formats[i].option);
+    fprintf(stderr, "] [--exposures n] [--exposure s] [--stream-seconds s] [--bandwidth MB/s]\n");
+}
+
+/* Parses the options into config, returns the exit code if the benchmark should not run. */
+static int parseArgs(int argc, char *argv[], const Driver &driver, Config &config)
+{
+    const char *format = driver.formats[0].option;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+        {
+            printUsage(argv[0], driver);
+            return 0;
+        }
+        else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc)
+            config.width = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc)
+            config.height = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+            format = argv[++i];
+        else if (strcmp(argv[i], "--exposures") == 0 && i + 1 < argc)
+            config.exposures = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--exposure") == 0 && i + 1 < argc)
+            config.exposure = atof(argv[++i]);
+        else if (strcmp(argv[i], "--stream-seconds") == 0 && i + 1 < argc)
+            config.streamSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--bandwidth") == 0 && i + 1 < argc)
+            config.bandwidth = atof(argv[++i]);
+        else
+        {
+            printUsage(argv[0], driver);
+            return 1;
+        }
+    }
+
+    for (size_t i = 0; i < driver.formatCount; i++)
+    {
+        if (strcmp(format, driver.formats[i].option) == 0)
+            config.format = &driver.formats[i];
+    }
+
+    if (config.format == nullptr || config.width == 0 || config.height == 0 || config.exposure <= 0 || config.bandwidth <= 0)
+    {
+        printUsage(argv[0], driver);
+        return 1;
+    }
+    return -1;
+}
+
+static void setMockEnv(const Driver &driver, const char *setting, const std::string &value)
+{
+    std::string name = std::string(driver.mockPrefix) + "_MOCK_" + setting;
+    setenv(name.c_str(), value.c_str(), 1);
+}
+
+/**
+ * @brief Runs the benchmark on a CameraT, which opens the first camera of the mock SDK when
+ * constructed and tells whether it found one with CameraT::listed().
+ */
+template <typename CameraT>
+int run(int argc, char *argv[], const Driver &driver)
+{
+    Config config;
+    int rc = parseArgs(argc, argv, driver, config);
+    if (rc >= 0)
+        return rc;
+
+    // The mock reads its sensor from the environment when the camera is listed
+    setMockEnv(driver, "WIDTH", std::to_string(config.width));
+    setMockEnv(driver, "HEIGHT", std::to_string(config.height));
+    setMockEnv(driver, "BANDWIDTH", std::to_string(config.bandwidth));
+    setMockEnv(driver, "COLOR", "1");
+
+    // The driver speaks INDI XML on stdout, keep it for the results only
+    fflush(stdout);
+    FILE *out = fdopen(dup(STDOUT_FILENO), "w");
+    int devNull = open("/dev/null", O_WRONLY);
+    if (out == nullptr || devNull < 0)
+    {
+        fprintf(stderr, "Failed to redirect stdout: %s\n", strerror(errno));
+        return 1;
+    }
+    dup2(devNull, STDOUT_FILENO);
+    close(devNull);
+
+    if (!CameraT::listed())
+    {
+        fprintf(stderr, "The mock SDK lists no camera.\n");
+        return 1;
+    }
+
+    CameraT camera;
+    const char *dev = camera.getDeviceName();
+    camera.ISGetProperties(nullptr);
+    setSwitch(dev, "CONNECTION", "CONNECT");
+    if (!camera.isConnected())
+    {
+        fprintf(stderr, "Failed to connect to the mock camera.\n");
+        return 1;
+    }
+    setSwitch(dev, "CCD_CAPTURE_FORMAT", config.format->element);
+
+    const size_t pixels = static_cast<size_t>(config.width) * config.height;
+    const size_t streamBytesPerPixel = config.format->streamBytesPerPixel ? config.format->streamBytesPerPixel :
+                                       config.format->bytesPerPixel;
+    PathResult exposure = runExposurePath(camera, driver, config, pixels * config.format->bytesPerPixel);
+    PathResult streaming = runStreamingPath(camera, driver, config, pixels * streamBytesPerPixel);
+
+    setSwitch(dev, "CONNECTION", "DISCONNECT");
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"driver\": \"%s\",\n", driver.name);
+    fprintf(out, "  \"frame\": {\"width\": %u, \"height\": %u, \"format\": \"%s\", \"exposure_s\": %.6f, \"bandwidth_mbps\": %.1f},\n",
+            config.width, config.height, config.format->element, config.exposure, config.bandwidth);
+    fprintf(out, "  \"paths\": {\n");
+    printResult(out, exposure, true, false);
+    printResult(out, streaming, false, true);
+    fprintf(out, "  },\n");
+    // ru_maxrss is reported in kilobytes on Linux
+    fprintf(out, "  \"peak_rss_kb\": %ld\n", usage.ru_maxrss);
+    fprintf(out, "}\n");
+    fclose(out);
+
+    return exposure.frames == config.exposures ? 0 : 1;
+}
+
+}
+
+void frameKernelsTrace(const char *, size_t bytes)
+{
+    CCDBenchmark::kernelBytes += bytes;
+}
+
+extern "C" void *__real_memcpy(void *dest, const void *src, size_t n);
+
+extern "C" void *__wrap_memcpy(void *dest, const void *src, size_t n)
+{
+    if (n >= MEMCPY_FRAME_MIN)
+        CCDBenchmark::memcpyBytes += n;
+    return __real_memcpy(dest, src, n);
+}
@@ -0,0 +1,102 @@
+/*
+    Exposure countdown and image ready polling shared by the CCD drivers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <unistd.h>
+
+/*
+    Drivers whose SDK has no blocking "wait for image" call run the exposure on a worker thread as:
+
+        if (!ReadyWait::countdown(isAboutToQuit, timeLeft, showTimeLeft))
+            return;
+        if (!ReadyWait::poll(isAboutToQuit, checkReady))
+            return;
+
+    The countdown sleeps until the predicted end of exposure without touching the camera, so that
+    guide pulses and temperature queries are not delayed. Polling then starts short, to pick the
+    image up as soon as the camera has digitized it, and backs off for slow readouts.
+*/
+namespace ReadyWait
+{
+
+enum class State
+{
+    Busy,     // not ready yet, poll again
+    Ready,    // the image can be downloaded
+    Failed    // the camera reported an error, stop waiting
+};
+
+static constexpr float COUNTDOWN_STEP = 0.1;  /* Exposure countdown sleep step (s) */
+static constexpr int   POLL_MIN       = 10;   /* First poll interval after the end of exposure (ms) */
+static constexpr int   POLL_MAX       = 250;  /* Default longest poll interval (ms) */
+
+/*
+    Sleeps until timeLeft() returns zero or less. showTimeLeft(timeleft) is called when the
+    number of whole seconds left changes, not on every step. Returns false if aborted.
+*/
+template <typename TimeLeft, typename ShowTimeLeft>
+bool countdown(const std::atomic_bool &isAboutToQuit, TimeLeft timeLeft, ShowTimeLeft showTimeLeft)
+{
+    float timeleft = timeLeft();
+    int shown      = -1;
+    while (timeleft > 0)
+    {
+        if (isAboutToQuit)
+            return false;
+
+        if (static_cast<int>(std::ceil(timeleft)) != shown)
+        {
+            shown = static_cast<int>(std::ceil(timeleft));
+            showTimeLeft(timeleft);
+        }
+        usleep(std::min(timeleft, COUNTDOWN_STEP) * 1000000);
+        timeleft = timeLeft();
+    }
+    return !isAboutToQuit;
+}
+
+/*
+    Calls checkReady() until it returns State::Ready, doubling the interval from POLL_MIN
+    up to maxInterval ms. checkReady takes and releases any camera lock itself, so the
+    camera is free between polls. Returns false if aborted or on State::Failed.
+*/
+template <typename CheckReady>
+bool poll(const std::atomic_bool &isAboutToQuit, CheckReady checkReady, int maxInterval = POLL_MAX)
+{
+    int interval = POLL_MIN;
+    while (!isAboutToQuit)
+    {
+        switch (checkReady())
+        {
+            case State::Ready:
+                return true;
+            case State::Failed:
+                return false;
+            case State::Busy:
+                break;
+        }
+
+        usleep(interval * 1000);
+        interval = std::min(interval * 2, maxInterval);
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,165 @@
+/*
+    Pixel kernels shared by the camera drivers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+/*
+    Benchmarks build the drivers with FRAME_KERNELS_TRACE and define frameKernelsTrace(),
+    which is then told the bytes each kernel writes, to count the passes over a frame.
+*/
+#ifdef FRAME_KERNELS_TRACE
+void frameKernelsTrace(const char *kernel, size_t bytes);
+#define FRAME_KERNELS_PASS(kernel, bytes) frameKernelsTrace(kernel, bytes)
+#else
+#define FRAME_KERNELS_PASS(kernel, bytes)
+#endif
+
+namespace FrameKernels
+{
+
+// Convert interleaved BGR (or BGRA) pixels as delivered by the SDK into planar R, G, B (and A) planes.
+// Separate loops per channel count let the compiler vectorize the de-interleave.
+inline void bgrToPlanar(const uint8_t *src, uint8_t *dst, size_t pixels, int channels)
+{
+    FRAME_KERNELS_PASS("bgrToPlanar", pixels * channels);
+    uint8_t *dstR = dst;
+    uint8_t *dstG = dst + pixels;
+    uint8_t *dstB = dst + pixels * 2;
+
+    if (channels == 4)
+    {
+        uint8_t *dstA = dst + pixels * 3;
+        for (size_t i = 0; i < pixels; i++)
+        {
+            dstB[i] = src[4 * i + 0];
+            dstG[i] = src[4 * i + 1];
+            dstR[i] = src[4 * i + 2];
+            dstA[i] = src[4 * i + 3];
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < pixels; i++)
+        {
+            dstB[i] = src[3 * i + 0];
+            dstG[i] = src[3 * i + 1];
+            dstR[i] = src[3 * i + 2];
+        }
+    }
+}
+
+// Swap R and B of interleaved BGR (or BGRA) pixels in place.
+inline void swapRedBlue(uint8_t *frame, size_t bytes, int channels)
+{
+    FRAME_KERNELS_PASS("swapRedBlue", bytes);
+    const size_t pixels = bytes / channels;
+    for (size_t i = 0; i < pixels; i++)
+    {
+        uint8_t *pixel = frame + i * channels;
+        uint8_t blue = pixel[0];
+        pixel[0] = pixel[2];
+        pixel[2] = blue;
+    }
+}
+
+
+// Big endian 16 bit pixels as sent by IIDC and i-Nova cameras, SSE2 or NEON when available.
+
+// sum[i] += byteswap(frame[i])
+inline void addSwapped16(uint32_t *sum, const uint8_t *frame, size_t pixels)
+{
+    FRAME_KERNELS_PASS("addSwapped16", pixels * sizeof(uint32_t));
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(frame + i * 2));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        __m128i *s = reinterpret_cast<__m128i *>(sum + i);
+        _mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), _mm_unpacklo_epi16(v, zero)));
+        _mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1), _mm_unpackhi_epi16(v, zero)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= pixels; i += 8)
+    {
+        uint16x8_t v = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(frame + i * 2)));
+        vst1q_u32(sum + i, vaddw_u16(vld1q_u32(sum + i), vget_low_u16(v)));
+        vst1q_u32(sum + i + 4, vaddw_u16(vld1q_u32(sum + i + 4), vget_high_u16(v)));
+    }
+#endif
+    for (; i < pixels; i++)
+        sum[i] += (frame[i * 2] << 8) | frame[i * 2 + 1];
+}
+
+// image[i] = min(sum[i], 0xFFFF)
+inline void saturate16(uint16_t *image, const uint32_t *sum, size_t pixels)
+{
+    FRAME_KERNELS_PASS("saturate16", pixels * sizeof(uint16_t));
+    size_t i = 0;
+#if defined(__SSE2__)
+    // SSE2 has no unsigned 32 bit compare or pack, clamp with signed compares (values above
+    // 2^31 look negative) and keep the low 16 bits sign extended so that packs is exact
+    const __m128i max = _mm_set1_epi32(0xFFFF);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + i + 4));
+        __m128i lomask = _mm_or_si128(_mm_cmpgt_epi32(lo, max), _mm_cmplt_epi32(lo, zero));
+        __m128i himask = _mm_or_si128(_mm_cmpgt_epi32(hi, max), _mm_cmplt_epi32(hi, zero));
+        lo = _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(lo, lomask), 16), 16);
+        hi = _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(hi, himask), 16), 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(image + i), _mm_packs_epi32(lo, hi));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= pixels; i += 8)
+        vst1q_u16(image + i, vcombine_u16(vqmovn_u32(vld1q_u32(sum + i)), vqmovn_u32(vld1q_u32(sum + i + 4))));
+#endif
+    for (; i < pixels; i++)
+        image[i] = std::min<uint32_t>(sum[i], 0xFFFF);
+}
+
+// image[i] = byteswap(frame[i])
+inline void swap16(uint16_t *image, const uint8_t *frame, size_t pixels)
+{
+    FRAME_KERNELS_PASS("swap16", pixels * sizeof(uint16_t));
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(frame + i * 2));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(image + i), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= pixels; i += 8)
+        vst1q_u16(image + i, vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(frame + i * 2))));
+#endif
+    for (; i < pixels; i++)
+        image[i] = (frame[i * 2] << 8) | frame[i * 2 + 1];
+}
+
+}
@@ -0,0 +1,177 @@
+/*
+    Helpers for the mock SDK libraries the drivers can be linked against
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace SDKMock
+{
+
+// Integer setting from the environment, value if unset
+inline int env(const char *name, int value)
+{
+    const char *s = getenv(name);
+    return s ? atoi(s) : value;
+}
+
+// Decimal setting from the environment, value if unset
+inline double env(const char *name, double value)
+{
+    const char *s = getenv(name);
+    return s ? atof(s) : value;
+}
+
+// Time the emulated camera takes to send bytes at bandwidth MB/s
+inline std::chrono::microseconds transferTime(size_t bytes, double bandwidth)
+{
+    return std::chrono::microseconds(static_cast<int64_t>(bytes / bandwidth));
+}
+
+/* Counters of a mock camera since the last reset, read by the download benchmarks. */
+struct Stats
+{
+    uint64_t exposures;     // exposures started
+    uint64_t statusPolls;   // exposure status and image ready polls
+    uint64_t downloads;     // exposure frames returned to the driver
+    uint64_t videoFrames;   // video frames returned to the driver
+    uint64_t videoSkipped;  // video frames overwritten before the driver asked for them
+    uint64_t bytesCopied;   // bytes the SDK wrote into driver buffers
+};
+
+/* Stats kept by a mock, updated from the SDK calls of any driver thread. */
+struct Counters
+{
+    std::atomic<uint64_t> exposures {0};
+    std::atomic<uint64_t> statusPolls {0};
+    std::atomic<uint64_t> downloads {0};
+    std::atomic<uint64_t> videoFrames {0};
+    std::atomic<uint64_t> videoSkipped {0};
+    std::atomic<uint64_t> bytesCopied {0};
+
+    void get(Stats *stats) const
+    {
+        stats->exposures    = exposures;
+        stats->statusPolls  = statusPolls;
+        stats->downloads    = downloads;
+        stats->videoFrames  = videoFrames;
+        stats->videoSkipped = videoSkipped;
+        stats->bytesCopied  = bytesCopied;
+    }
+
+    void reset()
+    {
+        exposures    = 0;
+        statusPolls  = 0;
+        downloads    = 0;
+        videoFrames  = 0;
+        videoSkipped = 0;
+        bytesCopied  = 0;
+    }
+};
+
+/*
+    Frame timing of an emulated camera. While capturing, the camera finishes a frame every period
+    whether the driver reads it or not, frame n at start + (n + 1) * period. A single frame capture
+    finishes frame 0 only. Frames finished before stop() can still be taken afterwards.
+*/
+class FrameClock
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        void start(Clock::duration period, bool single = false)
+        {
+            m_Start   = Clock::now();
+            m_Period  = std::max<Clock::duration>(period, std::chrono::microseconds(1));
+            m_Single  = single;
+            m_Stopped = Clock::time_point::max();
+            m_Last    = -1;
+            m_Started = true;
+        }
+
+        void stop()
+        {
+            if (m_Started)
+                m_Stopped = std::min(m_Stopped, Clock::now());
+        }
+
+        // Stops and drops the frames not taken yet
+        void clear()
+        {
+            m_Started = false;
+            m_Last    = -1;
+        }
+
+        bool running() const
+        {
+            return m_Started && m_Stopped == Clock::time_point::max();
+        }
+
+        // True if a frame not taken yet is finished
+        bool ready() const
+        {
+            return newest(Clock::now()) > m_Last;
+        }
+
+        // True if a frame not taken yet is finished or will be
+        bool pending() const
+        {
+            return newest(Clock::time_point::max()) > m_Last;
+        }
+
+        // When the first frame not taken yet finishes
+        Clock::time_point next() const
+        {
+            return m_Start + m_Period * (m_Last + 2);
+        }
+
+        // Takes the newest finished frame, returns the number of frames skipped since the last one
+        uint64_t take()
+        {
+            int64_t frame = newest(Clock::now());
+            uint64_t skipped = frame > m_Last ? frame - m_Last - 1 : 0;
+            m_Last = std::max(frame, m_Last);
+            return skipped;
+        }
+
+    private:
+        // Newest frame finished at time, -1 if none
+        int64_t newest(Clock::time_point time) const
+        {
+            if (!m_Started)
+                return -1;
+            time = std::min(time, m_Stopped);
+            if (time == Clock::time_point::max())
+                return m_Single ? 0 : INT64_MAX;
+            int64_t frame = (time - m_Start) / m_Period - 1;
+            return m_Single ? std::min<int64_t>(frame, 0) : frame;
+        }
+
+        Clock::time_point m_Start;
+        Clock::duration m_Period {std::chrono::seconds(1)};
+        Clock::time_point m_Stopped {Clock::time_point::max()};
+        bool m_Single {false};
+        bool m_Started {false};
+        int64_t m_Last {-1};
+};
+
+}
@@ -0,0 +1,257 @@
+/*
+    Serial exchange recorder and latency statistics shared by the mount and dome drivers
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <time.h>
+
+/*
+    Drivers talking LX200 style commands over a serial line record their exchanges with a
+    SerialTrace::Recorder, calling transmitted() after each successful write and received() after
+    each answer read:
+
+        serialTrace.transmitted(command);
+        ...
+        serialTrace.received(buffer, bytes);
+
+    The trace file starts with the 4 byte magic "SGTR" (the format was introduced by the StarGO
+    driver) and a version byte, followed by one record per transmitted or received message:
+        uint8_t  direction (0 = transmitted, 1 = received)
+        uint32_t microseconds elapsed since the previous record (monotonic clock)
+        uint16_t length
+        length bytes of raw data, including the '#' terminator if one was received
+    Integers are stored in host byte order. serial_trace_replay.h plays a trace back through a
+    pseudo terminal.
+
+    Latency is the time from transmitting a command to receiving its answer. It is collected
+    whether or not a trace file is being written. Not thread safe, the driver serializes access.
+*/
+namespace SerialTrace
+{
+
+enum Direction
+{
+    TRACE_TRANSMIT = 0,
+    TRACE_RECEIVE  = 1
+};
+
+struct Event
+{
+    Direction direction;
+    uint32_t delay_us;
+    std::string data;
+};
+
+static constexpr char    TRACE_MAGIC[4] = {'S', 'G', 'T', 'R'};
+static constexpr uint8_t TRACE_VERSION  = 1;
+
+/* Monotonic time in microseconds. */
+inline uint64_t now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Groups commands by their name without arguments, e.g. ":X34#" -> ":X34", ":Sr12:30:00#" -> ":Sr". */
+inline std::string commandKey(const char *command)
+{
+    size_t const limit = strncmp(command, ":S", 2) == 0 ? 3 : 4;
+    size_t length      = 0;
+    while (length < limit && command[length] != '\0' && command[length] != '#' && command[length] != ' ')
+        length++;
+    return std::string(command, length);
+}
+
+inline bool readHeader(FILE *fp)
+{
+    char magic[sizeof(TRACE_MAGIC)];
+    uint8_t version = 0;
+    if (fread(magic, sizeof(magic), 1, fp) != 1 || fread(&version, sizeof(version), 1, fp) != 1)
+        return false;
+    return memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0 && version == TRACE_VERSION;
+}
+
+inline bool readEvent(FILE *fp, Event &event)
+{
+    uint8_t direction = 0;
+    uint16_t length   = 0;
+    if (fread(&direction, sizeof(direction), 1, fp) != 1 ||
+            fread(&event.delay_us, sizeof(event.delay_us), 1, fp) != 1 ||
+            fread(&length, sizeof(length), 1, fp) != 1)
+        return false;
+
+    event.direction = direction == TRACE_TRANSMIT ? TRACE_TRANSMIT : TRACE_RECEIVE;
+    event.data.resize(length);
+    return length == 0 || fread(&event.data[0], length, 1, fp) == 1;
+}
+
+class Recorder
+{
+    public:
+        ~Recorder()
+        {
+            close();
+        }
+
+        /* Starts writing a trace file, replacing an open one. Returns false if it cannot be created. */
+        bool open(const char *path)
+        {
+            close();
+            file = fopen(path, "wb");
+            if (file == nullptr)
+                return false;
+
+            fwrite(TRACE_MAGIC, sizeof(TRACE_MAGIC), 1, file);
+            fwrite(&TRACE_VERSION, sizeof(TRACE_VERSION), 1, file);
+            lastEvent = now();
+            return true;
+        }
+
+        void close()
+        {
+            if (file != nullptr)
+                fclose(file);
+            file = nullptr;
+        }
+
+        bool isRecording() const
+        {
+            return file != nullptr;
+        }
+
+        /*
+            A command without answer is replaced by the next one. Commands written in one batch
+            before reading their answers are passed with pipelined set, each answer received is
+            then matched to the oldest command still waiting.
+        */
+        void transmitted(const char *data, bool pipelined = false)
+        {
+            if (!pipelined)
+                pending.clear();
+            pending.push_back({commandKey(data), now()});
+            write(TRACE_TRANSMIT, data, strlen(data));
+        }
+
+        void received(const char *data, int length)
+        {
+            uint64_t const time = now();
+            if (!pending.empty())
+            {
+                uint64_t const elapsed = time - pending.front().since;
+                uint32_t const ms      = static_cast<uint32_t>(elapsed / 1000);
+                Histogram &histogram   = latency[pending.front().command];
+                int bucket             = 0;
+                while (bucket < HISTOGRAM_SIZE - 1 && ms >= histogramLimits[bucket])
+                    bucket++;
+
+                histogram.buckets[bucket]++;
+                histogram.count++;
+                histogram.total_us += elapsed;
+                histogram.max_us = std::max(histogram.max_us, static_cast<uint32_t>(elapsed));
+                pending.pop_front();
+            }
+            write(TRACE_RECEIVE, data, length);
+        }
+
+        void resetStatistics()
+        {
+            latency.clear();
+            pending.clear();
+        }
+
+        /*
+            Human readable latency statistics, one line per command:
+            ":GR n=120 mean=12.3ms max=40.1ms <20ms:118 <50ms:2", empty buckets are omitted.
+        */
+        std::string report() const
+        {
+            std::string result;
+            char line[96];
+            for (auto const &entry : latency)
+            {
+                Histogram const &histogram = entry.second;
+                snprintf(line, sizeof(line), "%s n=%u mean=%.1fms max=%.1fms", entry.first.c_str(), histogram.count,
+                         histogram.total_us / 1000.0 / histogram.count, histogram.max_us / 1000.0);
+                result += line;
+                for (int i = 0; i < HISTOGRAM_SIZE; i++)
+                {
+                    if (histogram.buckets[i] == 0)
+                        continue;
+                    if (i < HISTOGRAM_SIZE - 1)
+                        snprintf(line, sizeof(line), " <%ums:%u", histogramLimits[i], histogram.buckets[i]);
+                    else
+                        snprintf(line, sizeof(line), " >=%ums:%u", histogramLimits[i - 1], histogram.buckets[i]);
+                    result += line;
+                }
+                result += "\n";
+            }
+            return result;
+        }
+
+    private:
+        // upper bounds of the latency histogram buckets in milliseconds, the last bucket is open
+        static constexpr int HISTOGRAM_SIZE = 12;
+        static constexpr uint32_t histogramLimits[HISTOGRAM_SIZE - 1] =
+        {
+            1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000
+        };
+
+        struct Histogram
+        {
+            uint32_t count {0};
+            uint64_t total_us {0};
+            uint32_t max_us {0};
+            uint32_t buckets[HISTOGRAM_SIZE] = {};
+        };
+
+        struct Pending
+        {
+            std::string command;
+            uint64_t since;
+        };
+
+        void write(Direction direction, const char *data, size_t length)
+        {
+            if (file == nullptr)
+                return;
+
+            uint64_t const time  = now();
+            uint8_t const dir    = direction;
+            uint32_t const delay = static_cast<uint32_t>(std::min<uint64_t>(time - lastEvent, UINT32_MAX));
+            uint16_t const size  = static_cast<uint16_t>(std::min<size_t>(length, UINT16_MAX));
+            lastEvent = time;
+
+            fwrite(&dir, sizeof(dir), 1, file);
+            fwrite(&delay, sizeof(delay), 1, file);
+            fwrite(&size, sizeof(size), 1, file);
+            fwrite(data, size, 1, file);
+        }
+
+        FILE *file {nullptr};
+        uint64_t lastEvent {0};
+        std::deque<Pending> pending;
+        std::map<std::string, Histogram> latency;
+};
+
+}
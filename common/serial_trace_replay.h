@@ -0,0 +1,135 @@
+/*
+    Playback of serial traces recorded with serial_trace.h
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+#include "serial_trace.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+/*
+    A driver's replay tool is a main() calling SerialTrace::replay(argc, argv):
+
+        <driver>_replay <trace file> [speed]
+
+    The trace is played back through a pseudo terminal, so the driver can be run against it
+    instead of the device. The slave device name is printed on startup, point the driver's port
+    at it. Commands written by the driver are compared to the recorded ones, answers are sent
+    after the recorded delay divided by speed (default 1, 0 answers immediately). Exits with 0
+    if the driver sent the recorded commands, 2 on mismatches and 1 on errors.
+*/
+namespace SerialTrace
+{
+
+// time to wait for the driver to send the next recorded command (ms)
+static constexpr int REPLAY_COMMAND_TIMEOUT = 30000;
+
+/* Reads from the driver until as many bytes as the recorded command were received. Returns false on timeout or error. */
+inline bool readCommand(int fd, size_t length, std::string &command)
+{
+    command.clear();
+    while (command.size() < length)
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        int const ready   = poll(&pfd, 1, REPLAY_COMMAND_TIMEOUT);
+        if (ready <= 0)
+            return false;
+
+        char buffer[256];
+        ssize_t const count = read(fd, buffer, std::min(sizeof(buffer), length - command.size()));
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return false;
+        command.append(buffer, count);
+    }
+    return true;
+}
+
+inline int replay(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <trace file> [speed]\n", argv[0]);
+        return 1;
+    }
+    double const speed = argc > 2 ? atof(argv[2]) : 1.0;
+
+    FILE *fp = fopen(argv[1], "rb");
+    if (fp == nullptr || !readHeader(fp))
+    {
+        fprintf(stderr, "%s is not a serial trace file.\n", argv[1]);
+        return 1;
+    }
+
+    int const master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        fprintf(stderr, "Failed to create pseudo terminal: %s\n", strerror(errno));
+        return 1;
+    }
+    // keep the slave open, so that the master does not fail while the driver reconnects
+    int const slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    printf("Replaying %s on %s\n", argv[1], ptsname(master));
+    fflush(stdout);
+
+    Event event;
+    std::string command;
+    int transmitted = 0, received = 0, mismatches = 0;
+    while (readEvent(fp, event))
+    {
+        if (event.direction == TRACE_TRANSMIT)
+        {
+            // the driver paces the commands, the recorded delay is not replayed
+            if (!readCommand(master, event.data.size(), command))
+            {
+                fprintf(stderr, "Driver did not send %s, stopping.\n", event.data.c_str());
+                break;
+            }
+            if (command != event.data)
+            {
+                fprintf(stderr, "Mismatch: expected %s, received %s\n", event.data.c_str(), command.c_str());
+                mismatches++;
+            }
+            transmitted++;
+        }
+        else
+        {
+            if (speed > 0)
+                usleep(static_cast<useconds_t>(event.delay_us / speed));
+            if (write(master, event.data.data(), event.data.size()) != static_cast<ssize_t>(event.data.size()))
+            {
+                fprintf(stderr, "Failed to send answer: %s\n", strerror(errno));
+                break;
+            }
+            received++;
+        }
+    }
+
+    // closing the master discards unread data, give the driver time to read the last answer
+    sleep(1);
+    printf("Replayed %d commands and %d answers, %d mismatches.\n", transmitted, received, mismatches);
+    fclose(fp);
+    close(slave);
+    close(master);
+    return mismatches == 0 ? 0 : 2;
+}
+
+}
@@ -0,0 +1,177 @@
+/*
+    Tests of the shared camera pipeline against a mock SDK traits class
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <gtest/gtest.h>
+
+#include "camera_pipeline.h"
+
+#include <cstring>
+
+using CameraPipeline::ReadStatus;
+
+// Frames of BGR pixels, the first pixel holds the frame number in its B byte
+struct MockTraits
+{
+    uint32_t sequence {0};
+    uint32_t failAfter {0};          // frames before readVideo() fails, 0 never
+    uint32_t timeoutEvery {0};       // every n-th readVideo() times out, 0 never
+    std::chrono::microseconds readDelay {0};
+    uint32_t reads {0};
+
+    ReadStatus readVideo(uint8_t *buffer, size_t bytes)
+    {
+        std::this_thread::sleep_for(readDelay);
+        reads++;
+        if (timeoutEvery && reads % timeoutEvery == 0)
+            return ReadStatus::Timeout;
+        if (failAfter && sequence >= failAfter)
+            return ReadStatus::Failed;
+
+        fill(buffer, bytes);
+        return ReadStatus::Ok;
+    }
+
+    ReadStatus readImage(uint8_t *buffer, size_t bytes)
+    {
+        fill(buffer, bytes);
+        return ReadStatus::Ok;
+    }
+
+    void fill(uint8_t *buffer, size_t bytes)
+    {
+        for (size_t i = 0; i + 2 < bytes; i += 3)
+        {
+            buffer[i]     = 10;
+            buffer[i + 1] = 20;
+            buffer[i + 2] = 30;
+        }
+        buffer[0] = static_cast<uint8_t>(sequence++);
+    }
+};
+
+static constexpr size_t PIXELS = 64;
+static constexpr size_t FRAME_BYTES = PIXELS * 3;
+
+TEST(CameraPipeline, StreamPublishesFramesInOrderWithRedBlueSwapped)
+{
+    CameraPipeline::Pipeline<MockTraits> pipeline {MockTraits()};
+    pipeline.traits().failAfter = 50;
+    pipeline.traits().readDelay = std::chrono::microseconds(500);
+
+    std::atomic_bool quit {false};
+    std::vector<uint8_t> received;
+    bool swapped = true;
+    bool ok = pipeline.stream(quit, FRAME_BYTES, 3, [&](const uint8_t *frame, size_t bytes)
+    {
+        EXPECT_EQ(bytes, FRAME_BYTES);
+        // B and R are swapped, the frame number moved to the third byte
+        received.push_back(frame[2]);
+        swapped &= frame[0] == 30 && frame[4] == 20 && frame[5] == 10;
+    });
+
+    // The mock fails after 50 frames, which ends the stream
+    EXPECT_FALSE(ok);
+    EXPECT_TRUE(swapped);
+    ASSERT_FALSE(received.empty());
+    for (size_t i = 1; i < received.size(); i++)
+        EXPECT_LT(received[i - 1], received[i]);
+
+    auto stats = pipeline.streamStats();
+    EXPECT_EQ(stats.captured, 50u);
+    EXPECT_EQ(stats.frames, received.size());
+    EXPECT_EQ(stats.frames + stats.dropped, stats.captured);
+}
+
+TEST(CameraPipeline, SlowPublisherDropsFramesWithoutBlockingTheSDK)
+{
+    CameraPipeline::Pipeline<MockTraits> pipeline {MockTraits()};
+    pipeline.traits().failAfter = 40;
+    pipeline.traits().readDelay = std::chrono::milliseconds(1);
+
+    std::atomic_bool quit {false};
+    auto start = std::chrono::steady_clock::now();
+    pipeline.stream(quit, FRAME_BYTES, 0, [&](const uint8_t *, size_t)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    });
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    auto stats = pipeline.streamStats();
+    EXPECT_EQ(stats.captured, 40u);
+    EXPECT_GT(stats.dropped, 0u);
+    // 40 reads of 1 ms, far less than publishing all 40 frames at 10 ms each
+    EXPECT_LT(elapsed, std::chrono::milliseconds(300));
+}
+
+TEST(CameraPipeline, TimeoutsAreRetriedAndQuitStopsTheStream)
+{
+    CameraPipeline::Pipeline<MockTraits> pipeline {MockTraits()};
+    pipeline.traits().timeoutEvery = 3;
+    pipeline.traits().readDelay = std::chrono::microseconds(200);
+
+    std::atomic_bool quit {false};
+    std::atomic<int> published {0};
+    std::thread stopper([&]
+    {
+        while (published < 20)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        quit = true;
+    });
+
+    bool ok = pipeline.stream(quit, FRAME_BYTES, 0, [&](const uint8_t *frame, size_t)
+    {
+        // Mono frames are published as read
+        EXPECT_EQ(frame[1], 20);
+        published++;
+    });
+    stopper.join();
+
+    EXPECT_TRUE(ok);
+    auto stats = pipeline.streamStats();
+    EXPECT_GE(stats.frames, 20u);
+    EXPECT_GT(stats.timeouts, 0u);
+}
+
+TEST(CameraPipeline, DownloadDeinterleavesRGBIntoPlanes)
+{
+    CameraPipeline::Pipeline<MockTraits> pipeline {MockTraits()};
+    pipeline.traits().sequence = 10;
+
+    std::vector<uint8_t> image(FRAME_BYTES, 0);
+    ASSERT_EQ(pipeline.download(image.data(), FRAME_BYTES, PIXELS, 3), ReadStatus::Ok);
+
+    // BGR in, R, G and B planes out
+    EXPECT_EQ(image[0], 30);
+    EXPECT_EQ(image[PIXELS], 20);
+    EXPECT_EQ(image[2 * PIXELS], 10);
+    EXPECT_EQ(image[2 * PIXELS + PIXELS - 1], 10);
+    EXPECT_GE(pipeline.lastDownloadMS(), 0);
+}
+
+TEST(CameraPipeline, MonoDownloadReadsStraightIntoTheFrameBuffer)
+{
+    CameraPipeline::Pipeline<MockTraits> pipeline {MockTraits()};
+    pipeline.traits().sequence = 7;
+
+    std::vector<uint8_t> image(FRAME_BYTES, 0);
+    ASSERT_EQ(pipeline.download(image.data(), FRAME_BYTES, PIXELS, 0), ReadStatus::Ok);
+
+    EXPECT_EQ(image[0], 7);
+    EXPECT_EQ(image[1], 20);
+    EXPECT_EQ(image[2], 30);
+}
@@ -0,0 +1,100 @@
+/*
+    Tests of the serial exchange recorder
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <gtest/gtest.h>
+
+#include "serial_trace.h"
+
+#include <unistd.h>
+
+TEST(SerialTrace, RecordedExchangesReadBackInOrder)
+{
+    char path[] = "/tmp/test_serial_trace_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    SerialTrace::Recorder recorder;
+    ASSERT_TRUE(recorder.open(path));
+    EXPECT_TRUE(recorder.isRecording());
+    recorder.transmitted(":GR#");
+    recorder.received("12:30:00#", 9);
+    recorder.transmitted(":Q#");
+    recorder.close();
+    EXPECT_FALSE(recorder.isRecording());
+
+    FILE *fp = fopen(path, "rb");
+    ASSERT_NE(fp, nullptr);
+    ASSERT_TRUE(SerialTrace::readHeader(fp));
+
+    SerialTrace::Event event;
+    ASSERT_TRUE(SerialTrace::readEvent(fp, event));
+    EXPECT_EQ(event.direction, SerialTrace::TRACE_TRANSMIT);
+    EXPECT_EQ(event.data, ":GR#");
+    ASSERT_TRUE(SerialTrace::readEvent(fp, event));
+    EXPECT_EQ(event.direction, SerialTrace::TRACE_RECEIVE);
+    EXPECT_EQ(event.data, "12:30:00#");
+    ASSERT_TRUE(SerialTrace::readEvent(fp, event));
+    EXPECT_EQ(event.data, ":Q#");
+    EXPECT_FALSE(SerialTrace::readEvent(fp, event));
+
+    fclose(fp);
+    unlink(path);
+}
+
+TEST(SerialTrace, CommandsAreGroupedWithoutArguments)
+{
+    EXPECT_EQ(SerialTrace::commandKey(":X34#"), ":X34");
+    EXPECT_EQ(SerialTrace::commandKey(":Sr12:30:00#"), ":Sr");
+    EXPECT_EQ(SerialTrace::commandKey(":Q#"), ":Q");
+}
+
+TEST(SerialTrace, UnansweredCommandIsReplacedByTheNextOne)
+{
+    SerialTrace::Recorder recorder;
+    recorder.transmitted(":Q#");
+    recorder.transmitted(":GR#");
+    recorder.received("12:30:00#", 9);
+
+    std::string report = recorder.report();
+    EXPECT_NE(report.find(":GR n=1 "), std::string::npos);
+    EXPECT_EQ(report.find(":Q "), std::string::npos);
+}
+
+TEST(SerialTrace, PipelinedAnswersMatchTheirCommandsInOrder)
+{
+    SerialTrace::Recorder recorder;
+    recorder.transmitted(":Q#");
+    recorder.transmitted(":RS#", false);
+    recorder.transmitted(":GR#", true);
+    recorder.transmitted(":GD#", true);
+    recorder.received("c#", 2);
+    recorder.received("12:30:00#", 9);
+    recorder.received("+45*00#", 7);
+    // a further answer has no command left to match
+    recorder.received("0", 1);
+
+    std::string report = recorder.report();
+    EXPECT_NE(report.find(":RS n=1 "), std::string::npos);
+    EXPECT_NE(report.find(":GR n=1 "), std::string::npos);
+    EXPECT_NE(report.find(":GD n=1 "), std::string::npos);
+    EXPECT_EQ(report.find(":Q "), std::string::npos);
+
+    recorder.resetStatistics();
+    EXPECT_TRUE(recorder.report().empty());
+}
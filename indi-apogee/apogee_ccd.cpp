@@ -42,7 +42,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301  USA
 #include <netdb.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <thread>
 
 #ifdef OSX_EMBEDED_MODE
 #include "Alta.h"
@@ -67,6 +71,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301  USA
 #include "indicom.h"
 #include "apogee_ccd.h"
 #include "config.h"
+#include "ccd_ready_wait.h"
 
 #define MAX_CCD_TEMP            45   /* Max CCD temperature */
 #define MIN_CCD_TEMP            -55  /* Min CCD temperature */
@@ -83,6 +88,11 @@ static std::unique_ptr<ApogeeCCD> apogeeCCD(new ApogeeCCD());
 ApogeeCCD::ApogeeCCD() : FilterInterface(this)
 {
     setVersion(APOGEE_VERSION_MAJOR, APOGEE_VERSION_MINOR);
+
+    // Download speed of the simulated camera in MB/s, instant if unset
+    const char *bandwidth = getenv("APOGEE_SIM_BANDWIDTH");
+    if (bandwidth != nullptr)
+        simulatedBandwidth = atof(bandwidth);
 }
 
 const char *ApogeeCCD::getDefaultName()
@@ -332,6 +342,7 @@ int ApogeeCCD::SetTemperature(double temperature)
 
     try
     {
+        std::lock_guard<std::mutex> lock(cameraLock);
         if (isSimulation() == false)
             ApgCam->SetCoolerSetPoint(temperature);
     }
@@ -381,6 +392,7 @@ bool ApogeeCCD::ISNewSwitch(const char *dev, const char *name, ISState *states,
             {
                 try
                 {
+                    std::lock_guard<std::mutex> lock(cameraLock);
                     if (isSimulation() == false)
                         ApgCam->SetCcdAdcSpeed(Apg::AdcSpeed_Normal);
                 }
@@ -397,6 +409,7 @@ bool ApogeeCCD::ISNewSwitch(const char *dev, const char *name, ISState *states,
             {
                 try
                 {
+                    std::lock_guard<std::mutex> lock(cameraLock);
                     if (isSimulation() == false)
                         ApgCam->SetCcdAdcSpeed(Apg::AdcSpeed_Fast);
                 }
@@ -424,7 +437,9 @@ bool ApogeeCCD::ISNewSwitch(const char *dev, const char *name, ISState *states,
             if (IUUpdateSwitch(&FanStatusSP, states, names, n) < 0)
                 return false;
 
+            std::unique_lock<std::mutex> lock(cameraLock);
             ApgCam->SetFanMode(static_cast<Apg::FanMode>(IUFindOnSwitchIndex(&FanStatusSP)));
+            lock.unlock();
             FanStatusSP.s = IPS_OK;
             IDSetSwitch(&FanStatusSP, nullptr);
             return true;
@@ -513,6 +528,7 @@ bool ApogeeCCD::StartExposure(float duration)
         LOGF_INFO("Bias Frame (s) : %.3f", ExposureRequest);
     }
 
+    std::unique_lock<std::mutex> lock(cameraLock);
     if (isSimulation() == false)
         ApgCam->SetImageCount(1);
 
@@ -550,10 +566,13 @@ bool ApogeeCCD::StartExposure(float duration)
         }
     }
 
+    lock.unlock();
+
     gettimeofday(&ExpStart, nullptr);
     LOGF_DEBUG("Taking a %g seconds frame...", ExposureRequest);
 
     InExposure = true;
+    readoutWorker.start(std::bind(&ApogeeCCD::workerExposure, this, std::placeholders::_1));
     return true;
 }
 
@@ -561,6 +580,7 @@ bool ApogeeCCD::AbortExposure()
 {
     try
     {
+        std::lock_guard<std::mutex> lock(cameraLock);
         if (isSimulation() == false)
             ApgCam->StopExposure(false);
     }
@@ -570,6 +590,7 @@ bool ApogeeCCD::AbortExposure()
         return false;
     }
 
+    readoutWorker.quit();
     InExposure = false;
     return true;
 }
@@ -678,28 +699,98 @@ bool ApogeeCCD::UpdateCCDBin(int binx, int biny)
     return UpdateCCDFrame(PrimaryCCD.getSubX(), PrimaryCCD.getSubY(), PrimaryCCD.getSubW(), PrimaryCCD.getSubH());
 }
 
+bool ApogeeCCD::waitImageReady(const std::atomic_bool &isAboutToQuit)
+{
+    auto timeLeft = [this]()
+    {
+        return CalcTimeLeft(ExpStart, ExposureRequest);
+    };
+    auto showTimeLeft = [this](float timeleft)
+    {
+        LOGF_DEBUG("Image not ready, time left %.0f", ceil(timeleft));
+        PrimaryCCD.setExposureLeft(timeleft);
+    };
+    if (!ReadyWait::countdown(isAboutToQuit, timeLeft, showTimeLeft))
+        return false;
+
+    if (isSimulation())
+        return true;
+
+    return ReadyWait::poll(isAboutToQuit, [this]()
+    {
+        try
+        {
+            std::lock_guard<std::mutex> lock(cameraLock);
+            Apg::Status status = ApgCam->GetImagingStatus();
+            if (status == Apg::Status_ImageReady)
+                return ReadyWait::State::Ready;
+            checkStatus(status);
+            return ReadyWait::State::Busy;
+        }
+        catch (std::runtime_error &err)
+        {
+            LOGF_ERROR("Waiting for the image failed. %s.", err.what());
+            return ReadyWait::State::Failed;
+        }
+    });
+}
+
+void ApogeeCCD::workerExposure(const std::atomic_bool &isAboutToQuit)
+{
+    if (!waitImageReady(isAboutToQuit))
+    {
+        if (!isAboutToQuit)
+        {
+            InExposure = false;
+            PrimaryCCD.setExposureFailed();
+        }
+        return;
+    }
+
+    /* We're done exposing */
+    LOG_INFO("Exposure done, downloading image...");
+    PrimaryCCD.setExposureLeft(0);
+
+    auto start = std::chrono::steady_clock::now();
+    int rc = grabImage();
+    InExposure = false;
+    if (rc < 0)
+    {
+        PrimaryCCD.setExposureFailed();
+        return;
+    }
+    LOGF_DEBUG("Downloaded in %.3f s.", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    // waits for the previous frame to be sent, the camera may already expose the next one
+    encodeWorker.start([this](const std::atomic_bool &)
+    {
+        workerComplete();
+    });
+}
+
+/* Downloads the image into the staging buffer, which keeps its size between frames. */
 int ApogeeCCD::grabImage()
 {
-    std::vector<uint16_t> pImageData;
-    uint16_t *image = reinterpret_cast<uint16_t*>(PrimaryCCD.getFrameBuffer());
+    std::lock_guard<std::mutex> guard(stagingBufferLock);
 
     try
     {
-        std::unique_lock<std::mutex> guard(ccdBufferLock);
         if (isSimulation())
         {
-            for (int i = 0; i < imageHeight; i++)
-                for (int j = 0; j < imageWidth; j++)
-                    image[i * imageWidth + j] = rand() % 65535;
+            stagingBuffer.resize(static_cast<size_t>(imageWidth) * imageHeight);
+            for (auto &pixel : stagingBuffer)
+                pixel = rand() % 65535;
+            if (simulatedBandwidth > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(stagingBuffer.size() * 2 /
+                                            simulatedBandwidth)));
         }
         else
         {
-            ApgCam->GetImage(pImageData);
+            std::lock_guard<std::mutex> lock(cameraLock);
+            ApgCam->GetImage(stagingBuffer);
             imageWidth  = ApgCam->GetRoiNumCols();
             imageHeight = ApgCam->GetRoiNumRows();
-            copy(pImageData.begin(), pImageData.end(), image);
         }
-        guard.unlock();
     }
     catch (std::runtime_error &err)
     {
@@ -707,11 +798,30 @@ int ApogeeCCD::grabImage()
         return -1;
     }
 
-    ExposureComplete(&PrimaryCCD);
+    return 0;
+}
+
+/* Runs on the encode worker. */
+void ApogeeCCD::workerComplete()
+{
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    {
+        std::lock_guard<std::mutex> lock(stagingBufferLock);
+        size_t size = stagingBuffer.size() * sizeof(uint16_t);
+        if (size > static_cast<size_t>(PrimaryCCD.getFrameBufferSize()))
+        {
+            guard.unlock();
+            LOG_ERROR("Frame buffer too small for the downloaded image.");
+            PrimaryCCD.setExposureFailed();
+            return;
+        }
+        memcpy(PrimaryCCD.getFrameBuffer(), stagingBuffer.data(), size);
+    }
+    guard.unlock();
 
     LOG_INFO("Download complete.");
 
-    return 0;
+    ExposureComplete(&PrimaryCCD);
 }
 
 ///////////////////////////
@@ -1200,6 +1310,9 @@ bool ApogeeCCD::Connect()
 
 bool ApogeeCCD::Disconnect()
 {
+    readoutWorker.quit();
+    encodeWorker.quit();
+
     try
     {
         if (isSimulation() == false)
@@ -1229,6 +1342,7 @@ void ApogeeCCD::activateCooler(bool enable)
 
     try
     {
+        std::lock_guard<std::mutex> lock(cameraLock);
         coolerOn = ApgCam->IsCoolerOn();
         if ((enable && coolerOn == false) || (!enable && coolerOn == true))
         {
@@ -1257,42 +1371,19 @@ void ApogeeCCD::activateCooler(bool enable)
 
 void ApogeeCCD::TimerHit()
 {
-    long timeleft;
     double ccdTemp;
     double coolerPower;
 
     if (isConnected() == false)
         return;
 
-    if (InExposure)
+    // Exposures are followed by the readout worker. Skip the camera queries while it holds
+    // the camera for a download, rather than blocking the main loop.
+    std::unique_lock<std::mutex> lock(cameraLock, std::try_to_lock);
+    if (!lock.owns_lock())
     {
-        timeleft = CalcTimeLeft(ExpStart, ExposureRequest);
-
-        if (timeleft < 1)
-        {
-            if (isSimulation() == false)
-            {
-                Apg::Status status = ApgCam->GetImagingStatus();
-
-                while (status != Apg::Status_ImageReady)
-                {
-                    usleep(250000);
-                    status = ApgCam->GetImagingStatus();
-                }
-            }
-
-            /* We're done exposing */
-            LOG_INFO("Exposure done, downloading image...");
-            PrimaryCCD.setExposureLeft(0);
-            InExposure = false;
-            /* grab and save image */
-            grabImage();
-        }
-        else
-        {
-            LOGF_DEBUG("Image not ready, time left %ld\n", timeleft);
-            PrimaryCCD.setExposureLeft(timeleft);
-        }
+        SetTimer(getCurrentPollingPeriod());
+        return;
     }
 
     switch (TemperatureNP.getState())
@@ -1413,6 +1504,8 @@ void ApogeeCCD::TimerHit()
             break;
     }
 
+    lock.unlock();
+
     if (FilterSlotNP.getState() == IPS_BUSY)
     {
         try
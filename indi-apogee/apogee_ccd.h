@@ -23,7 +23,11 @@
 #include <indiccd.h>
 #include <indiguiderinterface.h>
 #include <indifilterinterface.h>
+#include <indisinglethreadpool.h>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 #include "ApogeeCam.h"
 #include "ApogeeFilterWheel.h"
@@ -162,6 +166,20 @@ class ApogeeCCD : public INDI::CCD, public INDI::FilterInterface
 
         float CalcTimeLeft(timeval, float);
         int grabImage();
+
+        // Readout: the readout worker waits for the image and downloads it into the staging
+        // buffer, the encode worker copies it to the chip and sends it. The camera is free for
+        // the next exposure as soon as the download is done.
+        INDI::SingleThreadPool readoutWorker;
+        INDI::SingleThreadPool encodeWorker;
+        // libapogee calls are not thread safe
+        std::mutex cameraLock;
+        std::vector<uint16_t> stagingBuffer;
+        std::mutex stagingBufferLock;
+        double simulatedBandwidth {0};
+        bool waitImageReady(const std::atomic_bool &isAboutToQuit);
+        void workerExposure(const std::atomic_bool &isAboutToQuit);
+        void workerComplete();
         bool getCameraParams();
         void activateCooler(bool enable);
 };
@@ -52,6 +52,20 @@ const char *ASIBase::getBayerString() const
     return Helpers::toString(mCameraInfo.BayerPattern);
 }
 
+CameraPipeline::ReadStatus ASIPipelineTraits::readVideo(uint8_t *buffer, size_t bytes)
+{
+    error = ASIGetVideoData(cameraID, buffer, bytes, waitMS);
+    if (error == ASI_SUCCESS)
+        return CameraPipeline::ReadStatus::Ok;
+    return error == ASI_ERROR_TIMEOUT ? CameraPipeline::ReadStatus::Timeout : CameraPipeline::ReadStatus::Failed;
+}
+
+CameraPipeline::ReadStatus ASIPipelineTraits::readImage(uint8_t *buffer, size_t bytes)
+{
+    error = ASIGetDataAfterExp(cameraID, buffer, bytes);
+    return error == ASI_SUCCESS ? CameraPipeline::ReadStatus::Ok : CameraPipeline::ReadStatus::Failed;
+}
+
 void ASIBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
 {
     ASI_ERROR_CODE ret;
@@ -70,32 +84,21 @@ void ASIBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
         LOGF_ERROR("Failed to start video capture (%s).", Helpers::toString(ret));
     }
 
-    while (!isAboutToQuit)
-    {
-        uint8_t *targetFrame = PrimaryCCD.getFrameBuffer();
-        uint32_t totalBytes  = PrimaryCCD.getFrameBufferSize();
-        int waitMS           = static_cast<int>((ExposureRequest * 2000.0) + 500);
-
-        ret = ASIGetVideoData(mCameraInfo.CameraID, targetFrame, totalBytes, waitMS);
-        if (ret != ASI_SUCCESS)
-        {
-            if (ret != ASI_ERROR_TIMEOUT)
-            {
-                Streamer->setStream(false);
-                LOGF_ERROR("Failed to read video data (%s).", Helpers::toString(ret));
-                break;
-            }
-
-            usleep(100);
-            continue;
-        }
-
-        if (mCurrentVideoFormat == ASI_IMG_RGB24)
-            for (uint32_t i = 0; i < totalBytes; i += 3)
-                std::swap(targetFrame[i], targetFrame[i + 2]);
+    ASIPipelineTraits &sdk = mPipeline.traits();
+    sdk.cameraID = mCameraInfo.CameraID;
+    sdk.waitMS   = static_cast<int>((ExposureRequest * 2000.0) + 500);
 
-        Streamer->newFrame(targetFrame, totalBytes);
+    bool ok = mPipeline.stream(isAboutToQuit, PrimaryCCD.getFrameBufferSize(), mCurrentVideoFormat == ASI_IMG_RGB24 ? 3 : 0,
+                               [this](const uint8_t *frame, size_t bytes)
+    {
+        Streamer->newFrame(frame, bytes);
+    });
+    if (!ok)
+    {
+        Streamer->setStream(false);
+        LOGF_ERROR("Failed to read video data (%s).", Helpers::toString(sdk.error));
     }
+    LOGF_DEBUG("Stream stopped: %s.", mPipeline.streamStats().summary().c_str());
 
     ASIStopVideoCapture(mCameraInfo.CameraID);
 }
@@ -1246,61 +1249,30 @@ bool ASIBase::UpdateCCDBin(int binx, int biny)
  N.B. No processing is done on the image */
 int ASIBase::grabImage(float duration)
 {
-    ASI_ERROR_CODE ret = ASI_SUCCESS;
-
     ASI_IMG_TYPE type = getImageType();
 
     std::unique_lock<std::mutex> guard(ccdBufferLock);
     uint8_t *image = PrimaryCCD.getFrameBuffer();
-    uint8_t *buffer = image;
 
     uint16_t subW = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
     uint16_t subH = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
     int nChannels = (type == ASI_IMG_RGB24) ? 3 : 1;
     size_t nTotalBytes = subW * subH * nChannels * (PrimaryCCD.getBPP() / 8);
 
-    if (type == ASI_IMG_RGB24)
-    {
-        buffer = static_cast<uint8_t *>(malloc(nTotalBytes));
-        if (buffer == nullptr)
-        {
-            LOGF_ERROR("%s: %d malloc failed (RGB 24).", getDeviceName());
-            return -1;
-        }
-    }
-
-    ret = ASIGetDataAfterExp(mCameraInfo.CameraID, buffer, nTotalBytes);
-    if (ret != ASI_SUCCESS)
+    ASIPipelineTraits &sdk = mPipeline.traits();
+    sdk.cameraID = mCameraInfo.CameraID;
+    if (mPipeline.download(image, nTotalBytes, subW * subH, type == ASI_IMG_RGB24 ? 3 : 0) != CameraPipeline::ReadStatus::Ok)
     {
         LOGF_ERROR(
             "Failed to get data after exposure (%dx%d #%d channels) (%s).",
-            subW, subH, nChannels, Helpers::toString(ret)
+            subW, subH, nChannels, Helpers::toString(sdk.error)
         );
-        if (type == ASI_IMG_RGB24)
-            free(buffer);
         return -1;
     }
-
-    if (type == ASI_IMG_RGB24)
-    {
-        uint8_t *dstR = image;
-        uint8_t *dstG = image + subW * subH;
-        uint8_t *dstB = image + subW * subH * 2;
-
-        const uint8_t *src = buffer;
-        const uint8_t *end = buffer + subW * subH * 3;
-
-        while (src != end)
-        {
-            *dstB++ = *src++;
-            *dstG++ = *src++;
-            *dstR++ = *src++;
-        }
-
-        free(buffer);
-    }
     guard.unlock();
 
+    LOGF_DEBUG("Download took %.0f ms.", mPipeline.lastDownloadMS());
+
     PrimaryCCD.setNAxis(type == ASI_IMG_RGB24 ? 3 : 2);
 
     // If mono camera or we're sending Luma or RGB, turn off bayering
@@ -29,12 +29,24 @@
 #include "indipropertynumber.h"
 #include "indipropertytext.h"
 #include "indisinglethreadpool.h"
+#include "camera_pipeline.h"
 
 #include <vector>
 
 #include <indiccd.h>
 #include <inditimer.h>
 
+/* SDK calls used by the shared download and streaming pipeline */
+struct ASIPipelineTraits
+{
+    int cameraID {0};
+    int waitMS {0};
+    ASI_ERROR_CODE error {ASI_SUCCESS};
+
+    CameraPipeline::ReadStatus readVideo(uint8_t *buffer, size_t bytes);
+    CameraPipeline::ReadStatus readImage(uint8_t *buffer, size_t bytes);
+};
+
 class SingleWorker;
 class ASIBase : public INDI::CCD
 {
@@ -169,5 +181,6 @@ class ASIBase : public INDI::CCD
         ASI_CAMERA_INFO mCameraInfo;
         uint8_t mExposureRetry {0};
         ASI_IMG_TYPE mCurrentVideoFormat;
+        CameraPipeline::Pipeline<ASIPipelineTraits> mPipeline {ASIPipelineTraits()};
         std::vector<ASI_CONTROL_CAPS> mControlCaps;
 };
@@ -0,0 +1,425 @@
+/*
+ ASI CCD Driver - mock libASICamera2
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ libASICamera2 for asi_download_benchmark, see common/README.md. One colour camera is
+ enumerated, 1920 x 1080 and 300 MB/s unless set otherwise, with RAW8, RGB24, RAW16 and Y8.
+
+ Like the SDK, an exposure reports ASI_EXP_WORKING until the frame has crossed the USB link,
+ and ASIGetDataAfterExp then copies it out of the SDK's buffer. In video mode the camera
+ produces a frame per exposure time (or per transfer time, if longer) whether it is read or
+ not, ASIGetVideoData waits for the next one and returns the newest.
+*/
+
+#include <ASICamera2.h>
+#include "asi_mock.h"
+#include "sdk_mock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+const ASI_CONTROL_CAPS controls[] =
+{
+    { "Gain", "Gain", 570, 0, 0, ASI_TRUE, ASI_TRUE, ASI_GAIN, {} },
+    { "Exposure", "Exposure Time(us)", 2000000000, 32, 10000, ASI_TRUE, ASI_TRUE, ASI_EXPOSURE, {} },
+    { "Offset", "offset", 80, 0, 8, ASI_FALSE, ASI_TRUE, ASI_OFFSET, {} },
+    { "BandWidth", "The total data transfer rate percentage", 100, 40, 50, ASI_TRUE, ASI_TRUE, ASI_BANDWIDTHOVERLOAD, {} },
+    { "Flip", "Flip: 0->None 1->Horiz 2->Vert 3->Both", 3, 0, 0, ASI_FALSE, ASI_TRUE, ASI_FLIP, {} },
+    { "Temperature", "Sensor temperature(degrees Celsius)", 1000, -500, 20, ASI_FALSE, ASI_FALSE, ASI_TEMPERATURE, {} },
+};
+const int controlCount = sizeof(controls) / sizeof(controls[0]);
+
+struct MockCamera
+{
+    int width;
+    int height;
+    double bandwidth;
+    bool color;
+
+    int roiW {0}, roiH {0}, bin {1};
+    int startX {0}, startY {0};
+    ASI_IMG_TYPE type {ASI_IMG_RAW8};
+    long values[ASI_ROLLING_INTERVAL + 1] {};
+    bool opened {false};
+
+    // one frame of the largest format, the SDK's own buffer
+    std::vector<uint8_t> sensor;
+
+    ASI_EXPOSURE_STATUS status {ASI_EXP_IDLE};
+    Clock::time_point ready;
+
+    SDKMock::FrameClock video;
+    SDKMock::Counters counters;
+
+    std::mutex lock;
+} camera;
+
+bool configured = false;
+
+void configure()
+{
+    if (configured)
+        return;
+    configured       = true;
+    camera.width     = SDKMock::env("ASI_MOCK_WIDTH", 1920);
+    camera.height    = SDKMock::env("ASI_MOCK_HEIGHT", 1080);
+    camera.bandwidth = std::max(SDKMock::env("ASI_MOCK_BANDWIDTH", 300.0), 0.001);
+    camera.color     = SDKMock::env("ASI_MOCK_COLOR", 1) != 0;
+    camera.roiW      = camera.width;
+    camera.roiH      = camera.height;
+    for (const auto &control : controls)
+        camera.values[control.ControlType] = control.DefaultValue;
+    camera.values[ASI_TEMPERATURE] = 200;
+}
+
+size_t bytesPerPixel(ASI_IMG_TYPE type)
+{
+    switch (type)
+    {
+        case ASI_IMG_RGB24: return 3;
+        case ASI_IMG_RAW16: return 2;
+        default:            return 1;
+    }
+}
+
+size_t frameBytes()
+{
+    return static_cast<size_t>(camera.roiW) * camera.roiH * bytesPerPixel(camera.type);
+}
+
+const ASI_CONTROL_CAPS *findControl(ASI_CONTROL_TYPE type)
+{
+    for (const auto &control : controls)
+        if (control.ControlType == type)
+            return &control;
+    return nullptr;
+}
+
+ASI_ERROR_CODE checkCamera(int iCameraID)
+{
+    if (iCameraID != 0)
+        return ASI_ERROR_INVALID_ID;
+    return camera.opened ? ASI_SUCCESS : ASI_ERROR_CAMERA_CLOSED;
+}
+
+void copyFrame(unsigned char *pBuffer, size_t length)
+{
+    memcpy(pBuffer, camera.sensor.data(), length);
+    camera.counters.bytesCopied += length;
+}
+}
+
+extern "C" void ASIMockGetStats(SDKMock::Stats *stats)
+{
+    camera.counters.get(stats);
+}
+
+extern "C" void ASIMockResetStats()
+{
+    camera.counters.reset();
+}
+
+int ASIGetNumOfConnectedCameras()
+{
+    configure();
+    return 1;
+}
+
+ASI_ERROR_CODE ASIGetCameraProperty(ASI_CAMERA_INFO *pASICameraInfo, int iCameraIndex)
+{
+    if (iCameraIndex != 0)
+        return ASI_ERROR_INVALID_INDEX;
+    return ASIGetCameraPropertyByID(0, pASICameraInfo);
+}
+
+ASI_ERROR_CODE ASIGetCameraPropertyByID(int iCameraID, ASI_CAMERA_INFO *pASICameraInfo)
+{
+    if (iCameraID != 0)
+        return ASI_ERROR_INVALID_ID;
+    configure();
+
+    memset(pASICameraInfo, 0, sizeof(*pASICameraInfo));
+    snprintf(pASICameraInfo->Name, sizeof(pASICameraInfo->Name), "ZWO ASI Mock %dx%d", camera.width, camera.height);
+    pASICameraInfo->CameraID     = 0;
+    pASICameraInfo->MaxWidth     = camera.width;
+    pASICameraInfo->MaxHeight    = camera.height;
+    pASICameraInfo->IsColorCam   = camera.color ? ASI_TRUE : ASI_FALSE;
+    pASICameraInfo->BayerPattern = ASI_BAYER_RG;
+    pASICameraInfo->SupportedBins[0] = 1;
+    pASICameraInfo->SupportedBins[1] = 2;
+    // in enum order, the driver indexes its format switch with ASI_IMG_TYPE
+    pASICameraInfo->SupportedVideoFormat[0] = ASI_IMG_RAW8;
+    pASICameraInfo->SupportedVideoFormat[1] = ASI_IMG_RGB24;
+    pASICameraInfo->SupportedVideoFormat[2] = ASI_IMG_RAW16;
+    pASICameraInfo->SupportedVideoFormat[3] = ASI_IMG_Y8;
+    pASICameraInfo->SupportedVideoFormat[4] = ASI_IMG_END;
+    pASICameraInfo->PixelSize    = 2.9;
+    pASICameraInfo->ST4Port      = ASI_TRUE;
+    pASICameraInfo->IsUSB3Host   = ASI_TRUE;
+    pASICameraInfo->IsUSB3Camera = ASI_TRUE;
+    pASICameraInfo->ElecPerADU   = 1;
+    pASICameraInfo->BitDepth     = 12;
+    return ASI_SUCCESS;
+}
+
+ASI_ERROR_CODE ASIOpenCamera(int iCameraID)
+{
+    if (iCameraID != 0)
+        return ASI_ERROR_INVALID_ID;
+    configure();
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    // a horizontal gradient growing with the line number, so that a wrong flip or R/B swap is visible
+    camera.sensor.resize(static_cast<size_t>(camera.width) * camera.height * 3);
+    for (size_t i = 0; i < camera.sensor.size(); i++)
+        camera.sensor[i] = static_cast<uint8_t>(i % 251 + i / (camera.width * 3));
+    camera.opened = true;
+    return ASI_SUCCESS;
+}
+
+ASI_ERROR_CODE ASIInitCamera(int iCameraID)
+{
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASICloseCamera(int iCameraID)
+{
+    if (iCameraID != 0)
+        return ASI_ERROR_INVALID_ID;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.opened = false;
+    camera.status = ASI_EXP_IDLE;
+    camera.video.clear();
+    return ASI_SUCCESS;
+}
+
+ASI_ERROR_CODE ASIGetNumOfControls(int iCameraID, int *piNumberOfControls)
+{
+    *piNumberOfControls = controlCount;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIGetControlCaps(int iCameraID, int iControlIndex, ASI_CONTROL_CAPS *pControlCaps)
+{
+    if (iControlIndex < 0 || iControlIndex >= controlCount)
+        return ASI_ERROR_INVALID_INDEX;
+    *pControlCaps = controls[iControlIndex];
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIGetControlValue(int iCameraID, ASI_CONTROL_TYPE ControlType, long *plValue, ASI_BOOL *pbAuto)
+{
+    if (findControl(ControlType) == nullptr)
+        return ASI_ERROR_INVALID_CONTROL_TYPE;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *plValue = camera.values[ControlType];
+    *pbAuto  = ASI_FALSE;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASISetControlValue(int iCameraID, ASI_CONTROL_TYPE ControlType, long lValue, ASI_BOOL)
+{
+    const ASI_CONTROL_CAPS *control = findControl(ControlType);
+    if (control == nullptr || !control->IsWritable)
+        return ASI_ERROR_INVALID_CONTROL_TYPE;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.values[ControlType] = std::min(std::max(lValue, control->MinValue), control->MaxValue);
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASISetROIFormat(int iCameraID, int iWidth, int iHeight, int iBin, ASI_IMG_TYPE Img_type)
+{
+    if (iWidth <= 0 || iHeight <= 0 || iWidth * iBin > camera.width || iHeight * iBin > camera.height ||
+            iWidth % 8 != 0 || iHeight % 2 != 0)
+        return ASI_ERROR_INVALID_SIZE;
+    if (Img_type < ASI_IMG_RAW8 || Img_type > ASI_IMG_Y8)
+        return ASI_ERROR_INVALID_IMGTYPE;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.video.running())
+        return ASI_ERROR_VIDEO_MODE_ACTIVE;
+    camera.roiW = iWidth;
+    camera.roiH = iHeight;
+    camera.bin  = iBin;
+    camera.type = Img_type;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIGetROIFormat(int iCameraID, int *piWidth, int *piHeight, int *piBin, ASI_IMG_TYPE *pImg_type)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *piWidth   = camera.roiW;
+    *piHeight  = camera.roiH;
+    *piBin     = camera.bin;
+    *pImg_type = camera.type;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASISetStartPos(int iCameraID, int iStartX, int iStartY)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (iStartX < 0 || iStartY < 0 || iStartX + camera.roiW > camera.width / camera.bin ||
+            iStartY + camera.roiH > camera.height / camera.bin)
+        return ASI_ERROR_OUTOF_BOUNDARY;
+    camera.startX = iStartX;
+    camera.startY = iStartY;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIGetStartPos(int iCameraID, int *piStartX, int *piStartY)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *piStartX = camera.startX;
+    *piStartY = camera.startY;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIStartExposure(int iCameraID, ASI_BOOL)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.video.running())
+        return ASI_ERROR_VIDEO_MODE_ACTIVE;
+    if (camera.status == ASI_EXP_WORKING)
+        return ASI_ERROR_EXPOSURE_IN_PROGRESS;
+
+    camera.counters.exposures++;
+    camera.status = ASI_EXP_WORKING;
+    camera.ready  = Clock::now() + std::chrono::microseconds(camera.values[ASI_EXPOSURE]) +
+                    SDKMock::transferTime(frameBytes(), camera.bandwidth);
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIStopExposure(int iCameraID)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.status = ASI_EXP_IDLE;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIGetExpStatus(int iCameraID, ASI_EXPOSURE_STATUS *pExpStatus)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.counters.statusPolls++;
+    if (camera.status == ASI_EXP_WORKING && Clock::now() >= camera.ready)
+        camera.status = ASI_EXP_SUCCESS;
+    *pExpStatus = camera.status;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIGetDataAfterExp(int iCameraID, unsigned char *pBuffer, long lBuffSize)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.status != ASI_EXP_SUCCESS)
+        return ASI_ERROR_GENERAL_ERROR;
+
+    size_t length = frameBytes();
+    if (lBuffSize < static_cast<long>(length))
+        return ASI_ERROR_BUFFER_TOO_SMALL;
+
+    copyFrame(pBuffer, length);
+    camera.status = ASI_EXP_IDLE;
+    camera.counters.downloads++;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIStartVideoCapture(int iCameraID)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.status == ASI_EXP_WORKING)
+        return ASI_ERROR_EXPOSURE_IN_PROGRESS;
+
+    camera.video.start(std::max<Clock::duration>(std::chrono::microseconds(camera.values[ASI_EXPOSURE]),
+                       SDKMock::transferTime(frameBytes(), camera.bandwidth)));
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIStopVideoCapture(int iCameraID)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.video.clear();
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIGetVideoData(int iCameraID, unsigned char *pBuffer, long lBuffSize, int iWaitms)
+{
+    std::unique_lock<std::mutex> guard(camera.lock);
+    if (!camera.video.running())
+        return ASI_ERROR_INVALID_SEQUENCE;
+
+    size_t length = frameBytes();
+    if (lBuffSize < static_cast<long>(length))
+        return ASI_ERROR_BUFFER_TOO_SMALL;
+
+    // wait for the frame after the last one returned
+    Clock::time_point next = camera.video.next();
+    Clock::time_point now  = Clock::now();
+    if (next > now)
+    {
+        if (iWaitms >= 0 && next > now + std::chrono::milliseconds(iWaitms))
+        {
+            guard.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(iWaitms));
+            return ASI_ERROR_TIMEOUT;
+        }
+        guard.unlock();
+        std::this_thread::sleep_until(next);
+        guard.lock();
+        if (!camera.video.running())
+            return ASI_ERROR_INVALID_SEQUENCE;
+    }
+
+    camera.counters.videoSkipped += camera.video.take();
+    copyFrame(pBuffer, length);
+    camera.counters.videoFrames++;
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIPulseGuideOn(int iCameraID, ASI_GUIDE_DIRECTION)
+{
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIPulseGuideOff(int iCameraID, ASI_GUIDE_DIRECTION)
+{
+    return checkCamera(iCameraID);
+}
+
+ASI_ERROR_CODE ASIGetSerialNumber(int iCameraID, ASI_SN *pSN)
+{
+    memset(pSN->id, 0, sizeof(pSN->id));
+    return checkCamera(iCameraID);
+}
+
+char *ASIGetSDKVersion()
+{
+    static char version[] = "1, 37, 0, 0 (mock)";
+    return version;
+}
@@ -0,0 +1,48 @@
+/*
+    SPDX-FileCopyrightText: 2025 Jasem Mutlaq <mutlaqja@ikarustech.com>
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+/*
+    Offline benchmark of the ASI download path, see common/ccd_benchmark.h.
+
+    The real ASIBase (asi_base.cpp) is linked against the mock libASICamera2 in mock/, memcpy
+    calls are counted in asi_base.cpp.
+*/
+
+#include "asi_base.h"
+#include "asi_mock.h"
+#include "ccd_benchmark.h"
+
+/**
+ * @brief ASIBase on the first mock camera.
+ */
+class BenchmarkASI : public CCDBenchmark::Camera<ASIBase>
+{
+    public:
+        BenchmarkASI()
+        {
+            ASIGetCameraProperty(&mCameraInfo, 0);
+            mCameraName = mCameraInfo.Name;
+            setDeviceName("ZWO CCD Benchmark");
+        }
+
+        static bool listed()
+        {
+            return ASIGetNumOfConnectedCameras() > 0;
+        }
+};
+
+static const CCDBenchmark::Format formats[] =
+{
+    { "raw8",  "ASI_IMG_RAW8",  1 },
+    { "raw16", "ASI_IMG_RAW16", 2 },
+    { "rgb24", "ASI_IMG_RGB24", 3 },
+};
+
+int main(int argc, char *argv[])
+{
+    const CCDBenchmark::Driver driver = { "indi_asi", "ASI", formats, 3, ASIMockGetStats, ASIMockResetStats };
+    return CCDBenchmark::run<BenchmarkASI>(argc, argv, driver);
+}
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <math.h>
 #include <unistd.h>
+#include <cstring>
 #include <deque>
 #include <memory>
 
@@ -110,6 +111,13 @@ ATIKCCD::ATIKCCD(std::string filterName, int id) : FilterInterface(this), m_iDev
     setDeviceName(this->name);
 }
 
+ATIKCCD::~ATIKCCD()
+{
+    encodeWorker.quit();
+    // The frame buffer belongs to the pool or the SDK, the chip must not free it
+    PrimaryCCD.setFrameBuffer(nullptr);
+}
+
 const char *ATIKCCD::getDefaultName()
 {
     return "Atik";
@@ -184,6 +192,12 @@ bool ATIKCCD::initProperties()
     IUFillSwitchVector(&FastModeSP, FastModeS, 2, getDeviceName(), "CCD_FAST_MODE", "Fast Mode", CONTROLS_TAB, IP_RW,
                        ISR_1OFMANY, 60, IPS_IDLE);
 
+    // Frame buffer policy
+    IUFillSwitch(&FrameBufferS[FRAME_BUFFER_COPY], "FRAME_BUFFER_COPY", "Copy", ISS_ON);
+    IUFillSwitch(&FrameBufferS[FRAME_BUFFER_BORROW], "FRAME_BUFFER_BORROW", "Borrow", ISS_OFF);
+    IUFillSwitchVector(&FrameBufferSP, FrameBufferS, 2, getDeviceName(), "CCD_FRAME_BUFFER", "Frame Buffer", OPTIONS_TAB,
+                       IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
 #if 0
     // Bit send format
     IUFillSwitch(&BitSendS[BITSEND_16BITS], "BITSEND_16BITS", "16BITS", ISS_OFF);
@@ -244,6 +258,7 @@ bool ATIKCCD::updateProperties()
         if (m_CameraFlags & ARTEMIS_PROPERTIES_CAMERAFLAGS_HAS_FILTERWHEEL)
             INDI::FilterInterface::updateProperties();
 
+        defineProperty(&FrameBufferSP);
         defineProperty(&VersionInfoSP);
     }
     else
@@ -271,6 +286,7 @@ bool ATIKCCD::updateProperties()
         if (m_CameraFlags & ARTEMIS_PROPERTIES_CAMERAFLAGS_HAS_FILTERWHEEL)
             INDI::FilterInterface::updateProperties();
 
+        deleteProperty(FrameBufferSP.name);
         deleteProperty(VersionInfoSP.name);
     }
 
@@ -658,6 +674,7 @@ bool ATIKCCD::Disconnect()
     pthread_cond_signal(&cv);
     pthread_mutex_unlock(&condMutex);
     pthread_join(imagingThread, nullptr);
+    encodeWorker.quit();
     tState = StateNone;
     if (isSimulation() == false)
     {
@@ -666,6 +683,11 @@ bool ATIKCCD::Disconnect()
         ArtemisDisconnect(hCam);
     }
 
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    PrimaryCCD.setFrameBuffer(nullptr);
+    guard.unlock();
+    framePool.clear();
+
     LOG_INFO("Camera is offline.");
 
     return true;
@@ -998,6 +1020,15 @@ bool ATIKCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
             IDSetSwitch(&v, nullptr);
             return true;
         }
+        // Frame buffer policy
+        else if (!strcmp(name, FrameBufferSP.name))
+        {
+            IUUpdateSwitch(&FrameBufferSP, states, names, n);
+            FrameBufferSP.s = IPS_OK;
+            IDSetSwitch(&FrameBufferSP, nullptr);
+            saveConfig(true, FrameBufferSP.name);
+            return true;
+        }
 #if 0
         else if (!strcmp(name, BitSendSP.name))
         {
@@ -1217,12 +1248,16 @@ bool ATIKCCD::UpdateCCDBin(int binx, int biny)
 /////////////////////////////////////////////////////////
 bool ATIKCCD::grabImage()
 {
-    //uint8_t *image = PrimaryCCD.getFrameBuffer();
     int x, y, w, h, binx, biny;
+    bool copy = IUFindOnSwitchIndex(&FrameBufferSP) == FRAME_BUFFER_COPY;
 
+    pthread_mutex_lock(&accessMutex);
     int rc = ArtemisGetImageData(hCam, &x, &y, &w, &h, &binx, &biny);
     if (rc != ARTEMIS_OK)
+    {
+        pthread_mutex_unlock(&accessMutex);
         return false;
+    }
 
     int bufferSize = w * binx * h * biny * PrimaryCCD.getBPP() / 8;
     if ( bufferSize < PrimaryCCD.getFrameBufferSize())
@@ -1232,17 +1267,52 @@ bool ATIKCCD::grabImage()
         PrimaryCCD.setFrameBufferSize(bufferSize, false);
     }
 
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
-    PrimaryCCD.setFrameBuffer(reinterpret_cast<uint8_t*>(ArtemisImageBuffer(hCam)));
-    guard.unlock();
+    // A copied frame frees the SDK buffer for the next download right away, a borrowed
+    // frame saves the copy but the next frame can only be downloaded once it is sent.
+    uint8_t *frame = reinterpret_cast<uint8_t*>(ArtemisImageBuffer(hCam));
+    if (copy)
+    {
+        size_t frameSize = PrimaryCCD.getFrameBufferSize();
+        uint8_t *image = frame;
+        frame = framePool.acquire(frameSize);
+        memcpy(frame, image, frameSize);
+    }
+    pthread_mutex_unlock(&accessMutex);
 
     if (ExposureRequest > VERBOSE_EXPOSURE)
         LOG_INFO("Download complete.");
 
-    ExposureComplete(&PrimaryCCD);
+    if (copy)
+    {
+        // Waits for the previous frame, the camera is already free for the next exposure
+        encodeWorker.start([this, frame](const std::atomic_bool &)
+        {
+            encodeFrame(frame, true);
+        });
+    }
+    else
+        encodeFrame(frame, false);
     return true;
 }
 
+/////////////////////////////////////////////////////////
+/// Encode and send a frame
+/////////////////////////////////////////////////////////
+void ATIKCCD::encodeFrame(uint8_t *frame, bool copied)
+{
+    // Frames are sent in order, whichever thread encodes them
+    std::unique_lock<std::mutex> encodeGuard(encodeLock);
+
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    PrimaryCCD.setFrameBuffer(frame);
+    guard.unlock();
+
+    ExposureComplete(&PrimaryCCD);
+
+    if (copied)
+        framePool.release(frame);
+}
+
 /////////////////////////////////////////////////////////
 /// Cooler & Filter Wheel monitoring
 /////////////////////////////////////////////////////////
@@ -1537,12 +1607,12 @@ void ATIKCCD::checkExposureProgress()
             PrimaryCCD.setExposureLeft(0.0);
             if (ExposureRequest > VERBOSE_EXPOSURE)
                 DEBUG(INDI::Logger::DBG_SESSION, "Exposure done, downloading image...");
+            pthread_mutex_unlock(&accessMutex);
             pthread_mutex_lock(&condMutex);
             exposureSetRequest(StateIdle);
             pthread_mutex_unlock(&condMutex);
             grabImage();
             pthread_mutex_lock(&condMutex);
-            pthread_mutex_unlock(&accessMutex);
             break;
         }
 
@@ -1660,6 +1730,8 @@ bool ATIKCCD::saveConfigItems(FILE *fp)
         // IUSaveConfigSwitch(fp, &BitSendSP); // unused
     }
 
+    IUSaveConfigSwitch(fp, &FrameBufferSP);
+
     if (m_CameraFlags & ARTEMIS_PROPERTIES_CAMERAFLAGS_HAS_FILTERWHEEL)
         FilterNameTP.save(fp);
     // JM 2020-01-15: Seems like setting filter slot results in spinning
@@ -21,16 +21,19 @@
 
 #pragma once
 
+#include "atik_framepool.h"
+
 #include <AtikCameras.h>
 
 #include <indifilterinterface.h>
 #include <indiccd.h>
+#include <indisinglethreadpool.h>
 
 class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
 {
     public:
         explicit ATIKCCD(std::string cameraName, int id);
-        ~ATIKCCD() override = default;
+        ~ATIKCCD() override;
 
         virtual const char *getDefaultName() override;
 
@@ -133,6 +136,8 @@ class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
 
         // Retrieve image from SDK
         bool grabImage();
+        // Send the frame, releases it to the pool when copied
+        void encodeFrame(uint8_t *frame, bool copied);
 
         /**
          * @brief setupParams get initial camera parameters
@@ -220,6 +225,15 @@ class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
             FASTMODE_FAST,
         };
 
+        // Frame buffer policy
+        ISwitch FrameBufferS[2];
+        ISwitchVectorProperty FrameBufferSP;
+        enum
+        {
+            FRAME_BUFFER_COPY,
+            FRAME_BUFFER_BORROW,
+        };
+
 #if 0 // unused
         // Bit send
         ISwitch BitSendS[2];
@@ -254,6 +268,11 @@ class ATIKCCD : public INDI::CCD, public INDI::FilterInterface
         pthread_mutex_t condMutex = PTHREAD_MUTEX_INITIALIZER;
         pthread_mutex_t accessMutex = PTHREAD_MUTEX_INITIALIZER;
 
+        // Encoding of the copied frames, one frame is encoded while the next one is downloaded
+        INDI::SingleThreadPool encodeWorker;
+        std::mutex encodeLock;
+        AtikFramePool framePool {2};
+
         // Pulse Guiding
         int WEtimerID;
         int NStimerID;
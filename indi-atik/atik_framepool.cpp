@@ -0,0 +1,70 @@
+/*
+ ATIK CCD & Filter Wheel Driver
+
+ Copyright (C) 2018 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include "atik_framepool.h"
+
+AtikFramePool::AtikFramePool(size_t count) : frames(count)
+{
+}
+
+uint8_t *AtikFramePool::acquire(size_t size)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    while (true)
+    {
+        for (auto &frame : frames)
+        {
+            if (frame.inUse)
+                continue;
+
+            if (frame.size < size)
+            {
+                frame.data.reset(new uint8_t[size]);
+                frame.size = size;
+            }
+            frame.inUse = true;
+            return frame.data.get();
+        }
+        released.wait(guard);
+    }
+}
+
+void AtikFramePool::release(uint8_t *buffer)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    for (auto &frame : frames)
+    {
+        if (frame.data.get() == buffer)
+            frame.inUse = false;
+    }
+    released.notify_one();
+}
+
+void AtikFramePool::clear()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    for (auto &frame : frames)
+    {
+        frame.data.reset();
+        frame.size  = 0;
+        frame.inUse = false;
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ ATIK CCD & Filter Wheel Driver
+
+ Copyright (C) 2018 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/* Frame buffers owned by the driver. A downloaded frame is copied out of the SDK buffer into
+   one of them, so the camera can download the next exposure while the previous one is still
+   being encoded and sent. Buffers only grow, they are kept until clear(). */
+class AtikFramePool
+{
+    public:
+        explicit AtikFramePool(size_t count);
+
+        // waits until a buffer is free, returns it with at least size bytes
+        uint8_t *acquire(size_t size);
+        void release(uint8_t *buffer);
+        // frees the memory, no buffer may be in use
+        void clear();
+
+    private:
+        struct Frame
+        {
+            std::unique_ptr<uint8_t[]> data;
+            size_t size {0};
+            bool inUse {false};
+        };
+
+        std::vector<Frame> frames;
+        std::mutex lock;
+        std::condition_variable released;
+};
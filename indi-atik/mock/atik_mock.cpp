@@ -0,0 +1,325 @@
+/*
+ ATIK CCD & Filter Wheel Driver - mock libatik
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ libatikcameras for -DINDI_ATIK_MOCK=ON, see common/README.md. One camera is enumerated,
+ 3326 x 2504 and 40 MB/s unless set otherwise.
+
+ Like the SDK, the image is downloaded into the library's own buffer before ArtemisImageReady
+ returns true, and the buffer is overwritten by the next download. Completed downloads are
+ counted with their rate in frames per minute, printed to stderr on disconnect.
+*/
+
+#include <AtikCameras.h>
+#include "sdk_mock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+HINSTANCE hArtemisDLL = nullptr;
+
+struct MockCamera
+{
+    int width;
+    int height;
+    double bandwidth;
+    int binx {1};
+    int biny {1};
+    int x {0}, y {0}, w {0}, h {0};
+    bool exposing {false};
+    std::chrono::steady_clock::time_point end;
+    std::chrono::steady_clock::time_point ready;
+    std::vector<uint16_t> buffer;
+    int frame {0};
+
+    int downloads {0};
+    std::chrono::steady_clock::time_point firstDownload;
+    std::chrono::steady_clock::time_point lastDownload;
+
+    std::mutex lock;
+};
+
+static MockCamera *camera(ArtemisHandle handle)
+{
+    return static_cast<MockCamera *>(handle);
+}
+
+int ArtemisAPIVersion()
+{
+    return 20200904;
+}
+
+int ArtemisDLLVersion()
+{
+    return 20200904;
+}
+
+void ArtemisSetDebugCallbackContext(void *, void(*)(void *, const char *))
+{
+}
+
+int ArtemisDeviceCount()
+{
+    return 1;
+}
+
+BOOL ArtemisDeviceIsPresent(int iDevice)
+{
+    return iDevice == 0;
+}
+
+BOOL ArtemisDeviceName(int iDevice, char *pName)
+{
+    if (iDevice != 0)
+        return false;
+    strcpy(pName, "Atik Mock");
+    return true;
+}
+
+BOOL ArtemisDeviceIsCamera(int iDevice)
+{
+    return iDevice == 0;
+}
+
+ArtemisHandle ArtemisConnect(int iDevice)
+{
+    if (iDevice != 0)
+        return nullptr;
+
+    MockCamera *cam = new MockCamera();
+    cam->width     = SDKMock::env("ATIK_MOCK_WIDTH", 3326);
+    cam->height    = SDKMock::env("ATIK_MOCK_HEIGHT", 2504);
+    cam->bandwidth = std::max(SDKMock::env("ATIK_MOCK_BANDWIDTH", 40.0), 0.001);
+    cam->w         = cam->width;
+    cam->h         = cam->height;
+    return cam;
+}
+
+BOOL ArtemisDisconnect(ArtemisHandle handle)
+{
+    MockCamera *cam = camera(handle);
+    if (cam == nullptr)
+        return false;
+
+    double minutes = std::chrono::duration<double>(cam->lastDownload - cam->firstDownload).count() / 60;
+    fprintf(stderr, "atik mock: %d downloads", cam->downloads);
+    if (cam->downloads > 1 && minutes > 0)
+        fprintf(stderr, ", %.1f frames per minute", (cam->downloads - 1) / minutes);
+    fprintf(stderr, "\n");
+    delete cam;
+    return true;
+}
+
+int ArtemisProperties(ArtemisHandle handle, struct ARTEMISPROPERTIES *pProp)
+{
+    MockCamera *cam = camera(handle);
+    memset(pProp, 0, sizeof(*pProp));
+    pProp->Protocol      = 0x0100;
+    pProp->nPixelsX      = cam->width;
+    pProp->nPixelsY      = cam->height;
+    pProp->PixelMicronsX = 5.4f;
+    pProp->PixelMicronsY = 5.4f;
+    snprintf(pProp->Description, sizeof(pProp->Description), "Mock %dx%d", cam->width, cam->height);
+    snprintf(pProp->Manufacturer, sizeof(pProp->Manufacturer), "INDI");
+    return ARTEMIS_OK;
+}
+
+int ArtemisColourProperties(ArtemisHandle, enum ARTEMISCOLOURTYPE *colourType, int *normalOffsetX, int *normalOffsetY,
+                            int *previewOffsetX, int *previewOffsetY)
+{
+    *colourType    = ARTEMIS_COLOUR_NONE;
+    *normalOffsetX = *normalOffsetY = *previewOffsetX = *previewOffsetY = 0;
+    return ARTEMIS_OK;
+}
+
+int ArtemisBin(ArtemisHandle handle, int x, int y)
+{
+    camera(handle)->binx = x;
+    camera(handle)->biny = y;
+    return ARTEMIS_OK;
+}
+
+int ArtemisGetMaxBin(ArtemisHandle, int *x, int *y)
+{
+    *x = *y = 4;
+    return ARTEMIS_OK;
+}
+
+int ArtemisSubframe(ArtemisHandle handle, int x, int y, int w, int h)
+{
+    MockCamera *cam = camera(handle);
+    cam->x = x;
+    cam->y = y;
+    cam->w = w;
+    cam->h = h;
+    return ARTEMIS_OK;
+}
+
+int ArtemisSetDarkMode(ArtemisHandle, bool)
+{
+    return ARTEMIS_OK;
+}
+
+int ArtemisStartExposure(ArtemisHandle handle, float seconds)
+{
+    MockCamera *cam = camera(handle);
+    std::unique_lock<std::mutex> guard(cam->lock);
+    if (cam->exposing)
+        return ARTEMIS_OPERATION_FAILED;
+
+    size_t length = static_cast<size_t>(cam->w / cam->binx) * (cam->h / cam->biny) * 2;
+    cam->exposing = true;
+    cam->end      = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<int64_t>(seconds * 1000000));
+    cam->ready    = cam->end + SDKMock::transferTime(length, cam->bandwidth);
+    return ARTEMIS_OK;
+}
+
+int ArtemisStopExposure(ArtemisHandle handle)
+{
+    MockCamera *cam = camera(handle);
+    std::unique_lock<std::mutex> guard(cam->lock);
+    cam->exposing = false;
+    return ARTEMIS_OK;
+}
+
+BOOL ArtemisImageReady(ArtemisHandle handle)
+{
+    MockCamera *cam = camera(handle);
+    std::unique_lock<std::mutex> guard(cam->lock);
+    if (!cam->exposing || std::chrono::steady_clock::now() < cam->ready)
+        return false;
+
+    // download into the library buffer, a gradient shifted by the frame number
+    int w = cam->w / cam->binx, h = cam->h / cam->biny;
+    cam->buffer.resize(static_cast<size_t>(w) * h);
+    uint16_t *pixels = cam->buffer.data();
+    for (int row = 0; row < h; row++)
+        for (int col = 0; col < w; col++)
+            *pixels++ = static_cast<uint16_t>(cam->frame * 256 + row + col);
+
+    cam->exposing = false;
+    cam->frame++;
+    cam->lastDownload = std::chrono::steady_clock::now();
+    if (cam->downloads++ == 0)
+        cam->firstDownload = cam->lastDownload;
+    return true;
+}
+
+int ArtemisCameraState(ArtemisHandle handle)
+{
+    MockCamera *cam = camera(handle);
+    std::unique_lock<std::mutex> guard(cam->lock);
+    if (!cam->exposing)
+        return CAMERA_IDLE;
+    return std::chrono::steady_clock::now() < cam->end ? CAMERA_EXPOSING : CAMERA_DOWNLOADING;
+}
+
+float ArtemisExposureTimeRemaining(ArtemisHandle handle)
+{
+    MockCamera *cam = camera(handle);
+    std::unique_lock<std::mutex> guard(cam->lock);
+    if (!cam->exposing)
+        return 0;
+    return std::max(std::chrono::duration<float>(cam->end - std::chrono::steady_clock::now()).count(), 0.0f);
+}
+
+int ArtemisGetImageData(ArtemisHandle handle, int *x, int *y, int *w, int *h, int *binx, int *biny)
+{
+    MockCamera *cam = camera(handle);
+    *x    = cam->x;
+    *y    = cam->y;
+    *w    = cam->w / cam->binx;
+    *h    = cam->h / cam->biny;
+    *binx = cam->binx;
+    *biny = cam->biny;
+    return ARTEMIS_OK;
+}
+
+void *ArtemisImageBuffer(ArtemisHandle handle)
+{
+    return camera(handle)->buffer.data();
+}
+
+bool ArtemisHasCameraSpecificOption(ArtemisHandle, unsigned short)
+{
+    return false;
+}
+
+int ArtemisCameraSpecificOptionGetData(ArtemisHandle, unsigned short, unsigned char *, int, int *)
+{
+    return ARTEMIS_INVALID_FUNCTION;
+}
+
+int ArtemisCameraSpecificOptionSetData(ArtemisHandle, unsigned short, unsigned char *, int)
+{
+    return ARTEMIS_INVALID_FUNCTION;
+}
+
+int ArtemisFilterWheelInfo(ArtemisHandle, int *, int *, int *, int *)
+{
+    return ARTEMIS_INVALID_FUNCTION;
+}
+
+int ArtemisFilterWheelMove(ArtemisHandle, int)
+{
+    return ARTEMIS_INVALID_FUNCTION;
+}
+
+int ArtemisPulseGuide(ArtemisHandle, int, int)
+{
+    return ARTEMIS_OK;
+}
+
+int ArtemisOpenShutter(ArtemisHandle)
+{
+    return ARTEMIS_OK;
+}
+
+int ArtemisCloseShutter(ArtemisHandle)
+{
+    return ARTEMIS_OK;
+}
+
+int ArtemisTemperatureSensorInfo(ArtemisHandle, int sensor, int *temperature)
+{
+    // no sensors, sensor 0 is the count
+    *temperature = sensor == 0 ? 0 : 2000;
+    return sensor == 0 ? ARTEMIS_OK : ARTEMIS_INVALID_PARAMETER;
+}
+
+int ArtemisSetCooling(ArtemisHandle, int)
+{
+    return ARTEMIS_INVALID_FUNCTION;
+}
+
+int ArtemisCoolingInfo(ArtemisHandle, int *flags, int *level, int *minlvl, int *maxlvl, int *setpoint)
+{
+    *flags = *level = *minlvl = *maxlvl = *setpoint = 0;
+    return ARTEMIS_OK;
+}
+
+int ArtemisCoolerWarmUp(ArtemisHandle)
+{
+    return ARTEMIS_INVALID_FUNCTION;
+}
@@ -23,7 +23,9 @@
 
 #include "lx200stargofocuser.h"
 
+#include <cerrno>
 #include <cmath>
+#include <ctime>
 #include <memory>
 #include <cstring>
 #include <unistd.h>
@@ -154,6 +156,41 @@ bool LX200StarGo::ISNewSwitch(const char *dev, const char *name, ISState *states
             return syncHomePosition();
         }
 
+        // serial transaction trace
+        if (!strcmp(name, SerialTraceSP.name))
+        {
+            if (IUUpdateSwitch(&SerialTraceSP, states, names, n) < 0)
+                return false;
+
+            if (IUFindOnSwitchIndex(&SerialTraceSP) == INDI_ENABLED)
+            {
+                // start statistics together with the trace, so that both cover the same exchanges
+                serialTrace.resetStatistics();
+                if (serialTrace.open(SerialTraceFileT[0].text))
+                {
+                    LOGF_INFO("Recording serial trace to %s", SerialTraceFileT[0].text);
+                    SerialTraceSP.s = IPS_BUSY;
+                }
+                else
+                {
+                    LOGF_ERROR("Cannot create serial trace file %s: %s", SerialTraceFileT[0].text, strerror(errno));
+                    IUResetSwitch(&SerialTraceSP);
+                    SerialTraceS[INDI_DISABLED].s = ISS_ON;
+                    SerialTraceSP.s = IPS_ALERT;
+                }
+            }
+            else
+            {
+                if (serialTrace.isRecording())
+                    LOGF_INFO("Serial trace %s closed.", SerialTraceFileT[0].text);
+                serialTrace.close();
+                SerialTraceSP.s = IPS_OK;
+            }
+            IDSetSwitch(&SerialTraceSP, nullptr);
+            updateSerialLatency(true);
+            return true;
+        }
+
         // goto home position
         if (!strcmp(name, MountGotoHomeSP.name))
         {
@@ -380,6 +417,22 @@ bool LX200StarGo::ISNewNumber(const char *dev, const char *name, double values[]
     return result;
 }
 
+bool LX200StarGo::ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n)
+{
+    if (dev != nullptr && strcmp(dev, getDeviceName()) == 0)
+    {
+        if (!strcmp(name, SerialTraceFileTP.name))
+        {
+            IUUpdateText(&SerialTraceFileTP, texts, names, n);
+            SerialTraceFileTP.s = IPS_OK;
+            IDSetText(&SerialTraceFileTP, nullptr);
+            return true;
+        }
+    }
+
+    return LX200Telescope::ISNewText(dev, name, texts, names, n);
+}
+
 
 
 /**************************************************************************************
@@ -457,6 +510,18 @@ bool LX200StarGo::initProperties()
     IUFillNumberVector(&MountRequestDelayNP, MountRequestDelayN, 1, getDeviceName(), "REQUEST_DELAY", "StarGO", RA_DEC_TAB,
                        IP_RW, 60, IPS_OK);
 
+    // serial transaction trace, replay it with lx200stargo_replay
+    IUFillSwitch(&SerialTraceS[INDI_ENABLED], "INDI_ENABLED", "Record", ISS_OFF);
+    IUFillSwitch(&SerialTraceS[INDI_DISABLED], "INDI_DISABLED", "Off", ISS_ON);
+    IUFillSwitchVector(&SerialTraceSP, SerialTraceS, 2, getDeviceName(), "SERIAL_TRACE", "Serial Trace", OPTIONS_TAB,
+                       IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    IUFillText(&SerialTraceFileT[0], "FILE", "File", "/tmp/indi_lx200stargo.trace");
+    IUFillTextVector(&SerialTraceFileTP, SerialTraceFileT, 1, getDeviceName(), "SERIAL_TRACE_FILE", "Trace File",
+                     OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+    IUFillText(&SerialLatencyT[0], "REPORT", "Latency", "");
+    IUFillTextVector(&SerialLatencyTP, SerialLatencyT, 1, getDeviceName(), "SERIAL_LATENCY", "Serial Latency", INFO_TAB,
+                     IP_RO, 60, IPS_IDLE);
+
     return true;
 }
 
@@ -481,6 +546,9 @@ bool LX200StarGo::updateProperties()
         defineProperty(&MeridianFlipModeSP);
         defineProperty(&MountRequestDelayNP);
         defineProperty(&MountFirmwareInfoTP);
+        defineProperty(&SerialTraceSP);
+        defineProperty(&SerialTraceFileTP);
+        defineProperty(&SerialLatencyTP);
         getStarGoBasicData();
     }
     else
@@ -498,6 +566,9 @@ bool LX200StarGo::updateProperties()
         deleteProperty(MeridianFlipModeSP.name);
         deleteProperty(MountRequestDelayNP.name);
         deleteProperty(MountFirmwareInfoTP.name);
+        deleteProperty(SerialTraceSP.name);
+        deleteProperty(SerialTraceFileTP.name);
+        deleteProperty(SerialLatencyTP.name);
     }
 
     return true;
@@ -517,6 +588,11 @@ bool LX200StarGo::Connect()
 
 bool LX200StarGo::Disconnect()
 {
+    serialTrace.close();
+    IUResetSwitch(&SerialTraceSP);
+    SerialTraceS[INDI_DISABLED].s = ISS_ON;
+    SerialTraceSP.s = IPS_IDLE;
+
     bool result = DefaultDevice::Disconnect();
     result &= activateFocuserAux1(false);
     return result;
@@ -622,6 +698,7 @@ bool LX200StarGo::ReadScopeStatus()
     }
 
     LOG_DEBUG("################################ ReadScopeStatus (finish) ###############################");
+    updateSerialLatency();
 
     if (loader.isFocuserAux1Activated() && TrackState != SCOPE_SLEWING)
         return loader.getFocuserAux1()->ReadFocuserStatus();
@@ -1153,6 +1230,7 @@ bool LX200StarGo::saveConfigItems(FILE *fp)
     IUSaveConfigText(fp, &SiteNameTP);
     IUSaveConfigSwitch(fp, &Aux1FocuserSP);
     IUSaveConfigNumber(fp, &MountRequestDelayNP);
+    IUSaveConfigText(fp, &SerialTraceFileTP);
     IUSaveConfigSwitch(fp, &TrackingAutoAdjustmentSP);
 
     if (loader.isFocuserAux1Activated())
@@ -1833,6 +1911,7 @@ bool LX200StarGo::receive(char* buffer, int* bytes, char end, int wait)
         LOGF_WARN("Failed to receive full response: %s. (Return code: %d)", errorString, returnCode);
         return false;
     }
+    serialTrace.received(buffer, *bytes);
     if(buffer[*bytes - 1] == '#')
         buffer[*bytes - 1] = '\0'; // remove #
     else
@@ -1865,6 +1944,7 @@ bool LX200StarGo::transmit(const char* buffer)
         LOGF_WARN("Failed to transmit %s. Wrote %d bytes and got error %s.", buffer, bytesWritten, errorString);
         return false;
     }
+    serialTrace.transmitted(buffer);
     return true;
 }
 
@@ -2886,6 +2966,21 @@ void LX200StarGo::TimerHit()
     Telescope::TimerHit();
 }
 
+/**
+ * @brief Publish the serial latency statistics, at most every 10 seconds unless forced.
+ */
+void LX200StarGo::updateSerialLatency(bool force)
+{
+    time_t const now = time(nullptr);
+    if (!force && now - serialLatencyUpdate < 10)
+        return;
+    serialLatencyUpdate = now;
+
+    IUSaveText(&SerialLatencyT[0], serialTrace.report().c_str());
+    SerialLatencyTP.s = IPS_OK;
+    IDSetText(&SerialLatencyTP, nullptr);
+}
+
 bool LX200StarGo::getTrackFrequency(double * value)
 {
     LOG_DEBUG(__FUNCTION__);
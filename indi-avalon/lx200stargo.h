@@ -29,6 +29,8 @@
 #include <indilogger.h>
 #include <termios.h>
 
+#include "serial_trace.h"
+
 #include <cstring>
 #include <string>
 #include <unistd.h>
@@ -92,6 +94,7 @@ class LX200StarGo : public LX200Telescope
         virtual bool Handshake() override;
         virtual bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n) override;
         virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
+        virtual bool ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n) override;
         virtual bool updateProperties() override;
         virtual bool initProperties() override;
         virtual void ISGetProperties(const char *dev)override;
@@ -154,6 +157,17 @@ class LX200StarGo : public LX200Telescope
         INumberVectorProperty MountRequestDelayNP;
         INumber MountRequestDelayN[1];
 
+        // serial transaction trace and latency statistics
+        ISwitchVectorProperty SerialTraceSP;
+        ISwitch SerialTraceS[2];
+        ITextVectorProperty SerialTraceFileTP;
+        IText SerialTraceFileT[1] = {};
+        ITextVectorProperty SerialLatencyTP;
+        IText SerialLatencyT[1] = {};
+        SerialTrace::Recorder serialTrace;
+        time_t serialLatencyUpdate {0};
+        void updateSerialLatency(bool force = false);
+
         int controller_format { LX200_LONG_FORMAT };
 
         // override LX200Generic
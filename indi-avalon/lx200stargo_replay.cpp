@@ -0,0 +1,38 @@
+/*
+    Avalon StarGo driver - serial trace replay
+
+    Copyright (C) 2019 Christopher Contaxis, Wolfgang Reissenberger,
+    Ken Self and Tonino Tasselli
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+    Plays back a trace recorded by the StarGo driver (SERIAL_TRACE property) through a pseudo
+    terminal, so the driver can be run against it instead of the mount:
+
+        lx200stargo_replay <trace file> [speed]
+
+    The slave device name is printed on startup, point the driver's port at it. Commands
+    written by the driver are compared to the recorded ones, answers are sent after the
+    recorded delay divided by speed (default 1, 0 answers immediately).
+*/
+
+#include "serial_trace_replay.h"
+
+int main(int argc, char *argv[])
+{
+    return SerialTrace::replay(argc, argv);
+}
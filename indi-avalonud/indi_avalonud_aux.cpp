@@ -523,8 +523,7 @@ bool AUDAUX::ISNewNumber(const char * dev, const char * name, double values[], c
 
 bool AUDAUX::Connect()
 {
-    char addr[1024], *answer;
-    int timeout = 500;
+    char *answer;
 
     if (isConnected())
         return true;
@@ -533,10 +532,7 @@ bool AUDAUX::Connect()
 
     DEBUGF(INDI::Logger::DBG_SESSION, "Attempting to connect %s aux...",IPaddress);
 
-    requester = zmq_socket(context, ZMQ_REQ);
-    zmq_setsockopt(requester, ZMQ_RCVTIMEO, &timeout, sizeof(timeout) );
-    snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-    zmq_connect(requester, addr);
+    openRequester();
 
     answer = sendRequest("DISCOVER");
     if ( answer ) {
@@ -749,10 +745,26 @@ const char *AUDAUX::getDefaultName()
     return device_str;
 }
 
+void AUDAUX::openRequester()
+{
+    char addr[1024];
+    int timeout = 500, linger = 0, on = 1;
+
+    // A relaxed, correlating REQ socket can send again after a lost reply and drops late
+    // answers to earlier requests, so a timeout no longer needs a new socket and connection.
+    requester = zmq_socket(context, ZMQ_REQ);
+    zmq_setsockopt(requester, ZMQ_RCVTIMEO, &timeout, sizeof(timeout) );
+    zmq_setsockopt(requester, ZMQ_LINGER, &linger, sizeof(linger) );
+    zmq_setsockopt(requester, ZMQ_REQ_RELAXED, &on, sizeof(on) );
+    zmq_setsockopt(requester, ZMQ_REQ_CORRELATE, &on, sizeof(on) );
+    snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
+    zmq_connect(requester, addr);
+}
+
 char* AUDAUX::sendCommand(const char *fmt, ... )
 {
     va_list ap;
-    char buffer[4096], answer[4096], addr[1024];
+    char buffer[4096], answer[4096];
     int rc,retries;
     zmq_pollitem_t item;
 
@@ -779,10 +791,6 @@ char* AUDAUX::sendCommand(const char *fmt, ... )
                 return strdup("SYNTAXERROR");
             }
         }
-        zmq_close(requester);
-        requester = zmq_socket(context, ZMQ_REQ);
-        snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-        zmq_connect(requester, addr);
     } while ( --retries );
     pthread_mutex_unlock( &connectionmutex );
     DEBUG(INDI::Logger::DBG_WARNING, "No answer from driver");
@@ -792,7 +800,7 @@ char* AUDAUX::sendCommand(const char *fmt, ... )
 char* AUDAUX::sendRequest(const char *fmt, ... )
 {
     va_list ap;
-    char buffer[4096], answer[4096], addr[1024];
+    char buffer[4096], answer[4096];
     int rc,retries;
     zmq_pollitem_t item;
 
@@ -815,10 +823,6 @@ char* AUDAUX::sendRequest(const char *fmt, ... )
                 return strdup(answer);
             }
         }
-        zmq_close(requester);
-        requester = zmq_socket(context, ZMQ_REQ);
-        snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-        zmq_connect(requester, addr);
     } while ( --retries );
     pthread_mutex_unlock( &connectionmutex );
     DEBUG(INDI::Logger::DBG_WARNING, "No answer from driver");
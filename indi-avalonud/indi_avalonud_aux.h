@@ -106,6 +106,7 @@ private:
     char* sendCommand(const char*,...);
     char* sendRequest(const char*,...);
 
+    void openRequester();
     void *context,*requester;
     time_t reboot_time,shutdown_time;
 
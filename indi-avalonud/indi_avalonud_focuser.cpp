@@ -210,8 +210,7 @@ bool AUDFOCUSER::ISNewSwitch(const char * dev, const char * name, ISState * stat
 
 bool AUDFOCUSER::Connect()
 {
-    char addr[1024], *answer;
-    int timeout = 500;
+    char *answer;
 
     if (isConnected())
         return true;
@@ -220,10 +219,7 @@ bool AUDFOCUSER::Connect()
 
     DEBUGF(INDI::Logger::DBG_SESSION, "Attempting to connect %s focuser...",IPaddress);
 
-    requester = zmq_socket(context, ZMQ_REQ);
-    zmq_setsockopt(requester, ZMQ_RCVTIMEO, &timeout, sizeof(timeout) );
-    snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-    zmq_connect(requester, addr);
+    openRequester();
 
     answer = sendRequest("DISCOVER");
     if ( answer ) {
@@ -453,10 +449,26 @@ const char *AUDFOCUSER::getDefaultName()
     return device_str;
 }
 
+void AUDFOCUSER::openRequester()
+{
+    char addr[1024];
+    int timeout = 500, linger = 0, on = 1;
+
+    // A relaxed, correlating REQ socket can send again after a lost reply and drops late
+    // answers to earlier requests, so a timeout no longer needs a new socket and connection.
+    requester = zmq_socket(context, ZMQ_REQ);
+    zmq_setsockopt(requester, ZMQ_RCVTIMEO, &timeout, sizeof(timeout) );
+    zmq_setsockopt(requester, ZMQ_LINGER, &linger, sizeof(linger) );
+    zmq_setsockopt(requester, ZMQ_REQ_RELAXED, &on, sizeof(on) );
+    zmq_setsockopt(requester, ZMQ_REQ_CORRELATE, &on, sizeof(on) );
+    snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
+    zmq_connect(requester, addr);
+}
+
 char* AUDFOCUSER::sendCommand(const char *fmt, ... )
 {
     va_list ap;
-    char buffer[4096], answer[4096], addr[1024];
+    char buffer[4096], answer[4096];
     int rc,retries;
     zmq_pollitem_t item;
 
@@ -483,10 +495,6 @@ char* AUDFOCUSER::sendCommand(const char *fmt, ... )
                 return strdup("SYNTAXERROR");
             }
         }
-        zmq_close(requester);
-        requester = zmq_socket(context, ZMQ_REQ);
-        snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-        zmq_connect(requester, addr);
     } while ( --retries );
     pthread_mutex_unlock( &connectionmutex );
     DEBUG(INDI::Logger::DBG_WARNING, "No answer from driver");
@@ -496,7 +504,7 @@ char* AUDFOCUSER::sendCommand(const char *fmt, ... )
 char* AUDFOCUSER::sendRequest(const char *fmt, ... )
 {
     va_list ap;
-    char buffer[4096], answer[4096], addr[1024];
+    char buffer[4096], answer[4096];
     int rc,retries;
     zmq_pollitem_t item;
 
@@ -519,10 +527,6 @@ char* AUDFOCUSER::sendRequest(const char *fmt, ... )
                 return strdup(answer);
             }
         }
-        zmq_close(requester);
-        requester = zmq_socket(context, ZMQ_REQ);
-        snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-        zmq_connect(requester, addr);
     } while ( --retries );
     pthread_mutex_unlock( &connectionmutex );
     DEBUG(INDI::Logger::DBG_WARNING, "No answer from driver");
@@ -75,6 +75,7 @@ private:
     char* sendCommand(const char*,...);
     char* sendRequest(const char*,...);
 
+    void openRequester();
     void *context,*requester;
     int64_t currentPosition;
     int statusCode;
@@ -312,8 +312,6 @@ bool AUDTELESCOPE::updateProperties()
 bool AUDTELESCOPE::Connect()
 {
     char *answer;
-    char addr[1024];
-    int timeout = 500;
 
 
     if (isConnected())
@@ -323,10 +321,7 @@ bool AUDTELESCOPE::Connect()
 
     DEBUGF(INDI::Logger::DBG_SESSION, "Attempting to connect %s telescope...", IPaddress);
 
-    requester = zmq_socket(context, ZMQ_REQ);
-    zmq_setsockopt(requester, ZMQ_RCVTIMEO, &timeout, sizeof(timeout) );
-    snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-    zmq_connect(requester, addr);
+    openRequester();
 
     answer = sendRequest("ASTRO_INFO");
     if ( answer )
@@ -644,69 +639,23 @@ bool AUDTELESCOPE::updateTime(ln_date *utc, double utc_offset)
 
 bool AUDTELESCOPE::ReadScopeStatus()
 {
-    char *answer;
-    int sts, pierside, exposureready, meridianflip;
-    double utc, lst, jd, ha, ra, dec, az, alt, meridianflipha;
+    AstroStatus st;
 
-
-    answer = sendRequest("ASTRO_STATUS");
-    if ( answer )
+    if ( readAstroStatus(st) )
     {
-        json j;
+        int sts = st.globalStatus, pierside = st.pierSide, meridianflip = st.meridianFlip;
+        double utc = st.utc, lst = st.lst, jd = st.jd, ha = st.ha, ra = st.ra, dec = st.dec, az = st.az, alt = st.alt;
+        double meridianflipha = st.meridianFlipHA;
 
-        j = json::parse(answer, nullptr, false);
-        free(answer);
-        if ( j.is_discarded() ||
-                !j.contains("UTC") ||
-                !j.contains("JD") ||
-                !j.contains("LST") ||
-                !j.contains("HA") ||
-                !j.contains("RA") ||
-                !j.contains("Dec") ||
-                !j.contains("Az") ||
-                !j.contains("Alt") ||
-                !j.contains("globalStatus") ||
-                !j.contains("meridianFlip") ||
-                !j.contains("pierSide") ||
-                !j.contains("meridianFlipHA") ||
-                !j.contains("exposureReady") )
+        if ( st.errorMsg.length() > 0 )
         {
-            DEBUG(INDI::Logger::DBG_WARNING, "Status communication error");
-            return false;
-        }
-        j["UTC"].get_to(utc);
-        j["JD"].get_to(jd);
-        j["LST"].get_to(lst);
-        j["HA"].get_to(ha);
-        j["RA"].get_to(ra);
-        j["Dec"].get_to(dec);
-        j["Az"].get_to(az);
-        j["Alt"].get_to(alt);
-        j["globalStatus"].get_to(sts);
-        j["meridianFlip"].get_to(meridianflip);
-        j["pierSide"].get_to(pierside);
-        j["meridianFlipHA"].get_to(meridianflipha);
-        j["exposureReady"].get_to(exposureready);
-        if ( j.contains("errorMsg") )
-        {
-            std::string msg;
-            j["errorMsg"].get_to(msg);
-            if ( msg.length() > 0 )
-            {
-                if ( !lastErrorMsg || ( lastErrorMsg && strcmp(msg.c_str(), lastErrorMsg) ) )
-                {
-                    // the error message is written only once until it changes
-                    DEBUGF(INDI::Logger::DBG_WARNING, "Failed due to %s", msg.c_str());
-                    if ( lastErrorMsg )
-                        free( lastErrorMsg );
-                    lastErrorMsg = strdup(msg.c_str());
-                }
-            }
-            else
+            if ( !lastErrorMsg || ( lastErrorMsg && strcmp(st.errorMsg.c_str(), lastErrorMsg) ) )
             {
+                // the error message is written only once until it changes
+                DEBUGF(INDI::Logger::DBG_WARNING, "Failed due to %s", st.errorMsg.c_str());
                 if ( lastErrorMsg )
                     free( lastErrorMsg );
-                lastErrorMsg = NULL;
+                lastErrorMsg = strdup(st.errorMsg.c_str());
             }
         }
         else
@@ -1412,10 +1361,110 @@ const char *AUDTELESCOPE::getDefaultName()
     return device_str;
 }
 
+bool AUDTELESCOPE::readAstroStatus(AstroStatus &status)
+{
+    enum
+    {
+        ST_UTC = 1 << 0, ST_JD = 1 << 1, ST_LST = 1 << 2, ST_HA = 1 << 3, ST_RA = 1 << 4, ST_DEC = 1 << 5,
+        ST_AZ = 1 << 6, ST_ALT = 1 << 7, ST_GLOBALSTATUS = 1 << 8, ST_MERIDIANFLIP = 1 << 9, ST_PIERSIDE = 1 << 10,
+        ST_MERIDIANFLIPHA = 1 << 11, ST_EXPOSUREREADY = 1 << 12, ST_ALL = (1 << 13) - 1
+    };
+    zmq_msg_t msg;
+    zmq_pollitem_t item;
+    json j;
+    int rc, found = 0;
+
+    // The status is polled every period, so a lost answer is not retried here: the next
+    // poll asks again instead of blocking the timer for several timeouts.
+    pthread_mutex_lock( &connectionmutex );
+    zmq_send(requester, "ASTRO_STATUS", strlen("ASTRO_STATUS"), 0);
+    item = { requester, 0, ZMQ_POLLIN, 0 };
+    rc = zmq_poll( &item, 1, 500 ); // ms
+    if ( ( rc < 0 ) || !( item.revents & ZMQ_POLLIN ) )
+    {
+        pthread_mutex_unlock( &connectionmutex );
+        DEBUG(INDI::Logger::DBG_WARNING, "No answer from driver");
+        return false;
+    }
+
+    // parse the answer in place from the message, without intermediate copies
+    zmq_msg_init(&msg);
+    rc = zmq_msg_recv(&msg, requester, 0);
+    pthread_mutex_unlock( &connectionmutex );
+    if ( rc >= 0 )
+    {
+        const char *data = static_cast<const char *>(zmq_msg_data(&msg));
+        j = json::parse(data, data + zmq_msg_size(&msg), nullptr, false);
+    }
+    zmq_msg_close(&msg);
+
+    if ( rc < 0 || !j.is_object() )
+    {
+        DEBUG(INDI::Logger::DBG_WARNING, "Status communication error");
+        return false;
+    }
+
+    // decode all fields in a single pass over the document
+    status.errorMsg.clear();
+    for ( const auto &field : j.items() )
+    {
+        const std::string &key = field.key();
+        const json &value = field.value();
+
+        if ( key == "errorMsg" )
+        {
+            if ( value.is_string() )
+                value.get_to(status.errorMsg);
+            continue;
+        }
+        // flags may be sent as JSON booleans, get_to() converts them like numbers
+        if ( !value.is_number() && !value.is_boolean() )
+            continue;
+
+        if ( key == "UTC" )                 { value.get_to(status.utc); found |= ST_UTC; }
+        else if ( key == "JD" )             { value.get_to(status.jd); found |= ST_JD; }
+        else if ( key == "LST" )            { value.get_to(status.lst); found |= ST_LST; }
+        else if ( key == "HA" )             { value.get_to(status.ha); found |= ST_HA; }
+        else if ( key == "RA" )             { value.get_to(status.ra); found |= ST_RA; }
+        else if ( key == "Dec" )            { value.get_to(status.dec); found |= ST_DEC; }
+        else if ( key == "Az" )             { value.get_to(status.az); found |= ST_AZ; }
+        else if ( key == "Alt" )            { value.get_to(status.alt); found |= ST_ALT; }
+        else if ( key == "globalStatus" )   { value.get_to(status.globalStatus); found |= ST_GLOBALSTATUS; }
+        else if ( key == "meridianFlip" )   { value.get_to(status.meridianFlip); found |= ST_MERIDIANFLIP; }
+        else if ( key == "pierSide" )       { value.get_to(status.pierSide); found |= ST_PIERSIDE; }
+        else if ( key == "meridianFlipHA" ) { value.get_to(status.meridianFlipHA); found |= ST_MERIDIANFLIPHA; }
+        else if ( key == "exposureReady" )  { value.get_to(status.exposureReady); found |= ST_EXPOSUREREADY; }
+    }
+
+    if ( found != ST_ALL )
+    {
+        DEBUG(INDI::Logger::DBG_WARNING, "Status communication error");
+        return false;
+    }
+
+    return true;
+}
+
+void AUDTELESCOPE::openRequester()
+{
+    char addr[1024];
+    int timeout = 500, linger = 0, on = 1;
+
+    // A relaxed, correlating REQ socket can send again after a lost reply and drops late
+    // answers to earlier requests, so a timeout no longer needs a new socket and connection.
+    requester = zmq_socket(context, ZMQ_REQ);
+    zmq_setsockopt(requester, ZMQ_RCVTIMEO, &timeout, sizeof(timeout) );
+    zmq_setsockopt(requester, ZMQ_LINGER, &linger, sizeof(linger) );
+    zmq_setsockopt(requester, ZMQ_REQ_RELAXED, &on, sizeof(on) );
+    zmq_setsockopt(requester, ZMQ_REQ_CORRELATE, &on, sizeof(on) );
+    snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
+    zmq_connect(requester, addr);
+}
+
 char* AUDTELESCOPE::sendCommand(const char *fmt, ...)
 {
     va_list ap;
-    char buffer[4096], answer[4096], addr[1024];
+    char buffer[4096], answer[4096];
     int rc, retries;
     zmq_pollitem_t item;
 
@@ -1445,10 +1494,6 @@ char* AUDTELESCOPE::sendCommand(const char *fmt, ...)
                 return strdup("SYNTAXERROR");
             }
         }
-        zmq_close(requester);
-        requester = zmq_socket(context, ZMQ_REQ);
-        snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-        zmq_connect(requester, addr);
     }
     while ( --retries );
     pthread_mutex_unlock( &connectionmutex );
@@ -1459,7 +1504,7 @@ char* AUDTELESCOPE::sendCommand(const char *fmt, ...)
 char* AUDTELESCOPE::sendCommandOnce(const char *fmt, ...)
 {
     va_list ap;
-    char buffer[4096], answer[4096], addr[1024];
+    char buffer[4096], answer[4096];
     int rc;
     zmq_pollitem_t item;
 
@@ -1486,10 +1531,6 @@ char* AUDTELESCOPE::sendCommandOnce(const char *fmt, ...)
             return strdup("SYNTAXERROR");
         }
     }
-    zmq_close(requester);
-    requester = zmq_socket(context, ZMQ_REQ);
-    snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-    zmq_connect(requester, addr);
     pthread_mutex_unlock( &connectionmutex );
     DEBUG(INDI::Logger::DBG_WARNING, "No answer from driver");
     return strdup("COMMUNICATIONERROR");
@@ -1498,7 +1539,7 @@ char* AUDTELESCOPE::sendCommandOnce(const char *fmt, ...)
 char* AUDTELESCOPE::sendRequest(const char *fmt, ...)
 {
     va_list ap;
-    char buffer[4096], answer[4096], addr[1024];
+    char buffer[4096], answer[4096];
     int rc, retries;
     zmq_pollitem_t item;
 
@@ -1524,10 +1565,6 @@ char* AUDTELESCOPE::sendRequest(const char *fmt, ...)
                 return strdup(answer);
             }
         }
-        zmq_close(requester);
-        requester = zmq_socket(context, ZMQ_REQ);
-        snprintf( addr, sizeof(addr), "tcp://%s:%d", IPaddress, IPport );
-        zmq_connect(requester, addr);
     }
     while ( --retries );
     pthread_mutex_unlock( &connectionmutex );
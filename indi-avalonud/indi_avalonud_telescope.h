@@ -172,6 +172,16 @@ private:
     char* sendCommandOnce(const char*,...);
     char* sendRequest(const char*,...);
 
+    // Decoded ASTRO_STATUS answer
+    struct AstroStatus
+    {
+        double utc, jd, lst, ha, ra, dec, az, alt, meridianFlipHA;
+        int globalStatus, meridianFlip, pierSide, exposureReady;
+        std::string errorMsg;
+    };
+    bool readAstroStatus(AstroStatus &status);
+
+    void openRequester();
     void *context,*requester;
     char *lastErrorMsg;
 
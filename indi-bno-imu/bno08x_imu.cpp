@@ -24,7 +24,11 @@
 #include <sh2_SensorValue.h>
 #include <sh2.h>
 #include <sh2_err.h>
+#include <cerrno>
+#include <cinttypes>
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 
 std::unique_ptr<BNO08X> imu(new BNO08X());
 
@@ -37,22 +41,121 @@ BNO08X::BNO08X()
     setDriverInterface(IMU_INTERFACE);
 }
 
+BNO08X::~BNO08X()
+{
+    stopReader();
+}
+
 bool BNO08X::initProperties()
 {
     IMU::initProperties();
+
+    // Sensor event backlog
+    BacklogNP[BACKLOG_PENDING].fill("PENDING", "Pending events", "%.f", 0, 1e6, 0, 0);
+    BacklogNP[BACKLOG_RATE].fill("RATE", "Events/s", "%.1f", 0, 1e6, 0, 0);
+    BacklogNP[BACKLOG_DROPPED].fill("DROPPED", "Dropped since last update", "%.f", 0, 1e9, 0, 0);
+    BacklogNP.fill(getDeviceName(), "SENSOR_BACKLOG", "Backlog", INFO_TAB, IP_RO, 60, IPS_IDLE);
+
+    // SH2 trace, recorded while connected to the sensor, replayed in simulation
+    TraceSP[TRACE_ON].fill("TRACE_ON", "Record", ISS_OFF);
+    TraceSP[TRACE_OFF].fill("TRACE_OFF", "Off", ISS_ON);
+    TraceSP.fill(getDeviceName(), "SH2_TRACE", "SH2 Trace", OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    TraceFileTP[0].fill("FILE", "File", "/tmp/indi_bno08x.sh2");
+    TraceFileTP.fill(getDeviceName(), "SH2_TRACE_FILE", "Trace File", OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+
     addDebugControl();
+    addSimulationControl();
     addPollPeriodControl();
     return true;
 }
 
+void BNO08X::ISGetProperties(const char *dev)
+{
+    IMU::ISGetProperties(dev);
+
+    // Defined while disconnected, so that a trace can be chosen for replay before connecting
+    defineProperty(TraceFileTP);
+    loadConfig(true, TraceFileTP.getName());
+}
+
 bool BNO08X::updateProperties()
 {
     IMU::updateProperties();
+
+    if (isConnected())
+    {
+        defineProperty(BacklogNP);
+        defineProperty(TraceSP);
+    }
+    else
+    {
+        deleteProperty(BacklogNP);
+        deleteProperty(TraceSP);
+    }
+
+    return true;
+}
+
+bool BNO08X::ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n)
+{
+    if (dev != nullptr && strcmp(dev, getDeviceName()) == 0 && TraceSP.isNameMatch(name))
+    {
+        TraceSP.update(states, names, n);
+        if (TraceSP.findOnSwitchIndex() == TRACE_ON)
+        {
+            if (startTrace())
+                TraceSP.setState(IPS_BUSY);
+            else
+            {
+                TraceSP.reset();
+                TraceSP[TRACE_OFF].setState(ISS_ON);
+                TraceSP.setState(IPS_ALERT);
+            }
+        }
+        else
+        {
+            stopTrace();
+            TraceSP.setState(IPS_IDLE);
+        }
+        TraceSP.apply();
+        return true;
+    }
+
+    return IMU::ISNewSwitch(dev, name, states, names, n);
+}
+
+bool BNO08X::ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n)
+{
+    if (dev != nullptr && strcmp(dev, getDeviceName()) == 0 && TraceFileTP.isNameMatch(name))
+    {
+        TraceFileTP.update(texts, names, n);
+        TraceFileTP.setState(IPS_OK);
+        TraceFileTP.apply();
+        saveConfig(TraceFileTP);
+        return true;
+    }
+
+    return IMU::ISNewText(dev, name, texts, names, n);
+}
+
+bool BNO08X::saveConfigItems(FILE *fp)
+{
+    IMU::saveConfigItems(fp);
+    TraceFileTP.save(fp);
     return true;
 }
 
 bool BNO08X::Handshake()
 {
+    if (isSimulation())
+    {
+        if (!openReplay())
+            return false;
+        SetDeviceInfo("Replay", "N/A", TraceFileTP[0].getText());
+        startReader();
+        return true;
+    }
+
     try
     {
         // Initialize the BNO08x sensor with the I2C file descriptor
@@ -108,6 +211,7 @@ bool BNO08X::Handshake()
             return false;
         }
         LOG_INFO("BNO08X initialized and reports enabled successfully.");
+        startReader();
         return true;
     }
     catch (const BNO08x_exception &e)
@@ -117,90 +221,362 @@ bool BNO08X::Handshake()
     }
 }
 
+bool BNO08X::Disconnect()
+{
+    stopReader();
+    stopTrace();
+    closeReplay();
+    return IMU::Disconnect();
+}
+
 void BNO08X::TimerHit()
 {
     if (!isConnected())
         return;
 
-    readSensorData();
+    publishSnapshot();
 
-    SetTimer(getPollingPeriod());
+    SetTimer(m_PublishInterval > 0 ? m_PublishInterval : getPollingPeriod());
 }
 
-bool BNO08X::readSensorData()
+void BNO08X::startReader()
 {
-    sh2_SensorValue_t sensorValue;
-    if (bno08x.getSensorEvent(&sensorValue))
+    stopReader();
+    m_ReaderQuit = false;
+    m_EventsDrained = 0;
+    m_LastSnapshot = std::chrono::steady_clock::now();
+    m_ReaderThread = std::thread(&BNO08X::readerLoop, this);
+}
+
+void BNO08X::stopReader()
+{
+    m_ReaderQuit = true;
+    if (m_ReaderThread.joinable())
+        m_ReaderThread.join();
+}
+
+void BNO08X::readerLoop()
+{
+    int retry = READ_RETRY_MIN;
+    int failures = 0;
+    std::chrono::steady_clock::time_point lastFailureLog;
+
+    while (!m_ReaderQuit)
     {
-        switch (sensorValue.sensorId)
+        int drained = 0;
+        try
+        {
+            drained = m_ReplayFile != nullptr ? replaySensorEvents() : drainSensorEvents();
+        }
+        catch (const BNO08x_exception &e)
         {
-            case SH2_ROTATION_VECTOR:
-            case SH2_GAME_ROTATION_VECTOR:
-            case SH2_GEOMAGNETIC_ROTATION_VECTOR:
-                SetOrientationData(sensorValue.un.rotationVector.i,
-                                   sensorValue.un.rotationVector.j,
-                                   sensorValue.un.rotationVector.k,
-                                   sensorValue.un.rotationVector.real);
-                break;
-
-            case SH2_ACCELEROMETER:
-            case SH2_LINEAR_ACCELERATION:
-            case SH2_GRAVITY:
-                SetAccelerationData(sensorValue.un.accelerometer.x,
-                                    sensorValue.un.accelerometer.y,
-                                    sensorValue.un.accelerometer.z);
-                break;
-
-            case SH2_GYROSCOPE_CALIBRATED:
-            case SH2_GYROSCOPE_UNCALIBRATED:
-                SetGyroscopeData(sensorValue.un.gyroscope.x,
-                                 sensorValue.un.gyroscope.y,
-                                 sensorValue.un.gyroscope.z);
-                break;
-
-            case SH2_MAGNETIC_FIELD_CALIBRATED:
-            case SH2_MAGNETIC_FIELD_UNCALIBRATED:
-                SetMagnetometerData(sensorValue.un.magneticField.x,
-                                    sensorValue.un.magneticField.y,
-                                    sensorValue.un.magneticField.z);
-                break;
-
-            case SH2_TAP_DETECTOR:
-                LOGF_INFO("BNO08X: Tap detected! Flags: %d", sensorValue.un.tapDetector.flags);
-                break;
-
-            case SH2_STEP_DETECTOR:
-                LOGF_DEBUG("BNO08X: Step detected! Latency: %d us", sensorValue.un.stepDetector.latency);
-                break;
-
-            case SH2_STABILITY_CLASSIFIER:
-                LOGF_DEBUG("BNO08X: Stability Classifier: %d", sensorValue.un.stabilityClassifier.classification);
-                break;
-
-            case SH2_RAW_ACCELEROMETER:
-                // Handle raw data if needed, but usually calibrated data is preferred
-                break;
-            case SH2_RAW_GYROSCOPE:
-                // Handle raw data if needed
-                break;
-            case SH2_RAW_MAGNETOMETER:
-                // Handle raw data if needed
-                break;
+            // A sensor that keeps failing must neither spin nor flood the log
+            auto now = std::chrono::steady_clock::now();
+            failures++;
+            if (failures == 1 || now - lastFailureLog >= std::chrono::milliseconds(READ_FAILURE_LOG_INTERVAL))
+            {
+                LOGF_ERROR("BNO08X: sensor read failed (%d times), retrying in %d ms: %s", failures, retry, e.what());
+                lastFailureLog = now;
+            }
+            readerSleep(retry);
+            retry = std::min(retry * 2, READ_RETRY_MAX);
+            continue;
+        }
 
-            default:
-                LOGF_DEBUG("BNO08X: Unhandled sensor event ID: %d", sensorValue.sensorId);
-                break;
+        if (failures > 0)
+        {
+            LOGF_INFO("BNO08X: sensor reads recovered after %d failures.", failures);
+            failures = 0;
+            retry = READ_RETRY_MIN;
         }
 
-        // Update calibration status if available
-        SetCalibrationStatus(sensorValue.status & 0x03, // System calibration
-                             (sensorValue.status >> 2) & 0x03, // Gyro calibration
-                             (sensorValue.status >> 4) & 0x03, // Accelerometer calibration
-                             (sensorValue.status >> 6) & 0x03); // Magnetometer calibration
+        // Nothing pending, sleep for a fraction of the fastest report interval (100 Hz).
+        if (drained == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
 
-        return true;
+void BNO08X::readerSleep(int ms)
+{
+    for (int slept = 0; slept < ms && !m_ReaderQuit; slept += READ_RETRY_MIN)
+        std::this_thread::sleep_for(std::chrono::milliseconds(READ_RETRY_MIN));
+}
+
+int BNO08X::drainSensorEvents()
+{
+    std::lock_guard<std::mutex> busLock(m_BusMutex);
+
+    int drained = 0;
+    sh2_SensorValue_t sensorValue;
+    while (!m_ReaderQuit && bno08x.getSensorEvent(&sensorValue))
+    {
+        storeSensorEvent(sensorValue);
+        drained++;
+    }
+
+    m_EventsDrained += drained;
+    return drained;
+}
+
+void BNO08X::storeSensorEvent(const sh2_SensorValue_t &sensorValue)
+{
+    SensorSample sample;
+    sample.timestamp = sensorValue.timestamp;
+    sample.status = sensorValue.status;
+
+    std::lock_guard<std::mutex> ringLock(m_RingMutex);
+
+    switch (sensorValue.sensorId)
+    {
+        case SH2_ROTATION_VECTOR:
+        case SH2_GAME_ROTATION_VECTOR:
+        case SH2_GEOMAGNETIC_ROTATION_VECTOR:
+            sample.x = sensorValue.un.rotationVector.i;
+            sample.y = sensorValue.un.rotationVector.j;
+            sample.z = sensorValue.un.rotationVector.k;
+            sample.w = sensorValue.un.rotationVector.real;
+            pushSample('O', sample);
+            break;
+
+        case SH2_ACCELEROMETER:
+        case SH2_LINEAR_ACCELERATION:
+        case SH2_GRAVITY:
+            sample.x = sensorValue.un.accelerometer.x;
+            sample.y = sensorValue.un.accelerometer.y;
+            sample.z = sensorValue.un.accelerometer.z;
+            pushSample('A', sample);
+            break;
+
+        case SH2_GYROSCOPE_CALIBRATED:
+        case SH2_GYROSCOPE_UNCALIBRATED:
+            sample.x = sensorValue.un.gyroscope.x;
+            sample.y = sensorValue.un.gyroscope.y;
+            sample.z = sensorValue.un.gyroscope.z;
+            pushSample('G', sample);
+            break;
+
+        case SH2_MAGNETIC_FIELD_CALIBRATED:
+        case SH2_MAGNETIC_FIELD_UNCALIBRATED:
+            sample.x = sensorValue.un.magneticField.x;
+            sample.y = sensorValue.un.magneticField.y;
+            sample.z = sensorValue.un.magneticField.z;
+            pushSample('M', sample);
+            break;
+
+        case SH2_TAP_DETECTOR:
+            LOGF_INFO("BNO08X: Tap detected! Flags: %d", sensorValue.un.tapDetector.flags);
+            break;
+
+        case SH2_STEP_DETECTOR:
+            LOGF_DEBUG("BNO08X: Step detected! Latency: %d us", sensorValue.un.stepDetector.latency);
+            break;
+
+        case SH2_STABILITY_CLASSIFIER:
+            LOGF_DEBUG("BNO08X: Stability Classifier: %d", sensorValue.un.stabilityClassifier.classification);
+            break;
+
+        case SH2_RAW_ACCELEROMETER:
+            // Handle raw data if needed, but usually calibrated data is preferred
+            break;
+        case SH2_RAW_GYROSCOPE:
+            // Handle raw data if needed
+            break;
+        case SH2_RAW_MAGNETOMETER:
+            // Handle raw data if needed
+            break;
+
+        default:
+            LOGF_DEBUG("BNO08X: Unhandled sensor event ID: %d", sensorValue.sensorId);
+            break;
+    }
+
+    m_LastStatus = sensorValue.status;
+    m_HaveStatus = true;
+}
+
+void BNO08X::pushSample(char kind, const SensorSample &sample)
+{
+    switch (kind)
+    {
+        case 'O':
+            m_OrientationRing.push(sample);
+            break;
+        case 'A':
+            m_AccelerationRing.push(sample);
+            break;
+        case 'G':
+            m_GyroscopeRing.push(sample);
+            break;
+        case 'M':
+            m_MagnetometerRing.push(sample);
+            break;
+        default:
+            return;
+    }
+
+    if (m_TraceFile != nullptr)
+        fprintf(m_TraceFile, "%c %" PRIu64 " %u %.9g %.9g %.9g %.9g\n", kind, sample.timestamp, sample.status,
+                sample.x, sample.y, sample.z, sample.w);
+}
+
+bool BNO08X::startTrace()
+{
+    if (isSimulation())
+    {
+        LOG_ERROR("BNO08X: the trace is being replayed, recording is not available in simulation.");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> ringLock(m_RingMutex);
+    if (m_TraceFile != nullptr)
+        fclose(m_TraceFile);
+    m_TraceFile = fopen(TraceFileTP[0].getText(), "w");
+    if (m_TraceFile == nullptr)
+    {
+        LOGF_ERROR("BNO08X: failed to create trace file %s: %s", TraceFileTP[0].getText(), strerror(errno));
+        return false;
+    }
+
+    LOGF_INFO("BNO08X: recording SH2 reports to %s.", TraceFileTP[0].getText());
+    return true;
+}
+
+void BNO08X::stopTrace()
+{
+    std::lock_guard<std::mutex> ringLock(m_RingMutex);
+    if (m_TraceFile != nullptr)
+    {
+        fclose(m_TraceFile);
+        LOGF_INFO("BNO08X: SH2 trace saved to %s.", TraceFileTP[0].getText());
+    }
+    m_TraceFile = nullptr;
+}
+
+bool BNO08X::openReplay()
+{
+    closeReplay();
+    m_ReplayFile = fopen(TraceFileTP[0].getText(), "r");
+    if (m_ReplayFile == nullptr)
+    {
+        LOGF_ERROR("BNO08X: failed to open trace file %s: %s", TraceFileTP[0].getText(), strerror(errno));
+        return false;
+    }
+    if (!readReplaySample())
+    {
+        LOGF_ERROR("BNO08X: %s holds no SH2 reports.", TraceFileTP[0].getText());
+        closeReplay();
+        return false;
+    }
+
+    m_ReplayOrigin = m_ReplaySample.timestamp;
+    m_ReplayStart = std::chrono::steady_clock::now();
+    LOGF_INFO("BNO08X: replaying SH2 reports from %s.", TraceFileTP[0].getText());
+    return true;
+}
+
+void BNO08X::closeReplay()
+{
+    if (m_ReplayFile != nullptr)
+        fclose(m_ReplayFile);
+    m_ReplayFile = nullptr;
+    m_ReplayKind = 0;
+}
+
+bool BNO08X::readReplaySample()
+{
+    unsigned int status = 0;
+    int fields = fscanf(m_ReplayFile, " %c %" SCNu64 " %u %lf %lf %lf %lf", &m_ReplayKind, &m_ReplaySample.timestamp,
+                        &status, &m_ReplaySample.x, &m_ReplaySample.y, &m_ReplaySample.z, &m_ReplaySample.w);
+    m_ReplaySample.status = static_cast<uint8_t>(status);
+    if (fields != 7)
+        m_ReplayKind = 0;
+    return fields == 7;
+}
+
+int BNO08X::replaySensorEvents()
+{
+    // Samples are released once as much time passed since the replay started as in the recording
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                       m_ReplayStart).count();
+    int replayed = 0;
+
+    std::lock_guard<std::mutex> ringLock(m_RingMutex);
+    while (m_ReplayKind != 0 && m_ReplaySample.timestamp <= m_ReplayOrigin + elapsed)
+    {
+        pushSample(m_ReplayKind, m_ReplaySample);
+        m_LastStatus = m_ReplaySample.status;
+        m_HaveStatus = true;
+        replayed++;
+        if (!readReplaySample())
+            LOG_INFO("BNO08X: replay finished.");
     }
-    return false;
+
+    m_EventsDrained += replayed;
+    return replayed;
+}
+
+void BNO08X::publishSnapshot()
+{
+    bool haveOrientation = false, haveAcceleration = false, haveGyroscope = false, haveMagnetometer = false;
+    SensorSample orientation, acceleration, gyroscope, magnetometer;
+    size_t pending = 0;
+    uint64_t dropped = 0;
+    uint8_t status = 0;
+    bool haveStatus = false;
+
+    {
+        std::lock_guard<std::mutex> ringLock(m_RingMutex);
+
+        // Orientation is not averaged, the most recent quaternion defines the snapshot time.
+        haveOrientation = m_OrientationRing.size() > 0;
+        if (haveOrientation)
+        {
+            orientation = m_OrientationRing.latest();
+            m_OrientationRing.consume();
+        }
+
+        // Vector sensors are decimated by averaging all samples up to the snapshot time.
+        uint64_t snapshotTime = haveOrientation ? orientation.timestamp : UINT64_MAX;
+        haveAcceleration = m_AccelerationRing.decimate(snapshotTime, acceleration) > 0;
+        haveGyroscope = m_GyroscopeRing.decimate(snapshotTime, gyroscope) > 0;
+        haveMagnetometer = m_MagnetometerRing.decimate(snapshotTime, magnetometer) > 0;
+
+        pending = m_OrientationRing.size() + m_AccelerationRing.size() + m_GyroscopeRing.size() + m_MagnetometerRing.size();
+        dropped = m_OrientationRing.dropped() + m_AccelerationRing.dropped() + m_GyroscopeRing.dropped() +
+                  m_MagnetometerRing.dropped();
+        status = m_LastStatus;
+        haveStatus = m_HaveStatus;
+        m_HaveStatus = false;
+    }
+
+    if (haveOrientation)
+        SetOrientationData(orientation.x, orientation.y, orientation.z, orientation.w);
+    if (haveAcceleration)
+        SetAccelerationData(acceleration.x, acceleration.y, acceleration.z);
+    if (haveGyroscope)
+        SetGyroscopeData(gyroscope.x, gyroscope.y, gyroscope.z);
+    if (haveMagnetometer)
+        SetMagnetometerData(magnetometer.x, magnetometer.y, magnetometer.z);
+
+    // Update calibration status if available
+    if (haveStatus)
+        SetCalibrationStatus(status & 0x03, // System calibration
+                             (status >> 2) & 0x03, // Gyro calibration
+                             (status >> 4) & 0x03, // Accelerometer calibration
+                             (status >> 6) & 0x03); // Magnetometer calibration
+
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - m_LastSnapshot).count();
+    m_LastSnapshot = now;
+
+    BacklogNP[BACKLOG_PENDING].setValue(pending);
+    BacklogNP[BACKLOG_RATE].setValue(elapsed > 0 ? m_EventsDrained.exchange(0) / elapsed : 0);
+    // The ring counters never reset, report what was lost since the previous snapshot
+    uint64_t droppedSinceLast = dropped - m_LastDropped;
+    m_LastDropped = dropped;
+    BacklogNP[BACKLOG_DROPPED].setValue(droppedSinceLast);
+    BacklogNP.setState(droppedSinceLast > 0 ? IPS_BUSY : IPS_OK);
+    BacklogNP.apply();
 }
 
 bool BNO08X::SetCalibrationStatus(int sys, int gyro, int accel, int mag)
@@ -241,6 +617,7 @@ bool BNO08X::StartCalibration()
 
     // Enable dynamic calibration for Accel, Gyro, Mag, Planar Accel, On Table Cal
     uint8_t sensorsToCalibrate = SH2_CAL_ACCEL | SH2_CAL_GYRO | SH2_CAL_MAG | SH2_CAL_PLANAR;
+    std::lock_guard<std::mutex> busLock(m_BusMutex);
     int status = sh2_setCalConfig(sensorsToCalibrate);
 
     if (status != SH2_OK)
@@ -257,6 +634,7 @@ bool BNO08X::SaveCalibrationData()
 {
     LOG_INFO("BNO08X: Saving calibration data to FRS.");
 
+    std::lock_guard<std::mutex> busLock(m_BusMutex);
     int status = sh2_saveDcdNow();
     if (status != SH2_OK)
     {
@@ -282,6 +660,7 @@ bool BNO08X::ResetCalibration()
 {
     LOG_INFO("BNO08X: Resetting calibration data and performing a soft reset.");
 
+    std::lock_guard<std::mutex> busLock(m_BusMutex);
     int status = sh2_clearDcdAndReset();
     if (status != SH2_OK)
     {
@@ -323,7 +702,9 @@ bool BNO08X::SetAngularUnits(bool degrees)
 
 bool BNO08X::SetUpdateRate(double rate)
 {
-    // TODO: Implement BNO08X update rate setting
+    // Sensor reports keep streaming at their native rate, the rate only controls how often
+    // decimated snapshots are published. Zero follows the polling period.
+    m_PublishInterval = rate > 0 ? static_cast<uint32_t>(std::max(1.0, std::round(1000.0 / rate))) : 0;
     LOGF_INFO("BNO08X: Setting update rate to %f Hz.", rate);
     return true;
 }
@@ -24,12 +24,19 @@
 #include <connectionplugins/connectioni2c.h>
 #include <BNO08x.h>
 #include <cmath>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "sensor_ring.h"
 
 class BNO08X : public INDI::IMU
 {
     public:
         BNO08X();
-        virtual ~BNO08X() = default;
+        virtual ~BNO08X();
 
         virtual const char *getDefaultName() override
         {
@@ -37,8 +44,12 @@ class BNO08X : public INDI::IMU
         }
 
         virtual bool initProperties() override;
+        virtual void ISGetProperties(const char *dev) override;
         virtual bool updateProperties() override;
+        virtual bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n) override;
+        virtual bool ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n) override;
         virtual bool Handshake() override;
+        virtual bool Disconnect() override;
         virtual void TimerHit() override;
 
     protected:
@@ -55,7 +66,83 @@ class BNO08X : public INDI::IMU
         virtual bool SetUpdateRate(double rate) override;
         virtual bool SetDeviceInfo(const std::string &chipID, const std::string &firmwareVersion,
                                    const std::string &sensorStatus) override;
+        virtual bool saveConfigItems(FILE *fp) override;
+
     private:
+        // Ring capacity per sensor, enough for several seconds of 100 Hz reports.
+        static constexpr size_t SENSOR_RING_SIZE = 512;
+        // Reader backoff while the sensor keeps failing, and interval between repeated failure logs.
+        static constexpr int READ_RETRY_MIN = 10;
+        static constexpr int READ_RETRY_MAX = 1000;
+        static constexpr int READ_FAILURE_LOG_INTERVAL = 10000;
+
         BNO08x bno08x; // BNO08x sensor object
-        bool readSensorData();
+
+        // Reader thread, drains all pending SH2 events into the sensor rings.
+        void startReader();
+        void stopReader();
+        void readerLoop();
+        /** @return Number of events drained. */
+        int drainSensorEvents();
+        void storeSensorEvent(const sh2_SensorValue_t &sensorValue);
+        /** @brief Push a decoded sample into the ring of its kind and record it. Ring mutex held. */
+        void pushSample(char kind, const SensorSample &sample);
+        /** @brief Sleep up to ms, returning early when the reader is asked to quit. */
+        void readerSleep(int ms);
+
+        // SH2 trace. While recording, every decoded sample is written as one line:
+        // "<kind> <timestamp us> <status> <x> <y> <z> <w>", kind being O(rientation), A(cceleration),
+        // G(yroscope) or M(agnetometer). In simulation the trace file is replayed at its recorded pace.
+        bool startTrace();
+        void stopTrace();
+        bool openReplay();
+        void closeReplay();
+        /** @brief Read the next trace line into m_ReplayKind and m_ReplaySample. @return False at the end. */
+        bool readReplaySample();
+        /** @return Number of samples replayed. */
+        int replaySensorEvents();
+
+        // Publish a time-aligned, decimated snapshot of all sensors.
+        void publishSnapshot();
+
+        std::thread m_ReaderThread;
+        std::atomic_bool m_ReaderQuit {false};
+        // Serializes all access to the sensor bus (reader thread vs. calibration commands)
+        std::mutex m_BusMutex;
+        // Protects the sensor rings below
+        std::mutex m_RingMutex;
+        SensorRing<SENSOR_RING_SIZE> m_OrientationRing, m_AccelerationRing, m_GyroscopeRing, m_MagnetometerRing;
+        uint8_t m_LastStatus {0};
+        bool m_HaveStatus {false};
+        // Snapshot publishing interval in ms, zero to follow the polling period.
+        uint32_t m_PublishInterval {0};
+
+        // Backlog
+        INDI::PropertyNumber BacklogNP {3};
+        enum
+        {
+            BACKLOG_PENDING,
+            BACKLOG_RATE,
+            BACKLOG_DROPPED,
+        };
+        std::atomic<uint32_t> m_EventsDrained {0};
+
+        // SH2 trace
+        INDI::PropertySwitch TraceSP {2};
+        enum
+        {
+            TRACE_ON,
+            TRACE_OFF,
+        };
+        INDI::PropertyText TraceFileTP {1};
+        // Recording file, protected by m_RingMutex
+        FILE *m_TraceFile {nullptr};
+        // Replay file, only used by the reader thread once it runs
+        FILE *m_ReplayFile {nullptr};
+        std::chrono::steady_clock::time_point m_ReplayStart;
+        uint64_t m_ReplayOrigin {0};
+        char m_ReplayKind {0};
+        SensorSample m_ReplaySample;
+        std::chrono::steady_clock::time_point m_LastSnapshot;
+        uint64_t m_LastDropped {0};
 };
@@ -0,0 +1,126 @@
+/*
+    BNO085 IMU Driver - Sensor event ring buffer
+    Copyright (C) 2025 Jasem Mutlaq (mutlaqja@ikarustech.com)
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A single decoded SH2 report. Vector reports use x/y/z, quaternions use all four components.
+ */
+struct SensorSample
+{
+    uint64_t timestamp {0}; // SH2 sensor timestamp in microseconds
+    double x {0}, y {0}, z {0}, w {0};
+    uint8_t status {0};
+};
+
+/**
+ * @brief Fixed size ring of pending sensor samples. When full, the oldest pending sample is
+ * overwritten and counted as dropped. Not thread safe, the owner must serialize access.
+ */
+template <size_t N>
+class SensorRing
+{
+    public:
+        void push(const SensorSample &sample)
+        {
+            m_Samples[m_Head] = sample;
+            m_Head = (m_Head + 1) % N;
+            if (m_Count == N)
+                m_Dropped++;
+            else
+                m_Count++;
+
+            m_Latest = sample;
+            m_Valid = true;
+        }
+
+        /** @return Number of samples not yet consumed. */
+        size_t size() const
+        {
+            return m_Count;
+        }
+
+        uint64_t dropped() const
+        {
+            return m_Dropped;
+        }
+
+        /** @return True once at least one sample was received. */
+        bool valid() const
+        {
+            return m_Valid;
+        }
+
+        /** @return Most recent sample, consumed or not. Only meaningful if valid(). */
+        const SensorSample &latest() const
+        {
+            return m_Latest;
+        }
+
+        /** @brief Drop all pending samples. */
+        void consume()
+        {
+            m_Count = 0;
+        }
+
+        /**
+         * @brief Average all pending samples not newer than the given timestamp and consume them.
+         * @return Number of samples averaged, zero if there were none and average is untouched.
+         */
+        size_t decimate(uint64_t timestamp, SensorSample &average)
+        {
+            size_t used = 0;
+            double x = 0, y = 0, z = 0, w = 0;
+            const size_t tail = (m_Head + N - m_Count) % N;
+            for (; used < m_Count; used++)
+            {
+                const SensorSample &sample = m_Samples[(tail + used) % N];
+                if (sample.timestamp > timestamp)
+                    break;
+                x += sample.x;
+                y += sample.y;
+                z += sample.z;
+                w += sample.w;
+            }
+
+            if (used == 0)
+                return 0;
+
+            average = m_Samples[(tail + used - 1) % N];
+            average.x = x / used;
+            average.y = y / used;
+            average.z = z / used;
+            average.w = w / used;
+            m_Count -= used;
+            return used;
+        }
+
+    private:
+        std::array<SensorSample, N> m_Samples;
+        SensorSample m_Latest;
+        size_t m_Head {0};
+        size_t m_Count {0};
+        uint64_t m_Dropped {0};
+        bool m_Valid {false};
+};
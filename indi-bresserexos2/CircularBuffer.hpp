@@ -24,6 +24,7 @@
 #ifndef _CIRCULARBUFFER_H_INCLUDED_
 #define _CIRCULARBUFFER_H_INCLUDED_
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <vector>
@@ -78,6 +79,21 @@ class CircularBuffer
             return false;
         }
 
+        //Appends as many values as fit into the buffer, returns the number of values added.
+        size_t PushBack(const T* values, size_t count)
+        {
+            count = std::min(count, Free());
+
+            //copy in at most two pieces, up to the end of the storage and from its beginning.
+            size_t first = std::min(count, max_size - mEnd);
+            std::memcpy(&mBuffer[mEnd], values, first * sizeof(T));
+            std::memcpy(&mBuffer[0], values + first, (count - first) * sizeof(T));
+
+            mEnd = (mEnd + count) % max_size;
+            mSize += count;
+            return count;
+        }
+
         bool PopFront()
         {
             if(!IsEmpty())
@@ -144,6 +160,18 @@ class CircularBuffer
             return mSize;
         }
 
+        //Number of values that can still be added.
+        size_t Free()
+        {
+            return max_size - mSize;
+        }
+
+        //Returns the value at the logical index, counted from the front. The index has to be smaller than Size().
+        T At(size_t logicalIndex)
+        {
+            return mBuffer[ActualIndex(logicalIndex)];
+        }
+
         bool IsEmpty()
         {
             return mSize == 0;
@@ -164,15 +192,14 @@ class CircularBuffer
             }
         }
 
+        //Drops count values from the front, returns false if there were less values than that.
         bool DiscardFront(size_t count)
         {
-            bool returnval = false;
-
-            for(size_t i = 0; i < count; i++)
-            {
-                returnval = PopFront();
-            }
+            bool returnval = count > 0 && count <= mSize;
+            count = std::min(count, mSize);
 
+            mStart = (mStart + count) % max_size;
+            mSize -= count;
             return returnval;
         }
 
@@ -210,7 +237,7 @@ class CircularBuffer
             {
                 value = max_size;
             }
-            value++;
+            value--;
         }
 };
 }
@@ -0,0 +1,438 @@
+/*
+ * HandboxEmulator.cpp
+ *
+ * Copyright 2020 Kevin Krüger <kkevin@gmx.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ *
+ *
+ */
+
+//Emulates the Exos II handbox (firmware 2.3) on a pseudo terminal, for testing without the mount:
+//
+//    bresserexos2_handbox_emulator [--period ms] [--fragment bytes] [--latency count]
+//
+//The slave device name is printed on startup, point the driver's serial port at it.
+//Pointing reports are sent every period (1000 ms by default, like the handbox).
+//GOTO and PARK slew the reported coordinates, SYNC sets them, SET_SITE_LOCATION is echoed on GET_SITE_LOCATION,
+//DISCONNECT stops the reports until the next command, like the handbox does.
+//--fragment writes every message in pieces of that many bytes, 2 ms apart, like a slow USB serial adapter.
+//
+//--latency runs the receive path of the driver (SerialCommandTransceiver on IndiSerialWrapper) against the
+//emulator in the same process. count reports are sent at random times, half of them in bursts of three.
+//The time from writing a report to its callback is printed in milliseconds, along with the reports lost.
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <random>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "IndiSerialWrapper.hpp"
+#include "SerialCommand.hpp"
+#include "SerialCommandTransceiver.hpp"
+
+using SerialDeviceControl::FloatByteConverter;
+using SerialDeviceControl::SerialCommand;
+using SerialDeviceControl::SerialCommandID;
+using Clock = std::chrono::steady_clock;
+
+//State of the emulated mount.
+struct Handbox
+{
+    int master {-1};
+    size_t fragment {0};
+
+    bool reporting {true};
+    float rightAscension {0};
+    float declination {90};
+    float targetRightAscension {0};
+    float targetDeclination {90};
+    uint8_t siteLocation[8] {};
+};
+
+static void SendMessage(Handbox &handbox, uint8_t cid, const uint8_t* arguments)
+{
+    std::vector<uint8_t> message;
+    SerialCommand::PushHeader(message);
+    message.push_back(cid);
+    message.insert(message.end(), arguments, arguments + 8);
+
+    size_t piece = handbox.fragment > 0 ? handbox.fragment : message.size();
+
+    for(size_t offset = 0; offset < message.size(); offset += piece)
+    {
+        if(offset > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+
+        size_t length = std::min(piece, message.size() - offset);
+
+        if(write(handbox.master, &message[offset], length) < 0)
+        {
+            fprintf(stderr, "Failed to write: %s\n", strerror(errno));
+        }
+    }
+}
+
+static void SendCoordinates(Handbox &handbox, uint8_t cid, float first, float second)
+{
+    FloatByteConverter first_bytes;
+    FloatByteConverter second_bytes;
+    first_bytes.decimal_number = first;
+    second_bytes.decimal_number = second;
+
+    uint8_t arguments[8];
+    std::memcpy(arguments, first_bytes.bytes, 4);
+    std::memcpy(arguments + 4, second_bytes.bytes, 4);
+
+    SendMessage(handbox, cid, arguments);
+}
+
+//Moves the reported coordinates a step towards the target, the handbox slews at a few degrees per second.
+static void Slew(Handbox &handbox)
+{
+    float deltaRightAscension = handbox.targetRightAscension - handbox.rightAscension;
+    float deltaDeclination = handbox.targetDeclination - handbox.declination;
+
+    handbox.rightAscension += std::max(-0.25f, std::min(0.25f, deltaRightAscension));
+    handbox.declination += std::max(-4.0f, std::min(4.0f, deltaDeclination));
+}
+
+static void HandleCommand(Handbox &handbox, const uint8_t* message)
+{
+    FloatByteConverter first_bytes;
+    FloatByteConverter second_bytes;
+    std::memcpy(first_bytes.bytes, message + 5, 4);
+    std::memcpy(second_bytes.bytes, message + 9, 4);
+
+    handbox.reporting = true;
+
+    switch(message[4])
+    {
+        case SerialCommandID::GOTO_COMMAND_ID:
+            handbox.targetRightAscension = first_bytes.decimal_number;
+            handbox.targetDeclination = second_bytes.decimal_number;
+            break;
+
+        case SerialCommandID::SYNC_COMMAND_ID:
+            handbox.rightAscension = handbox.targetRightAscension = first_bytes.decimal_number;
+            handbox.declination = handbox.targetDeclination = second_bytes.decimal_number;
+            break;
+
+        case SerialCommandID::PARK_COMMAND_ID:
+            handbox.targetDeclination = 90;
+            break;
+
+        case SerialCommandID::STOP_MOTION_COMMAND_ID:
+            handbox.targetRightAscension = handbox.rightAscension;
+            handbox.targetDeclination = handbox.declination;
+            break;
+
+        case SerialCommandID::MOVE_EAST_COMMAND_ID:
+            handbox.rightAscension = handbox.targetRightAscension += 0.001f;
+            break;
+
+        case SerialCommandID::MOVE_WEST_COMMAND_ID:
+            handbox.rightAscension = handbox.targetRightAscension -= 0.001f;
+            break;
+
+        case SerialCommandID::MOVE_NORTH_COMMAND_ID:
+            handbox.declination = handbox.targetDeclination += 0.01f;
+            break;
+
+        case SerialCommandID::MOVE_SOUTH_COMMAND_ID:
+            handbox.declination = handbox.targetDeclination -= 0.01f;
+            break;
+
+        case SerialCommandID::SET_SITE_LOCATION_COMMAND_ID:
+            std::memcpy(handbox.siteLocation, message + 5, 8);
+            break;
+
+        case SerialCommandID::GET_SITE_LOCATION_COMMAND_ID:
+            SendMessage(handbox, SerialCommandID::TELESCOPE_SITE_LOCATION_REPORT_COMMAND_ID, handbox.siteLocation);
+            break;
+
+        case SerialCommandID::DISCONNET_COMMAND_ID:
+            handbox.reporting = false;
+            break;
+
+        default:
+            break;
+    }
+}
+
+//Serves the driver until the pseudo terminal fails.
+static int Emulate(Handbox &handbox, int period)
+{
+    std::vector<uint8_t> header;
+    SerialCommand::PushHeader(header);
+
+    std::vector<uint8_t> received;
+    Clock::time_point nextReport = Clock::now();
+
+    while(true)
+    {
+        int timeout = std::max<int>(0, std::chrono::duration_cast<std::chrono::milliseconds>(nextReport - Clock::now()).count());
+
+        struct pollfd pfd;
+        pfd.fd = handbox.master;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int result = poll(&pfd, 1, timeout);
+
+        if(result < 0 && errno != EINTR)
+        {
+            fprintf(stderr, "Failed to poll: %s\n", strerror(errno));
+            return 1;
+        }
+
+        if(result > 0)
+        {
+            uint8_t buffer[256];
+            ssize_t count = read(handbox.master, buffer, sizeof(buffer));
+
+            if(count < 0 && errno != EINTR && errno != EAGAIN && errno != EIO)
+            {
+                fprintf(stderr, "Failed to read: %s\n", strerror(errno));
+                return 1;
+            }
+
+            if(count <= 0)
+            {
+                //EIO while the driver has the port closed.
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            else
+            {
+                received.insert(received.end(), buffer, buffer + count);
+            }
+
+            std::vector<uint8_t>::iterator start;
+
+            while((start = std::search(received.begin(), received.end(), header.begin(), header.end())) != received.end()
+                    && received.end() - start >= MESSAGE_FRAME_SIZE)
+            {
+                HandleCommand(handbox, &*start);
+                received.erase(received.begin(), start + MESSAGE_FRAME_SIZE);
+            }
+        }
+
+        if(Clock::now() >= nextReport)
+        {
+            nextReport += std::chrono::milliseconds(period);
+
+            if(handbox.reporting)
+            {
+                Slew(handbox);
+                SendCoordinates(handbox, SerialCommandID::TELESCOPE_POSITION_REPORT_COMMAND_ID, handbox.rightAscension,
+                                handbox.declination);
+            }
+        }
+    }
+}
+
+//Receives the reports of the latency test, the report number is sent as right ascension.
+class LatencyProbe : public SerialDeviceControl::INotifyPointingCoordinatesReceived
+{
+    public:
+        explicit LatencyProbe(size_t count) :
+            mSent(count),
+            mLatency(count, -1)
+        {
+
+        }
+
+        void Sent(size_t index)
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            mSent[index] = Clock::now();
+        }
+
+        virtual void OnPointingCoordinatesReceived(float right_ascension, float declination)
+        {
+            (void)declination;
+            Clock::time_point now = Clock::now();
+            size_t index = static_cast<size_t>(right_ascension);
+
+            std::lock_guard<std::mutex> guard(mMutex);
+
+            if(index < mSent.size())
+            {
+                mLatency[index] = std::chrono::duration<double, std::milli>(now - mSent[index]).count();
+            }
+        }
+
+        virtual void OnSiteLocationCoordinatesReceived(float latitude, float longitude)
+        {
+            (void)latitude;
+            (void)longitude;
+        }
+
+        void Print()
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+
+            std::vector<double> latency;
+            std::copy_if(mLatency.begin(), mLatency.end(), std::back_inserter(latency), [](double value)
+            {
+                return value >= 0;
+            });
+            std::sort(latency.begin(), latency.end());
+
+            printf("reports: %zu, received: %zu\n", mLatency.size(), latency.size());
+
+            if(latency.empty())
+            {
+                return;
+            }
+
+            double sum = 0;
+            for(double value : latency)
+            {
+                sum += value;
+            }
+
+            printf("latency ms: min %.2f, mean %.2f, median %.2f, p99 %.2f, max %.2f\n", latency.front(), sum / latency.size(),
+                   latency[latency.size() / 2], latency[std::min(latency.size() - 1, latency.size() * 99 / 100)], latency.back());
+        }
+
+    private:
+        std::mutex mMutex;
+        std::vector<Clock::time_point> mSent;
+        std::vector<double> mLatency;
+};
+
+static int MeasureLatency(Handbox &handbox, size_t count)
+{
+    int slave = open(ptsname(handbox.master), O_RDWR | O_NOCTTY);
+
+    if(slave < 0)
+    {
+        fprintf(stderr, "Failed to open %s: %s\n", ptsname(handbox.master), strerror(errno));
+        return 1;
+    }
+
+    struct termios tty;
+    tcgetattr(slave, &tty);
+    cfmakeraw(&tty);
+    tcsetattr(slave, TCSANOW, &tty);
+
+    GoToDriver::IndiSerialWrapper wrapper;
+    wrapper.SetFD(slave);
+
+    LatencyProbe probe(count);
+
+    {
+        SerialDeviceControl::SerialCommandTransceiver<GoToDriver::IndiSerialWrapper, LatencyProbe> transceiver(wrapper, probe);
+        transceiver.Start();
+
+        //let the reader settle, then send the reports at random times
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> pause(20, 250);
+
+        for(size_t index = 0; index < count; index++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(pause(random)));
+
+            //every other round is a burst of up to three reports back to back
+            size_t burst = (index / 3) % 2 ? std::min<size_t>(3, count - index) : 1;
+
+            for(size_t i = 0; i < burst; i++)
+            {
+                probe.Sent(index + i);
+                SendCoordinates(handbox, SerialCommandID::TELESCOPE_POSITION_REPORT_COMMAND_ID, index + i, 0);
+            }
+            index += burst - 1;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(600));
+        transceiver.Stop();
+    }
+
+    close(slave);
+    probe.Print();
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    Handbox handbox;
+    int period = 1000;
+    size_t latencyCount = 0;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--period") == 0 && i + 1 < argc)
+        {
+            period = std::max(1, atoi(argv[++i]));
+        }
+        else if(strcmp(argv[i], "--fragment") == 0 && i + 1 < argc)
+        {
+            handbox.fragment = std::max(0, atoi(argv[++i]));
+        }
+        else if(strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+        {
+            latencyCount = std::max(1, atoi(argv[++i]));
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--period ms] [--fragment bytes] [--latency count]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    handbox.master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if(handbox.master < 0 || grantpt(handbox.master) != 0 || unlockpt(handbox.master) != 0)
+    {
+        fprintf(stderr, "Failed to create pseudo terminal: %s\n", strerror(errno));
+        return 1;
+    }
+
+    if(latencyCount > 0)
+    {
+        int rc = MeasureLatency(handbox, latencyCount);
+        close(handbox.master);
+        return rc;
+    }
+
+    //keep the slave open, so that the master does not fail while the driver reconnects
+    int slave = open(ptsname(handbox.master), O_RDWR | O_NOCTTY);
+    printf("Exos II handbox emulator on %s\n", ptsname(handbox.master));
+    fflush(stdout);
+
+    int rc = Emulate(handbox, period);
+
+    close(slave);
+    close(handbox.master);
+    return rc;
+}
@@ -24,6 +24,7 @@
 #ifndef _ISERIALINTERFACE_H_INCLUDED_
 #define _ISERIALINTERFACE_H_INCLUDED_
 
+#include <cstddef>
 #include <cstdint>
 #include "config.h"
 
@@ -48,6 +49,12 @@ class ISerialInterface
         //Reads a byte from the serial device. Can safely cast to uint8_t unless -1 is returned, corresponding to "stream end reached".
         virtual int16_t ReadByte() = 0;
 
+        //Waits up to timeout milliseconds for data to read, returns true if data is available.
+        virtual bool WaitForData(int timeout) = 0;
+
+        //Reads the data available, up to length bytes, into the buffer without blocking. Returns the number of bytes read.
+        virtual size_t Read(uint8_t* buffer, size_t length) = 0;
+
         //writes the buffer to the serial interface.
         //this function should handle all the quirks of various serial interfaces.
         virtual bool Write(uint8_t* buffer, size_t offset, size_t length) = 0;
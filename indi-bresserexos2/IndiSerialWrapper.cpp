@@ -1,5 +1,7 @@
 #include "IndiSerialWrapper.hpp"
 
+#include <algorithm>
+
 using namespace GoToDriver;
 
 #define UNUSED(x) (void)(x)
@@ -99,6 +101,50 @@ int16_t IndiSerialWrapper::ReadByte()
     return -1;
 }
 
+//Waits up to timeout milliseconds for data to read, returns true if data is available.
+bool IndiSerialWrapper::WaitForData(int timeout)
+{
+    if(IsOpen())
+    {
+        struct pollfd pfd;
+        pfd.fd = mTtyFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        int result = poll(&pfd, 1, timeout);
+
+        //report errors and hang ups as readable too, the following read tells what happened.
+        return result > 0;
+    }
+
+    //nothing to wait on, do not make the caller spin.
+    usleep(timeout * 1000);
+    return false;
+}
+
+//Reads the data available, up to length bytes, into the buffer without blocking. Returns the number of bytes read.
+size_t IndiSerialWrapper::Read(uint8_t* buffer, size_t length)
+{
+    if(IsOpen() && buffer != nullptr && length > 0)
+    {
+        size_t available = BytesToRead();
+
+        if(available == 0)
+        {
+            return 0;
+        }
+
+        ssize_t result = read(mTtyFd, buffer, std::min(available, length));
+
+        if(result > 0)
+        {
+            return result;
+        }
+    }
+
+    return 0;
+}
+
 //writes the buffer to the serial interface.
 //this function should handle all the quirks of various serial interfaces.
 bool IndiSerialWrapper::Write(uint8_t* buffer, size_t offset, size_t length)
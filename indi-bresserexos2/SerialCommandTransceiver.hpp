@@ -30,6 +30,7 @@
 #include <deque>
 #include <queue>
 #include <thread>
+#include <chrono>
 
 #include <algorithm>
 #include "config.h"
@@ -75,6 +76,9 @@ class SerialCommandTransceiver
         //Start the serial command dispatching.
         virtual bool Start()
         {
+            //set before the thread starts, so that an early Stop() still joins it.
+            mThreadRunning.Set(true);
+
             mSerialReaderThread = std::thread(&SerialCommandTransceiver::SerialReaderThreadFunction, this);
 
             return true;
@@ -125,113 +129,107 @@ class SerialCommandTransceiver
         //movable thread object to control.
         std::thread mSerialReaderThread;
 
-        //buffer used when serial messages are parsed.
-        std::vector<uint8_t> mParseBuffer;
+        //longest time the reader waits for data, before checking if it should stop, in milliseconds.
+        static constexpr const int SERIAL_WAIT_TIMEOUT {100};
 
-        //When messages are received, try parsing them.
-        //It may happen that messages are received in fragments, this function tries to piece together these fragments to valid messages.
-        //skip any previous junk if message was found, drop anything until the end of the parsed message, to clean up the buffer.
+        //Parses every complete message in the receive buffer.
+        //Messages may be received in fragments, an incomplete message is left in the buffer until the rest arrives.
+        //Anything in front of a message header is junk and dropped, so every byte is only looked at once for a header.
         void TryParseMessagesFromBuffer()
         {
-            mParseBuffer.clear();
-
-            if(mSerialReceiverBuffer.Size() > 0)
+            while(mSerialReceiverBuffer.Size() >= mMessageHeader.size())
             {
-                mSerialReceiverBuffer.CopyToVector(mParseBuffer);
+                size_t matched = 0;
 
-                std::vector<uint8_t>::iterator startPosition = std::search(mParseBuffer.begin(), mParseBuffer.end(), mMessageHeader.begin(),
-                        mMessageHeader.end());
+                while(matched < mMessageHeader.size() && mSerialReceiverBuffer.At(matched) == mMessageHeader[matched])
+                {
+                    matched++;
+                }
 
-                std::vector<uint8_t>::iterator endPosition = startPosition + MESSAGE_FRAME_SIZE;
+                if(matched < mMessageHeader.size())
+                {
+                    mSerialReceiverBuffer.DiscardFront(1);
+                    continue;
+                }
 
-                if(startPosition != mParseBuffer.end() && endPosition != mParseBuffer.end())
+                //wait for the rest of the message.
+                if(mSerialReceiverBuffer.Size() < MESSAGE_FRAME_SIZE)
                 {
-                    FloatByteConverter ra_bytes;
-                    FloatByteConverter dec_bytes;
-
-                    ra_bytes.bytes[0] = *(startPosition + 5);
-                    ra_bytes.bytes[1] = *(startPosition + 6);
-                    ra_bytes.bytes[2] = *(startPosition + 7);
-                    ra_bytes.bytes[3] = *(startPosition + 8);
-
-                    dec_bytes.bytes[0] = *(startPosition + 9);
-                    dec_bytes.bytes[1] = *(startPosition + 10);
-                    dec_bytes.bytes[2] = *(startPosition + 11);
-                    dec_bytes.bytes[3] = *(startPosition + 12);
-
-                    uint8_t cid = *(startPosition + 4);
-                    float ra = ra_bytes.decimal_number;
-                    float dec = dec_bytes.decimal_number;
-
-                    //std::cerr << "COMMAND RECEIVED:" << std::hex << (int)cid << std::endl;
-
-                    //handle specific response.
-                    switch(cid)
-                    {
-                        case SerialCommandID::TELESCOPE_SITE_LOCATION_REPORT_COMMAND_ID:
-                            //std::cout << "new location received!" << std::endl;
-                            mDataReceivedCallback.OnSiteLocationCoordinatesReceived(ra, dec);
-                            break;
-                            
-                        /* The handbox unfortunately does not report "untracked" coordinates, -> reason for this big state machine.
-                         * case SerialCommandID::TELESCOPE_POSITION_REPORT_UNTRACKED_COMMAND_ID:
-                            std::cerr << "untracked pointing report:" << "RA:" << ra << " DEC:" << dec << std::endl;
-                            break;*/
-
-                        case SerialCommandID::TELESCOPE_POSITION_REPORT_COMMAND_ID:
-                            mDataReceivedCallback.OnPointingCoordinatesReceived(ra, dec);
-                            break;
-
-                        default:
-                            break;
-                    }
-
-                    size_t dropCount = endPosition - mParseBuffer.begin();
-
-                    mSerialReceiverBuffer.DiscardFront(dropCount);
-
-                    //std::cout << "Receive size after :" << mSerialReceiverBuffer.Size() << " dropped " << dropCount << std::endl;
+                    break;
+                }
+
+                FloatByteConverter ra_bytes;
+                FloatByteConverter dec_bytes;
+
+                for(size_t i = 0; i < 4; i++)
+                {
+                    ra_bytes.bytes[i] = mSerialReceiverBuffer.At(5 + i);
+                    dec_bytes.bytes[i] = mSerialReceiverBuffer.At(9 + i);
+                }
+
+                uint8_t cid = mSerialReceiverBuffer.At(4);
+                float ra = ra_bytes.decimal_number;
+                float dec = dec_bytes.decimal_number;
+
+                mSerialReceiverBuffer.DiscardFront(MESSAGE_FRAME_SIZE);
+
+                //std::cerr << "COMMAND RECEIVED:" << std::hex << (int)cid << std::endl;
+
+                //handle specific response.
+                switch(cid)
+                {
+                    case SerialCommandID::TELESCOPE_SITE_LOCATION_REPORT_COMMAND_ID:
+                        //std::cout << "new location received!" << std::endl;
+                        mDataReceivedCallback.OnSiteLocationCoordinatesReceived(ra, dec);
+                        break;
+
+                    /* The handbox unfortunately does not report "untracked" coordinates, -> reason for this big state machine.
+                     * case SerialCommandID::TELESCOPE_POSITION_REPORT_UNTRACKED_COMMAND_ID:
+                        std::cerr << "untracked pointing report:" << "RA:" << ra << " DEC:" << dec << std::endl;
+                        break;*/
+
+                    case SerialCommandID::TELESCOPE_POSITION_REPORT_COMMAND_ID:
+                        mDataReceivedCallback.OnPointingCoordinatesReceived(ra, dec);
+                        break;
+
+                    default:
+                        break;
                 }
             }
         }
+
         //Endless loop function of the thread used to receive the serial messages of the mount.
+        //Waits for data on the serial interface, reads everything available at once and parses all complete messages.
         void SerialReaderThreadFunction()
         {
             std::cerr << "Serial Reader Thread started!" << std::endl;
-            bool running = mThreadRunning.Get();
 
             mInterfaceImplementation.Open();
 
-            if(running == false)
+            uint8_t readBuffer[256];
+
+            while(mThreadRunning.Get())
             {
-                mThreadRunning.Set(true);
+                if(!mInterfaceImplementation.WaitForData(SERIAL_WAIT_TIMEOUT))
+                {
+                    continue;
+                }
+
+                //the parser leaves less than a message in the buffer, so there is always room.
+                size_t bytesRead = mInterfaceImplementation.Read(readBuffer, std::min(sizeof(readBuffer), mSerialReceiverBuffer.Free()));
 
-                do
+                if(bytesRead == 0)
                 {
-                    //controller sends status messages about every second so wait a bit
-                    std::this_thread::sleep_until(std::chrono::system_clock::now() + std::chrono::milliseconds(500));
-
-                    size_t bufferContent = mInterfaceImplementation.BytesToRead();
-                    int16_t data = -1;
-
-                    bool addSucceed = false;
-
-                    if(bufferContent > 0)
-                    {
-                        while((data = mInterfaceImplementation.ReadByte()) > -1)
-                        {
-                            addSucceed = mSerialReceiverBuffer.PushBack((uint8_t)data);
-                        }
-
-                        if(addSucceed)
-                        {
-                            TryParseMessagesFromBuffer();
-                        }
-                    }
-                    running = mThreadRunning.Get();
+                    //readable but nothing to read, the device is gone, do not spin.
+                    std::this_thread::sleep_for(std::chrono::milliseconds(SERIAL_WAIT_TIMEOUT));
+                    continue;
                 }
-                while(running == true);
+
+                mSerialReceiverBuffer.PushBack(readBuffer, bytesRead);
+
+                TryParseMessagesFromBuffer();
             }
+
             std::cerr << "Serial Reader Thread stopped!" << std::endl;
             mInterfaceImplementation.Flush();
             mInterfaceImplementation.Close();
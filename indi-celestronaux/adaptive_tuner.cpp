@@ -1,5 +1,4 @@
 #include "adaptive_tuner.h"
-#include <numeric> // for std::accumulate
 #include <algorithm> // for std::min, std::max
 #include <iostream> // For temporary debugging
 
@@ -58,10 +57,13 @@ void AdaptivePIDTuner::setHistorySize(size_t size)
     m_history_size = std::max(static_cast<size_t>(10), size); // Need some minimum history
     m_min_data_for_tuning = std::max(static_cast<size_t>(10), m_history_size / 2); // Update this too
 
-    // Trim histories if they are now too long
-    while (m_error_history.size() > m_history_size) m_error_history.pop_front();
-    while (m_plant_output_history.size() > m_history_size) m_plant_output_history.pop_front();
-    while (m_setpoint_history.size() > m_history_size) m_setpoint_history.pop_front();
+    // Trim history if it is now too long
+    while (m_error_history.size() > m_history_size) popError();
+}
+
+void AdaptivePIDTuner::setSampleTime(double dt)
+{
+    m_dt = std::max(0.001, dt);
 }
 
 void AdaptivePIDTuner::startActiveTuning()
@@ -94,8 +96,10 @@ void AdaptivePIDTuner::reset()
 
     // Reset history
     m_error_history.clear();
-    m_plant_output_history.clear();
-    m_setpoint_history.clear();
+    m_error_sum = 0.0;
+    m_error_sq_sum = 0.0;
+    m_error_sign_changes = 0;
+    m_samples_since_refresh = 0;
 
     // Reset flags
     // m_is_tuning_active is user-controlled, don't reset here unless intended
@@ -123,14 +127,12 @@ void AdaptivePIDTuner::processMeasurement(double setpoint_r, double plant_output
     // 2. Calculate adaptation error
     double error_adapt = plant_output_yp - m_ref_x1; // y_p - y_m
 
-    // 3. Store in history buffers
-    m_error_history.push_back(error_adapt);
-    m_plant_output_history.push_back(plant_output_yp);
-    m_setpoint_history.push_back(setpoint_r);
+    // 3. Store in history buffer
+    pushError(error_adapt);
+    while (m_error_history.size() > m_history_size) popError();
 
-    while (m_error_history.size() > m_history_size) m_error_history.pop_front();
-    while (m_plant_output_history.size() > m_history_size) m_plant_output_history.pop_front();
-    while (m_setpoint_history.size() > m_history_size) m_setpoint_history.pop_front();
+    if (++m_samples_since_refresh >= m_history_size)
+        refreshErrorStatistics();
 
     // 4. Check if enough data gathered
     if (m_is_tuning_active && !m_has_gathered_sufficient_data)
@@ -166,36 +168,50 @@ void AdaptivePIDTuner::getCurrentReferenceModelOutput(double &outYm) const
 
 // --- Helper methods for analysis ---
 
-double AdaptivePIDTuner::calculateMean(const std::deque<double> &data) const
+void AdaptivePIDTuner::pushError(double error)
 {
-    if (data.empty()) return 0.0;
-    double sum = std::accumulate(data.begin(), data.end(), 0.0);
-    return sum / data.size();
+    if (!m_error_history.empty() && isSignChange(m_error_history.back(), error))
+        m_error_sign_changes++;
+    m_error_history.push_back(error);
+    m_error_sum += error;
+    m_error_sq_sum += error * error;
 }
 
-double AdaptivePIDTuner::calculateStdDev(const std::deque<double> &data, double mean) const
+void AdaptivePIDTuner::popError()
 {
-    if (data.size() < 2) return 0.0;
-    double sq_sum = 0.0;
-    for (double val : data)
-    {
-        sq_sum += (val - mean) * (val - mean);
-    }
-    return std::sqrt(sq_sum / (data.size() - 1)); // Sample standard deviation
+    double error = m_error_history.front();
+    m_error_history.pop_front();
+    if (!m_error_history.empty() && isSignChange(error, m_error_history.front()))
+        m_error_sign_changes--;
+    m_error_sum -= error;
+    m_error_sq_sum -= error * error;
 }
 
-int AdaptivePIDTuner::countSignChanges(const std::deque<double> &data) const
+void AdaptivePIDTuner::refreshErrorStatistics()
 {
-    if (data.size() < 2) return 0;
-    int changes = 0;
-    for (size_t i = 0; i < data.size() - 1; ++i)
+    m_error_sum = 0.0;
+    m_error_sq_sum = 0.0;
+    for (double val : m_error_history)
     {
-        if ((data[i] > 0 && data[i + 1] < 0) || (data[i] < 0 && data[i + 1] > 0))
-        {
-            changes++;
-        }
+        m_error_sum += val;
+        m_error_sq_sum += val * val;
     }
-    return changes;
+    m_samples_since_refresh = 0;
+}
+
+double AdaptivePIDTuner::errorMean() const
+{
+    if (m_error_history.empty()) return 0.0;
+    return m_error_sum / m_error_history.size();
+}
+
+double AdaptivePIDTuner::errorStdDev(double mean) const
+{
+    size_t n = m_error_history.size();
+    if (n < 2) return 0.0;
+    // Sample standard deviation from the running sums, clamped against rounding below zero
+    double variance = (m_error_sq_sum - n * mean * mean) / (n - 1);
+    return std::sqrt(std::max(0.0, variance));
 }
 
 // This is the core heuristic logic - needs careful design and testing
@@ -204,9 +220,9 @@ void AdaptivePIDTuner::analyzeErrorAndAdjustGains()
     if (m_error_history.size() < m_min_data_for_tuning) return;
 
     // Characteristics of the adaptation error (e_adapt = plant_output - model_output)
-    double error_mean   = calculateMean(m_error_history);
-    double error_stddev = calculateStdDev(m_error_history, error_mean);
-    int error_oscillations = countSignChanges(m_error_history);
+    double error_mean   = errorMean();
+    double error_stddev = errorStdDev(error_mean);
+    int error_oscillations = m_error_sign_changes;
 
     // Characteristics of the plant output (yp) relative to setpoint (r)
     // This can give clues about overall system performance, not just model following.
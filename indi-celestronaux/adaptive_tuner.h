@@ -19,6 +19,7 @@ class AdaptivePIDTuner
         void setAdaptationStepSizes(double stepKp, double stepKi, double stepKd);
         void setAdaptationAggressiveness(double aggressiveness); // General tuning parameter for step sizes
         void setHistorySize(size_t size); // How many samples to keep for analysis
+        void setSampleTime(double dt);
 
         void startActiveTuning();
         void stopActiveTuning();
@@ -63,10 +64,14 @@ class AdaptivePIDTuner
         double m_stepKd { 0.001 };
         double m_aggressiveness { 1.0 }; // Multiplier for step sizes
 
-        // History buffers for analysis
-        std::deque<double> m_error_history;      // e_adapt = plant_output_yp - y_m
-        std::deque<double> m_plant_output_history; // yp
-        std::deque<double> m_setpoint_history;     // r
+        // History buffer for analysis, e_adapt = plant_output_yp - y_m
+        // The statistics are kept up to date as samples enter and leave the window,
+        // so the analysis costs O(1) per measurement regardless of the history size.
+        std::deque<double> m_error_history;
+        double m_error_sum { 0.0 };
+        double m_error_sq_sum { 0.0 };
+        int m_error_sign_changes { 0 };
+        size_t m_samples_since_refresh { 0 }; // Running sums are recomputed once per window to bound rounding drift
         size_t m_history_size { 100 }; // e.g., 10 seconds of data if dt = 0.1s
         size_t m_min_data_for_tuning { 50 }; // Need at least this much data to start tuning
 
@@ -75,7 +80,13 @@ class AdaptivePIDTuner
 
         // Helper methods for analysis (to be implemented in .cpp)
         void analyzeErrorAndAdjustGains();
-        double calculateMean(const std::deque<double> &data) const;
-        double calculateStdDev(const std::deque<double> &data, double mean) const;
-        int countSignChanges(const std::deque<double> &data) const;
+        void pushError(double error);
+        void popError();
+        void refreshErrorStatistics();
+        double errorMean() const;
+        double errorStdDev(double mean) const;
+        static bool isSignChange(double a, double b)
+        {
+            return (a > 0 && b < 0) || (a < 0 && b > 0);
+        }
 };
@@ -42,6 +42,94 @@
 using namespace INDI::AlignmentSubsystem;
 
 static constexpr double MIN_TRACK_RATE_FACTOR = 0.1; // Factor to ensure track rate doesn't go below a certain threshold of predicted rate
+static constexpr double SIDEREAL_RATE_RAD = 7.2921159e-5; // Earth rotation in rad/s
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Direction of a fixed star in the horizontal frame (north, east, up) and its first
+/// and second time derivatives. Hour angle, declination and latitude in radians.
+/////////////////////////////////////////////////////////////////////////////////////
+static void horizontalVector(double ha, double dec, double lat, double v[3], double dv[3], double d2v[3])
+{
+    const double omega = SIDEREAL_RATE_RAD;
+    const double cd = std::cos(dec), sd = std::sin(dec);
+    const double cl = std::cos(lat), sl = std::sin(lat);
+    const double ch = std::cos(ha), sh = std::sin(ha);
+
+    v[0] = cl * sd - sl * cd * ch;
+    v[1] = -cd * sh;
+    v[2] = sl * sd + cl * cd * ch;
+
+    dv[0] = omega * sl * cd * sh;
+    dv[1] = -omega * cd * ch;
+    dv[2] = -omega * cl * cd * sh;
+
+    d2v[0] = omega * omega * sl * cd * ch;
+    d2v[1] = omega * omega * cd * sh;
+    d2v[2] = -omega * omega * cl * cd * ch;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Azimuth and altitude of a (not necessarily normalized) direction vector with their
+/// first and second time derivatives, all in radians. azSign selects the azimuth
+/// direction of the vector frame.
+/////////////////////////////////////////////////////////////////////////////////////
+static void angularMotion(const double w[3], const double dw[3], const double d2w[3], double azSign,
+                          double angle[2], double rate[2], double acceleration[2])
+{
+    // azimuth = atan2(azSign * y, x)
+    const double rho2  = w[0] * w[0] + w[1] * w[1];
+    const double cross = w[0] * dw[1] - w[1] * dw[0];
+    const double dcross = w[0] * d2w[1] - w[1] * d2w[0];
+    const double drho2 = 2 * (w[0] * dw[0] + w[1] * dw[1]);
+
+    angle[0] = std::atan2(azSign * w[1], w[0]);
+    rate[0] = azSign * cross / rho2;
+    acceleration[0] = azSign * (dcross * rho2 - cross * drho2) / (rho2 * rho2);
+
+    // altitude = atan2(z, rho)
+    const double rho = std::sqrt(rho2);
+    const double drho = (w[0] * dw[0] + w[1] * dw[1]) / rho;
+    const double d2rho = (dw[0] * dw[0] + w[0] * d2w[0] + dw[1] * dw[1] + w[1] * d2w[1] - drho * drho) / rho;
+    const double num = rho * dw[2] - w[2] * drho;
+    const double dnum = rho * d2w[2] - w[2] * d2rho;
+    const double den = rho2 + w[2] * w[2];
+    const double dden = 2 * (rho * drho + w[2] * dw[2]);
+
+    angle[1] = std::atan2(w[2], rho);
+    rate[1] = num / den;
+    acceleration[1] = (dnum * den - num * dden) / (den * den);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// result = a * b
+/////////////////////////////////////////////////////////////////////////////////////
+static void multiply(const double a[3][3], const double b[3], double result[3])
+{
+    for (int i = 0; i < 3; i++)
+        result[i] = a[i][0] * b[0] + a[i][1] * b[1] + a[i][2] * b[2];
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Inverse of a 3x3 matrix, false if it is singular.
+/////////////////////////////////////////////////////////////////////////////////////
+static bool invert(const double m[3][3], double inverse[3][3])
+{
+    const double det = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                       - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                       + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    if (std::fabs(det) < 1e-12)
+        return false;
+
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+        {
+            // cofactor of m[j][i]
+            const int r1 = (j + 1) % 3, r2 = (j + 2) % 3;
+            const int c1 = (i + 1) % 3, c2 = (i + 2) % 3;
+            inverse[i][j] = (m[r1][c1] * m[r2][c2] - m[r1][c2] * m[r2][c1]) / det;
+        }
+    return true;
+}
 
 static std::unique_ptr<CelestronAUX> telescope_caux(new CelestronAUX());
 
@@ -98,6 +186,8 @@ CelestronAUX::CelestronAUX()
         GuideNSNP.setState(IPS_IDLE);
         GuideNSNP.apply();
     });
+
+    m_TrackingTimer.callOnTimeout(std::bind(&CelestronAUX::trackingLoop, this));
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -182,7 +272,7 @@ bool CelestronAUX::Handshake()
         // Initialize PID Tuners if in Alt-Az mode
         if (m_MountType == ALT_AZ)
         {
-            double dt = getPollingPeriod() / 1000.0;
+            double dt = TrackingPeriodNP[0].getValue() / 1000.0;
             // Default reference model: omega_n = 0.5 rad/s, zeta = 1.0 (critically damped)
             // These values might need tuning based on mount characteristics.
             double ref_omega_n = 0.5;
@@ -210,6 +300,8 @@ bool CelestronAUX::Handshake()
                 m_az_pid_tuner->startActiveTuning();
             if (AdaptiveTuningAlSP[INDI_ENABLED].s == ISS_ON)
                 m_al_pid_tuner->startActiveTuning();
+
+            m_TrackingTimer.start(TrackingPeriodNP[0].getValue());
         }
 
         return true;
@@ -226,6 +318,7 @@ bool CelestronAUX::Handshake()
 /////////////////////////////////////////////////////////////////////////////////////
 bool CelestronAUX::Disconnect()
 {
+    m_TrackingTimer.stop();
     Abort();
     return INDI::Telescope::Disconnect();
 }
@@ -417,6 +510,15 @@ bool CelestronAUX::initProperties()
     AngleNP[AXIS_ALT].fill("AXIS_ALT", "Axis 2", "%.2f", -90, 90, 0, 0);
     AngleNP.fill(getDeviceName(), "TELESCOPE_ENCODER_ANGLES", "Angles", MOUNTINFO_TAB, IP_RO, 60, IPS_IDLE);
 
+    // Alt-Az tracking loop
+    TrackingPeriodNP[0].fill("PERIOD", "Period (ms)", "%.f", 50, 2000, 50, 250);
+    TrackingPeriodNP.fill(getDeviceName(), "TRACKING_PERIOD", "Tracking Loop", MOUNTINFO_TAB, IP_RW, 60, IPS_IDLE);
+    TrackingPeriodNP.load();
+
+    TrackingErrorNP[AXIS_AZ].fill("AXIS_AZ", "Axis 1 (arcsec)", "%.1f", -3600, 3600, 0, 0);
+    TrackingErrorNP[AXIS_ALT].fill("AXIS_ALT", "Axis 2 (arcsec)", "%.1f", -3600, 3600, 0, 0);
+    TrackingErrorNP.fill(getDeviceName(), "TRACKING_ERROR", "Tracking Error", MOUNTINFO_TAB, IP_RO, 60, IPS_IDLE);
+
     // PID Control
     Axis1PIDNP[Propotional].fill("Propotional", "Propotional", "%.2f", 0, 500, 10, 0);
     Axis1PIDNP[Derivative].fill("Derivative", "Derivative", "%.2f", 0, 500, 10, 0);
@@ -590,6 +692,8 @@ bool CelestronAUX::updateProperties()
         defineProperty(AngleNP);
         if (m_MountType == ALT_AZ)
         {
+            defineProperty(TrackingPeriodNP);
+            defineProperty(TrackingErrorNP);
             defineProperty(Axis1PIDNP);
             defineProperty(Axis2PIDNP);
             defineProperty(AdaptiveTuningAzSP);
@@ -754,6 +858,8 @@ bool CelestronAUX::updateProperties()
 
         if (m_MountType == ALT_AZ)
         {
+            deleteProperty(TrackingPeriodNP);
+            deleteProperty(TrackingErrorNP);
             deleteProperty(Axis1PIDNP);
             deleteProperty(Axis2PIDNP);
             deleteProperty(AdaptiveTuningAzSP);
@@ -790,6 +896,7 @@ bool CelestronAUX::saveConfigItems(FILE *fp)
 
     if (m_MountType == ALT_AZ)
     {
+        TrackingPeriodNP.save(fp);
         Axis1PIDNP.save(fp);
         Axis2PIDNP.save(fp);
         AdaptiveTuningAzSP.save(fp);
@@ -822,6 +929,7 @@ bool CelestronAUX::ISNewBLOB(const char *dev, const char *name, int sizes[], int
     {
         // Process alignment properties
         ProcessAlignmentBLOBProperties(this, name, sizes, blobsizes, blobs, formats, names, n);
+        m_TrackingModel.valid = false;
     }
     // Pass it up the chain
     return INDI::Telescope::ISNewBLOB(dev, name, sizes, blobsizes, blobs, formats, names, n);
@@ -841,6 +949,26 @@ bool CelestronAUX::ISNewNumber(const char *dev, const char *name, double values[
 
     if (strcmp(dev, getDeviceName()) == 0)
     {
+        // Tracking loop period
+        if (TrackingPeriodNP.isNameMatch(name))
+        {
+            TrackingPeriodNP.update(values, names, n);
+            double dt = TrackingPeriodNP[0].getValue() / 1000.0;
+            if (m_az_pid_tuner)
+                m_az_pid_tuner->setSampleTime(dt);
+            if (m_al_pid_tuner)
+                m_al_pid_tuner->setSampleTime(dt);
+            // restart the controllers with the new sample time
+            if (TrackState == SCOPE_TRACKING)
+                resetTracking();
+            if (m_TrackingTimer.isActive())
+                m_TrackingTimer.start(TrackingPeriodNP[0].getValue());
+            TrackingPeriodNP.setState(IPS_OK);
+            TrackingPeriodNP.apply();
+            saveConfig(true, TrackingPeriodNP.getName());
+            return true;
+        }
+
         // Axis1 PID
         if (Axis1PIDNP.isNameMatch(name))
         {
@@ -943,6 +1071,7 @@ bool CelestronAUX::ISNewNumber(const char *dev, const char *name, double values[
 
         // Process Alignment Properties
         ProcessAlignmentNumberProperties(this, name, values, names, n);
+        m_TrackingModel.valid = false;
 
     }
 
@@ -1163,6 +1292,7 @@ bool CelestronAUX::ISNewSwitch(const char *dev, const char *name, ISState *state
 
         // Process alignment properties
         ProcessAlignmentSwitchProperties(this, name, states, names, n);
+        m_TrackingModel.valid = false;
 
         // Process Focus Properties
         if (strstr(name, "FOCUS_"))
@@ -1181,7 +1311,10 @@ bool CelestronAUX::ISNewSwitch(const char *dev, const char *name, ISState *state
 bool CelestronAUX::ISNewText(const char *dev, const char *name, char *texts[], char *names[], int n)
 {
     if (!strcmp(dev, getDeviceName()))
+    {
         ProcessAlignmentTextProperties(this, name, texts, names, n);
+        m_TrackingModel.valid = false;
+    }
 
     return INDI::Telescope::ISNewText(dev, name, texts, names, n);
 }
@@ -1454,10 +1587,11 @@ void CelestronAUX::resetTracking()
     //    m_TrackStartSteps[AXIS_AZ] = EncoderNP[AXIS_AZ].getValue();
     //    m_TrackStartSteps[AXIS_ALT] = EncoderNP[AXIS_ALT].getValue();
 
-    m_Controllers[AXIS_AZ].reset(new PID(getPollingPeriod() / 1000.0, 10000, -10000, Axis1PIDNP[Propotional].getValue(),
+    double dt = TrackingPeriodNP[0].getValue() / 1000.0;
+    m_Controllers[AXIS_AZ].reset(new PID(dt, 10000, -10000, Axis1PIDNP[Propotional].getValue(),
                                          Axis1PIDNP[Derivative].getValue(), Axis1PIDNP[Integral].getValue()));
     m_Controllers[AXIS_AZ]->setIntegratorLimits(-10000, 10000);
-    m_Controllers[AXIS_ALT].reset(new PID(getPollingPeriod() / 1000.0, 10000, -10000, Axis2PIDNP[Propotional].getValue(),
+    m_Controllers[AXIS_ALT].reset(new PID(dt, 10000, -10000, Axis2PIDNP[Propotional].getValue(),
                                           Axis2PIDNP[Derivative].getValue(), Axis2PIDNP[Integral].getValue()));
     m_Controllers[AXIS_ALT]->setIntegratorLimits(-10000, 10000);
 
@@ -1478,6 +1612,9 @@ void CelestronAUX::resetTracking()
 
     m_TrackingElapsedTimer.restart();
     m_GuideOffset[AXIS_AZ] = m_GuideOffset[AXIS_ALT] = 0;
+
+    // target or alignment may have changed
+    m_TrackingModel.valid = false;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -2019,215 +2156,19 @@ void CelestronAUX::TimerHit()
             break;
 
         case SCOPE_TRACKING:
-        {
-            // Check if manual motion in progress but we stopped
-            if (m_ManualMotionActive && isSlewing() == false)
+            // Alt-Az mounts are actively tracked by trackingLoop, equatorial mounts track passively.
+            // If we slewed manually using NSWE keys, restart tracking at whatever point we are AT now.
+            if (m_MountType != ALT_AZ && m_ManualMotionActive && isSlewing() == false)
             {
                 m_ManualMotionActive = false;
-                // If we slewed manually using NSWE keys, then we need to restart tracking
-                // whatever point we are AT now. We need to update the SkyTrackingTarget accordingly.
                 m_SkyTrackingTarget.rightascension = EqNP[AXIS_RA].getValue();
                 m_SkyTrackingTarget.declination = EqNP[AXIS_DE].getValue();
                 resetTracking();
             }
-            // If we're manually moving by WESN controls, update the tracking coordinates.
-            if (m_ManualMotionActive)
-            {
-                break;
-            }
-            // We only engage ACTIVE tracking if the mount is Alt-Az.
-            // For Equatorial mount, we simply use user-selected tracking mode and let it passively track.
-            else if (m_MountType == ALT_AZ)
-            {
-                TelescopeDirectionVector TDV;
-                TelescopeDirectionVector futureTDV;
-                TelescopeDirectionVector pastTDV;
-                INDI::IHorizontalCoordinates targetMountAxisCoordinates { 0, 0 };
-                INDI::IHorizontalCoordinates pastMountAxisCoordinates { 0, 0 };
-                INDI::IHorizontalCoordinates futureMountAxisCoordinates { 0, 0 };
-                double timeStep { 5.0 }; // time step for tracking rate estimation in seconds
-                double JDoffset { timeStep / (60 * 60 * 24) } ; // The same in days
-
-                // Start by transforming tracking target celestial coordinates to telescope coordinates.
-                if (TransformCelestialToTelescope(m_SkyTrackingTarget.rightascension, m_SkyTrackingTarget.declination,
-                                                  0, TDV))
-                {
-                    // If mount is Alt-Az then that's all we need to do
-                    AltitudeAzimuthFromTelescopeDirectionVector(TDV, targetMountAxisCoordinates);
-                    TransformCelestialToTelescope(m_SkyTrackingTarget.rightascension, m_SkyTrackingTarget.declination,
-                                                  JDoffset, futureTDV);
-                    AltitudeAzimuthFromTelescopeDirectionVector(futureTDV, futureMountAxisCoordinates);
-                    TransformCelestialToTelescope(m_SkyTrackingTarget.rightascension, m_SkyTrackingTarget.declination,
-                                                  -JDoffset, pastTDV);
-                    AltitudeAzimuthFromTelescopeDirectionVector(pastTDV, pastMountAxisCoordinates);
-
-                }
-                // If transformation failed.
-                else
-                {
-                    double JDnow {ln_get_julian_from_sys()};
-                    INDI::IEquatorialCoordinates EquatorialCoordinates { 0, 0 };
-                    EquatorialCoordinates.rightascension  = m_SkyTrackingTarget.rightascension;
-                    EquatorialCoordinates.declination = m_SkyTrackingTarget.declination;
-                    INDI::EquatorialToHorizontal(&EquatorialCoordinates, &m_Location, JDnow, &targetMountAxisCoordinates);
-                    INDI::EquatorialToHorizontal(&EquatorialCoordinates, &m_Location, JDnow + JDoffset, &futureMountAxisCoordinates);
-                    INDI::EquatorialToHorizontal(&EquatorialCoordinates, &m_Location, JDnow - JDoffset, &pastMountAxisCoordinates);
-                }
-
-
-                // Calculate expected tracking rates
-                double predRate[2] = {0, 0};
-                // Central difference, error quadratic in timestep
-                // Rates in deg/s
-                predRate[AXIS_AZ] = range180(AzimuthToDegrees(futureMountAxisCoordinates.azimuth - pastMountAxisCoordinates.azimuth)) /
-                                    timeStep / 2;
-                predRate[AXIS_ALT] = (futureMountAxisCoordinates.altitude - pastMountAxisCoordinates.altitude) / timeStep / 2;
-
-                LOGF_DEBUG("Predicted positions (AZ):  %9.4f  %9.4f (now, future, degs)",
-                           AzimuthToDegrees(targetMountAxisCoordinates.azimuth),
-                           AzimuthToDegrees(futureMountAxisCoordinates.azimuth)) ;
-                LOGF_DEBUG("Predicted positions (AL):  %9.4f  %9.4f (now, future, degs)", targetMountAxisCoordinates.altitude,
-                           futureMountAxisCoordinates.altitude);
-                LOGF_DEBUG("Predicted Rates (AZ, ALT): %9.4f  %9.4f (arcsec/s)", 3600 * predRate[AXIS_AZ], 3600 * predRate[AXIS_ALT]);
-
-                // Rates in units 1024 * arcsec/s
-                // This is specific to Celestron AUX protocol
-                predRate[AXIS_AZ] = 3600 * predRate[AXIS_AZ] * 1024;
-                predRate[AXIS_ALT] = 3600 * predRate[AXIS_ALT] * 1024;
-
-                // Now add the guiding offsets.
-                    targetMountAxisCoordinates.azimuth += m_GuideOffset[AXIS_AZ];
-                    targetMountAxisCoordinates.altitude += m_GuideOffset[AXIS_ALT];
-
-                // If we had guiding pulses active, mark them as complete
-                if (GuideWENP.getState() == IPS_BUSY)
-                    GuideComplete(AXIS_RA);
-                if (GuideNSNP.getState() == IPS_BUSY)
-                    GuideComplete(AXIS_DE);
-
-                // Next get current alt-az
-                INDI::IHorizontalCoordinates currentAltAz { 0, 0 };
-                currentAltAz.azimuth = DegreesToAzimuth(EncodersToDegrees(EncoderNP[AXIS_AZ].getValue()));
-                currentAltAz.altitude = EncodersToDegrees(EncoderNP[AXIS_ALT].getValue());
-
-                // Offset in degrees
-                double offsetAngle[2] = {0, 0};
-                offsetAngle[AXIS_AZ] = range180(targetMountAxisCoordinates.azimuth - currentAltAz.azimuth);
-                offsetAngle[AXIS_ALT] = (targetMountAxisCoordinates.altitude - currentAltAz.altitude);
-
-                int32_t offsetSteps[2] = {0, 0};
-                int32_t targetSteps[2] = {0, 0};
-                double trackRates[2] = {0, 0};
-
-                offsetSteps[AXIS_AZ] = offsetAngle[AXIS_AZ] * STEPS_PER_DEGREE;
-                offsetSteps[AXIS_ALT] = offsetAngle[AXIS_ALT] * STEPS_PER_DEGREE;
-
-                // Only apply tracking IF we're still on the same side of the curve
-                // If we switch over, let's settle for a bit
-                /// AZ tracking
-                {
-                    if (m_az_pid_tuner && m_MountType == ALT_AZ) // Only for AltAz
-                    {
-                        double current_az_encoder = EncoderNP[AXIS_AZ].getValue();
-                        // Use the target that includes guide offsets for the reference model input
-                        double target_az_for_model = DegreesToEncoders(AzimuthToDegrees(targetMountAxisCoordinates.azimuth));
-                        m_az_pid_tuner->processMeasurement(target_az_for_model, current_az_encoder);
-
-                        if (m_az_pid_tuner->isActivelyTuning())
-                        {
-                            double newKp, newKi, newKd;
-                            m_az_pid_tuner->getAdaptedGains(newKp, newKi, newKd);
-                            m_Controllers[AXIS_AZ]->setKp(newKp);
-                            m_Controllers[AXIS_AZ]->setKi(newKi);
-                            m_Controllers[AXIS_AZ]->setKd(newKd);
-                            // Optionally update Axis1PIDNP if you want to see live values in client
-                            // Axis1PIDNP[Propotional].setValue(newKp);
-                            // Axis1PIDNP[Integral].setValue(newKi);
-                            // Axis1PIDNP[Derivative].setValue(newKd);
-                            // defineProperty(Axis1PIDNP); // Be careful with frequent updates
-                        }
-                    }
-
-                    m_OffsetSwitchSettle[AXIS_AZ] = 0; // Reset settle counter as in Skywatcher
-                    m_LastOffset[AXIS_AZ] = offsetSteps[AXIS_AZ];
-                    targetSteps[AXIS_AZ] = DegreesToEncoders(AzimuthToDegrees(targetMountAxisCoordinates.azimuth));
-                    // Track rate: predicted + PID controlled correction based on tracking error: offsetSteps
-                    trackRates[AXIS_AZ] = predRate[AXIS_AZ] + m_Controllers[AXIS_AZ]->calculate(0, -offsetSteps[AXIS_AZ]);
-
-                    // Apply minTrackRate logic from Skywatcher
-                    double minAzTrackRate = predRate[AXIS_AZ] * MIN_TRACK_RATE_FACTOR;
-                    if (trackRates[AXIS_AZ] * predRate[AXIS_AZ] < 0 || std::abs(trackRates[AXIS_AZ]) < std::abs(minAzTrackRate))
-                        trackRates[AXIS_AZ] = minAzTrackRate;
-
-                    LOGF_DEBUG("Predicted AZ Rate: %8.2f", predRate[AXIS_AZ]);
-                    LOGF_DEBUG("Tracking AZ Now: %8.f Target: %8d Offset: %8d Rate: %8.2f", EncoderNP[AXIS_AZ].getValue(), targetSteps[AXIS_AZ],
-                               offsetSteps[AXIS_AZ], trackRates[AXIS_AZ]);
-#ifdef DEBUG_PID
-                    LOGF_DEBUG("Tracking AZ P: %8.1f I: %8.1f D: %8.1f O: %8.1f",
-                               m_Controllers[AXIS_AZ]->propotionalTerm(),
-                               m_Controllers[AXIS_AZ]->integralTerm(),
-                               m_Controllers[AXIS_AZ]->derivativeTerm(),
-                               trackRates[AXIS_AZ] - predRate[AXIS_AZ]);
-#endif
-
-                    // Set the tracking rate
-                    trackByRate(AXIS_AZ, static_cast<int32_t>(trackRates[AXIS_AZ]));
-                }
-
-                /// Alt tracking
-                {
-                    if (m_al_pid_tuner && m_MountType == ALT_AZ) // Only for AltAz
-                    {
-                        double current_al_encoder = EncoderNP[AXIS_ALT].getValue();
-                        // Use the target that includes guide offsets for the reference model input
-                        double target_al_for_model = DegreesToEncoders(targetMountAxisCoordinates.altitude);
-                        m_al_pid_tuner->processMeasurement(target_al_for_model, current_al_encoder);
-
-                        if (m_al_pid_tuner->isActivelyTuning())
-                        {
-                            double newKp, newKi, newKd;
-                            m_al_pid_tuner->getAdaptedGains(newKp, newKi, newKd);
-                            m_Controllers[AXIS_ALT]->setKp(newKp);
-                            m_Controllers[AXIS_ALT]->setKi(newKi);
-                            m_Controllers[AXIS_ALT]->setKd(newKd);
-                            // Axis2PIDNP[Propotional].setValue(newKp);
-                            // Axis2PIDNP[Integral].setValue(newKi);
-                            // Axis2PIDNP[Derivative].setValue(newKd);
-                            // defineProperty(Axis2PIDNP);
-                        }
-                    }
-
-                    m_OffsetSwitchSettle[AXIS_ALT] = 0; // Reset settle counter as in Skywatcher
-                    m_LastOffset[AXIS_ALT] = offsetSteps[AXIS_ALT];
-                    targetSteps[AXIS_ALT]  = DegreesToEncoders(targetMountAxisCoordinates.altitude);
-                    // Track rate: predicted + PID controlled correction based on tracking error: offsetSteps
-                    trackRates[AXIS_ALT] = predRate[AXIS_ALT] + m_Controllers[AXIS_ALT]->calculate(0, -offsetSteps[AXIS_ALT]);
-
-                    // Apply minTrackRate logic from Skywatcher
-                    double minAlTrackRate = predRate[AXIS_ALT] * MIN_TRACK_RATE_FACTOR;
-                    if (trackRates[AXIS_ALT] * predRate[AXIS_ALT] < 0 || std::abs(trackRates[AXIS_ALT]) < std::abs(minAlTrackRate))
-                        trackRates[AXIS_ALT] = minAlTrackRate;
-
-                    LOGF_DEBUG("Predicted AL Rate: %8.2f", predRate[AXIS_ALT]);
-                    LOGF_DEBUG("Tracking AL Now: %8.f Target: %8d Offset: %8d Rate: %8.2f", EncoderNP[AXIS_ALT].getValue(),
-                               targetSteps[AXIS_ALT],
-                               offsetSteps[AXIS_ALT], trackRates[AXIS_ALT]);
-#ifdef DEBUG_PID
-                    LOGF_DEBUG("Tracking AL P: %8.1f I: %8.1f D: %8.1f O: %8.1f",
-                               m_Controllers[AXIS_ALT]->propotionalTerm(),
-                               m_Controllers[AXIS_ALT]->integralTerm(),
-                               m_Controllers[AXIS_ALT]->derivativeTerm(),
-                               trackRates[AXIS_ALT] - predRate[AXIS_ALT]);
-#endif
-                    trackByRate(AXIS_ALT, static_cast<int32_t>(trackRates[AXIS_ALT]));
-                }
-                break;
-            }
             break;
 
-            default:
-                break;
-            }
+        default:
+            break;
     }
 
     // Check if seeking index or leveling is done
@@ -2283,6 +2224,267 @@ void CelestronAUX::TimerHit()
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+///
+/////////////////////////////////////////////////////////////////////////////////////
+void CelestronAUX::trackingLoop()
+{
+    if (TrackState != SCOPE_TRACKING || m_MountType != ALT_AZ || !isConnected())
+        return;
+
+    // Check if manual motion in progress but we stopped
+    if (m_ManualMotionActive && isSlewing() == false)
+    {
+        m_ManualMotionActive = false;
+        // If we slewed manually using NSWE keys, then we need to restart tracking
+        // whatever point we are AT now. We need to update the SkyTrackingTarget accordingly.
+        m_SkyTrackingTarget.rightascension = EqNP[AXIS_RA].getValue();
+        m_SkyTrackingTarget.declination = EqNP[AXIS_DE].getValue();
+        resetTracking();
+    }
+    // If we're manually moving by WESN controls, update the tracking coordinates.
+    if (m_ManualMotionActive)
+        return;
+
+    // Fresh encoder positions, the status poll may be much slower than the tracking loop
+    if (!getEncoder(AXIS_AZ) || !getEncoder(AXIS_ALT))
+        return;
+
+    INDI::IHorizontalCoordinates targetMountAxisCoordinates { 0, 0 };
+    double rate[2] = {0, 0}, acceleration[2] = {0, 0};
+    predictTracking(targetMountAxisCoordinates, rate, acceleration);
+
+    // Feed forward the mean rate over the next period, deg/s
+    double period = TrackingPeriodNP[0].getValue() / 1000.0;
+    double predRate[2] = {0, 0};
+    predRate[AXIS_AZ] = rate[AXIS_AZ] + acceleration[AXIS_AZ] * period / 2;
+    predRate[AXIS_ALT] = rate[AXIS_ALT] + acceleration[AXIS_ALT] * period / 2;
+
+    LOGF_DEBUG("Predicted positions (AZ, AL): %9.4f  %9.4f (degs)", AzimuthToDegrees(targetMountAxisCoordinates.azimuth),
+               targetMountAxisCoordinates.altitude);
+    LOGF_DEBUG("Predicted Rates (AZ, ALT): %9.4f  %9.4f (arcsec/s)", 3600 * predRate[AXIS_AZ], 3600 * predRate[AXIS_ALT]);
+
+    // Rates in units 1024 * arcsec/s
+    // This is specific to Celestron AUX protocol
+    predRate[AXIS_AZ] = 3600 * predRate[AXIS_AZ] * 1024;
+    predRate[AXIS_ALT] = 3600 * predRate[AXIS_ALT] * 1024;
+
+    // Now add the guiding offsets.
+    targetMountAxisCoordinates.azimuth += m_GuideOffset[AXIS_AZ];
+    targetMountAxisCoordinates.altitude += m_GuideOffset[AXIS_ALT];
+
+    // If we had guiding pulses active, mark them as complete
+    if (GuideWENP.getState() == IPS_BUSY)
+        GuideComplete(AXIS_RA);
+    if (GuideNSNP.getState() == IPS_BUSY)
+        GuideComplete(AXIS_DE);
+
+    // Next get current alt-az
+    INDI::IHorizontalCoordinates currentAltAz { 0, 0 };
+    currentAltAz.azimuth = DegreesToAzimuth(EncodersToDegrees(EncoderNP[AXIS_AZ].getValue()));
+    currentAltAz.altitude = EncodersToDegrees(EncoderNP[AXIS_ALT].getValue());
+
+    // Offset in degrees
+    double offsetAngle[2] = {0, 0};
+    offsetAngle[AXIS_AZ] = range180(targetMountAxisCoordinates.azimuth - currentAltAz.azimuth);
+    offsetAngle[AXIS_ALT] = (targetMountAxisCoordinates.altitude - currentAltAz.altitude);
+
+    TrackingErrorNP[AXIS_AZ].setValue(offsetAngle[AXIS_AZ] * 3600);
+    TrackingErrorNP[AXIS_ALT].setValue(offsetAngle[AXIS_ALT] * 3600);
+    TrackingErrorNP.setState(IPS_OK);
+    TrackingErrorNP.apply();
+
+    int32_t offsetSteps[2] = {0, 0};
+    int32_t targetSteps[2] = {0, 0};
+    double trackRates[2] = {0, 0};
+
+    offsetSteps[AXIS_AZ] = offsetAngle[AXIS_AZ] * STEPS_PER_DEGREE;
+    offsetSteps[AXIS_ALT] = offsetAngle[AXIS_ALT] * STEPS_PER_DEGREE;
+
+    /// AZ tracking
+    {
+        if (m_az_pid_tuner)
+        {
+            double current_az_encoder = EncoderNP[AXIS_AZ].getValue();
+            // Use the target that includes guide offsets for the reference model input
+            double target_az_for_model = DegreesToEncoders(AzimuthToDegrees(targetMountAxisCoordinates.azimuth));
+            m_az_pid_tuner->processMeasurement(target_az_for_model, current_az_encoder);
+
+            if (m_az_pid_tuner->isActivelyTuning())
+            {
+                double newKp, newKi, newKd;
+                m_az_pid_tuner->getAdaptedGains(newKp, newKi, newKd);
+                m_Controllers[AXIS_AZ]->setKp(newKp);
+                m_Controllers[AXIS_AZ]->setKi(newKi);
+                m_Controllers[AXIS_AZ]->setKd(newKd);
+            }
+        }
+
+        m_OffsetSwitchSettle[AXIS_AZ] = 0; // Reset settle counter as in Skywatcher
+        m_LastOffset[AXIS_AZ] = offsetSteps[AXIS_AZ];
+        targetSteps[AXIS_AZ] = DegreesToEncoders(AzimuthToDegrees(targetMountAxisCoordinates.azimuth));
+        // Track rate: predicted + PID controlled correction based on tracking error: offsetSteps
+        trackRates[AXIS_AZ] = predRate[AXIS_AZ] + m_Controllers[AXIS_AZ]->calculate(0, -offsetSteps[AXIS_AZ]);
+
+        // Apply minTrackRate logic from Skywatcher
+        double minAzTrackRate = predRate[AXIS_AZ] * MIN_TRACK_RATE_FACTOR;
+        if (trackRates[AXIS_AZ] * predRate[AXIS_AZ] < 0 || std::abs(trackRates[AXIS_AZ]) < std::abs(minAzTrackRate))
+            trackRates[AXIS_AZ] = minAzTrackRate;
+
+        LOGF_DEBUG("Tracking AZ Now: %8.f Target: %8d Offset: %8d Rate: %8.2f", EncoderNP[AXIS_AZ].getValue(), targetSteps[AXIS_AZ],
+                   offsetSteps[AXIS_AZ], trackRates[AXIS_AZ]);
+#ifdef DEBUG_PID
+        LOGF_DEBUG("Tracking AZ P: %8.1f I: %8.1f D: %8.1f O: %8.1f",
+                   m_Controllers[AXIS_AZ]->propotionalTerm(),
+                   m_Controllers[AXIS_AZ]->integralTerm(),
+                   m_Controllers[AXIS_AZ]->derivativeTerm(),
+                   trackRates[AXIS_AZ] - predRate[AXIS_AZ]);
+#endif
+
+        // Set the tracking rate
+        trackByRate(AXIS_AZ, static_cast<int32_t>(trackRates[AXIS_AZ]));
+    }
+
+    /// Alt tracking
+    {
+        if (m_al_pid_tuner)
+        {
+            double current_al_encoder = EncoderNP[AXIS_ALT].getValue();
+            // Use the target that includes guide offsets for the reference model input
+            double target_al_for_model = DegreesToEncoders(targetMountAxisCoordinates.altitude);
+            m_al_pid_tuner->processMeasurement(target_al_for_model, current_al_encoder);
+
+            if (m_al_pid_tuner->isActivelyTuning())
+            {
+                double newKp, newKi, newKd;
+                m_al_pid_tuner->getAdaptedGains(newKp, newKi, newKd);
+                m_Controllers[AXIS_ALT]->setKp(newKp);
+                m_Controllers[AXIS_ALT]->setKi(newKi);
+                m_Controllers[AXIS_ALT]->setKd(newKd);
+            }
+        }
+
+        m_OffsetSwitchSettle[AXIS_ALT] = 0; // Reset settle counter as in Skywatcher
+        m_LastOffset[AXIS_ALT] = offsetSteps[AXIS_ALT];
+        targetSteps[AXIS_ALT]  = DegreesToEncoders(targetMountAxisCoordinates.altitude);
+        // Track rate: predicted + PID controlled correction based on tracking error: offsetSteps
+        trackRates[AXIS_ALT] = predRate[AXIS_ALT] + m_Controllers[AXIS_ALT]->calculate(0, -offsetSteps[AXIS_ALT]);
+
+        // Apply minTrackRate logic from Skywatcher
+        double minAlTrackRate = predRate[AXIS_ALT] * MIN_TRACK_RATE_FACTOR;
+        if (trackRates[AXIS_ALT] * predRate[AXIS_ALT] < 0 || std::abs(trackRates[AXIS_ALT]) < std::abs(minAlTrackRate))
+            trackRates[AXIS_ALT] = minAlTrackRate;
+
+        LOGF_DEBUG("Tracking AL Now: %8.f Target: %8d Offset: %8d Rate: %8.2f", EncoderNP[AXIS_ALT].getValue(),
+                   targetSteps[AXIS_ALT],
+                   offsetSteps[AXIS_ALT], trackRates[AXIS_ALT]);
+#ifdef DEBUG_PID
+        LOGF_DEBUG("Tracking AL P: %8.1f I: %8.1f D: %8.1f O: %8.1f",
+                   m_Controllers[AXIS_ALT]->propotionalTerm(),
+                   m_Controllers[AXIS_ALT]->integralTerm(),
+                   m_Controllers[AXIS_ALT]->derivativeTerm(),
+                   trackRates[AXIS_ALT] - predRate[AXIS_ALT]);
+#endif
+        trackByRate(AXIS_ALT, static_cast<int32_t>(trackRates[AXIS_ALT]));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// The target moves on a circle of constant declination, so its horizontal direction
+/// and derivatives are known in closed form. The cached model maps them to the mount,
+/// no alignment transformation or numerical differentiation is done per step.
+/////////////////////////////////////////////////////////////////////////////////////
+void CelestronAUX::predictTracking(INDI::IHorizontalCoordinates &position, double rate[2], double acceleration[2])
+{
+    if (!m_TrackingModel.valid || m_TrackingModel.age.elapsed() > TRACKING_MODEL_LIFETIME)
+        updateTrackingModel();
+
+    double ha = range24(get_local_sidereal_time(m_Location.longitude) - m_SkyTrackingTarget.rightascension);
+    double v[3], dv[3], d2v[3];
+    horizontalVector(DEG_TO_RAD(ha * 15), DEG_TO_RAD(m_SkyTrackingTarget.declination), DEG_TO_RAD(m_Location.latitude),
+                     v, dv, d2v);
+
+    double w[3], dw[3], d2w[3];
+    multiply(m_TrackingModel.matrix, v, w);
+    multiply(m_TrackingModel.matrix, dv, dw);
+    multiply(m_TrackingModel.matrix, d2v, d2w);
+
+    double angle[2];
+    angularMotion(w, dw, d2w, m_TrackingModel.azimuthSign, angle, rate, acceleration);
+
+    position.azimuth = range360(RAD_TO_DEG(angle[AXIS_AZ]));
+    position.altitude = RAD_TO_DEG(angle[AXIS_ALT]);
+    for (int axis = AXIS_AZ; axis <= AXIS_ALT; axis++)
+    {
+        rate[axis] = RAD_TO_DEG(rate[axis]);
+        acceleration[axis] = RAD_TO_DEG(acceleration[axis]);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+/// Transform three directions around the target and solve W = M * V for M.
+/////////////////////////////////////////////////////////////////////////////////////
+void CelestronAUX::updateTrackingModel()
+{
+    const double ra = m_SkyTrackingTarget.rightascension;
+    const double de = m_SkyTrackingTarget.declination;
+    const double samples[3][2] =
+    {
+        {ra, de},
+        {range24(ra + TRACKING_MODEL_SPAN / 15 / std::max(std::cos(DEG_TO_RAD(de)), 0.1)), de},
+        {ra, de > 0 ? de - TRACKING_MODEL_SPAN : de + TRACKING_MODEL_SPAN}
+    };
+
+    // Columns are the ideal horizontal (V) and the mount (W) directions of the samples
+    double V[3][3], W[3][3], inverse[3][3];
+    double lst = get_local_sidereal_time(m_Location.longitude);
+    bool success = true;
+    INDI::IHorizontalCoordinates sampleAltAz { 0, 0 };
+    for (int i = 0; i < 3 && success; i++)
+    {
+        double v[3], dv[3], d2v[3];
+        horizontalVector(DEG_TO_RAD(range24(lst - samples[i][0]) * 15), DEG_TO_RAD(samples[i][1]),
+                         DEG_TO_RAD(m_Location.latitude), v, dv, d2v);
+
+        TelescopeDirectionVector TDV;
+        success = TransformCelestialToTelescope(samples[i][0], samples[i][1], 0, TDV);
+        if (i == 0 && success)
+            AltitudeAzimuthFromTelescopeDirectionVector(TDV, sampleAltAz);
+
+        const double w[3] = {TDV.x, TDV.y, TDV.z};
+        for (int row = 0; row < 3; row++)
+        {
+            V[row][i] = v[row];
+            W[row][i] = w[row];
+        }
+    }
+
+    if (success && invert(V, inverse))
+    {
+        for (int row = 0; row < 3; row++)
+            for (int column = 0; column < 3; column++)
+                m_TrackingModel.matrix[row][column] = W[row][0] * inverse[0][column] + W[row][1] * inverse[1][column] +
+                                                      W[row][2] * inverse[2][column];
+
+        // Match the azimuth direction of the alignment subsystem
+        double azimuth = RAD_TO_DEG(std::atan2(W[1][0], W[0][0]));
+        m_TrackingModel.azimuthSign = std::fabs(range180(azimuth - sampleAltAz.azimuth)) <=
+                                      std::fabs(range180(-azimuth - sampleAltAz.azimuth)) ? 1 : -1;
+    }
+    else
+    {
+        // Without alignment the mount follows the ideal horizontal coordinates
+        LOG_DEBUG("Tracking model: alignment transformation failed, using ideal horizontal coordinates.");
+        for (int row = 0; row < 3; row++)
+            for (int column = 0; column < 3; column++)
+                m_TrackingModel.matrix[row][column] = row == column ? 1 : 0;
+        m_TrackingModel.azimuthSign = 1;
+    }
+
+    m_TrackingModel.valid = true;
+    m_TrackingModel.age.restart();
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 ///
 /////////////////////////////////////////////////////////////////////////////////////
@@ -2290,6 +2492,7 @@ bool CelestronAUX::updateLocation(double latitude, double longitude, double elev
 {
     // Update INDI Alignment Subsystem Location
     UpdateLocation(latitude, longitude, elevation);
+    m_TrackingModel.valid = false;
 
     // Do we really need this in update Location??
     // take care of latitude for north or south emisphere
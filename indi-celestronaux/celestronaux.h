@@ -197,6 +197,25 @@ class CelestronAUX :
         bool SetTrackRate(double raRate, double deRate) override;
         void resetTracking();
 
+        /**
+         * @brief trackingLoop Alt-Az closed loop tracking step, runs on its own timer at the tracking period.
+         */
+        void trackingLoop();
+
+        /**
+         * @brief predictTracking Position, rate and acceleration of the tracking target in mount coordinates.
+         * @param position Mount Alt-Az of the target now.
+         * @param rate Axis rates in degrees/s.
+         * @param acceleration Axis accelerations in degrees/s^2.
+         */
+        void predictTracking(INDI::IHorizontalCoordinates &position, double rate[2], double acceleration[2]);
+
+        /**
+         * @brief updateTrackingModel Fit the sky to mount transformation around the tracking target.
+         * This is the only place the tracking loop calls the alignment subsystem.
+         */
+        void updateTrackingModel();
+
         /**
          * @brief TrackByRate Set axis tracking rate in arcsecs/sec.
          * @param axis AZ or ALT
@@ -306,6 +325,19 @@ class CelestronAUX :
 
         INDI::ElapsedTimer m_TrackingElapsedTimer;
         INDI::Timer m_GuideRATimer, m_GuideDETimer;
+        INDI::Timer m_TrackingTimer;
+
+        // Local linear model of the alignment transformation around the tracking target.
+        // Maps the ideal horizontal direction (north, east, up) of the target to the mount direction vector.
+        // It is refitted when the target or the alignment changes and when it gets old.
+        struct
+        {
+            bool valid {false};
+            double matrix[3][3] {};
+            // +1 if mount azimuth runs from x towards y, -1 otherwise
+            double azimuthSign {1};
+            INDI::ElapsedTimer age;
+        } m_TrackingModel;
 
 
         /////////////////////////////////////////////////////////////////////////////////////
@@ -426,6 +458,11 @@ class CelestronAUX :
         int32_t m_LastOffset[2] = {0, 0};
         int m_OffsetSwitchSettle[2] = {0, 0};
 
+        // Tracking loop period
+        INDI::PropertyNumber TrackingPeriodNP {1};
+        // Tracking error in arcsecs
+        INDI::PropertyNumber TrackingErrorNP {2};
+
         // PID controllers
         INDI::PropertyNumber Axis1PIDNP {3};
         INDI::PropertyNumber Axis2PIDNP {3};
@@ -502,6 +539,9 @@ class CelestronAUX :
         static constexpr uint16_t AUX_LUNAR {0xfffd};
         // GEM Home Position
         static constexpr uint32_t GEM_HOME {4194304};
+        // Tracking model: refit interval (ms) and spread of the fitted directions (degrees)
+        static constexpr uint32_t TRACKING_MODEL_LIFETIME {300000};
+        static constexpr double TRACKING_MODEL_SPAN {2.0};
 
 
 };
@@ -0,0 +1,87 @@
+#!/bin/env python3
+
+# Record the alt-az tracking error reported by the driver while it tracks
+# the simulator, write it to CSV and optionally plot it.
+#
+#   track_error_plot.py [-d device] [-t seconds] [-i interval] [-o file.csv] [-p]
+#
+# The driver publishes TRACKING_ERROR on every tracking loop step, the
+# error is read with indi_getprop so no python INDI bindings are needed.
+
+import argparse
+import csv
+import subprocess
+import sys
+import time
+
+
+def read_error(device, host, port):
+    prop = '%s.TRACKING_ERROR.*' % device
+    try:
+        out = subprocess.run(['indi_getprop', '-h', host, '-p', str(port), '-1', prop],
+                             capture_output=True, text=True, timeout=5).stdout
+    except (OSError, subprocess.TimeoutExpired):
+        return None
+    # One "device.property.element=value" per line, the device name may contain spaces
+    values = {}
+    for line in out.splitlines():
+        name, sep, value = line.partition('=')
+        if not sep:
+            continue
+        try:
+            values[name.rsplit('.', 1)[-1]] = float(value)
+        except ValueError:
+            continue
+    if 'AXIS_AZ' not in values or 'AXIS_ALT' not in values:
+        return None
+    return values['AXIS_AZ'], values['AXIS_ALT']
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Record Celestron AUX tracking error.')
+    parser.add_argument('-d', '--device', default='Celestron AUX')
+    parser.add_argument('--host', default='localhost')
+    parser.add_argument('--port', type=int, default=7624)
+    parser.add_argument('-t', '--time', type=float, default=600, help='duration in seconds')
+    parser.add_argument('-i', '--interval', type=float, default=0.5, help='sampling interval in seconds')
+    parser.add_argument('-o', '--output', default='track_error.csv')
+    parser.add_argument('-p', '--plot', action='store_true', help='plot the error with matplotlib')
+    args = parser.parse_args()
+
+    samples = []
+    start = time.time()
+    while time.time() - start < args.time:
+        error = read_error(args.device, args.host, args.port)
+        if error is not None:
+            samples.append((time.time() - start,) + error)
+        time.sleep(args.interval)
+
+    if not samples:
+        print('No TRACKING_ERROR received, is the mount tracking in Alt-Az mode?')
+        return 1
+
+    with open(args.output, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['time', 'az_arcsec', 'alt_arcsec'])
+        writer.writerows(samples)
+
+    for axis, name in ((1, 'AZ'), (2, 'ALT')):
+        errors = [s[axis] for s in samples]
+        rms = (sum(e * e for e in errors) / len(errors)) ** 0.5
+        print('%-3s rms %7.2f"  max %7.2f"' % (name, rms, max(abs(e) for e in errors)))
+
+    if args.plot:
+        import matplotlib.pyplot as plt
+        t = [s[0] for s in samples]
+        plt.plot(t, [s[1] for s in samples], label='AZ')
+        plt.plot(t, [s[2] for s in samples], label='ALT')
+        plt.xlabel('time (s)')
+        plt.ylabel('tracking error (arcsec)')
+        plt.legend()
+        plt.grid()
+        plt.show()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
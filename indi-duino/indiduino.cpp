@@ -92,7 +92,8 @@ void indiduino::TimerHit()
     if (isConnected() == false)
         return;
 
-    sf->OnIdle();
+    if (sf->OnIdle() < 0)
+        LOG_DEBUG("Firmata: error reading from port");
 
     for (const auto &it: *getProperties())
     {
@@ -379,9 +380,21 @@ bool indiduino::Handshake()
         return false;
     }
 
+    // Parse incoming messages in the background so TimerHit only reads the pin table
+    sf->startReader();
+
     return true;
 }
 
+bool indiduino::Disconnect()
+{
+    // The port is closed by the connection plugin, the reader must be done with it by then
+    if (sf)
+        sf->stopReader();
+
+    return INDI::DefaultDevice::Disconnect();
+}
+
 bool indiduino::updateProperties()
 {
     if (isConnected())
@@ -397,6 +410,7 @@ bool indiduino::updateProperties()
             LOG_ERROR("Failed to get Arduino state");
             getSwitch("CONNECTION").apply("Fail to get Arduino state");
             delete sf;
+            sf = NULL;
             this->serialConnection->Disconnect();
             return false;
         }
@@ -408,6 +422,7 @@ bool indiduino::updateProperties()
             LOG_ERROR("Failed to map Arduino pins, check skeleton file syntax.");
             getSwitch("CONNECTION").apply("Failed to map Arduino pins, check skeleton file syntax.");
             delete sf;
+            sf = NULL;
             this->serialConnection->Disconnect();
             return false;
         }
@@ -88,6 +88,7 @@ class indiduino : public INDI::DefaultDevice
 
   protected:
     virtual const char *getDefaultName() override;
+    virtual bool Disconnect() override;
     /* Switch only for testing
     ISwitch TestStateS[2];
     ISwitchVectorProperty TestStateSP;
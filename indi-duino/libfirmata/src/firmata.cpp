@@ -15,6 +15,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctime>
+#include <chrono>
 
 void (*firmata_debug_cb)(const char *file, int line, const char *msg, ...) = NULL;
 
@@ -44,6 +45,7 @@ Firmata::Firmata(int fd)
 
 Firmata::~Firmata()
 {
+    stopReader();
     delete arduino;
 }
 
@@ -83,7 +85,7 @@ int Firmata::writeDigitalPin(unsigned char pin, unsigned char mode)
 
     rv |= arduino->sendUchar(FIRMATA_DIGITAL_MESSAGE + port);
     rv |= sendValueAsTwo7bitBytes(digitalPortValue[port]); //ARDUINO_HIGH OR ARDUINO_LOW
-    LOGF_DEBUG("Sending DIGITAL_MESSAGE pin:%d, mode:%d, port:%d, port_val:%02X", pin, mode, port, digitalPortValue[port]);
+    LOGF_DEBUG("Sending DIGITAL_MESSAGE pin:%d, mode:%d, port:%d, port_val:%02X", pin, mode, port, digitalPortValue[port].load());
     return (rv);
 }
 
@@ -263,11 +265,9 @@ int Firmata::askPinStateWaitForReply(int pin)
 {
     OnIdle();
     pin_info[pin].mode = 0xff;
-    for (int i = 0; i < 100; i++) { // 1s
-        if (i % 10 == 0) askPinState(pin); // try again every 0.1 second
-        OnIdle(); // 10ms
-        if (pin_info[pin].mode != 0xff) break;
-    }
+    // wait up to 1s, try again every 0.1 second
+    waitForReply([this, pin] { return pin_info[pin].mode != 0xff; },
+                 [this, pin] { return askPinState(pin); }, 1000, 100);
     if (pin_info[pin].mode == 0xff) {
         pin_info[pin].mode = FIRMATA_MODE_INPUT;
         return -1;
@@ -301,16 +301,14 @@ int Firmata::init(int fd)
 
 int Firmata::handshake()
 {
+    have_firmata_name = false;
     firmata_name[0] = 0;
 
-    for (int i = 0; i < 3000; i++) // 30s
-    {
-        if (i % 50 == 0) askFirmwareVersion(); // try again every 0.5s
-        OnIdle(); // wait 10ms
-        if (strlen(firmata_name) > 0) break;
-    }
+    // wait up to 30s, try again every 0.5s
+    waitForReply([this] { return hasFirmataName(); },
+                 [this] { return askFirmwareVersion(); }, 30000, 500);
 
-    if (strlen(firmata_name) == 0) return 1;
+    if (!hasFirmataName()) return 1;
 
     char *requested_name = getenv("INDIDUINO_CHECK_FIRMWARE");
     if (requested_name && strcmp(firmata_name, requested_name) != 0) {
@@ -328,17 +326,12 @@ int Firmata::initState()
     for (int i = 0; i < ARDUINO_DIG_PORTS; i++)
         digitalPortValue[i] = 0;
 
-    for (int i = 0; i < 100; i++) {
-        if (i % 20 == 0) askCapabilities(); // try again every 0.2s
-        OnIdle(); // 10ms
-        if (have_capabilities) break;
-    }
+    // wait up to 1s each, try again every 0.2s
+    waitForReply([this] { return have_capabilities != 0; },
+                 [this] { return askCapabilities(); }, 1000, 200);
 
-    for (int i = 0; i < 100; i++) {
-        if (i % 20 == 0) mapAnalogChannels(); // try again every 0.2s
-        OnIdle(); // 10ms
-        if (have_analog_mapping) break;
-    }
+    waitForReply([this] { return have_analog_mapping != 0; },
+                 [this] { return mapAnalogChannels(); }, 1000, 200);
 
     for (int pin = 0; pin < 128; pin++)
     {
@@ -454,13 +447,15 @@ void Firmata::DoMessage(void)
             name[len++] = parse_buf[3] + '0';
             name[len++] = 0;
             LOGF_DEBUG("FIRMWARE:%s", name);
-            if (strlen(firmata_name) == 0) {
+            if (!have_firmata_name) {
+                // Written once, then only read, the flag publishes it to other threads
                 strcpy(firmata_name, name);
-                time(&version_reply_time);
+                version_reply_time = time(nullptr);
+                have_firmata_name = true;
             }
             else
                 if (strcmp(firmata_name, name) == 0) // use repeated firmware reports to check connection, the string is expected to stay unchanged
-                    time(&version_reply_time);       // record the time of last correct reply
+                    version_reply_time = time(nullptr); // record the time of last correct reply
 
         }
         else if (parse_buf[1] == FIRMATA_CAPABILITY_RESPONSE)
@@ -494,7 +489,7 @@ void Firmata::DoMessage(void)
             for (int i = 2; i < parse_count - 1; i++)
             {
                 pin_info[pin].analog_channel = parse_buf[i];
-                LOGF_DEBUG("ANALOG_MAPPING: pin %d is A%d", pin, pin_info[pin].analog_channel);
+                LOGF_DEBUG("ANALOG_MAPPING: pin %d is A%d", pin, pin_info[pin].analog_channel.load());
                 pin++;
             }
             for (; pin < 128; pin++)
@@ -507,13 +502,15 @@ void Firmata::DoMessage(void)
         else if (parse_buf[1] == FIRMATA_PIN_STATE_RESPONSE && parse_count >= 6)
         {
             int pin             = parse_buf[2];
-            pin_info[pin].mode  = parse_buf[3];
-            pin_info[pin].value = parse_buf[4];
+            // Assemble the value first, readers must never see part of it
+            uint64_t value      = parse_buf[4];
             if (parse_count > 6)
-                pin_info[pin].value |= (parse_buf[5] << 7);
+                value |= (parse_buf[5] << 7);
             if (parse_count > 7)
-                pin_info[pin].value |= (parse_buf[6] << 14);
-            LOGF_DEBUG("PIN_STATE_RESPONSE: pin:%u. Mode:%u. Value:%llu", pin, pin_info[pin].mode, static_cast<unsigned long long>(pin_info[pin].value));
+                value |= (parse_buf[6] << 14);
+            pin_info[pin].mode  = parse_buf[3];
+            pin_info[pin].value = value;
+            LOGF_DEBUG("PIN_STATE_RESPONSE: pin:%u. Mode:%u. Value:%llu", pin, pin_info[pin].mode.load(), static_cast<unsigned long long>(pin_info[pin].value));
             if (pin_info[pin].mode == FIRMATA_MODE_OUTPUT)
                 updateDigitalPort(pin, pin_info[pin].value ? ARDUINO_HIGH : ARDUINO_LOW);
         }
@@ -575,6 +572,10 @@ void Firmata::DoMessage(void)
 
 int Firmata::OnIdle()
 {
+    // The reader thread owns the port and keeps the state up to date.
+    if (readerRunning)
+        return reader_error;
+
     uint8_t buf[1024];
     int r = 1;
 
@@ -615,3 +616,88 @@ time_t Firmata::secondsSinceVersionReply()
     time(&now);
     return now - version_reply_time;
 }
+
+bool Firmata::waitForReply(const std::function<bool()> &done, const std::function<int()> &request,
+                           int timeout_ms, int retry_ms)
+{
+    using namespace std::chrono;
+    const auto start = steady_clock::now();
+    auto last_request = start;
+    request();
+
+    while (!done())
+    {
+        const auto now = steady_clock::now();
+        if (now - start >= milliseconds(timeout_ms))
+            return false;
+
+        if (now - last_request >= milliseconds(retry_ms))
+        {
+            request();
+            last_request = now;
+        }
+
+        if (readerRunning)
+        {
+            // Woken by the reader as soon as a message was processed
+            std::unique_lock<std::mutex> lock(reply_mutex);
+            reply_cv.wait_for(lock, milliseconds(10), done);
+        }
+        else
+            OnIdle(); // 10ms
+    }
+    return true;
+}
+
+int Firmata::startReader()
+{
+    if (readerRunning)
+        return 0;
+
+    reader_error  = 0;
+    readerRunning = true;
+    reader_thread = std::thread(&Firmata::readerLoop, this);
+    LOG_DEBUG("Firmata reader thread started");
+    return 0;
+}
+
+void Firmata::stopReader()
+{
+    if (!readerRunning)
+        return;
+
+    readerRunning = false;
+    if (reader_thread.joinable())
+        reader_thread.join();
+    LOG_DEBUG("Firmata reader thread stopped");
+}
+
+void Firmata::readerLoop()
+{
+    uint8_t buf[1024];
+
+    while (readerRunning)
+    {
+        // Waits up to 10ms for data, then drains whatever the driver has buffered.
+        int r = arduino->readPort(buf, sizeof(buf));
+        if (r < 0)
+        {
+            if (reader_error == 0)
+                LOGF_DEBUG("Firmata reader: read error %d", r);
+            reader_error = r;
+            usleep(10000);
+            continue;
+        }
+
+        reader_error = 0;
+        if (r == 0)
+            continue;
+
+        Parse(buf, r);
+
+        {
+            std::lock_guard<std::mutex> lock(reply_mutex);
+        }
+        reply_cv.notify_all();
+    }
+}
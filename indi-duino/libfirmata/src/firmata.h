@@ -14,6 +14,11 @@
 #include <vector>
 #include <stdint.h>
 #include <arduino.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #define FIRMATA_MAX_DATA_BYTES 32 // max number of data bytes in non-Sysex messages
 //#define FIRMATA_DEFAULT_BAUD          115200
@@ -78,12 +83,14 @@ using namespace std;
 
 extern void (*firmata_debug_cb)(const char *file, int line, const char *msg, ...);
 
+// Pin state is updated by the reader thread and read by the application, all fields are atomic
+// so the table can be read without locking.
 typedef struct
 {
-    uint8_t mode;
-    uint8_t analog_channel;
-    uint64_t supported_modes;
-    uint64_t value;
+    std::atomic<uint8_t> mode;
+    std::atomic<uint8_t> analog_channel;
+    std::atomic<uint64_t> supported_modes;
+    std::atomic<uint64_t> value;
 } pin_t;
 
 class Firmata
@@ -112,10 +119,16 @@ class Firmata
     int sendStringData(char *data);
     int askPinStateWaitForReply(int pin);
     int initState();
+    // Start a background thread that reads and parses all incoming messages. Once running, pin_info
+    // is kept up to date continuously and OnIdle() no longer touches the port.
+    int startReader();
+    void stopReader();
     time_t secondsSinceVersionReply();
     pin_t pin_info[128];
     void print_state();
+    // Set by the reader once the board reported its firmware, read it only when hasFirmataName()
     char firmata_name[140];
+    bool hasFirmataName() const { return have_firmata_name; }
     char string_buffer[MAX_STRING_DATA_LEN];
     int OnIdle();
     bool portOpen;
@@ -126,15 +139,26 @@ class Firmata
     uint8_t parse_buf[4096];
     void Parse(const uint8_t *buf, int len);
     void DoMessage(void);
-    int have_analog_mapping { 0 };
-    int have_capabilities { 0 };
-    time_t version_reply_time { 0 };
+    std::atomic<int> have_analog_mapping { 0 };
+    std::atomic<int> have_capabilities { 0 };
+    std::atomic<time_t> version_reply_time { 0 };
+    std::atomic<bool> have_firmata_name { false };
+
+    // Send request every retry_ms until done() holds or timeout_ms elapsed. Returns true on reply.
+    bool waitForReply(const std::function<bool()> &done, const std::function<int()> &request,
+                      int timeout_ms, int retry_ms);
+    void readerLoop();
+    std::thread reader_thread;
+    std::atomic<bool> readerRunning { false };
+    std::atomic<int> reader_error { 0 };
+    std::mutex reply_mutex;
+    std::condition_variable reply_cv;
 
   protected:
     Arduino *arduino;
 
     char firmwareVersion[FIRMATA_FIRMWARE_VERSION_SIZE];
-    uint8_t digitalPortValue[ARDUINO_DIG_PORTS]; /// bitpacked digital pin state
+    std::atomic<uint8_t> digitalPortValue[ARDUINO_DIG_PORTS]; /// bitpacked digital pin state
     int init(const char *_serialPort, uint32_t baud);
     int init(int fd);
     int handshake();
@@ -25,6 +25,7 @@
 #include "weatherradio.h"
 #include "weathercalculator.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <map>
@@ -49,6 +50,9 @@ std::unique_ptr<WeatherRadio> station_ptr(new WeatherRadio());
 
 #define ARDUINO_SETTLING_TIME 5
 
+// flag of the telemetry middle buffer index, set while the snapshot has not been taken
+#define TELEMETRY_FRESH 4
+
 #define WIFI_DEVICE "WiFi"
 
 #define WEATHER_TEMPERATURE     "WEATHER_TEMPERATURE"
@@ -91,6 +95,11 @@ WeatherRadio::WeatherRadio()
     commands[CMD_RESET]    = "r";
 }
 
+WeatherRadio::~WeatherRadio()
+{
+    stopTelemetry();
+}
+
 /**************************************************************************************
 ** Initialize all properties & set default values.
 **************************************************************************************/
@@ -104,6 +113,11 @@ bool WeatherRadio::initProperties()
     IUFillNumberVector(&ttyTimeoutNP, ttyTimeoutN, 1, getDeviceName(), "TTY_TIMEOUT", "TTY timeout", CONNECTION_TAB, IP_RW, 0,
                        IPS_OK);
 
+    // interval of the background weather readings
+    IUFillNumber(&telemetryPeriodN[0], "PERIOD", "Period (s)", "%.f", 1, 600, 1, 10);
+    IUFillNumberVector(&telemetryPeriodNP, telemetryPeriodN, 1, getDeviceName(), "TELEMETRY_PERIOD", "Sensor polling", OPTIONS_TAB,
+                       IP_RW, 0, IPS_OK);
+
     // Firmware version
     IUFillText(&FirmwareInfoT[0], "FIRMWARE_INFO", "Firmware Version", "<unknown version>");
     IUFillTextVector(&FirmwareInfoTP, FirmwareInfoT, 1, getDeviceName(), "FIRMWARE", "Firmware", INFO_TAB, IP_RO, 60, IPS_OK);
@@ -325,9 +339,15 @@ bool WeatherRadio::updateProperties()
         result = INDI::Weather::updateProperties();
 
         defineProperty(&resetArduinoSP);
+        defineProperty(&telemetryPeriodNP);
+
+        // from now on the sensors are read in the background
+        startTelemetry();
     }
     else
     {
+        stopTelemetry();
+        deleteProperty(telemetryPeriodNP.name);
 
         for (size_t i = 0; i < rawDevices.size(); i++)
             deleteProperty(rawDevices[i].name);
@@ -685,6 +705,19 @@ bool WeatherRadio::ISNewNumber(const char *dev, const char *name, double values[
             IDSetNumber(&ttyTimeoutNP, nullptr);
             return ttyTimeoutNP.s;
         }
+        else if (strcmp(name, telemetryPeriodNP.name) == 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(telemetryMutex);
+                IUUpdateNumber(&telemetryPeriodNP, values, names, n);
+                telemetryPeriodChanged = true;
+            }
+            // wake up the reader so that the new period applies immediately
+            telemetryCondition.notify_all();
+            telemetryPeriodNP.s = IPS_OK;
+            IDSetNumber(&telemetryPeriodNP, nullptr);
+            return true;
+        }
         else if (strcmp(name, skyTemperatureCalibrationNP.name) == 0)
         {
             IUUpdateNumber(&skyTemperatureCalibrationNP, values, names, n);
@@ -818,6 +851,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&temperatureSensorSP, selected);
             currentSensors.temperature = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Temperature sensor selected: %s", selected);
             return (temperatureSensorSP.s == IPS_OK);
@@ -830,6 +864,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&pressureSensorSP, selected);
             currentSensors.pressure = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Pressure sensor selected: %s", selected);
             return (pressureSensorSP.s == IPS_OK);
@@ -842,6 +877,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&humiditySensorSP, selected);
             currentSensors.humidity = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Humidity sensor selected: %s", selected);
             return (humiditySensorSP.s == IPS_OK);
@@ -854,6 +890,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&luminositySensorSP, selected);
             currentSensors.luminosity = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Luminosity sensor selected: %s", selected);
             return (luminositySensorSP.s == IPS_OK);
@@ -866,6 +903,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&sqmSensorSP, selected);
             currentSensors.sqm = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("SQM sensor selected: %s", selected);
             return (sqmSensorSP.s == IPS_OK);
@@ -878,6 +916,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&ambientTemperatureSensorSP, selected);
             currentSensors.temp_ambient = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Ambient temperature sensor selected: %s", selected);
             return (ambientTemperatureSensorSP.s == IPS_OK);
@@ -890,6 +929,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&objectTemperatureSensorSP, selected);
             currentSensors.temp_object = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Object temperature sensor selected: %s", selected);
             return (objectTemperatureSensorSP.s == IPS_OK);
@@ -902,6 +942,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&windGustSensorSP, selected);
             currentSensors.wind_gust = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Wind gust sensor selected: %s", selected);
             return (windGustSensorSP.s == IPS_OK);
@@ -914,6 +955,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&windSpeedSensorSP, selected);
             currentSensors.wind_speed = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Wind speed sensor selected: %s", selected);
             return (windSpeedSensorSP.s == IPS_OK);
@@ -926,6 +968,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&windDirectionSensorSP, selected);
             currentSensors.wind_direction = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Wind direction sensor selected: %s", selected);
             return (windDirectionSensorSP.s == IPS_OK);
@@ -938,6 +981,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&rainDropsSensorSP, selected);
             currentSensors.rain_drops = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Rain intensity sensor selected: %s", selected);
             return (rainDropsSensorSP.s == IPS_OK);
@@ -950,6 +994,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&rainVolumeSensorSP, selected);
             currentSensors.rain_volume = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Rain intensity sensor selected: %s", selected);
             return (rainVolumeSensorSP.s == IPS_OK);
@@ -962,6 +1007,7 @@ bool WeatherRadio::ISNewSwitch(const char *dev, const char *name, ISState *state
             const char *selected = IUFindOnSwitchName(states, names, n);
             sensor_name sensor = updateSensorSelection(&wetnessSensorSP, selected);
             currentSensors.wetness = sensor;
+            updateSensorBindings();
 
             LOGF_DEBUG("Wetness sensor selected: %s", selected);
             return (wetnessSensorSP.s == IPS_OK);
@@ -1006,11 +1052,27 @@ bool WeatherRadio::Handshake()
 ***************************************************************************************/
 IPState WeatherRadio::updateWeather()
 {
-    bool result = executeCommand(CMD_WEATHER);
+    if (!telemetryThread.joinable())
+    {
+        bool result = executeCommand(CMD_WEATHER);
 
-    // result recieved
-    LOGF_DEBUG("Reading weather data from Arduino %s", result ? "succeeded." : "failed!");
-    return result == true ? IPS_OK : IPS_ALERT;
+        // result recieved
+        LOGF_DEBUG("Reading weather data from Arduino %s", result ? "succeeded." : "failed!");
+        return result == true ? IPS_OK : IPS_ALERT;
+    }
+
+    // take the latest snapshot, if the reader has published one since the last update
+    if ((telemetryMiddle.load() & TELEMETRY_FRESH) == 0)
+        return telemetryState;
+
+    telemetryFront = telemetryMiddle.exchange(telemetryFront) & ~TELEMETRY_FRESH;
+    telemetry_snapshot &snapshot = telemetryBuffers[telemetryFront];
+
+    for (const std::string &line : snapshot.lines)
+        handleResponse(CMD_WEATHER, line.c_str(), static_cast<int>(line.length()));
+
+    telemetryState = snapshot.success ? IPS_OK : IPS_ALERT;
+    return telemetryState;
 }
 
 /**************************************************************************************
@@ -1025,7 +1087,8 @@ void WeatherRadio::handleWeatherData(JsonValue value)
         snprintf(name, strlen(deviceIter->key) + 1, "%s", deviceIter->key);
 
         JsonIterator sensorIter;
-        INumberVectorProperty *deviceProp = findRawDeviceProperty(name);
+        auto deviceIndex = rawDeviceIndex.find(name);
+        INumberVectorProperty *deviceProp = deviceIndex == rawDeviceIndex.end() ? nullptr : &rawDevices[deviceIndex->second];
 
         if (deviceProp == nullptr)
         {
@@ -1074,22 +1137,33 @@ void WeatherRadio::handleWeatherData(JsonValue value)
                 if (isConnected())
                     defineProperty(deviceProp);
                 rawDevices.push_back(*deviceProp);
+                rawDeviceIndex[name] = rawDevices.size() - 1;
+                updateSensorBindings();
             }
         }
         else
         {
             deviceProp->s = IPS_IDLE;
+            const std::vector<weather_parameter> &bindings = sensorBindings[deviceIndex->second];
             // read all sensor data
+            int position = 0;
             for (sensorIter = begin(deviceIter->value); sensorIter != end(deviceIter->value); ++sensorIter)
             {
                 if (strcmp(sensorIter->key, "init") == 0 || sensorIter->value.getTag() != JSON_NUMBER)
                     continue;
-                INumber *sensor = IUFindNumber(deviceProp, sensorIter->key);
+                // the firmware sends the sensors always in the same order, search only if it has changed
+                INumber *sensor = nullptr;
+                if (position < deviceProp->nnp && strcmp(deviceProp->np[position].name, sensorIter->key) == 0)
+                    sensor = &deviceProp->np[position];
+                else
+                    sensor = IUFindNumber(deviceProp, sensorIter->key);
+
+                if (sensor != nullptr)
+                    position = static_cast<int>(sensor - deviceProp->np) + 1;
                 if (sensor != nullptr && sensorIter->value.isDouble())
                 {
                     sensor->value = sensorIter->value.toNumber();
-                    // update the weather parameter {name, sensorIter->key} to sensorIter->value.toNumber()
-                    updateWeatherParameter({name, sensorIter->key}, sensorIter->value.toNumber());
+                    updateWeatherParameter(bindings[sensor - deviceProp->np], sensor->value);
                     deviceProp->s = IPS_OK;
                 }
             }
@@ -1120,76 +1194,137 @@ WeatherRadio::sensor_name WeatherRadio::updateSensorSelection(ISwitchVectorPrope
 /**************************************************************************************
 ** Update the value of the WEATHER_... from its sensor value
 ***************************************************************************************/
-void WeatherRadio::updateWeatherParameter(WeatherRadio::sensor_name sensor, double value)
+void WeatherRadio::updateWeatherParameter(weather_parameter parameter, double value)
 {
-    if (currentSensors.temperature == sensor)
-        setParameterValue(WEATHER_TEMPERATURE, weatherCalculator->calibrate(weatherCalculator->temperatureCalibration, value));
-    else if (currentSensors.pressure == sensor)
+    switch (parameter)
     {
-        double elevation = LocationNP[LOCATION_ELEVATION].getValue();
-
-        double temp = 15.0; // default value
+        case PARAM_TEMPERATURE:
+            setParameterValue(WEATHER_TEMPERATURE, weatherCalculator->calibrate(weatherCalculator->temperatureCalibration, value));
+            break;
+        case PARAM_PRESSURE:
+        {
+            double elevation = LocationNP[LOCATION_ELEVATION].getValue();
 
-        auto temperatureParameter = ParametersNP.findWidgetByName(WEATHER_TEMPERATURE);
-        if (temperatureParameter)
-            temp = temperatureParameter->getValue();
+            double temp = 15.0; // default value
 
-        double pressure_normalized = weatherCalculator->sealevelPressure(value, elevation, temp);
-        setParameterValue(WEATHER_PRESSURE, pressure_normalized);
-    }
-    else if (currentSensors.humidity == sensor)
-    {
-        double humidity = weatherCalculator->calibrate(weatherCalculator->humidityCalibration, value);
+            auto temperatureParameter = ParametersNP.findWidgetByName(WEATHER_TEMPERATURE);
+            if (temperatureParameter)
+                temp = temperatureParameter->getValue();
 
-        setParameterValue(WEATHER_HUMIDITY, humidity);
-        auto temperatureParameter = ParametersNP.findWidgetByName(WEATHER_TEMPERATURE);
-        if (temperatureParameter)
-        {
-            double dp =  weatherCalculator->dewPoint(humidity, temperatureParameter->getValue());
-            setParameterValue(WEATHER_DEWPOINT, dp);
+            double pressure_normalized = weatherCalculator->sealevelPressure(value, elevation, temp);
+            setParameterValue(WEATHER_PRESSURE, pressure_normalized);
+            break;
         }
-    }
-    else if (currentSensors.temp_ambient == sensor)
-    {
-        // obtain the current object temperature
-        INumber *objProp = findRawSensorProperty(currentSensors.temp_object);
-        if (objProp != nullptr)
+        case PARAM_HUMIDITY:
         {
-            double objectTemperature = objProp->value;
-            setParameterValue(WEATHER_CLOUD_COVER, weatherCalculator->cloudCoverage(value, objectTemperature));
-            setParameterValue(WEATHER_SKY_TEMPERATURE, weatherCalculator->skyTemperatureCorr(value, objectTemperature));
+            double humidity = weatherCalculator->calibrate(weatherCalculator->humidityCalibration, value);
+
+            setParameterValue(WEATHER_HUMIDITY, humidity);
+            auto temperatureParameter = ParametersNP.findWidgetByName(WEATHER_TEMPERATURE);
+            if (temperatureParameter)
+            {
+                double dp =  weatherCalculator->dewPoint(humidity, temperatureParameter->getValue());
+                setParameterValue(WEATHER_DEWPOINT, dp);
+            }
+            break;
         }
+        case PARAM_TEMP_AMBIENT:
+            // obtain the current object temperature
+            if (objectTemperatureSensor != nullptr)
+            {
+                double objectTemperature = objectTemperatureSensor->value;
+                setParameterValue(WEATHER_CLOUD_COVER, weatherCalculator->cloudCoverage(value, objectTemperature));
+                setParameterValue(WEATHER_SKY_TEMPERATURE, weatherCalculator->skyTemperatureCorr(value, objectTemperature));
+            }
+            break;
+        case PARAM_TEMP_OBJECT:
+            // obtain the current ambient temperature
+            if (ambientTemperatureSensor != nullptr)
+            {
+                double ambientTemperature = ambientTemperatureSensor->value;
+                setParameterValue(WEATHER_CLOUD_COVER, weatherCalculator->cloudCoverage(ambientTemperature, value));
+                setParameterValue(WEATHER_SKY_TEMPERATURE, weatherCalculator->skyTemperatureCorr(ambientTemperature, value));
+            }
+            break;
+        case PARAM_LUMINOSITY:
+            setParameterValue(WEATHER_SQM, weatherCalculator->calibrate(weatherCalculator->sqmCalibration,
+                              weatherCalculator->sqmValue(value)));
+            break;
+        case PARAM_SQM:
+            setParameterValue(WEATHER_SQM, weatherCalculator->calibrate(weatherCalculator->sqmCalibration, value));
+            break;
+        case PARAM_WIND_GUST:
+            setParameterValue(WEATHER_WIND_GUST, value);
+            break;
+        case PARAM_WIND_SPEED:
+            setParameterValue(WEATHER_WIND_SPEED, value);
+            break;
+        case PARAM_WIND_DIRECTION:
+            setParameterValue(WEATHER_WIND_DIRECTION, weatherCalculator->calibratedWindDirection(value));
+            break;
+        case PARAM_RAIN_DROPS:
+            setParameterValue(WEATHER_RAIN_DROPS, value);
+            break;
+        case PARAM_RAIN_VOLUME:
+            setParameterValue(WEATHER_RAIN_VOLUME, value);
+            break;
+        case PARAM_WETNESS:
+            setParameterValue(WEATHER_WETNESS, weatherCalculator->calibrate(weatherCalculator->wetnessCalibration, value));
+            break;
+        case PARAM_NONE:
+            // raw sensor only
+            break;
     }
-    else if (currentSensors.temp_object == sensor)
+}
+
+/**************************************************************************************
+** Bind each raw sensor to the weather parameter it is selected for
+***************************************************************************************/
+void WeatherRadio::updateSensorBindings()
+{
+    sensorBindings.resize(rawDevices.size());
+    for (size_t device = 0; device < rawDevices.size(); device++)
     {
-        // obtain the current ambient temperature
-        INumber *ambientProp = findRawSensorProperty(currentSensors.temp_ambient);
-        if (ambientProp != nullptr)
+        INumberVectorProperty &deviceProp = rawDevices[device];
+        sensorBindings[device].assign(static_cast<size_t>(deviceProp.nnp), PARAM_NONE);
+
+        for (int i = 0; i < deviceProp.nnp; i++)
         {
-            double ambientTemperature = ambientProp->value;
-            setParameterValue(WEATHER_CLOUD_COVER, weatherCalculator->cloudCoverage(ambientTemperature, value));
-            setParameterValue(WEATHER_SKY_TEMPERATURE, weatherCalculator->skyTemperatureCorr(ambientTemperature, value));
+            sensor_name sensor = {deviceProp.name, deviceProp.np[i].name};
+            weather_parameter &parameter = sensorBindings[device][static_cast<size_t>(i)];
+
+            // a sensor selected for several parameters drives the first one in this order
+            if (currentSensors.temperature == sensor)
+                parameter = PARAM_TEMPERATURE;
+            else if (currentSensors.pressure == sensor)
+                parameter = PARAM_PRESSURE;
+            else if (currentSensors.humidity == sensor)
+                parameter = PARAM_HUMIDITY;
+            else if (currentSensors.temp_ambient == sensor)
+                parameter = PARAM_TEMP_AMBIENT;
+            else if (currentSensors.temp_object == sensor)
+                parameter = PARAM_TEMP_OBJECT;
+            else if (currentSensors.luminosity == sensor)
+                parameter = PARAM_LUMINOSITY;
+            else if (currentSensors.sqm == sensor)
+                parameter = PARAM_SQM;
+            else if (currentSensors.wind_gust == sensor)
+                parameter = PARAM_WIND_GUST;
+            else if (currentSensors.wind_speed == sensor)
+                parameter = PARAM_WIND_SPEED;
+            else if (currentSensors.wind_direction == sensor)
+                parameter = PARAM_WIND_DIRECTION;
+            else if (currentSensors.rain_drops == sensor)
+                parameter = PARAM_RAIN_DROPS;
+            else if (currentSensors.rain_volume == sensor)
+                parameter = PARAM_RAIN_VOLUME;
+            else if (currentSensors.wetness == sensor)
+                parameter = PARAM_WETNESS;
         }
     }
-    else if (currentSensors.luminosity == sensor)
-    {
-        setParameterValue(WEATHER_SQM, weatherCalculator->calibrate(weatherCalculator->sqmCalibration,
-                          weatherCalculator->sqmValue(value)));
-    }
-    else if (currentSensors.sqm == sensor)
-        setParameterValue(WEATHER_SQM, weatherCalculator->calibrate(weatherCalculator->sqmCalibration, value));
-    else if (currentSensors.wind_gust == sensor)
-        setParameterValue(WEATHER_WIND_GUST, value);
-    else if (currentSensors.wind_speed == sensor)
-        setParameterValue(WEATHER_WIND_SPEED, value);
-    else if (currentSensors.wind_direction == sensor)
-        setParameterValue(WEATHER_WIND_DIRECTION, weatherCalculator->calibratedWindDirection(value));
-    else if (currentSensors.rain_drops == sensor)
-        setParameterValue(WEATHER_RAIN_DROPS, value);
-    else if (currentSensors.rain_volume == sensor)
-        setParameterValue(WEATHER_RAIN_VOLUME, value);
-    else if (currentSensors.wetness == sensor)
-        setParameterValue(WEATHER_WETNESS, weatherCalculator->calibrate(weatherCalculator->wetnessCalibration, value));
+
+    ambientTemperatureSensor = findRawSensorProperty(currentSensors.temp_ambient);
+    objectTemperatureSensor  = findRawSensorProperty(currentSensors.temp_object);
 }
 
 /**************************************************************************************
@@ -1269,6 +1404,7 @@ bool WeatherRadio::saveConfigItems(FILE *fp)
     IUSaveConfigSwitch(fp, &rainVolumeSensorSP);
     IUSaveConfigSwitch(fp, &wetnessSensorSP);
     IUSaveConfigNumber(fp, &ttyTimeoutNP);
+    IUSaveConfigNumber(fp, &telemetryPeriodNP);
 
     return INDI::Weather::saveConfigItems(fp);
 }
@@ -1278,11 +1414,9 @@ bool WeatherRadio::saveConfigItems(FILE *fp)
 ***************************************************************************************/
 INumberVectorProperty *WeatherRadio::findRawDeviceProperty(const char *name)
 {
-    for (size_t i = 0; i < rawDevices.size(); i++)
-    {
-        if (strcmp(name, rawDevices[i].name) == 0)
-            return &rawDevices[i];
-    }
+    auto index = rawDeviceIndex.find(name);
+    if (index != rawDeviceIndex.end())
+        return &rawDevices[index->second];
 
     // not found
     return nullptr;
@@ -1322,9 +1456,23 @@ bool WeatherRadio::parseCanonicalName(sensor_name *sensor, std::string name)
 ***************************************************************************************/
 bool WeatherRadio::executeCommand(wr_command cmd)
 {
-    std::string cmdstring = commands[cmd];
+    std::vector<std::string> lines;
+    bool result = queryDevice(cmd, lines);
+
+    for (const std::string &line : lines)
+        handleResponse(cmd, line.c_str(), static_cast<int>(line.length()));
+
+    return result;
+}
+
+bool WeatherRadio::queryDevice(wr_command cmd, std::vector<std::string> &lines)
+{
+    std::lock_guard<std::mutex> lock(commandMutex);
+
+    std::string cmdstring = commands.at(cmd);
     char response[MAX_WEATHERBUFFER] = {0};
     int length = 0;
+    lines.clear();
     // communication through a serial (USB) interface
     if (getActiveConnection()->type() == Connection::Interface::CONNECTION_SERIAL)
     {
@@ -1346,7 +1494,7 @@ bool WeatherRadio::executeCommand(wr_command cmd)
         // read the response lines
         bool result = receiveSerial(response, &length, '\n', getTTYTimeout());
         if (result)
-            handleResponse(cmd, response, length);
+            lines.push_back(std::string(response, static_cast<size_t>(length)));
         else
         {
             LOG_ERROR("Receiving response failed.");
@@ -1357,7 +1505,7 @@ bool WeatherRadio::executeCommand(wr_command cmd)
         {
             if (response[0] == '\0') // nothing received
                 break;
-            handleResponse(cmd, response, length);
+            lines.push_back(std::string(response, static_cast<size_t>(length)));
         }
         return true;
     }
@@ -1385,7 +1533,7 @@ bool WeatherRadio::executeCommand(wr_command cmd)
 
                 // handle each line separately
                 while(std::getline(rs, line, '\n'))
-                    handleResponse(cmd, line.c_str(), line.length());
+                    lines.push_back(line);
 
                 return true;
             }
@@ -1568,9 +1716,71 @@ bool WeatherRadio::Connect()
 
 bool WeatherRadio::Disconnect()
 {
+    // the reader must not access the port any more once it is closed
+    stopTelemetry();
     return INDI::Weather::Disconnect();
 }
 
+/**************************************************************************************
+** Telemetry reader
+***************************************************************************************/
+void WeatherRadio::startTelemetry()
+{
+    if (telemetryThread.joinable())
+        return;
+
+    // nothing published yet
+    telemetryMiddle = 1;
+    telemetryFront  = 0;
+    telemetryBack   = 2;
+    telemetryState  = IPS_BUSY;
+
+    telemetryRunning = true;
+    telemetryThread  = std::thread(&WeatherRadio::telemetryLoop, this);
+    LOG_DEBUG("Telemetry reader started.");
+}
+
+void WeatherRadio::stopTelemetry()
+{
+    if (!telemetryThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(telemetryMutex);
+        telemetryRunning = false;
+    }
+    telemetryCondition.notify_all();
+    telemetryThread.join();
+    LOG_DEBUG("Telemetry reader stopped.");
+}
+
+void WeatherRadio::telemetryLoop()
+{
+    std::unique_lock<std::mutex> lock(telemetryMutex);
+    while (telemetryRunning)
+    {
+        lock.unlock();
+
+        auto lastRead = std::chrono::steady_clock::now();
+        telemetry_snapshot &snapshot = telemetryBuffers[telemetryBack];
+        snapshot.success = queryDevice(CMD_WEATHER, snapshot.lines);
+        LOGF_DEBUG("Reading weather data from Arduino %s", snapshot.success ? "succeeded." : "failed!");
+
+        // publish the snapshot, taking over the previous middle buffer for the next reading
+        telemetryBack = telemetryMiddle.exchange(telemetryBack | TELEMETRY_FRESH) & ~TELEMETRY_FRESH;
+
+        lock.lock();
+        // a new period moves the next reading, counted from the last one
+        do
+        {
+            telemetryPeriodChanged = false;
+            auto next = lastRead + std::chrono::milliseconds(static_cast<int>(telemetryPeriodN[0].value * 1000));
+            telemetryCondition.wait_until(lock, next, [this] { return !telemetryRunning || telemetryPeriodChanged; });
+        }
+        while (telemetryRunning && telemetryPeriodChanged);
+    }
+}
+
 const char *WeatherRadio::getDefaultName()
 {
     return "Weather Radio";
@@ -22,9 +22,15 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <map>
 #include <math.h>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "gason/gason.h"
 
@@ -38,7 +44,7 @@ class WeatherRadio : public INDI::Weather
 {
   public:
     WeatherRadio();
-    ~WeatherRadio() override = default;
+    ~WeatherRadio() override;
 
     virtual void ISGetProperties(const char *dev) override;
     virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
@@ -128,7 +134,22 @@ protected:
         }
     };
 
+    /**
+     * Weather parameters a raw sensor may be selected for
+     */
+    enum weather_parameter {PARAM_NONE, PARAM_TEMPERATURE, PARAM_PRESSURE, PARAM_HUMIDITY, PARAM_TEMP_AMBIENT,
+                            PARAM_TEMP_OBJECT, PARAM_LUMINOSITY, PARAM_SQM, PARAM_WIND_GUST, PARAM_WIND_SPEED,
+                            PARAM_WIND_DIRECTION, PARAM_RAIN_DROPS, PARAM_RAIN_VOLUME, PARAM_WETNESS};
+
     std::vector<INumberVectorProperty> rawDevices;
+    // position of each raw device in rawDevices
+    std::map<std::string, size_t> rawDeviceIndex;
+    // weather parameter of each sensor, same layout as rawDevices and their numbers
+    std::vector<std::vector<weather_parameter>> sensorBindings;
+    // current sensors needed to calculate cloud coverage and sky temperature
+    INumber *ambientTemperatureSensor = nullptr;
+    INumber *objectTemperatureSensor = nullptr;
+
     /**
      * \brief Find the matching raw device INDI property vector.
     */
@@ -136,7 +157,12 @@ protected:
     /**
      * @brief find the matching sensor INDI property
      */
-    INumber *findRawSensorProperty(const sensor_name sensor);    
+    INumber *findRawSensorProperty(const sensor_name sensor);
+    /**
+     * @brief Resolve the weather parameter of all raw sensors from the current sensor selection.
+     *        Needs to be called whenever a raw device is added or a sensor selection changes.
+     */
+    void updateSensorBindings();
 
     /**
      * @brief TTY interface timeout
@@ -148,6 +174,10 @@ protected:
     INumber ttyTimeoutN[1] = {};
     INumberVectorProperty ttyTimeoutNP;
 
+    // interval of the telemetry reader
+    INumber telemetryPeriodN[1] = {};
+    INumberVectorProperty telemetryPeriodNP;
+
     ISwitch refreshConfigS[1] = {};
     ISwitchVectorProperty refreshConfigSP;
 
@@ -248,12 +278,13 @@ protected:
     sensor_name updateSensorSelection(ISwitchVectorProperty *weatherParameter, const char *selected);
 
     /**
-     * @brief Select the weather parameter from the sensor registry and update it.
+     * @brief Update the weather parameter a sensor is bound to.
      */
-    void updateWeatherParameter(sensor_name sensor, double value);
+    void updateWeatherParameter(weather_parameter parameter, double value);
 
     /**
-     * @brief Read the weather data from the JSON document
+     * @brief Apply the latest weather document read by the telemetry reader.
+     *        Before the reader has been started, the document is read directly.
      * @return parse success
      */
     IPState updateWeather() override;
@@ -295,6 +326,40 @@ protected:
 
     // send a command to the serial device or by HTTP
     bool executeCommand(wr_command cmd);
+    // send a command and collect the response lines without handling them
+    bool queryDevice(wr_command cmd, std::vector<std::string> &lines);
+    // serializes the device communication of the INDI thread and the telemetry reader
+    std::mutex commandMutex;
+
+    /**
+     * Telemetry cache. The reader thread polls the weather document at its own rate and
+     * hands the response over in a triple buffer: the reader fills the back buffer and
+     * exchanges it with the middle one, updateWeather() exchanges the front buffer with
+     * the middle one if it is fresh. Neither side ever waits for the other.
+     */
+    struct telemetry_snapshot
+    {
+        std::vector<std::string> lines;
+        bool success = false;
+    };
+    telemetry_snapshot telemetryBuffers[3];
+    // index of the middle buffer, TELEMETRY_FRESH is set while it has not been taken
+    std::atomic<int> telemetryMiddle {1};
+    // owned by the INDI thread and the reader thread respectively
+    int telemetryFront = 0;
+    int telemetryBack = 2;
+    IPState telemetryState = IPS_BUSY;
+
+    std::thread telemetryThread;
+    std::mutex telemetryMutex;
+    std::condition_variable telemetryCondition;
+    bool telemetryRunning = false;
+    // set when TELEMETRY_PERIOD changes, the reader then waits for the new period instead
+    bool telemetryPeriodChanged = false;
+
+    void startTelemetry();
+    void stopTelemetry();
+    void telemetryLoop();
     // handle one single response line
     void handleResponse(wr_command cmd, const char *response, int length);
     // handle a message from the weather station
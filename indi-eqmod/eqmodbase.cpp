@@ -34,6 +34,7 @@
 
 #include "mach_gettime.h"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <cstring>
@@ -121,6 +122,7 @@ EQMod::EQMod(): GI(this)
     DBG_MOUNT        = INDI::Logger::getInstance().addDebugLevel("Verbose Mount", "MOUNT");
 
     mount = new Skywatcher(this);
+    mount->SetMotionCallback(std::bind(&EQMod::motionComplete, this));
 
     SetTelescopeCapability(TELESCOPE_CAN_PARK | TELESCOPE_CAN_SYNC | TELESCOPE_CAN_GOTO | TELESCOPE_CAN_ABORT |
                            TELESCOPE_HAS_TIME | TELESCOPE_HAS_LOCATION
@@ -325,6 +327,7 @@ void EQMod::ISGetProperties(const char *dev)
         defineProperty(SlewSpeedsNP);
         defineProperty(GuideRateNP);
         defineProperty(PulseLimitsNP);
+        defineProperty(GuidePulseAppliedNP);
         defineProperty(MountInformationTP);
         defineProperty(SteppersNP);
         defineProperty(CurrentSteppersNP);
@@ -404,6 +407,7 @@ bool EQMod::loadProperties()
     PulseLimitsNP  = getNumber("PULSE_LIMITS");
     MinPulseN      = PulseLimitsNP.findWidgetByName("MIN_PULSE");
     MinPulseTimerN = PulseLimitsNP.findWidgetByName("MIN_PULSE_TIMER");
+    GuidePulseAppliedNP = getNumber("GUIDE_PULSE_APPLIED");
 
     MountInformationTP = getText("MOUNTINFORMATION");
     SteppersNP         = getNumber("STEPPERS");
@@ -507,6 +511,7 @@ bool EQMod::updateProperties()
         defineProperty(SlewSpeedsNP);
         defineProperty(GuideRateNP);
         defineProperty(PulseLimitsNP);
+        defineProperty(GuidePulseAppliedNP);
         defineProperty(MountInformationTP);
         defineProperty(SteppersNP);
         defineProperty(CurrentSteppersNP);
@@ -617,6 +622,7 @@ bool EQMod::updateProperties()
     {
         deleteProperty(GuideRateNP);
         deleteProperty(PulseLimitsNP);
+        deleteProperty(GuidePulseAppliedNP);
         deleteProperty(MountInformationTP);
         deleteProperty(SteppersNP);
         deleteProperty(CurrentSteppersNP);
@@ -796,6 +802,21 @@ void EQMod::TimerHit()
     }
 }
 
+// Called by the mount once a goto motion stopped, complete it now rather than at the next poll
+void EQMod::motionComplete()
+{
+    if (!isConnected() || pulseInProgress != 0)
+        return;
+    if (!gotoInProgress() && TrackState != SCOPE_PARKING)
+        return;
+
+    if (!ReadScopeStatus())
+    {
+        EqNP.setState(IPS_ALERT);
+        EqNP.apply();
+    }
+}
+
 bool EQMod::ReadScopeStatus()
 {
     // Time
@@ -2184,11 +2205,9 @@ IPState EQMod::GuideNorth(uint32_t ms)
         rateshift = -rateshift;
     try
     {
-        if (ms >= MinPulseTimerN->value)
+        if (ms >= MinPulseTimerN->value || guideScheduler.isActive(AXIS_DE))
         {
-            pulseInProgress |= 1;
-            GuideTimerNS = IEAddTimer(ms, (IE_TCF *)timedguideNSCallback, this);
-            mount->StartDETracking(GetDETrackRate() + rateshift);
+            guidePulse(AXIS_DE, rateshift, ms);
         }
         else
         {
@@ -2248,11 +2267,9 @@ IPState EQMod::GuideSouth(uint32_t ms)
         rateshift = -rateshift;
     try
     {
-        if (ms >= MinPulseTimerN->value)
+        if (ms >= MinPulseTimerN->value || guideScheduler.isActive(AXIS_DE))
         {
-            pulseInProgress |= 1;
-            GuideTimerNS = IEAddTimer(ms, (IE_TCF *)timedguideNSCallback, this);
-            mount->StartDETracking(GetDETrackRate() - rateshift);
+            guidePulse(AXIS_DE, -rateshift, ms);
         }
         else
         {
@@ -2311,7 +2328,8 @@ IPState EQMod::GuideEast(uint32_t ms)
         rateshift = -rateshift;
     try
     {
-        if (mount->HasPPEC())
+        // PPEC is already off while a merged RA pulse runs
+        if (mount->HasPPEC() && !guideScheduler.isActive(AXIS_RA))
         {
             restartguidePPEC = false;
             if (PPECSP.getState() == IPS_BUSY)
@@ -2321,11 +2339,9 @@ IPState EQMod::GuideEast(uint32_t ms)
                 mount->TurnPPEC(false);
             }
         }
-        if (ms >= MinPulseTimerN->value)
+        if (ms >= MinPulseTimerN->value || guideScheduler.isActive(AXIS_RA))
         {
-            pulseInProgress |= 2;
-            GuideTimerWE = IEAddTimer(ms, (IE_TCF *)timedguideWECallback, this);
-            mount->StartRATracking(GetRATrackRate() - rateshift);
+            guidePulse(AXIS_RA, -rateshift, ms);
         }
         else
         {
@@ -2394,7 +2410,8 @@ IPState EQMod::GuideWest(uint32_t ms)
         rateshift = -rateshift;
     try
     {
-        if (mount->HasPPEC())
+        // PPEC is already off while a merged RA pulse runs
+        if (mount->HasPPEC() && !guideScheduler.isActive(AXIS_RA))
         {
             restartguidePPEC = false;
             if (PPECSP.getState() == IPS_BUSY)
@@ -2404,11 +2421,9 @@ IPState EQMod::GuideWest(uint32_t ms)
                 mount->TurnPPEC(false);
             }
         }
-        if (ms >= MinPulseTimerN->value)
+        if (ms >= MinPulseTimerN->value || guideScheduler.isActive(AXIS_RA))
         {
-            pulseInProgress |= 2;
-            GuideTimerWE = IEAddTimer(ms, (IE_TCF *)timedguideWECallback, this);
-            mount->StartRATracking(GetRATrackRate() + rateshift);
+            guidePulse(AXIS_RA, rateshift, ms);
         }
         else
         {
@@ -3181,6 +3196,14 @@ bool EQMod::MoveWE(INDI_DIR_WE dir, TelescopeMotionCommand command)
 
 bool EQMod::Abort()
 {
+    mount->StopMonitor();
+    // drop running guide pulses, the motors are stopped
+    if (GuideTimer != -1)
+        IERmTimer(GuideTimer);
+    GuideTimer = -1;
+    guideScheduler.reset(AXIS_RA);
+    guideScheduler.reset(AXIS_DE);
+    pulseInProgress = 0;
     try
     {
         mount->StopRA();
@@ -3226,57 +3249,104 @@ bool EQMod::Abort()
     return true;
 }
 
-void EQMod::timedguideNSCallback(void *userpointer)
+// Start or merge a timed guide pulse, rateshift is signed
+void EQMod::guidePulse(INDI_EQ_AXIS axis, double rateshift, uint32_t ms)
 {
-    EQMod *p = ((EQMod *)userpointer);
-    p->pulseInProgress &= ~1;
+    uint8_t pulsebit = (axis == AXIS_RA) ? 2 : 1;
+    int direction    = (rateshift >= 0.0) ? 1 : -1;
 
-    try
-    {
-        p->mount->StartDETracking(p->GetDETrackRate());
-    }
-    catch (EQModError e)
+    if (guideScheduler.pulse(axis, direction, ms, GuidePulseScheduler::now()) == GuidePulseScheduler::PULSE_START)
     {
-        if (!(e.DefaultHandleException(p)))
+        try
+        {
+            if (axis == AXIS_RA)
+                mount->StartRATracking(GetRATrackRate() + rateshift);
+            else
+                mount->StartDETracking(GetDETrackRate() + rateshift);
+        }
+        catch (EQModError &e)
         {
-            DEBUGDEVICE(p->getDeviceName(), INDI::Logger::DBG_WARNING,
-                        "Timed guide North/South Error: can not restart tracking");
+            guideScheduler.reset(axis);
+            pulseInProgress &= ~pulsebit;
+            scheduleGuideTimer();
+            throw;
         }
+        // the pulse is timed from the moment the mount accepted the rate
+        guideScheduler.started(axis, GuidePulseScheduler::now());
     }
-    p->GuideComplete(AXIS_DE);
-    DEBUGDEVICE(p->getDeviceName(), INDI::Logger::DBG_DEBUG, "End Timed guide North/South");
-    IERmTimer(p->GuideTimerNS);
+    else
+    {
+        DEBUGF(DBG_MOUNT, "Timed guide %d ms merged into the running %s pulse", ms, axis == AXIS_RA ? "RA" : "DE");
+    }
+    pulseInProgress |= pulsebit;
+    scheduleGuideTimer();
 }
 
-void EQMod::timedguideWECallback(void *userpointer)
+void EQMod::stopGuidePulse(INDI_EQ_AXIS axis)
 {
-    EQMod *p = ((EQMod *)userpointer);
-    p->pulseInProgress &= ~2;
+    pulseInProgress &= ~((axis == AXIS_RA) ? 2 : 1);
 
     try
     {
-        if (p->mount->HasPPEC())
+        if (axis == AXIS_RA)
         {
-            if (p->restartguidePPEC)
+            if (mount->HasPPEC())
             {
-                p->restartguidePPEC = false;
-                DEBUGDEVICE(p->getDeviceName(), INDI::Logger::DBG_SESSION, "Turning PPEC on after guiding.");
-                p->mount->TurnPPEC(true);
+                if (restartguidePPEC)
+                {
+                    restartguidePPEC = false;
+                    DEBUGDEVICE(getDeviceName(), INDI::Logger::DBG_SESSION, "Turning PPEC on after guiding.");
+                    mount->TurnPPEC(true);
+                }
             }
+            mount->StartRATracking(GetRATrackRate());
         }
-        p->mount->StartRATracking(p->GetRATrackRate());
+        else
+            mount->StartDETracking(GetDETrackRate());
     }
     catch (EQModError e)
     {
-        if (!(e.DefaultHandleException(p)))
+        if (!(e.DefaultHandleException(this)))
         {
-            DEBUGDEVICE(p->getDeviceName(), INDI::Logger::DBG_WARNING,
-                        "Timed guide West/East Error: can not restart tracking");
+            DEBUGFDEVICE(getDeviceName(), INDI::Logger::DBG_WARNING, "Timed guide %s Error: can not restart tracking",
+                         axis == AXIS_RA ? "West/East" : "North/South");
         }
     }
-    p->GuideComplete(AXIS_RA);
-    DEBUGDEVICE(p->getDeviceName(), INDI::Logger::DBG_DEBUG, "End Timed guide West/East");
-    IERmTimer(p->GuideTimerWE);
+
+    double applied = guideScheduler.stopped(axis, GuidePulseScheduler::now());
+    GuidePulseAppliedNP[axis].setValue(applied);
+    GuidePulseAppliedNP.setState(IPS_OK);
+    GuidePulseAppliedNP.apply();
+
+    GuideComplete(axis);
+    DEBUGFDEVICE(getDeviceName(), INDI::Logger::DBG_DEBUG, "End Timed guide %s, applied %.1f ms",
+                 axis == AXIS_RA ? "West/East" : "North/South", applied);
+}
+
+// Arm the event loop timer for the earliest end of the running pulses
+void EQMod::scheduleGuideTimer()
+{
+    if (GuideTimer != -1)
+        IERmTimer(GuideTimer);
+    GuideTimer = -1;
+
+    int64_t deadline = guideScheduler.nextDeadline();
+    if (deadline < 0)
+        return;
+    int64_t wait = std::max<int64_t>(deadline - GuidePulseScheduler::now(), 0);
+    GuideTimer   = IEAddTimer(static_cast<int>((wait + 500) / 1000), (IE_TCF *)timedguideCallback, this);
+}
+
+void EQMod::timedguideCallback(void *userpointer)
+{
+    EQMod *p      = ((EQMod *)userpointer);
+    p->GuideTimer = -1;
+
+    if (p->guideScheduler.isExpired(AXIS_RA, GuidePulseScheduler::now()))
+        p->stopGuidePulse(AXIS_RA);
+    if (p->guideScheduler.isExpired(AXIS_DE, GuidePulseScheduler::now()))
+        p->stopGuidePulse(AXIS_DE);
+    p->scheduleGuideTimer();
 }
 
 void EQMod::computePolarAlign(SyncData s1, SyncData s2, double lat, double *tpaalt, double *tpaaz)
@@ -19,6 +19,7 @@
 
 #include "config.h"
 #include "skywatcher.h"
+#include "guidescheduler.h"
 #ifdef WITH_ALIGN_GEEHALEL
 #include "align/align.h"
 #endif
@@ -85,8 +86,9 @@ protected:
     struct timespec lastclockupdate;
     double juliandate;
 
-    int GuideTimerNS;
-    int GuideTimerWE;
+    // Timed guide pulses
+    GuidePulseScheduler guideScheduler;
+    int GuideTimer {-1};
 
     // INumber *GuideRateN                        = nullptr;
     INDI::PropertyNumber   GuideRateNP         {INDI::Property()};
@@ -133,6 +135,7 @@ protected:
     INumber *MinPulseN                   = nullptr;
     INumber *MinPulseTimerN              = nullptr;
     INDI::PropertyNumber   PulseLimitsNP       {INDI::Property()};
+    INDI::PropertyNumber   GuidePulseAppliedNP {INDI::Property()};
 
     enum Hemisphere
     {
@@ -177,11 +180,14 @@ protected:
     double GetDETrackRate();
     double GetDefaultRATrackRate();
     double GetDefaultDETrackRate();
-    static void timedguideNSCallback(void *userpointer);
-    static void timedguideWECallback(void *userpointer);
+    void guidePulse(INDI_EQ_AXIS axis, double rateshift, uint32_t ms);
+    void stopGuidePulse(INDI_EQ_AXIS axis);
+    void scheduleGuideTimer();
+    static void timedguideCallback(void *userpointer);
     double GetRASlew();
     double GetDESlew();
     bool gotoInProgress();
+    void motionComplete();
 
     bool loadProperties();
 
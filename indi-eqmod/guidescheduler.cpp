@@ -0,0 +1,122 @@
+/* Copyright 2012 Geehalel (geehalel AT gmail DOT com) */
+/* This file is part of the Skywatcher Protocol INDI driver.
+
+    The Skywatcher Protocol INDI driver is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The Skywatcher Protocol INDI driver is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the Skywatcher Protocol INDI driver.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "guidescheduler.h"
+
+#include "mach_gettime.h"
+
+#include <algorithm>
+#include <time.h>
+
+int64_t GuidePulseScheduler::now()
+{
+    struct timespec ts;
+    // monotonic clock, mach clock on older OSX
+    get_utc_time(&ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+GuidePulseScheduler::Action GuidePulseScheduler::pulse(int axis, int direction, uint32_t ms, int64_t time)
+{
+    AxisPulse &p     = axes[axis];
+    int64_t duration = static_cast<int64_t>(ms) * 1000;
+
+    if (!p.active)
+    {
+        p           = AxisPulse();
+        p.active    = true;
+        p.direction = direction;
+        p.pending   = duration;
+        p.end       = time + duration;
+        return PULSE_START;
+    }
+
+    int64_t remaining = std::max<int64_t>(p.end - time, 0);
+    if (direction == p.direction)
+    {
+        p.pending += duration;
+        p.end = time + remaining + duration;
+        return PULSE_MERGED;
+    }
+    if (remaining >= duration)
+    {
+        p.pending -= duration;
+        p.end -= duration;
+        return PULSE_MERGED;
+    }
+
+    // reverse for what is left of the new pulse
+    p.direction = direction;
+    p.pending   = duration - remaining;
+    p.end       = time + p.pending;
+    return PULSE_START;
+}
+
+void GuidePulseScheduler::started(int axis, int64_t time)
+{
+    AxisPulse &p = axes[axis];
+    if (!p.applied)
+    {
+        p.applied = true;
+        p.start   = time;
+    }
+    p.end = time + p.pending;
+}
+
+void GuidePulseScheduler::reset(int axis)
+{
+    axes[axis] = AxisPulse();
+}
+
+bool GuidePulseScheduler::isActive(int axis) const
+{
+    return axes[axis].active;
+}
+
+bool GuidePulseScheduler::isExpired(int axis, int64_t time) const
+{
+    return axes[axis].active && axes[axis].applied && axes[axis].end - time <= EXPIRY_MARGIN;
+}
+
+int GuidePulseScheduler::direction(int axis) const
+{
+    return axes[axis].direction;
+}
+
+int64_t GuidePulseScheduler::nextDeadline() const
+{
+    int64_t deadline = -1;
+    for (int axis = 0; axis < NUMBER_OF_AXES; axis++)
+    {
+        if (axes[axis].active && axes[axis].applied && (deadline < 0 || axes[axis].end < deadline))
+            deadline = axes[axis].end;
+    }
+    return deadline;
+}
+
+double GuidePulseScheduler::stopped(int axis, int64_t time)
+{
+    if (axes[axis].applied)
+        applied[axis] = (time - axes[axis].start) / 1000.0;
+    axes[axis] = AxisPulse();
+    return applied[axis];
+}
+
+double GuidePulseScheduler::lastApplied(int axis) const
+{
+    return applied[axis];
+}
@@ -0,0 +1,69 @@
+/* Copyright 2012 Geehalel (geehalel AT gmail DOT com) */
+/* This file is part of the Skywatcher Protocol INDI driver.
+
+    The Skywatcher Protocol INDI driver is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The Skywatcher Protocol INDI driver is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the Skywatcher Protocol INDI driver.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+/* Timing of the timed guide pulses on both axes, times in microseconds of the monotonic clock.
+   RA and DE pulses run independently. A pulse received while one is active on the same axis is
+   merged into it: in the same direction the end is postponed, in the opposite direction it is
+   brought forward, or the direction is reversed for the remainder. Only starts and reversals
+   need a rate change on the mount, the end is counted from the moment the rate was applied. */
+class GuidePulseScheduler
+{
+    public:
+        enum Action
+        {
+            PULSE_MERGED, // nothing to send
+            PULSE_START   // apply the guide rate in the pulse direction, then call started()
+        };
+
+        static constexpr int NUMBER_OF_AXES = 2;
+
+        static int64_t now();
+
+        Action pulse(int axis, int direction, uint32_t ms, int64_t time);
+        void started(int axis, int64_t time);
+        void reset(int axis);
+
+        bool isActive(int axis) const;
+        bool isExpired(int axis, int64_t time) const;
+        int direction(int axis) const;
+        // earliest end of the running pulses, -1 if none
+        int64_t nextDeadline() const;
+        // end the pulse, returns the time in ms the guide rate was applied including merged pulses
+        double stopped(int axis, int64_t time);
+        double lastApplied(int axis) const;
+
+    private:
+        // a pulse ending within this margin is considered expired, the event loop has ms resolution
+        static constexpr int64_t EXPIRY_MARGIN = 500;
+
+        struct AxisPulse
+        {
+            bool active {false};
+            bool applied {false};
+            int direction {0};
+            int64_t start {0};
+            int64_t end {0};
+            int64_t pending {0};
+        };
+
+        AxisPulse axes[NUMBER_OF_AXES];
+        double applied[NUMBER_OF_AXES] {0, 0};
+};
@@ -22,6 +22,7 @@
 #include <indicom.h>
 
 #include <termios.h>
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
@@ -96,6 +97,7 @@ bool Skywatcher::Handshake()
 
 bool Skywatcher::Disconnect()
 {
+    ResetMonitor();
     if (PortFD < 0)
         return true;
 
@@ -247,7 +249,8 @@ void Skywatcher::GetRAMotorStatus(ILightVectorProperty *motorLP)
 
 void Skywatcher::GetRAMotorStatus(INDI::PropertyLight motorLP)
 {
-    ReadMotorStatus(Axis1);
+    // the motion monitor may have just read it
+    CheckMotorStatus(Axis1);
     if (!RAInitialized)
     {
         motorLP.findWidgetByName("RAInitialized")->setState(IPS_ALERT);
@@ -290,7 +293,8 @@ void Skywatcher::GetDEMotorStatus(ILightVectorProperty *motorLP)
 
 void Skywatcher::GetDEMotorStatus(INDI::PropertyLight motorLP)
 {
-    ReadMotorStatus(Axis2);
+    // the motion monitor may have just read it
+    CheckMotorStatus(Axis2);
     if (!DEInitialized)
     {
         motorLP.findWidgetByName("DEInitialized")->setState(IPS_ALERT);
@@ -790,15 +794,19 @@ void Skywatcher::InquireEncoderInfo(SkywatcherAxis axis, double *steppersvalues)
 bool Skywatcher::IsRARunning()
 {
     CheckMotorStatus(Axis1);
-    LOGF_DEBUG("%s() = %s", __FUNCTION__, (RARunning ? "true" : "false"));
-    return (RARunning);
+    // commands waiting for a stop will move the axis again
+    bool running = RARunning || stopping[Axis1] || !deferred[Axis1].empty();
+    LOGF_DEBUG("%s() = %s", __FUNCTION__, (running ? "true" : "false"));
+    return running;
 }
 
 bool Skywatcher::IsDERunning()
 {
     CheckMotorStatus(Axis2);
-    LOGF_DEBUG("%s() = %s", __FUNCTION__, (DERunning ? "true" : "false"));
-    return (DERunning);
+    // commands waiting for a stop will move the axis again
+    bool running = DERunning || stopping[Axis2] || !deferred[Axis2].empty();
+    LOGF_DEBUG("%s() = %s", __FUNCTION__, (running ? "true" : "false"));
+    return running;
 }
 
 void Skywatcher::ReadMotorStatus(SkywatcherAxis axis)
@@ -881,10 +889,12 @@ void Skywatcher::SlewRA(double rate)
         newstatus.speedmode = HIGHSPEED;
     else
         newstatus.speedmode = LOWSPEED;
-    SetMotion(Axis1, newstatus);
-    SetSpeed(Axis1, period);
-    if (!RARunning)
-        StartMotor(Axis1);
+    SetMotion(Axis1, newstatus, [this, period]()
+    {
+        SetSpeed(Axis1, period);
+        if (!RARunning)
+            StartMotor(Axis1);
+    });
 }
 
 void Skywatcher::SlewDE(double rate)
@@ -927,10 +937,12 @@ void Skywatcher::SlewDE(double rate)
         newstatus.speedmode = HIGHSPEED;
     else
         newstatus.speedmode = LOWSPEED;
-    SetMotion(Axis2, newstatus);
-    SetSpeed(Axis2, period);
-    if (!DERunning)
-        StartMotor(Axis2);
+    SetMotion(Axis2, newstatus, [this, period]()
+    {
+        SetSpeed(Axis2, period);
+        if (!DERunning)
+            StartMotor(Axis2);
+    });
 }
 
 void Skywatcher::SlewTo(int32_t deltaraencoder, int32_t deltadeencoder)
@@ -959,18 +971,22 @@ void Skywatcher::SlewTo(int32_t deltaraencoder, int32_t deltadeencoder)
         newstatus.speedmode = LOWSPEED;
     if (deltaraencoder > 0)
     {
-        SetMotion(Axis1, newstatus);
-        if (useHighSpeed)
-            SetSpeed(Axis1, minperiods[Axis1]);
-        else
-            SetSpeed(Axis1, lowperiod);
-        SetTarget(Axis1, deltaraencoder);
+        uint32_t period = useHighSpeed ? minperiods[Axis1] : lowperiod;
         if (useHighSpeed)
             breaks = ((deltaraencoder > 3200) ? 3200 : deltaraencoder / 10);
         else
             breaks = ((deltaraencoder > 200) ? 200 : deltaraencoder / 10);
-        SetTargetBreaks(Axis1, breaks);
-        StartMotor(Axis1);
+        double duration = PredictMotion(Axis1, deltaraencoder, period, newstatus.speedmode);
+        SetMotion(Axis1, newstatus, [this, period, deltaraencoder, breaks, duration]()
+        {
+            SetSpeed(Axis1, period);
+            SetTarget(Axis1, deltaraencoder);
+            SetTargetBreaks(Axis1, breaks);
+            StartMotor(Axis1, [this, duration]()
+            {
+                StartMonitor(Axis1, duration);
+            });
+        });
     }
 
     if (deltadeencoder >= 0)
@@ -989,18 +1005,22 @@ void Skywatcher::SlewTo(int32_t deltaraencoder, int32_t deltadeencoder)
         newstatus.speedmode = LOWSPEED;
     if (deltadeencoder > 0)
     {
-        SetMotion(Axis2, newstatus);
-        if (useHighSpeed)
-            SetSpeed(Axis2, minperiods[Axis2]);
-        else
-            SetSpeed(Axis2, lowperiod);
-        SetTarget(Axis2, deltadeencoder);
+        uint32_t period = useHighSpeed ? minperiods[Axis2] : lowperiod;
         if (useHighSpeed)
             breaks = ((deltadeencoder > 3200) ? 3200 : deltadeencoder / 10);
         else
             breaks = ((deltadeencoder > 200) ? 200 : deltadeencoder / 10);
-        SetTargetBreaks(Axis2, breaks);
-        StartMotor(Axis2);
+        double duration = PredictMotion(Axis2, deltadeencoder, period, newstatus.speedmode);
+        SetMotion(Axis2, newstatus, [this, period, deltadeencoder, breaks, duration]()
+        {
+            SetSpeed(Axis2, period);
+            SetTarget(Axis2, deltadeencoder);
+            SetTargetBreaks(Axis2, breaks);
+            StartMotor(Axis2, [this, duration]()
+            {
+                StartMonitor(Axis2, duration);
+            });
+        });
     }
 }
 
@@ -1035,19 +1055,23 @@ void Skywatcher::AbsSlewTo(uint32_t raencoder, uint32_t deencoder, bool raup, bo
         newstatus.speedmode = LOWSPEED;
     if (deltaraencoder > 0)
     {
-        SetMotion(Axis1, newstatus);
-        if (useHighSpeed)
-            SetSpeed(Axis1, minperiods[Axis1]);
-        else
-            SetSpeed(Axis1, lowperiod);
-        SetAbsTarget(Axis1, raencoder);
+        uint32_t period = useHighSpeed ? minperiods[Axis1] : lowperiod;
         if (useHighSpeed)
             breaks = ((deltaraencoder > 3200) ? 3200 : deltaraencoder / 10);
         else
             breaks = ((deltaraencoder > 200) ? 200 : deltaraencoder / 10);
         breaks = (raup ? (raencoder - breaks) : (raencoder + breaks));
-        SetAbsTargetBreaks(Axis1, breaks);
-        StartMotor(Axis1);
+        double duration = PredictMotion(Axis1, deltaraencoder, period, newstatus.speedmode);
+        SetMotion(Axis1, newstatus, [this, period, raencoder, breaks, duration]()
+        {
+            SetSpeed(Axis1, period);
+            SetAbsTarget(Axis1, raencoder);
+            SetAbsTargetBreaks(Axis1, breaks);
+            StartMotor(Axis1, [this, duration]()
+            {
+                StartMonitor(Axis1, duration);
+            });
+        });
     }
 
     if (deup)
@@ -1066,23 +1090,27 @@ void Skywatcher::AbsSlewTo(uint32_t raencoder, uint32_t deencoder, bool raup, bo
         newstatus.speedmode = LOWSPEED;
     if (deltadeencoder > 0)
     {
-        SetMotion(Axis2, newstatus);
-        if (useHighSpeed)
-            SetSpeed(Axis2, minperiods[Axis2]);
-        else
-            SetSpeed(Axis2, lowperiod);
-        SetAbsTarget(Axis2, deencoder);
+        uint32_t period = useHighSpeed ? minperiods[Axis2] : lowperiod;
         if (useHighSpeed)
             breaks = ((deltadeencoder > 3200) ? 3200 : deltadeencoder / 10);
         else
             breaks = ((deltadeencoder > 200) ? 200 : deltadeencoder / 10);
         breaks = (deup ? (deencoder - breaks) : (deencoder + breaks));
-        SetAbsTargetBreaks(Axis2, breaks);
-        StartMotor(Axis2);
+        double duration = PredictMotion(Axis2, deltadeencoder, period, newstatus.speedmode);
+        SetMotion(Axis2, newstatus, [this, period, deencoder, breaks, duration]()
+        {
+            SetSpeed(Axis2, period);
+            SetAbsTarget(Axis2, deencoder);
+            SetAbsTargetBreaks(Axis2, breaks);
+            StartMotor(Axis2, [this, duration]()
+            {
+                StartMonitor(Axis2, duration);
+            });
+        });
     }
 }
 
-void Skywatcher::SetRARate(double rate)
+void Skywatcher::SetRARate(double rate, std::function<void()> then)
 {
     double absrate       = fabs(rate);
     uint32_t period = 0;
@@ -1112,21 +1140,28 @@ void Skywatcher::SetRARate(double rate)
         newstatus.speedmode = HIGHSPEED;
     else
         newstatus.speedmode = LOWSPEED;
-    ReadMotorStatus(Axis1);
-    if (RARunning)
+    WhenStopped(Axis1, [this, newstatus, period, then]()
     {
-        if (newstatus.speedmode != RAStatus.speedmode)
-            throw EQModError(EQModError::ErrInvalidParameter,
-                             "Can not change rate while motor is running (speedmode differs).");
-        if (newstatus.direction != RAStatus.direction)
-            throw EQModError(EQModError::ErrInvalidParameter,
-                             "Can not change rate while motor is running (direction differs).");
-    }
-    SetMotion(Axis1, newstatus);
-    SetSpeed(Axis1, period);
+        ReadMotorStatus(Axis1);
+        if (RARunning)
+        {
+            if (newstatus.speedmode != RAStatus.speedmode)
+                throw EQModError(EQModError::ErrInvalidParameter,
+                                 "Can not change rate while motor is running (speedmode differs).");
+            if (newstatus.direction != RAStatus.direction)
+                throw EQModError(EQModError::ErrInvalidParameter,
+                                 "Can not change rate while motor is running (direction differs).");
+        }
+        SetMotion(Axis1, newstatus, [this, period, then]()
+        {
+            SetSpeed(Axis1, period);
+            if (then)
+                then();
+        });
+    });
 }
 
-void Skywatcher::SetDERate(double rate)
+void Skywatcher::SetDERate(double rate, std::function<void()> then)
 {
     double absrate       = fabs(rate);
     uint32_t period = 0;
@@ -1156,18 +1191,25 @@ void Skywatcher::SetDERate(double rate)
         newstatus.speedmode = HIGHSPEED;
     else
         newstatus.speedmode = LOWSPEED;
-    ReadMotorStatus(Axis2);
-    if (DERunning)
+    WhenStopped(Axis2, [this, newstatus, period, then]()
     {
-        if (newstatus.speedmode != DEStatus.speedmode)
-            throw EQModError(EQModError::ErrInvalidParameter,
-                             "Can not change rate while motor is running (speedmode differs).");
-        if (newstatus.direction != DEStatus.direction)
-            throw EQModError(EQModError::ErrInvalidParameter,
-                             "Can not change rate while motor is running (direction differs).");
-    }
-    SetMotion(Axis2, newstatus);
-    SetSpeed(Axis2, period);
+        ReadMotorStatus(Axis2);
+        if (DERunning)
+        {
+            if (newstatus.speedmode != DEStatus.speedmode)
+                throw EQModError(EQModError::ErrInvalidParameter,
+                                 "Can not change rate while motor is running (speedmode differs).");
+            if (newstatus.direction != DEStatus.direction)
+                throw EQModError(EQModError::ErrInvalidParameter,
+                                 "Can not change rate while motor is running (direction differs).");
+        }
+        SetMotion(Axis2, newstatus, [this, period, then]()
+        {
+            SetSpeed(Axis2, period);
+            if (then)
+                then();
+        });
+    });
 }
 
 void Skywatcher::StartRATracking(double trackspeed)
@@ -1181,12 +1223,19 @@ void Skywatcher::StartRATracking(double trackspeed)
                rate);
     if (rate != 0.0)
     {
-        SetRARate(rate);
-        if (!RARunning)
-            StartMotor(Axis1);
+        SetRARate(rate, [this]()
+        {
+            if (!RARunning)
+                StartMotor(Axis1);
+        });
     }
     else
-        StopMotor(Axis1);
+    {
+        WhenStopped(Axis1, [this]()
+        {
+            StopMotor(Axis1);
+        });
+    }
 }
 
 void Skywatcher::StartDETracking(double trackspeed)
@@ -1200,12 +1249,19 @@ void Skywatcher::StartDETracking(double trackspeed)
                rate);
     if (rate != 0.0)
     {
-        SetDERate(rate);
-        if (!DERunning)
-            StartMotor(Axis2);
+        SetDERate(rate, [this]()
+        {
+            if (!DERunning)
+                StartMotor(Axis2);
+        });
     }
     else
-        StopMotor(Axis2);
+    {
+        WhenStopped(Axis2, [this]()
+        {
+            StopMotor(Axis2);
+        });
+    }
 }
 
 void Skywatcher::SetSpeed(SkywatcherAxis axis, uint32_t period)
@@ -1515,7 +1571,7 @@ void Skywatcher::SetDEAxisPosition(uint32_t step)
     SetAxisPosition(Axis2, step);
 }
 
-void Skywatcher::StartMotor(SkywatcherAxis axis)
+void Skywatcher::StartMotor(SkywatcherAxis axis, std::function<void()> then)
 {
     bool usebacklash       = UseBacklash[axis];
     uint32_t backlash = Backlash[axis];
@@ -1530,8 +1586,6 @@ void Skywatcher::StartMotor(SkywatcherAxis axis)
             char cmd[7];
             char motioncmd[3] = "20";                                               // lowspeed goto
             motioncmd[1]      = (NewStatus[axis].direction == FORWARD ? '0' : '1'); // same direction
-            bool *motorrunning;
-            struct timespec wait;
             LOGF_INFO("Performing backlash compensation for axis %c, microsteps = %d", AxisCmd[axis],
                       backlash);
             // Axis Position
@@ -1556,79 +1610,102 @@ void Skywatcher::StartMotor(SkywatcherAxis axis)
             // Start Backlash
             dispatch_command(StartMotion, axis, nullptr);
             //read_eqmod();
-            // Wait end of backlash
-            if (axis == Axis1)
-                motorrunning = &RARunning;
-            else
-                motorrunning = &DERunning;
-            wait.tv_sec  = 0;
-            wait.tv_nsec = 100000000; // 100ms
-            ReadMotorStatus(axis);
-            while (*motorrunning)
-            {
-                nanosleep(&wait, nullptr);
-                ReadMotorStatus(axis);
-            }
-            // Restore microsteps
-            long2Revu24str(currentsteps, cmd);
-            dispatch_command(SetAxisPositionCmd, axis, cmd);
-            //read_eqmod();
-            // Restore Speed
-            long2Revu24str((axis == Axis1 ? RAPeriod : DEPeriod), cmd);
-            dispatch_command(SetStepPeriod, axis, cmd);
-            //read_eqmod();
-            // Restore motion mode
-            switch (NewStatus[axis].slewmode)
+            // Start the motion once the backlash steps are done
+            WaitMotorStop(axis, PredictMotion(axis, backlash, backlashperiod[axis], LOWSPEED),
+                          [this, axis, currentsteps, then]()
             {
-                case SLEW:
-                    if (NewStatus[axis].speedmode == LOWSPEED)
-                        motioncmd[0] = '1';
-                    else
-                        motioncmd[0] = '3';
-                    break;
-                case GOTO:
-                    if (NewStatus[axis].speedmode == LOWSPEED)
-                        motioncmd[0] = '2';
-                    else
-                        motioncmd[0] = '0';
-                    break;
-                default:
-                    motioncmd[0] = '1';
-                    break;
-            }
-            dispatch_command(SetMotionMode, axis, motioncmd);
-            //read_eqmod();
-            // Restore Target
-            long2Revu24str(Target[axis], cmd);
-            dispatch_command(SetGotoTargetIncrement, axis, cmd);
-            //read_eqmod();
-            // Restore Target breaks
-            long2Revu24str(TargetBreaks[axis], cmd);
-            dispatch_command(SetBreakPointIncrement, axis, cmd);
-            //read_eqmod();
+                RestoreMotion(axis, currentsteps);
+                dispatch_command(StartMotion, axis, nullptr);
+                if (then)
+                    then();
+            });
+            return;
         }
     }
     dispatch_command(StartMotion, axis, nullptr);
     //read_eqmod();
+    if (then)
+        then();
+}
+
+// Restores the position, speed, mode and target of the axis after the backlash steps
+void Skywatcher::RestoreMotion(SkywatcherAxis axis, uint32_t currentsteps)
+{
+    char cmd[7];
+    char motioncmd[3] = "20";
+    motioncmd[1]      = (NewStatus[axis].direction == FORWARD ? '0' : '1');
+    // Restore microsteps
+    long2Revu24str(currentsteps, cmd);
+    dispatch_command(SetAxisPositionCmd, axis, cmd);
+    //read_eqmod();
+    // Restore Speed
+    long2Revu24str((axis == Axis1 ? RAPeriod : DEPeriod), cmd);
+    dispatch_command(SetStepPeriod, axis, cmd);
+    //read_eqmod();
+    // Restore motion mode
+    switch (NewStatus[axis].slewmode)
+    {
+        case SLEW:
+            if (NewStatus[axis].speedmode == LOWSPEED)
+                motioncmd[0] = '1';
+            else
+                motioncmd[0] = '3';
+            break;
+        case GOTO:
+            if (NewStatus[axis].speedmode == LOWSPEED)
+                motioncmd[0] = '2';
+            else
+                motioncmd[0] = '0';
+            break;
+        default:
+            motioncmd[0] = '1';
+            break;
+    }
+    dispatch_command(SetMotionMode, axis, motioncmd);
+    //read_eqmod();
+    // Restore Target
+    long2Revu24str(Target[axis], cmd);
+    dispatch_command(SetGotoTargetIncrement, axis, cmd);
+    //read_eqmod();
+    // Restore Target breaks
+    long2Revu24str(TargetBreaks[axis], cmd);
+    dispatch_command(SetBreakPointIncrement, axis, cmd);
+    //read_eqmod();
 }
 
 void Skywatcher::StopRA()
 {
     LOGF_DEBUG("%s() : calling RA StopWaitMotor", __FUNCTION__);
-    StopWaitMotor(Axis1);
+    WhenStopped(Axis1, [this]()
+    {
+        StopWaitMotor(Axis1, nullptr);
+    });
 }
 
 void Skywatcher::StopDE()
 {
     LOGF_DEBUG("%s() : calling DE StopWaitMotor", __FUNCTION__);
-    StopWaitMotor(Axis2);
+    WhenStopped(Axis2, [this]()
+    {
+        StopWaitMotor(Axis2, nullptr);
+    });
 }
 
-void Skywatcher::SetMotion(SkywatcherAxis axis, SkywatcherAxisStatus newstatus)
+void Skywatcher::SetMotion(SkywatcherAxis axis, SkywatcherAxisStatus newstatus, std::function<void()> then)
 {
     char motioncmd[3];
     SkywatcherAxisStatus *currentstatus;
 
+    if (stopping[axis])
+    {
+        // change the motion once the stop in progress completed
+        deferred[axis].push_back([this, axis, newstatus, then]()
+        {
+            SetMotion(axis, newstatus, then);
+        });
+        return;
+    }
+
     DEBUGF(telescope->DBG_MOUNT, "%s() : Axis = %c -- dir=%s mode=%s speedmode=%s", __FUNCTION__, AxisCmd[axis],
            ((newstatus.direction == FORWARD) ? "forward" : "backward"),
            ((newstatus.slewmode == SLEW) ? "slew" : "goto"),
@@ -1672,12 +1749,20 @@ void Skywatcher::SetMotion(SkywatcherAxis axis, SkywatcherAxisStatus newstatus)
     if ((newstatus.direction != currentstatus->direction) || (newstatus.speedmode != currentstatus->speedmode) ||
             (newstatus.slewmode != currentstatus->slewmode))
     {
-        StopWaitMotor(axis);
-        dispatch_command(SetMotionMode, axis, motioncmd);
-        //read_eqmod();
+        StopWaitMotor(axis, [this, axis, newstatus, motioncmd, then]() mutable
+        {
+            dispatch_command(SetMotionMode, axis, motioncmd);
+            //read_eqmod();
+            NewStatus[axis] = newstatus;
+            if (then)
+                then();
+        });
+        return;
     }
     //#endif
     NewStatus[axis] = newstatus;
+    if (then)
+        then();
 }
 
 void Skywatcher::ResetMotions()
@@ -1738,10 +1823,8 @@ void Skywatcher::InstantStopMotor(SkywatcherAxis axis)
     //read_eqmod();
 }
 
-void Skywatcher::StopWaitMotor(SkywatcherAxis axis)
+void Skywatcher::StopWaitMotor(SkywatcherAxis axis, std::function<void()> then)
 {
-    bool *motorrunning;
-    struct timespec wait;
     ReadMotorStatus(axis);
     if (axis == Axis1 && RARunning)
         LastRunningStatus[Axis1] = RAStatus;
@@ -1750,17 +1833,197 @@ void Skywatcher::StopWaitMotor(SkywatcherAxis axis)
     DEBUGF(telescope->DBG_MOUNT, "%s() : Axis = %c", __FUNCTION__, AxisCmd[axis]);
     dispatch_command(NotInstantAxisStop, axis, nullptr);
     //read_eqmod();
-    if (axis == Axis1)
-        motorrunning = &RARunning;
-    else
-        motorrunning = &DERunning;
-    wait.tv_sec  = 0;
-    wait.tv_nsec = 100000000; // 100ms
-    ReadMotorStatus(axis);
-    while (*motorrunning)
+    WaitMotorStop(axis, 0, then);
+}
+
+/* Motion monitor
+   Instead of waiting for the next status poll, the motor status of a moving axis is read again
+   around its predicted end: rarely while far from it, every SKYWATCHER_MONITOR_MIN ms close to it,
+   and backing off if the prediction was too short. The callback then lets the driver complete
+   the goto right away. It runs on the event loop since the serial exchange is not thread safe.
+   Stops before a direction or mode change and backlash steps are waited for the same way: the
+   commands that follow are deferred on the axis and sent in order once it stopped, so guide
+   pulses and slews no longer block the event loop while the motor decelerates. */
+
+void Skywatcher::SetMotionCallback(std::function<void()> callback)
+{
+    motionCallback = callback;
+}
+
+// Duration in seconds of a motion of steps microsteps at the given period, ignoring acceleration
+double Skywatcher::PredictMotion(SkywatcherAxis axis, uint32_t steps, uint32_t period, SkywatcherSpeedMode speedmode)
+{
+    double speed = (axis == Axis1 ? RAStepsWorm : DEStepsWorm) / static_cast<double>(period == 0 ? 1 : period);
+    if (speedmode == HIGHSPEED)
+        speed *= (axis == Axis1 ? RAHighspeedRatio : DEHighspeedRatio);
+    return (speed > 0) ? steps / speed : 0;
+}
+
+void Skywatcher::StartMonitor(SkywatcherAxis axis, double duration)
+{
+    gettimeofday(&monitorend[axis], nullptr);
+    monitorend[axis].tv_sec += static_cast<time_t>(duration);
+    monitorend[axis].tv_usec += static_cast<suseconds_t>((duration - floor(duration)) * 1e6);
+    if (monitorend[axis].tv_usec >= 1000000)
+    {
+        monitorend[axis].tv_sec += 1;
+        monitorend[axis].tv_usec -= 1000000;
+    }
+    monitoring[axis] = true;
+    DEBUGF(telescope->DBG_MOUNT, "%s() : Axis = %c -- predicted duration %.2fs", __FUNCTION__, AxisCmd[axis], duration);
+    ScheduleMonitor();
+}
+
+void Skywatcher::StopMonitor()
+{
+    // an axis waiting for a stop keeps its monitor, commands are deferred on it
+    for (int axis = Axis1; axis < NUMBER_OF_SKYWATCHERAXIS; axis++)
+    {
+        if (!stopping[axis])
+            monitoring[axis] = false;
+    }
+    if (monitoring[Axis1] || monitoring[Axis2])
+        return;
+    if (monitorTimerID != -1)
+        IERmTimer(monitorTimerID);
+    monitorTimerID = -1;
+}
+
+// Drops the deferred commands along with the monitor, the motor status is unknown
+void Skywatcher::ResetMonitor()
+{
+    for (int axis = Axis1; axis < NUMBER_OF_SKYWATCHERAXIS; axis++)
+    {
+        if (!deferred[axis].empty())
+            LOGF_WARN("Dropping %d pending commands for axis %c", static_cast<int>(deferred[axis].size()), AxisCmd[axis]);
+        stopping[axis] = false;
+        deferred[axis].clear();
+    }
+    StopMonitor();
+}
+
+void Skywatcher::ScheduleMonitor()
+{
+    struct timeval now;
+    double interval = SKYWATCHER_MONITOR_MAX;
+    gettimeofday(&now, nullptr);
+    for (int axis = Axis1; axis < NUMBER_OF_SKYWATCHERAXIS; axis++)
+    {
+        if (!monitoring[axis])
+            continue;
+        double remaining = (monitorend[axis].tv_sec - now.tv_sec) * 1000.0 +
+                           (monitorend[axis].tv_usec - now.tv_usec) / 1000.0;
+        // halve the distance to the predicted end, then back off once it is passed
+        interval = std::min(interval, (remaining > 0) ? remaining / 2 : -remaining / 4);
+    }
+    interval = std::max(interval, static_cast<double>(SKYWATCHER_MONITOR_MIN));
+
+    if (monitorTimerID != -1)
+        IERmTimer(monitorTimerID);
+    monitorTimerID = IEAddTimer(static_cast<int>(interval), (IE_TCF *)monitorCallback, this);
+}
+
+void Skywatcher::monitorCallback(void *userpointer)
+{
+    Skywatcher *p = static_cast<Skywatcher *>(userpointer);
+    p->monitorTimerID = -1;
+    p->MonitorMotors();
+}
+
+void Skywatcher::MonitorMotors()
+{
+    bool gotostopped = false;
+    try
+    {
+        for (int axis = Axis1; axis < NUMBER_OF_SKYWATCHERAXIS; axis++)
+        {
+            if (!monitoring[axis])
+                continue;
+            ReadMotorStatus(static_cast<SkywatcherAxis>(axis));
+            if ((axis == Axis1) ? RARunning : DERunning)
+                continue;
+            monitoring[axis] = false;
+            if (stopping[axis])
+            {
+                stopping[axis] = false;
+                RunDeferred(static_cast<SkywatcherAxis>(axis));
+            }
+            else
+                gotostopped = true;
+        }
+    }
+    catch (EQModError &e)
+    {
+        // leave it to the regular status update
+        DEBUGF(telescope->DBG_MOUNT, "%s() : %s", __FUNCTION__, e.message);
+        ResetMonitor();
+        return;
+    }
+
+    // the deferred commands may have started a goto on the axis
+    bool gotorunning = false;
+    for (int axis = Axis1; axis < NUMBER_OF_SKYWATCHERAXIS; axis++)
+    {
+        if (monitoring[axis] && !stopping[axis])
+            gotorunning = true;
+    }
+    if (monitoring[Axis1] || monitoring[Axis2])
+        ScheduleMonitor();
+
+    if (!gotostopped || gotorunning)
+        return;
+
+    DEBUGF(telescope->DBG_MOUNT, "%s() : motion complete", __FUNCTION__);
+    if (motionCallback)
+        motionCallback();
+}
+
+// Runs then once the axis stopped, duration is the predicted time left until it stops.
+// Commands for the axis issued meanwhile are deferred after it.
+void Skywatcher::WaitMotorStop(SkywatcherAxis axis, double duration, std::function<void()> then)
+{
+    if (duration <= 0)
     {
-        nanosleep(&wait, nullptr);
         ReadMotorStatus(axis);
+        if (!((axis == Axis1) ? RARunning : DERunning))
+        {
+            if (then)
+                then();
+            return;
+        }
+    }
+    deferred[axis].push_front(then);
+    stopping[axis] = true;
+    StartMonitor(axis, duration);
+}
+
+// Runs command now, or after the stop in progress on the axis
+void Skywatcher::WhenStopped(SkywatcherAxis axis, std::function<void()> command)
+{
+    if (stopping[axis])
+        deferred[axis].push_back(command);
+    else
+        command();
+}
+
+void Skywatcher::RunDeferred(SkywatcherAxis axis)
+{
+    try
+    {
+        // a command may stop the axis again, the rest then waits for that stop
+        while (!stopping[axis] && !deferred[axis].empty())
+        {
+            std::function<void()> command = deferred[axis].front();
+            deferred[axis].pop_front();
+            if (command)
+                command();
+        }
+    }
+    catch (EQModError &e)
+    {
+        // the caller already returned, report it here and drop what depended on it
+        deferred[axis].clear();
+        e.DefaultHandleException(telescope);
     }
 }
 
@@ -23,6 +23,8 @@
 
 #include <lilxml.h>
 
+#include <deque>
+#include <functional>
 #include <time.h>
 #include <sys/time.h>
 
@@ -45,6 +47,10 @@ class EQMod; // TODO
 #define SKYWATCHER_BACKLASH_SPEED_RA 64
 #define SKYWATCHER_BACKLASH_SPEED_DE 64
 
+// Motor status poll interval bounds (ms) while waiting for the end of a motion
+#define SKYWATCHER_MONITOR_MIN  20
+#define SKYWATCHER_MONITOR_MAX  1000
+
 #define HEX(c) (((c) < 'A') ? ((c) - '0') : ((c) - 'A') + 10)
 
 class Skywatcher
@@ -105,8 +111,9 @@ class Skywatcher
         void SlewDE(double rate);
         void StopRA();
         void StopDE();
-        void SetRARate(double rate);
-        void SetDERate(double rate);
+        // then runs once the rate is set, after a stop the rate change needs
+        void SetRARate(double rate, std::function<void()> then = nullptr);
+        void SetDERate(double rate, std::function<void()> then = nullptr);
         void SlewTo(int32_t deltaraencoder, int32_t deltadeencoder);
         void AbsSlewTo(uint32_t raencoder, uint32_t deencoder, bool raup, bool deup);
         void StartRATracking(double trackspeed);
@@ -150,6 +157,10 @@ class Skywatcher
 
         void setPortFD(int value);
 
+        // Called from the event loop once all axes of a goto stopped
+        void SetMotionCallback(std::function<void()> callback);
+        void StopMonitor();
+
     private:
         // Official Skywatcher Protocol
         // See http://code.google.com/p/skywatcher/wiki/SkyWatcherProtocol
@@ -269,16 +280,17 @@ class Skywatcher
         void InquireEncoderInfo(SkywatcherAxis axis, double *steppersvalues);
         void CheckMotorStatus(SkywatcherAxis axis);
         void ReadMotorStatus(SkywatcherAxis axis);
-        void SetMotion(SkywatcherAxis axis, SkywatcherAxisStatus newstatus);
+        void SetMotion(SkywatcherAxis axis, SkywatcherAxisStatus newstatus, std::function<void()> then);
         void SetSpeed(SkywatcherAxis axis, uint32_t period);
         void SetTarget(SkywatcherAxis axis, uint32_t increment);
         void SetTargetBreaks(SkywatcherAxis axis, uint32_t increment);
         void SetAbsTarget(SkywatcherAxis axis, uint32_t target);
         void SetAbsTargetBreaks(SkywatcherAxis axis, uint32_t breakstep);
-        void StartMotor(SkywatcherAxis axis);
+        void StartMotor(SkywatcherAxis axis, std::function<void()> then = nullptr);
+        void RestoreMotion(SkywatcherAxis axis, uint32_t currentsteps);
         void StopMotor(SkywatcherAxis axis);
         void InstantStopMotor(SkywatcherAxis axis);
-        void StopWaitMotor(SkywatcherAxis axis);
+        void StopWaitMotor(SkywatcherAxis axis, std::function<void()> then);
         void SetFeature(SkywatcherAxis axis, uint32_t command);
         void GetFeature(SkywatcherAxis axis, uint32_t command);
         void TurnEncoder(SkywatcherAxis axis, bool on);
@@ -289,6 +301,17 @@ class Skywatcher
         void SetAxisPosition(SkywatcherAxis axis, uint32_t step);
         void TurnSnapPort(SkywatcherAxis axis, bool on);
 
+        // Motion monitor
+        double PredictMotion(SkywatcherAxis axis, uint32_t steps, uint32_t period, SkywatcherSpeedMode speedmode);
+        void StartMonitor(SkywatcherAxis axis, double duration);
+        void ScheduleMonitor();
+        void MonitorMotors();
+        static void monitorCallback(void *userpointer);
+        void ResetMonitor();
+        void WaitMotorStop(SkywatcherAxis axis, double duration, std::function<void()> then);
+        void WhenStopped(SkywatcherAxis axis, std::function<void()> command);
+        void RunDeferred(SkywatcherAxis axis);
+
         bool read_eqmod();
         bool dispatch_command(SkywatcherCommand cmd, SkywatcherAxis axis, char *arg);
 
@@ -356,6 +379,15 @@ class Skywatcher
 
         bool snapportstatus[NUMBER_OF_SKYWATCHERAXIS];
 
+        // Motion monitor
+        bool monitoring[NUMBER_OF_SKYWATCHERAXIS] {false, false};
+        struct timeval monitorend[NUMBER_OF_SKYWATCHERAXIS]; // predicted end of the motion
+        int monitorTimerID {-1};
+        std::function<void()> motionCallback;
+        // axis waiting for a stop, and the commands deferred until then
+        bool stopping[NUMBER_OF_SKYWATCHERAXIS] {false, false};
+        std::deque<std::function<void()>> deferred[NUMBER_OF_SKYWATCHERAXIS];
+
         const long EQMOD_TIMEOUT = 200000; // us
         const uint8_t EQMOD_MAX_RETRY = 10;
 };
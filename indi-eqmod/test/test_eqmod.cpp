@@ -185,6 +185,70 @@ TEST(EqmodTest, encoder_target_south)
     eqmod.TestEncoderTarget();
 }
 
+TEST(EqmodTest, guide_pulse_overlap)
+{
+    GuidePulseScheduler scheduler;
+
+    // RA and DE pulses run independently, each ends relative to when its rate was applied
+    ASSERT_EQ(scheduler.pulse(AXIS_RA, 1, 200, 0), GuidePulseScheduler::PULSE_START);
+    scheduler.started(AXIS_RA, 5000);
+    ASSERT_EQ(scheduler.pulse(AXIS_DE, -1, 100, 10000), GuidePulseScheduler::PULSE_START);
+    scheduler.started(AXIS_DE, 15000);
+
+    EXPECT_EQ(scheduler.nextDeadline(), 115000);
+    EXPECT_FALSE(scheduler.isExpired(AXIS_DE, 100000));
+    EXPECT_TRUE(scheduler.isExpired(AXIS_DE, 115000));
+    EXPECT_DOUBLE_EQ(scheduler.stopped(AXIS_DE, 116000), 101.0);
+
+    EXPECT_EQ(scheduler.nextDeadline(), 205000);
+    EXPECT_FALSE(scheduler.isExpired(AXIS_RA, 115000));
+    EXPECT_DOUBLE_EQ(scheduler.stopped(AXIS_RA, 205000), 200.0);
+    EXPECT_EQ(scheduler.nextDeadline(), -1);
+}
+
+TEST(EqmodTest, guide_pulse_coalesce)
+{
+    GuidePulseScheduler scheduler;
+
+    ASSERT_EQ(scheduler.pulse(AXIS_RA, 1, 100, 0), GuidePulseScheduler::PULSE_START);
+    scheduler.started(AXIS_RA, 0);
+
+    // same direction: postponed, no rate change
+    EXPECT_EQ(scheduler.pulse(AXIS_RA, 1, 100, 50000), GuidePulseScheduler::PULSE_MERGED);
+    EXPECT_EQ(scheduler.nextDeadline(), 200000);
+
+    // opposite and shorter than the remainder: brought forward
+    EXPECT_EQ(scheduler.pulse(AXIS_RA, -1, 50, 100000), GuidePulseScheduler::PULSE_MERGED);
+    EXPECT_EQ(scheduler.nextDeadline(), 150000);
+    EXPECT_EQ(scheduler.direction(AXIS_RA), 1);
+
+    // opposite and longer: reversed for the rest
+    EXPECT_EQ(scheduler.pulse(AXIS_RA, -1, 80, 120000), GuidePulseScheduler::PULSE_START);
+    EXPECT_EQ(scheduler.direction(AXIS_RA), -1);
+    scheduler.started(AXIS_RA, 121000);
+    EXPECT_EQ(scheduler.nextDeadline(), 171000);
+
+    // applied time covers the whole merged pulse
+    EXPECT_DOUBLE_EQ(scheduler.stopped(AXIS_RA, 171000), 171.0);
+    EXPECT_DOUBLE_EQ(scheduler.lastApplied(AXIS_RA), 171.0);
+    EXPECT_FALSE(scheduler.isActive(AXIS_RA));
+}
+
+TEST(EqmodTest, guide_pulse_late_merge)
+{
+    GuidePulseScheduler scheduler;
+
+    // a pulse arriving after the end was missed still gets its full duration
+    ASSERT_EQ(scheduler.pulse(AXIS_DE, 1, 100, 0), GuidePulseScheduler::PULSE_START);
+    scheduler.started(AXIS_DE, 0);
+    EXPECT_EQ(scheduler.pulse(AXIS_DE, 1, 100, 150000), GuidePulseScheduler::PULSE_MERGED);
+    EXPECT_EQ(scheduler.nextDeadline(), 250000);
+
+    scheduler.reset(AXIS_DE);
+    EXPECT_FALSE(scheduler.isActive(AXIS_DE));
+    EXPECT_EQ(scheduler.nextDeadline(), -1);
+}
+
 #ifdef WITH_SCOPE_LIMITS
 TEST(EqmodTest, scope_limits_properties)
 {
@@ -17,10 +17,11 @@
  */
 
 #include <sys/time.h>
+#include <algorithm>
 #include <memory>
 #include <stdint.h>
-#include <arpa/inet.h>
 #include <math.h>
+#include <poll.h>
 #include <sys/time.h>
 #include <dc1394/dc1394.h>
 #include <indiapi.h>
@@ -80,6 +81,8 @@ FFMVCCD::FFMVCCD()
     InExposure = false;
     capturing  = false;
 
+    last_exposure_length = -1;
+
     setVersion(FFMV_VERSION_MAJOR, FFMV_VERSION_MINOR);
 
     SetCCDCapability(CCD_CAN_ABORT);
@@ -261,6 +264,7 @@ bool FFMVCCD::Disconnect()
 {
     if (dcam)
     {
+        stopCapture();
         dc1394_capture_stop(dcam);
         dc1394_camera_free(dcam);
     }
@@ -297,6 +301,17 @@ bool FFMVCCD::initProperties()
     IUFillSwitchVector(&GainSP, GainS, 2, getDeviceName(), "GAIN", "Gain", IMAGE_SETTINGS_TAB, IP_WO, ISR_NOFMANY, 0,
                        IPS_IDLE);
 
+    /* Subs stacking */
+    IUFillSwitch(&StackS[FFMVStack::STACK_SUM], "STACK_SUM", "Sum", ISS_ON);
+    IUFillSwitch(&StackS[FFMVStack::STACK_AVERAGE], "STACK_AVERAGE", "Average", ISS_OFF);
+    IUFillSwitch(&StackS[FFMVStack::STACK_SIGMA], "STACK_SIGMA", "Sigma clip", ISS_OFF);
+    IUFillSwitchVector(&StackSP, StackS, 3, getDeviceName(), "CCD_STACK", "Stacking", IMAGE_SETTINGS_TAB, IP_RW,
+                       ISR_1OFMANY, 0, IPS_IDLE);
+
+    IUFillNumber(&StackKappaN[0], "KAPPA", "Kappa", "%.1f", 1, 5, 0.5, 3);
+    IUFillNumberVector(&StackKappaNP, StackKappaN, 1, getDeviceName(), "CCD_STACK_KAPPA", "Sigma clip",
+                       IMAGE_SETTINGS_TAB, IP_RW, 0, IPS_IDLE);
+
     setDefaultPollingPeriod(250);
 
     return true;
@@ -319,10 +334,14 @@ bool FFMVCCD::updateProperties()
         // Start the timer
         SetTimer(getCurrentPollingPeriod());
         defineProperty(&GainSP);
+        defineProperty(&StackSP);
+        defineProperty(&StackKappaNP);
     }
     else
     {
         deleteProperty(GainSP.name);
+        deleteProperty(StackSP.name);
+        deleteProperty(StackKappaNP.name);
     }
 
     return true;
@@ -352,7 +371,6 @@ void FFMVCCD::setupParams()
 bool FFMVCCD::StartExposure(float duration)
 {
     dc1394error_t err;
-    dc1394video_frame_t *frame;
     int ms;
     float sub_length;
     float fval;
@@ -372,11 +390,6 @@ bool FFMVCCD::StartExposure(float duration)
     InExposure = true;
     LOG_ERROR("Exposure has begun.");
 
-    // Let's get a pointer to the frame buffer
-    uint8_t *image = PrimaryCCD.getFrameBuffer();
-
-    memset(image, 0, PrimaryCCD.getFrameBufferSize());
-
     if (duration != last_exposure_length)
     {
         /* Calculate the number of exposures needed */
@@ -408,8 +421,39 @@ bool FFMVCCD::StartExposure(float duration)
             LOG_ERROR("Unable to get shutter value.");
         }
         LOGF_DEBUG("Shutter value is %f.", fval);
+        last_exposure_length = duration;
     }
 
+    size_t pixels = (PrimaryCCD.getSubW() / PrimaryCCD.getBinX()) * (PrimaryCCD.getSubH() / PrimaryCCD.getBinY());
+    FFMVStack::Mode mode = static_cast<FFMVStack::Mode>(IUFindOnSwitchIndex(&StackSP));
+    double kappa = StackKappaN[0].value;
+
+    // waits for the previous exposure to be captured
+    captureWorker.start([this, pixels, mode, kappa](const std::atomic_bool &isAboutToQuit)
+    {
+        workerCapture(isAboutToQuit, pixels, mode, kappa);
+    });
+
+    // We're done
+    return true;
+}
+
+/**
+ * Captures the subs of an exposure and hands them to the stack worker, which stacks a sub while
+ * the next one is dequeued. All dc1394 capture calls are made from this thread.
+ */
+void FFMVCCD::workerCapture(const std::atomic_bool &isAboutToQuit, size_t pixels, FFMVStack::Mode mode,
+                            double kappa)
+{
+    dc1394error_t err;
+    dc1394video_frame_t *frame;
+    int subs = sub_count;
+    bool failed = false;
+    struct timeval start;
+
+    // subs of the previous exposure still held by the stack worker
+    recycleFrames();
+
     /* Flush the DMA buffer */
     while (1)
     {
@@ -426,6 +470,13 @@ bool FFMVCCD::StartExposure(float duration)
         dc1394_capture_enqueue(dcam, frame);
     }
 
+    stackWorker.start([this, pixels, subs, mode, kappa](const std::atomic_bool &)
+    {
+        if (stack.begin(pixels, subs, mode, kappa) != mode)
+            LOGF_WARN("Not enough memory to sigma clip %d subs (limit %zu MB), averaging them instead.", subs,
+                      FFMVStack::SIGMA_MAX_BYTES / (1024 * 1024));
+    });
+
     /*-----------------------------------------------------------------------
      *  have the camera start sending us data
      *-----------------------------------------------------------------------*/
@@ -434,11 +485,110 @@ bool FFMVCCD::StartExposure(float duration)
     if (err != DC1394_SUCCESS)
     {
         LOG_ERROR("Unable to start transmission");
-        return false;
+        InExposure = false;
+        PrimaryCCD.setExposureFailed();
+        return;
     }
 
-    // We're done
-    return true;
+    struct pollfd pfd;
+    pfd.fd     = dc1394_capture_get_fileno(dcam);
+    pfd.events = POLLIN;
+
+    for (int sub = 0; sub < subs && !isAboutToQuit;)
+    {
+        recycleFrames();
+
+        // wait for the next sub, but keep an eye on abort
+        if (poll(&pfd, 1, 100) <= 0)
+            continue;
+
+        err = dc1394_capture_dequeue(dcam, DC1394_CAPTURE_POLICY_POLL, &frame);
+        if (err != DC1394_SUCCESS)
+        {
+            LOG_ERROR("Could not capture frame");
+            failed = true;
+            break;
+        }
+        if (!frame)
+            continue;
+
+        LOGF_DEBUG("Getting sub %d of %d", sub++, subs);
+        if (DC1394_TRUE == dc1394_capture_is_frame_corrupt(dcam, frame))
+        {
+            LOG_ERROR("Corrupt frame!");
+            dc1394_capture_enqueue(dcam, frame);
+            continue;
+        }
+        if (frame->image_bytes < pixels * 2)
+        {
+            LOG_ERROR("Frame is smaller than the subframe!");
+            dc1394_capture_enqueue(dcam, frame);
+            continue;
+        }
+
+        // waits for the previous sub to be stacked
+        stackWorker.start([this, frame](const std::atomic_bool &)
+        {
+            stack.add(frame->image);
+            releaseFrame(frame);
+        });
+    }
+
+    /*-----------------------------------------------------------------------
+    *  stop data transmission
+    *-----------------------------------------------------------------------*/
+    dc1394_video_set_transmission(dcam, DC1394_OFF);
+
+    if (isAboutToQuit)
+        return;
+
+    gettimeofday(&start, nullptr);
+    stackWorker.start([this, failed, start](const std::atomic_bool &)
+    {
+        std::unique_lock<std::mutex> guard(ccdBufferLock);
+        bool stacked = !failed && stack.finish(reinterpret_cast<uint16_t *>(PrimaryCCD.getFrameBuffer()));
+        guard.unlock();
+
+        InExposure = false;
+        if (!stacked)
+        {
+            LOG_ERROR("No sub could be captured.");
+            PrimaryCCD.setExposureFailed();
+            return;
+        }
+
+        struct timeval end;
+        gettimeofday(&end, nullptr);
+        LOGF_DEBUG("Stacked %d subs, %d uS after the last one", stack.count(),
+                   (int)((end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec)));
+
+        // Let INDI::CCD know we're done filling the image buffer
+        ExposureComplete(&PrimaryCCD);
+    });
+}
+
+/* Called by the stack worker, the capture thread gives the frame back to the DMA ring. */
+void FFMVCCD::releaseFrame(dc1394video_frame_t *frame)
+{
+    std::lock_guard<std::mutex> guard(releasedFramesLock);
+    releasedFrames.push_back(frame);
+}
+
+void FFMVCCD::recycleFrames()
+{
+    std::lock_guard<std::mutex> guard(releasedFramesLock);
+    for (auto frame : releasedFrames)
+        dc1394_capture_enqueue(dcam, frame);
+    releasedFrames.clear();
+}
+
+/* Stops the workers and hands all frames back, from the main thread. */
+void FFMVCCD::stopCapture()
+{
+    captureWorker.quit();
+    stackWorker.quit();
+    recycleFrames();
+    dc1394_video_set_transmission(dcam, DC1394_OFF);
 }
 
 /**************************************************************************************
@@ -446,6 +596,7 @@ bool FFMVCCD::StartExposure(float duration)
 ***************************************************************************************/
 bool FFMVCCD::AbortExposure()
 {
+    stopCapture();
     InExposure = false;
     return true;
 }
@@ -558,118 +709,64 @@ bool FFMVCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, ch
             setDigitalGain(GainS[1].s);
             return true;
         }
+
+        /* Stacking */
+        if (!strcmp(name, StackSP.name))
+        {
+            if (IUUpdateSwitch(&StackSP, states, names, n) < 0)
+            {
+                return false;
+            }
+            StackSP.s = IPS_OK;
+            IDSetSwitch(&StackSP, nullptr);
+            saveConfig(true, StackSP.name);
+            return true;
+        }
     }
 
     //  Nobody has claimed this, so, ignore it
     return INDI::CCD::ISNewSwitch(dev, name, states, names, n);
 }
 
-/**************************************************************************************
-** Main device loop. We check for exposure progress
-***************************************************************************************/
-void FFMVCCD::TimerHit()
+bool FFMVCCD::ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n)
 {
-    if (isConnected() == false)
-        return;
-
-    if (InExposure)
+    if (strcmp(dev, getDeviceName()) == 0)
     {
-        double timeleft = CalcTimeLeft();
-
-        // Less than a 0.1 second away from exposure completion
-        // This is an over simplified timing method, check CCDSimulator and ffmvCCD for better timing checks
-        if (timeleft < 0.1)
+        if (!strcmp(name, StackKappaNP.name))
         {
-            /* We're done exposing */
-            LOG_DEBUG("Exposure done, downloading image...");
-
-            // Set exposure left to zero
-            PrimaryCCD.setExposureLeft(0);
-
-            // We're no longer exposing...
-            InExposure = false;
-
-            /* grab and save image */
-            grabImage();
-        }
-        else
-        {
-            // Just update time left in client
-            PrimaryCCD.setExposureLeft(timeleft);
+            IUUpdateNumber(&StackKappaNP, values, names, n);
+            StackKappaNP.s = IPS_OK;
+            IDSetNumber(&StackKappaNP, nullptr);
+            saveConfig(true, StackKappaNP.name);
+            return true;
         }
     }
 
-    SetTimer(getCurrentPollingPeriod());
-    return;
+    return INDI::CCD::ISNewNumber(dev, name, values, names, n);
 }
 
-/**
- * Download image from FireFly
- */
-void FFMVCCD::grabImage()
+bool FFMVCCD::saveConfigItems(FILE *fp)
 {
-    dc1394error_t err;
-    dc1394video_frame_t *frame;
-    uint32_t uheight, uwidth;
-    int sub;
-    uint16_t val;
-    struct timeval start, end;
+    INDI::CCD::saveConfigItems(fp);
 
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
-    // Let's get a pointer to the frame buffer
-    uint8_t *image = PrimaryCCD.getFrameBuffer();
+    IUSaveConfigSwitch(fp, &StackSP);
+    IUSaveConfigNumber(fp, &StackKappaNP);
 
-    // Get width and height
-    int width  = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
-    int height = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
-
-    memset(image, 0, PrimaryCCD.getFrameBufferSize());
-
-    /*-----------------------------------------------------------------------
-    *  stop data transmission
-    *-----------------------------------------------------------------------*/
-
-    gettimeofday(&start, nullptr);
-    for (sub = 0; sub < sub_count; ++sub)
-    {
-        LOGF_DEBUG("Getting sub %d of %d", sub, sub_count);
-        err = dc1394_capture_dequeue(dcam, DC1394_CAPTURE_POLICY_WAIT, &frame);
-        if (err != DC1394_SUCCESS)
-        {
-            LOG_ERROR("Could not capture frame");
-        }
-        dc1394_get_image_size_from_video_mode(dcam, DC1394_VIDEO_MODE_640x480_MONO16, &uwidth, &uheight);
+    return true;
+}
 
-        if (DC1394_TRUE == dc1394_capture_is_frame_corrupt(dcam, frame))
-        {
-            LOG_ERROR("Corrupt frame!");
-            continue;
-        }
-        // Fill buffer with random pattern
-        for (int i = 0; i < height; i++)
-        {
-            for (int j = 0; j < width; j++)
-            {
-                /* Detect unsigned overflow */
-                val = ((uint16_t *)image)[i * width + j] + ntohs(((uint16_t *)(frame->image))[i * width + j]);
-                if (val > ((uint16_t *)image)[i * width + j])
-                {
-                    ((uint16_t *)image)[i * width + j] = val;
-                }
-                else
-                {
-                    ((uint16_t *)image)[i * width + j] = 0xFFFF;
-                }
-            }
-        }
+/**************************************************************************************
+** Main device loop. We check for exposure progress
+***************************************************************************************/
+void FFMVCCD::TimerHit()
+{
+    if (isConnected() == false)
+        return;
 
-        dc1394_capture_enqueue(dcam, frame);
-    }
-    guard.unlock();
-    err = dc1394_video_set_transmission(dcam, DC1394_OFF);
-    gettimeofday(&end, nullptr);
-    LOGF_DEBUG("Download took %d uS", (int)((end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec)));
+    // The workers complete the exposure once the last sub is stacked
+    if (InExposure)
+        PrimaryCCD.setExposureLeft(std::max(CalcTimeLeft(), 0.0f));
 
-    // Let INDI::CCD know we're done filling the image buffer
-    ExposureComplete(&PrimaryCCD);
+    SetTimer(getCurrentPollingPeriod());
+    return;
 }
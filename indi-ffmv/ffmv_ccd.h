@@ -21,8 +21,15 @@
 #define FFMVCCD_H
 
 #include <indiccd.h>
+#include <indisinglethreadpool.h>
 #include <dc1394/dc1394.h>
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "ffmv_stack.h"
+
 using namespace std;
 
 class FFMVCCD : public INDI::CCD
@@ -31,6 +38,7 @@ class FFMVCCD : public INDI::CCD
     FFMVCCD();
 
     virtual bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n);
+    virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n);
 
   protected:
     // General device functions
@@ -45,19 +53,24 @@ class FFMVCCD : public INDI::CCD
     bool AbortExposure();
     void TimerHit();
 
+    bool saveConfigItems(FILE *fp);
+
   private:
     // Utility functions
     float CalcTimeLeft();
     void setupParams();
-    void grabImage();
+    void workerCapture(const std::atomic_bool &isAboutToQuit, size_t pixels, FFMVStack::Mode mode, double kappa);
+    void stopCapture();
+    void releaseFrame(dc1394video_frame_t *frame);
+    void recycleFrames();
     dc1394error_t writeMicronReg(unsigned int offset, unsigned int val);
     dc1394error_t readMicronReg(unsigned int offset, unsigned int *val);
 
     dc1394error_t setGainVref(ISState iss);
     dc1394error_t setDigitalGain(ISState state);
 
-    // Are we exposing?
-    bool InExposure;
+    // Are we exposing? Cleared by the stack worker.
+    std::atomic_bool InExposure;
     bool capturing;
     // Struct to keep timing
     struct timeval ExpStart;
@@ -70,6 +83,21 @@ class FFMVCCD : public INDI::CCD
     ISwitch GainS[2];
     ISwitchVectorProperty GainSP;
 
+    ISwitch StackS[3];
+    ISwitchVectorProperty StackSP;
+
+    INumber StackKappaN[1];
+    INumberVectorProperty StackKappaNP;
+
+    // dequeues the subs, stacking runs on stackWorker one frame behind
+    INDI::SingleThreadPool captureWorker;
+    INDI::SingleThreadPool stackWorker;
+    FFMVStack stack;
+
+    // frames stacked and waiting to be given back to the DMA ring by the capture thread
+    std::vector<dc1394video_frame_t *> releasedFrames;
+    std::mutex releasedFramesLock;
+
     dc1394_t *dc1394;
     dc1394camera_t *dcam;
 
@@ -0,0 +1,111 @@
+/**
+ * Copyright (C) 2013 Ben Gilsrud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "ffmv_stack.h"
+#include "frame_kernels.h"
+
+#include <algorithm>
+#include <new>
+#include <math.h>
+
+FFMVStack::Mode FFMVStack::begin(size_t pixels, int subs, Mode mode, double kappa)
+{
+    if (mode == STACK_SIGMA && pixels * subs * sizeof(uint16_t) > SIGMA_MAX_BYTES)
+        mode = STACK_AVERAGE;
+
+    this->pixels = pixels;
+    this->kappa  = kappa;
+    frames       = 0;
+
+    // the buffers are kept from one exposure to the next, the subs only while sigma clipping
+    sum.assign(pixels, 0);
+    if (mode == STACK_SIGMA)
+    {
+        try
+        {
+            this->subs.resize(pixels * subs);
+        }
+        catch (const std::bad_alloc &)
+        {
+            mode = STACK_AVERAGE;
+        }
+    }
+    if (mode != STACK_SIGMA)
+        std::vector<uint16_t>().swap(this->subs);
+
+    this->mode = mode;
+    return mode;
+}
+
+void FFMVStack::add(const uint8_t *frame)
+{
+    FrameKernels::addSwapped16(sum.data(), frame, pixels);
+    if (mode == STACK_SIGMA && (frames + 1) * pixels <= subs.size())
+        FrameKernels::swap16(subs.data() + frames * pixels, frame, pixels);
+    frames++;
+}
+
+bool FFMVStack::finish(uint16_t *image)
+{
+    if (frames == 0)
+        return false;
+
+    if (mode == STACK_SUM || frames == 1)
+        FrameKernels::saturate16(image, sum.data(), pixels);
+    // rejection needs at least three values to tell an outlier
+    else if (mode == STACK_SIGMA && frames >= 3 && frames * pixels <= subs.size())
+        finishSigma(image);
+    else
+    {
+        for (size_t i = 0; i < pixels; i++)
+            image[i] = (sum[i] + frames / 2) / frames;
+    }
+    return true;
+}
+
+void FFMVStack::finishSigma(uint16_t *image)
+{
+    std::vector<uint64_t> squares(pixels, 0);
+    for (int f = 0; f < frames; f++)
+    {
+        const uint16_t *sub = subs.data() + f * pixels;
+        for (size_t i = 0; i < pixels; i++)
+            squares[i] += static_cast<uint32_t>(sub[i]) * sub[i];
+    }
+
+    for (size_t i = 0; i < pixels; i++)
+    {
+        double mean  = static_cast<double>(sum[i]) / frames;
+        double sigma = sqrt(std::max(static_cast<double>(squares[i]) / frames - mean * mean, 0.0));
+        double limit = kappa * sigma;
+
+        uint32_t kept = 0, count = 0;
+        for (int f = 0; f < frames; f++)
+        {
+            uint16_t value = subs[f * pixels + i];
+            if (fabs(value - mean) <= limit)
+            {
+                kept += value;
+                count++;
+            }
+        }
+
+        // a kappa below 1 may reject every value, keep the plain mean then
+        image[i] = count ? (kept + count / 2) / count : static_cast<uint16_t>(mean + 0.5);
+    }
+}
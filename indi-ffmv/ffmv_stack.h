@@ -0,0 +1,68 @@
+/**
+ * INDI driver for Point Grey FireFly MV camera.
+ *
+ * Copyright (C) 2013 Ben Gilsrud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef FFMVSTACK_H
+#define FFMVSTACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Accumulates the subs of an exposure longer than the camera shutter allows.
+ * Frames are added as they come from the camera (16 bit big endian) into a 32 bit sum,
+ * so nothing saturates before the last sub. The sum is narrowed to 16 bit by finish().
+ */
+class FFMVStack
+{
+  public:
+    enum Mode
+    {
+        STACK_SUM,     // sum of the subs, saturated at 0xFFFF
+        STACK_AVERAGE, // mean of the subs
+        STACK_SIGMA    // mean of the subs within kappa sigma of the pixel mean
+    };
+
+    // sigma rejection keeps every sub, above this it falls back to the average
+    static constexpr size_t SIGMA_MAX_BYTES = 256 * 1024 * 1024;
+
+    /* Starts a new stack of up to subs frames of the given number of pixels. Returns the mode
+       used, STACK_AVERAGE if the subs of a sigma stack do not fit in SIGMA_MAX_BYTES or memory. */
+    Mode begin(size_t pixels, int subs, Mode mode, double kappa);
+    /* Adds a frame in camera byte order. */
+    void add(const uint8_t *frame);
+    /* Writes the result in host byte order. Returns false if no frame was added. */
+    bool finish(uint16_t *image);
+
+    int count() const { return frames; }
+
+  private:
+    void finishSigma(uint16_t *image);
+
+    Mode mode { STACK_SUM };
+    double kappa { 3 };
+    size_t pixels { 0 };
+    int frames { 0 };
+
+    std::vector<uint32_t> sum;
+    // subs in host byte order, only kept for sigma rejection
+    std::vector<uint16_t> subs;
+};
+
+#endif // FFMVSTACK_H
@@ -0,0 +1,210 @@
+/**
+ * Copyright (C) 2013 Ben Gilsrud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Offline benchmark of the FireFly MV sub stacking.
+ *
+ * Synthetic dc1394 frames (MONO16, big endian like the camera sends them) with noise and a few
+ * hot pixels are stacked by the per-pixel loop the driver used before FFMVStack, and by
+ * FFMVStack in each mode. The sum is checked against the old loop. No camera or INDI server
+ * is needed. Built with -DINDI_FFMV_BENCHMARK=ON, results are printed as JSON on stdout.
+ */
+
+#include "ffmv_stack.h"
+
+#include <dc1394/dc1394.h>
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct SyntheticFrame
+{
+    dc1394video_frame_t frame;
+    std::unique_ptr<uint8_t[]> image;
+};
+
+static void makeFrames(std::vector<SyntheticFrame> &frames, uint32_t width, uint32_t height, int subs)
+{
+    size_t pixels = static_cast<size_t>(width) * height;
+    srand(1);
+    frames.resize(subs);
+    for (auto &sub : frames)
+    {
+        memset(&sub.frame, 0, sizeof(sub.frame));
+        sub.image.reset(new uint8_t[pixels * 2]);
+        sub.frame.image          = sub.image.get();
+        sub.frame.size[0]        = width;
+        sub.frame.size[1]        = height;
+        sub.frame.color_coding   = DC1394_COLOR_CODING_MONO16;
+        sub.frame.data_depth     = 16;
+        sub.frame.stride         = width * 2;
+        sub.frame.video_mode     = DC1394_VIDEO_MODE_640x480_MONO16;
+        sub.frame.image_bytes    = pixels * 2;
+        sub.frame.little_endian  = DC1394_FALSE;
+
+        uint16_t *image = reinterpret_cast<uint16_t *>(sub.image.get());
+        for (size_t i = 0; i < pixels; i++)
+        {
+            uint16_t value = 1000 + (i % width) + rand() % 64;
+            // a cosmic or hot pixel in about one pixel out of a thousand
+            if (rand() % 1000 == 0)
+                value = 60000;
+            image[i] = htons(value);
+        }
+    }
+}
+
+// The loop FFMVCCD::grabImage ran for every sub before FFMVStack
+static void oldStack(uint16_t *image, const dc1394video_frame_t *frame, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++)
+    {
+        /* Detect unsigned overflow */
+        uint16_t val = image[i] + ntohs(((uint16_t *)(frame->image))[i]);
+        if (val > image[i])
+            image[i] = val;
+        else
+            image[i] = 0xFFFF;
+    }
+}
+
+static double toMS(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+struct StackResult
+{
+    double addMS {0};    // per sub
+    double finishMS {0}; // once per exposure
+};
+
+static StackResult runStack(FFMVStack::Mode mode, const std::vector<SyntheticFrame> &frames, size_t pixels,
+                            int rounds, std::vector<uint16_t> &image)
+{
+    StackResult result;
+    FFMVStack stack;
+    for (int round = 0; round < rounds; round++)
+    {
+        stack.begin(pixels, frames.size(), mode, 3);
+        auto start = Clock::now();
+        for (auto &sub : frames)
+            stack.add(sub.frame.image);
+        auto added = Clock::now();
+        stack.finish(image.data());
+        result.addMS    += toMS(added - start);
+        result.finishMS += toMS(Clock::now() - added);
+    }
+    result.addMS    /= static_cast<double>(rounds) * frames.size();
+    result.finishMS /= rounds;
+    return result;
+}
+
+static void printResult(const char *name, const StackResult &result, int subs, bool last)
+{
+    // the driver stacks each sub while the next one is exposed, only the last add and finish
+    // are left once the exposure is over
+    printf("    \"%s\": {\"add_ms\": %.3f, \"finish_ms\": %.3f, \"after_last_sub_ms\": %.3f, \"total_ms\": %.3f}%s\n",
+           name, result.addMS, result.finishMS, result.addMS + result.finishMS, result.addMS * subs + result.finishMS,
+           last ? "" : ",");
+}
+
+static void printUsage(const char *progName)
+{
+    printf("Usage: %s [width height subs rounds]\n", progName);
+    printf("Example: %s 640 480 32 20\n", progName);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t width = 640, height = 480;
+    int subs = 32, rounds = 20;
+
+    if (argc > 1 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")))
+    {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    if (argc > 1)
+        width = strtoul(argv[1], nullptr, 10);
+    if (argc > 2)
+        height = strtoul(argv[2], nullptr, 10);
+    if (argc > 3)
+        subs = atoi(argv[3]);
+    if (argc > 4)
+        rounds = atoi(argv[4]);
+
+    if (width == 0 || height == 0 || subs <= 0 || rounds <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    size_t pixels = static_cast<size_t>(width) * height;
+    std::vector<SyntheticFrame> frames;
+    makeFrames(frames, width, height, subs);
+
+    StackResult old;
+    std::vector<uint16_t> reference(pixels);
+    for (int round = 0; round < rounds; round++)
+    {
+        memset(reference.data(), 0, pixels * 2);
+        auto start = Clock::now();
+        for (auto &sub : frames)
+            oldStack(reference.data(), &sub.frame, pixels);
+        old.addMS += toMS(Clock::now() - start);
+    }
+    old.addMS /= static_cast<double>(rounds) * subs;
+
+    std::vector<uint16_t> image(pixels);
+    StackResult sum = runStack(FFMVStack::STACK_SUM, frames, pixels, rounds, image);
+    bool identical = image == reference;
+    StackResult average = runStack(FFMVStack::STACK_AVERAGE, frames, pixels, rounds, image);
+    StackResult sigma = runStack(FFMVStack::STACK_SIGMA, frames, pixels, rounds, image);
+
+    printf("{\n");
+    printf("  \"driver\": \"indi_ffmv\",\n");
+    printf("  \"frame\": {\"width\": %u, \"height\": %u, \"subs\": %d},\n", width, height, subs);
+#if defined(__SSE2__)
+    printf("  \"kernels\": \"sse2\",\n");
+#elif defined(__ARM_NEON)
+    printf("  \"kernels\": \"neon\",\n");
+#else
+    printf("  \"kernels\": \"scalar\",\n");
+#endif
+    printf("  \"stack\": {\n");
+    // the old loop ran on the main loop for every sub once the exposure was over
+    printf("    \"old\": {\"add_ms\": %.3f, \"after_last_sub_ms\": %.3f, \"total_ms\": %.3f},\n", old.addMS,
+           old.addMS * subs, old.addMS * subs);
+    printResult("sum", sum, subs, false);
+    printResult("average", average, subs, false);
+    printResult("sigma", sigma, subs, true);
+    printf("  },\n");
+    printf("  \"sum_matches_old\": %s\n", identical ? "true" : "false");
+    printf("}\n");
+
+    return identical ? 0 : 1;
+}
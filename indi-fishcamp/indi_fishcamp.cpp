@@ -19,9 +19,13 @@
  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <time.h>
 #include <math.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/time.h>
 #include <deque>
@@ -31,6 +35,7 @@
 
 #include "indi_fishcamp.h"
 #include "config.h"
+#include "ccd_ready_wait.h"
 
 #define MAX_CCD_TEMP   45   /* Max CCD temperature */
 #define MIN_CCD_TEMP   -55  /* Min CCD temperature */
@@ -38,6 +43,7 @@
 #define MAX_Y_BIN      16   /* Max Vertical binning */
 #define MAX_PIXELS     4096 /* Max number of pixels in one dimension */
 #define TEMP_THRESHOLD .25  /* Differential temperature threshold (C)*/
+#define READY_POLL_MAX 100  /* Longest camera state poll interval, the readout is short (ms) */
 
 static class Loader
 {
@@ -199,6 +205,7 @@ bool FishCampCCD::ISNewNumber(const char *dev, const char *name, double values[]
 
 bool FishCampCCD::setGain(double gain)
 {
+    std::lock_guard<std::mutex> lock(cameraLock);
     int rc = fcUsb_cmd_setCameraGain(cameraNum, ((int)gain));
 
     LOGF_DEBUG("fcUsb_cmd_setCameraGain returns %d", rc);
@@ -210,6 +217,7 @@ int FishCampCCD::SetTemperature(double temperature)
 {
     TemperatureRequest = temperature;
 
+    std::unique_lock<std::mutex> lock(cameraLock);
     int rc = fcUsb_cmd_setTemperature(cameraNum, TemperatureRequest);
 
     LOGF_DEBUG("fcUsb_cmd_setTemperature returns %d", rc);
@@ -218,6 +226,7 @@ int FishCampCCD::SetTemperature(double temperature)
         CoolerNP.s = IPS_OK;
     else
         CoolerNP.s = IPS_IDLE;
+    lock.unlock();
 
     TemperatureNP.setState(IPS_BUSY);
     TemperatureNP.apply();
@@ -240,28 +249,51 @@ bool FishCampCCD::Connect()
     if (sim)
     {
         LOG_INFO("Simulated Fishcamp is online.");
-        return true;
     }
-
-    if (fcUsb_haveCamera())
+    else if (fcUsb_haveCamera())
     {
         fcUsb_cmd_setReadMode(cameraNum, fc_classicDataXfr, fc_16b_data);
         fcUsb_cmd_setCameraGain(cameraNum, GainN[0].value);
         fcUsb_cmd_setRoi(cameraNum, 0, 0, camInfo.width - 1, camInfo.height - 1);
         if (fcUsb_cmd_getTECInPowerOK(cameraNum))
             CoolerNP.s = IPS_OK;
-        LOG_INFO("Fishcamp CCD is online.");
-        return true;
     }
     else
     {
         LOG_ERROR("Cannot find Fishcamp CCD. Please check the logfile and try again.");
         return false;
     }
+
+    // Downloaded frames are handed from the readout worker to the main loop through a pipe
+    if (pipe(readyPipe) != 0)
+    {
+        LOGF_ERROR("Failed to create the readout pipe. %s.", strerror(errno));
+        return false;
+    }
+    fcntl(readyPipe[0], F_SETFL, O_NONBLOCK);
+    readyCallbackID = IEAddCallback(readyPipe[0], frameReadyHelper, this);
+
+    LOG_INFO("Fishcamp CCD is online.");
+    return true;
 }
 
 bool FishCampCCD::Disconnect()
 {
+    readoutWorker.quit();
+    stopPulses(guideNS);
+    stopPulses(guideWE);
+    if (readyCallbackID >= 0)
+    {
+        IERmCallback(readyCallbackID);
+        readyCallbackID = -1;
+    }
+    for (int &fd : readyPipe)
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+
     LOG_INFO("Fishcamp CCD is offline.");
 
     if (sim)
@@ -281,12 +313,14 @@ bool FishCampCCD::StartExposure(float duration)
 
     LOGF_DEBUG("Exposure Time (s) is: %g", duration);
 
+    std::unique_lock<std::mutex> lock(cameraLock);
     // setup the exposure time in ms.
     rc = fcUsb_cmd_setIntegrationTime(cameraNum, (UInt32)(duration * 1000.0));
 
     LOGF_DEBUG("fcUsb_cmd_setIntegrationTime returns %d", rc);
 
     rc = fcUsb_cmd_startExposure(cameraNum);
+    lock.unlock();
 
     LOGF_DEBUG("fcUsb_cmd_startExposure returns %d", rc);
 
@@ -295,6 +329,7 @@ bool FishCampCCD::StartExposure(float duration)
     LOGF_INFO("Taking a %g seconds frame...", ExposureRequest);
 
     InExposure = true;
+    readoutWorker.start(std::bind(&FishCampCCD::workerExposure, this, std::placeholders::_1));
 
     return (rc == 0);
 }
@@ -303,7 +338,12 @@ bool FishCampCCD::AbortExposure()
 {
     int rc = 0;
 
+    readoutWorker.quit();
+    dropPendingFrames();
+
+    std::unique_lock<std::mutex> lock(cameraLock);
     rc = fcUsb_cmd_abortExposure(cameraNum);
+    lock.unlock();
 
     LOGF_DEBUG("fcUsb_cmd_abortExposure returns %d", rc);
 
@@ -348,7 +388,9 @@ bool FishCampCCD::UpdateCCDFrame(int x, int y, int w, int h)
     LOGF_DEBUG("The Final image area is (%ld, %ld), (%ld, %ld)\n", x_1, y_1, bin_width,
                bin_height);
 
+    std::unique_lock<std::mutex> lock(cameraLock);
     rc = fcUsb_cmd_setRoi(cameraNum, x_1, y_1,  x_1 + w - 1, y_1 + h - 1);
+    lock.unlock();
 
     LOGF_DEBUG("fcUsb_cmd_setRoi returns %d", rc);
 
@@ -391,88 +433,133 @@ float FishCampCCD::CalcTimeLeft()
     return timeleft;
 }
 
-/* Downloads the image from the CCD.*/
+bool FishCampCCD::waitImageReady(const std::atomic_bool &isAboutToQuit)
+{
+    auto timeLeft = [this]()
+    {
+        return CalcTimeLeft();
+    };
+    auto showTimeLeft = [this](float timeleft)
+    {
+        PrimaryCCD.setExposureLeft(timeleft);
+    };
+    if (!ReadyWait::countdown(isAboutToQuit, timeLeft, showTimeLeft))
+        return false;
+
+    if (sim)
+        return true;
+
+    return ReadyWait::poll(isAboutToQuit, [this]()
+    {
+        std::lock_guard<std::mutex> lock(cameraLock);
+        return fcUsb_cmd_getState(cameraNum) == 0 ? ReadyWait::State::Ready : ReadyWait::State::Busy;
+    }, READY_POLL_MAX);
+}
+
+void FishCampCCD::workerExposure(const std::atomic_bool &isAboutToQuit)
+{
+    if (!waitImageReady(isAboutToQuit))
+        return;
+
+    /* We're done exposing */
+    PrimaryCCD.setExposureLeft(0);
+    LOG_DEBUG("Exposure done, downloading image...");
+    LOGF_DEBUG("Camera ready %.3f s after the end of exposure.", -CalcTimeLeft());
+
+    struct timeval start, end;
+    gettimeofday(&start, nullptr);
+
+    char result = grabImage() == 0 ? 1 : 0;
+
+    gettimeofday(&end, nullptr);
+    LOGF_DEBUG("Download took %.3f s.", (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6);
+
+    if (write(readyPipe[1], &result, 1) != 1)
+        LOG_ERROR("Failed to hand over the downloaded image.");
+}
+
+/* Downloads the image from the CCD into the readout buffer.*/
 int FishCampCCD::grabImage()
 {
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
-    uint8_t *image = PrimaryCCD.getFrameBuffer();
-    UInt16 *frameBuffer = (UInt16 *)image;
-    int numBytes = fcUsb_cmd_getRawFrame(cameraNum, PrimaryCCD.getSubW(), PrimaryCCD.getSubH(), frameBuffer);
-    guard.unlock();
-    if(numBytes != 0)
+    std::lock_guard<std::mutex> guard(readoutBufferLock);
+    readoutBuffer.resize(static_cast<size_t>(PrimaryCCD.getSubW()) * PrimaryCCD.getSubH());
+
+    if (sim)
     {
-        LOG_INFO("Download complete.");
-        ExposureComplete(&PrimaryCCD);
+        for (auto &pixel : readoutBuffer)
+            pixel = rand() % UINT16_MAX;
         return 0;
     }
-    else
+
+    std::lock_guard<std::mutex> lock(cameraLock);
+    int numBytes = fcUsb_cmd_getRawFrame(cameraNum, PrimaryCCD.getSubW(), PrimaryCCD.getSubH(), readoutBuffer.data());
+
+    return numBytes != 0 ? 0 : -1;
+}
+
+void FishCampCCD::frameReadyHelper(int fd, void *context)
+{
+    INDI_UNUSED(fd);
+    static_cast<FishCampCCD *>(context)->frameReady();
+}
+
+/* Runs on the main loop once the worker has downloaded a frame, or failed to. */
+void FishCampCCD::frameReady()
+{
+    char result = 0;
+    if (read(readyPipe[0], &result, 1) != 1)
+        return;
+
+    InExposure = false;
+    if (result == 0)
     {
         LOG_INFO("Download error. Please check the log for details.");
-        ExposureComplete(&PrimaryCCD);  //This should be an error. It is not complete, it messed up!
-        return -1;
+        PrimaryCCD.setExposureFailed();
+        return;
     }
 
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    {
+        std::lock_guard<std::mutex> lock(readoutBufferLock);
+        size_t size = readoutBuffer.size() * sizeof(UInt16);
+        if (size > static_cast<size_t>(PrimaryCCD.getFrameBufferSize()))
+        {
+            guard.unlock();
+            LOG_ERROR("Frame buffer too small for the downloaded image.");
+            PrimaryCCD.setExposureFailed();
+            return;
+        }
+        memcpy(PrimaryCCD.getFrameBuffer(), readoutBuffer.data(), size);
+    }
+    guard.unlock();
+
+    LOG_INFO("Download complete.");
+    ExposureComplete(&PrimaryCCD);
+}
+
+/* Discards frames the worker handed over after the exposure was aborted. */
+void FishCampCCD::dropPendingFrames()
+{
+    char result;
+    while (readyPipe[0] >= 0 && read(readyPipe[0], &result, 1) == 1)
+        ;
 }
 
 void FishCampCCD::TimerHit()
 {
-    int timerHitID = -1, state = -1, rc = -1;
-    float timeleft;
+    int rc = -1;
     double ccdTemp;
 
     if (!isConnected())
         return; //  No need to reset timer if we are not connected anymore
 
-    if (InExposure)
+    // The exposure is followed by the readout worker. While it holds the camera for the
+    // download, skip the status queries rather than blocking the main loop until it is done.
+    std::unique_lock<std::mutex> lock(cameraLock, std::try_to_lock);
+    if (!lock.owns_lock())
     {
-        timeleft = CalcTimeLeft();
-
-        if (timeleft < 1.0)
-        {
-            if (timeleft > 0.25)
-            {
-                //  a quarter of a second or more
-                //  just set a tighter timer
-                timerHitID = SetTimer(250);
-            }
-            else
-            {
-                if (timeleft > 0.07)
-                {
-                    //  use an even tighter timer
-                    timerHitID = SetTimer(50);
-                }
-                else
-                {
-                    //  it's real close now, so spin on it
-                    //  We have to wait till the camera is ready to download
-                    bool ready = false;
-                    int slv;
-                    slv = fabs(100000 * timeleft); //0.05s (50000 us) is checked every 5000 us or so
-                    while (!sim && !ready)
-                    {
-                        state = fcUsb_cmd_getState(cameraNum);
-                        if (state == 0)
-                            ready = true;
-                        else
-                            usleep(slv);
-                    }
-
-                    /* We're done exposing */
-                    LOG_DEBUG("Exposure done, downloading image...");
-
-                    PrimaryCCD.setExposureLeft(0);
-                    InExposure = false;
-                    /* grab and save image */
-                    grabImage();
-                }
-            }
-        }
-        else
-        {
-            LOGF_DEBUG("Image not yet ready. With time left %ld\n", timeleft);
-            PrimaryCCD.setExposureLeft(timeleft);
-        }
+        SetTimer(getCurrentPollingPeriod());
+        return;
     }
 
     switch (TemperatureNP.getState())
@@ -532,63 +619,85 @@ void FishCampCCD::TimerHit()
             break;
     }
 
-    if (timerHitID == -1)
-        SetTimer(getCurrentPollingPeriod());
+    SetTimer(getCurrentPollingPeriod());
     return;
 }
 
 IPState FishCampCCD::GuideNorth(uint32_t ms)
 {
-    if (sim)
-        return IPS_OK;
-
-    int rc = 0;
-
-    rc = fcUsb_cmd_pulseRelay(cameraNum, fcRELAYNORTH, ms, 0, false);
-
-    LOGF_DEBUG("fcUsb_cmd_pulseRelay fcRELAYNORTH returns %d", rc);
-
-    return IPS_OK;
+    return pulseRelay(guideNS, fcRELAYNORTH, ms);
 }
 
 IPState FishCampCCD::GuideSouth(uint32_t ms)
 {
-    if (sim)
-        return IPS_OK;
-
-    int rc = 0;
-
-    rc = fcUsb_cmd_pulseRelay(cameraNum, fcRELAYSOUTH, ms, 0, false);
+    return pulseRelay(guideNS, fcRELAYSOUTH, ms);
+}
 
-    LOGF_DEBUG("fcUsb_cmd_pulseRelay fcRELAYSOUTH returns %d", rc);
+IPState FishCampCCD::GuideEast(uint32_t ms)
+{
+    return pulseRelay(guideWE, fcRELAYEAST, ms);
+}
 
-    return IPS_OK;
+IPState FishCampCCD::GuideWest(uint32_t ms)
+{
+    return pulseRelay(guideWE, fcRELAYWEST, ms);
 }
 
-IPState FishCampCCD::GuideEast(uint32_t ms)
+/* The relay is timed by the camera. The command is sent from a worker, a download in progress
+   delays it but not the main loop, which completes the pulse once it is sent. The worker is only
+   started when idle, so that SingleThreadPool::start never waits for a pulse stuck behind a download. */
+IPState FishCampCCD::pulseRelay(GuideRelay &guide, int relay, uint32_t ms)
 {
     if (sim)
         return IPS_OK;
 
-    int rc = 0;
-
-    rc = fcUsb_cmd_pulseRelay(cameraNum, fcRELAYEAST, ms, 0, false);
-
-    LOGF_DEBUG("fcUsb_cmd_pulseRelay fcRELAYEAST returns %d", rc);
+    INDI_EQ_AXIS axis = (relay == fcRELAYNORTH || relay == fcRELAYSOUTH) ? AXIS_DE : AXIS_RA;
+    std::lock_guard<std::mutex> guard(guide.lock);
+    if (guide.pending)
+        LOGF_DEBUG("Guide pulse on relay %d replaced by relay %d before it was sent", guide.relay, relay);
+    guide.pending = true;
+    guide.relay   = relay;
+    guide.ms      = ms;
+    if (!guide.running)
+    {
+        guide.running = true;
+        guide.worker.start([this, &guide, axis](const std::atomic_bool &isAboutToQuit)
+        {
+            sendPulses(guide, axis, isAboutToQuit);
+        });
+    }
 
-    return IPS_OK;
+    return IPS_BUSY;
 }
 
-IPState FishCampCCD::GuideWest(uint32_t ms)
+void FishCampCCD::sendPulses(GuideRelay &guide, INDI_EQ_AXIS axis, const std::atomic_bool &isAboutToQuit)
 {
-    if (sim)
-        return IPS_OK;
+    std::unique_lock<std::mutex> guard(guide.lock);
+    while (guide.pending && !isAboutToQuit)
+    {
+        int relay   = guide.relay;
+        uint32_t ms = guide.ms;
+        guide.pending = false;
+        guard.unlock();
 
-    int rc = 0;
+        std::unique_lock<std::mutex> lock(cameraLock);
+        int rc = fcUsb_cmd_pulseRelay(cameraNum, relay, ms, 0, false);
+        lock.unlock();
 
-    rc = fcUsb_cmd_pulseRelay(cameraNum, fcRELAYWEST, ms, 0, false);
+        LOGF_DEBUG("fcUsb_cmd_pulseRelay %d returns %d", relay, rc);
+        guard.lock();
+    }
+    guide.running = false;
+    guard.unlock();
 
-    LOGF_DEBUG("fcUsb_cmd_pulseRelay fcRELAYWEST returns %d", rc);
+    GuideComplete(axis);
+}
 
-    return IPS_OK;
+void FishCampCCD::stopPulses(GuideRelay &guide)
+{
+    {
+        std::lock_guard<std::mutex> guard(guide.lock);
+        guide.pending = false;
+    }
+    guide.worker.quit();
 }
@@ -23,7 +23,11 @@
 #define FISHCAMP_CCD_H
 
 #include <indiccd.h>
+#include <indisinglethreadpool.h>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 #include <fishcamp.h>
 
@@ -97,6 +101,38 @@ class FishCampCCD : public INDI::CCD
 
     bool sim;
 
+    // libfishcamp shares one command buffer for all calls, they must not overlap
+    std::mutex cameraLock;
+
+    // Readout, runs on the worker until the frame is downloaded, then hands it to the main loop
+    INDI::SingleThreadPool readoutWorker;
+    std::vector<UInt16> readoutBuffer;
+    std::mutex readoutBufferLock;
+    int readyPipe[2] {-1, -1};
+    int readyCallbackID {-1};
+    void workerExposure(const std::atomic_bool &isAboutToQuit);
+    bool waitImageReady(const std::atomic_bool &isAboutToQuit);
+    static void frameReadyHelper(int fd, void *context);
+    void frameReady();
+    void dropPendingFrames();
+
+    // Guide pulses are sent once the camera is free, without holding up the main loop.
+    // A pulse arriving while the previous one on the axis still waits for the camera replaces it.
+    struct GuideRelay
+    {
+        INDI::SingleThreadPool worker;
+        std::mutex lock;
+        bool running {false};
+        bool pending {false};
+        int relay {0};
+        uint32_t ms {0};
+    };
+    GuideRelay guideNS;
+    GuideRelay guideWE;
+    IPState pulseRelay(GuideRelay &guide, int relay, uint32_t ms);
+    void sendPulses(GuideRelay &guide, INDI_EQ_AXIS axis, const std::atomic_bool &isAboutToQuit);
+    void stopPulses(GuideRelay &guide);
+
     friend void ::ISGetProperties(const char *dev);
     friend void ::ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int num);
     friend void ::ISNewText(const char *dev, const char *name, char *texts[], char *names[], int num);
@@ -0,0 +1,235 @@
+/*
+ Fishcamp INDI CCD Driver - mock libfishcamp
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ libfishcamp for -DINDI_FISHCAMP_MOCK=ON, see common/README.md. One camera is found, 1280 x 1024
+ and 20 MB/s unless set otherwise. FISHCAMP_MOCK_READOUT is the time from the end of exposure
+ until fcUsb_cmd_getState reports idle (ms, default 200).
+
+ Like libfishcamp, a command and its answer share the bulk endpoints and one buffer, so calls
+ must not overlap. Overlapping calls are counted, together with state polls, downloads and
+ guide pulses, and printed to stderr when the camera is closed.
+*/
+
+#include <fishcamp.h>
+#include "sdk_mock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+struct MockCamera
+{
+    int width;
+    int height;
+    int readout;
+    double bandwidth;
+
+    UInt32 integration {1000};
+    bool exposing {false};
+    std::chrono::steady_clock::time_point end;
+    SInt16 setpoint {2000};
+    bool cooling {false};
+
+    std::atomic_bool busy {false};
+    std::atomic<int> overlaps {0};
+    int statePolls {0};
+    int downloads {0};
+    int pulses {0};
+    double downloadSeconds {0};
+} camera;
+
+// marks the camera busy for the duration of a call, counting calls made while another one runs
+class Command
+{
+    public:
+        Command()
+        {
+            if (camera.busy.exchange(true))
+                camera.overlaps++;
+        }
+        ~Command()
+        {
+            camera.busy = false;
+        }
+};
+}
+
+void fcUsb_init(void)
+{
+    camera.width     = SDKMock::env("FISHCAMP_MOCK_WIDTH", 1280);
+    camera.height    = SDKMock::env("FISHCAMP_MOCK_HEIGHT", 1024);
+    camera.readout   = SDKMock::env("FISHCAMP_MOCK_READOUT", 200);
+    camera.bandwidth = std::max(SDKMock::env("FISHCAMP_MOCK_BANDWIDTH", 20.0), 0.001);
+}
+
+void fcUsb_setLogging(bool)
+{
+}
+
+void fcUsb_setSimulation(bool)
+{
+}
+
+int fcUsb_FindCameras(void)
+{
+    return 1;
+}
+
+int fcUsb_OpenCamera(int)
+{
+    return 0;
+}
+
+int fcUsb_CloseCamera(int)
+{
+    fprintf(stderr, "fishcamp mock: %d state polls, %d downloads (%.3f s), %d guide pulses, %d overlapping calls, "
+            "%.2f s CPU\n", camera.statePolls, camera.downloads, camera.downloadSeconds, camera.pulses,
+            camera.overlaps.load(), static_cast<double>(clock()) / CLOCKS_PER_SEC);
+    return 0;
+}
+
+bool fcUsb_haveCamera(void)
+{
+    return true;
+}
+
+int fcUsb_cmd_getinfo(int, fc_camInfo *camInfo)
+{
+    Command command;
+    memset(camInfo, 0, sizeof(*camInfo));
+    camInfo->width       = camera.width;
+    camInfo->height      = camera.height;
+    camInfo->pixelWidth  = 52;
+    camInfo->pixelHeight = 52;
+    snprintf(reinterpret_cast<char *>(camInfo->camSerialStr), sizeof(camInfo->camSerialStr), "0001");
+    snprintf(reinterpret_cast<char *>(camInfo->camNameStr), sizeof(camInfo->camNameStr), "Starfish Mock");
+    return 0;
+}
+
+int fcUsb_cmd_setReadMode(int, int, int)
+{
+    Command command;
+    return 0;
+}
+
+int fcUsb_cmd_setCameraGain(int, UInt16)
+{
+    Command command;
+    return 0;
+}
+
+int fcUsb_cmd_setRoi(int, UInt16, UInt16, UInt16, UInt16)
+{
+    Command command;
+    return 0;
+}
+
+int fcUsb_cmd_setTemperature(int, SInt16 theTemp)
+{
+    Command command;
+    camera.setpoint = theTemp;
+    camera.cooling  = true;
+    return 0;
+}
+
+SInt16 fcUsb_cmd_getTemperature(int)
+{
+    Command command;
+    return camera.cooling ? camera.setpoint * 100 : 2000;
+}
+
+UInt16 fcUsb_cmd_getTECPowerLevel(int)
+{
+    Command command;
+    return camera.cooling ? 40 : 0;
+}
+
+bool fcUsb_cmd_getTECInPowerOK(int)
+{
+    Command command;
+    return true;
+}
+
+int fcUsb_cmd_setIntegrationTime(int, UInt32 theTime)
+{
+    Command command;
+    camera.integration = theTime;
+    return 0;
+}
+
+int fcUsb_cmd_startExposure(int)
+{
+    Command command;
+    camera.exposing = true;
+    camera.end      = std::chrono::steady_clock::now() + std::chrono::milliseconds(camera.integration);
+    return 0;
+}
+
+int fcUsb_cmd_abortExposure(int)
+{
+    Command command;
+    camera.exposing = false;
+    return 0;
+}
+
+UInt16 fcUsb_cmd_getState(int)
+{
+    Command command;
+    camera.statePolls++;
+
+    UInt16 state = 0;
+    auto now = std::chrono::steady_clock::now();
+    if (camera.exposing && now < camera.end)
+        state = 1;
+    else if (camera.exposing && now < camera.end + std::chrono::milliseconds(camera.readout))
+        state = 2;
+
+    // libfishcamp sleeps after every state query
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return state;
+}
+
+int fcUsb_cmd_getRawFrame(int, UInt16 numRows, UInt16 numCols, UInt16 *frameBuffer)
+{
+    Command command;
+    if (!camera.exposing)
+        return 0;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t length = static_cast<size_t>(numRows) * numCols;
+    for (size_t i = 0; i < length; i++)
+        frameBuffer[i] = static_cast<UInt16>(i % numCols + i / numCols);
+    std::this_thread::sleep_for(SDKMock::transferTime(length * 2, camera.bandwidth));
+
+    camera.exposing = false;
+    camera.downloads++;
+    camera.downloadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return length * 2;
+}
+
+int fcUsb_cmd_pulseRelay(int, int, int, int, bool)
+{
+    Command command;
+    camera.pulses++;
+    return 0;
+}
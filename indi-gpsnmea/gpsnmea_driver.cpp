@@ -27,20 +27,28 @@
 
 #include "config.h"
 
+#include <connectionplugins/connectionserial.h>
 #include <connectionplugins/connectiontcp.h>
 #include <indicom.h>
 #include <libnova/julian_day.h>
 #include <libnova/sidereal_time.h>
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <unistd.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <time.h>
 #include <string.h>
-#include <pthread.h>
 
-#define MAX_NMEA_PARSES     50              // Read 50 streams before giving up
-#define MAX_TIMEOUT_COUNT   5               // Maximum timeout before auto-connect
+#define MAX_HANDSHAKE_LINES 5               // Lines read looking for a sentence, the first one may be cut
+#define HANDSHAKE_TIMEOUT   3               // seconds per line when connecting
+#define RECONNECT_TIMEOUT   1               // seconds per line when reconnecting, Disconnect() waits for it
+#define READ_TIMEOUT        250             // ms, how often the reader checks for a disconnection
+#define NO_DATA_TIMEOUT     15              // seconds without data before reconnecting
+#define RECONNECT_MIN       1               // seconds before the first reconnection attempt
+#define RECONNECT_MAX       32              // seconds between attempts once backed off
 
 // We declare an auto pointer to GPSD.
 static std::unique_ptr<GPSNMEA> gpsnema(new GPSNMEA());
@@ -50,6 +58,11 @@ GPSNMEA::GPSNMEA()
     setVersion(GPSNMEA_VERSION_MAJOR, GPSNMEA_VERSION_MINOR);
 }
 
+GPSNMEA::~GPSNMEA()
+{
+    stopReader();
+}
+
 const char *GPSNMEA::getDefaultName()
 {
     return "GPS NMEA";
@@ -73,7 +86,17 @@ bool GPSNMEA::initProperties()
         return isNMEA();
     });
 
+    // USB and serial receivers, or a pty replaying a recorded log
+    serialConnection = new Connection::Serial(this);
+    serialConnection->setDefaultBaudRate(Connection::Serial::B_9600);
+    serialConnection->registerHandshake([&]()
+    {
+        PortFD = serialConnection->getPortFD();
+        return isNMEA();
+    });
+
     registerConnection(tcpConnection);
+    registerConnection(serialConnection);
 
     addDebugControl();
 
@@ -91,7 +114,7 @@ bool GPSNMEA::updateProperties()
     {
         defineProperty(&GPSstatusTP);
 
-        pthread_create(&nmeaThread, nullptr, &GPSNMEA::parseNMEAHelper, this);
+        startReader();
     }
     else
     {
@@ -101,18 +124,36 @@ bool GPSNMEA::updateProperties()
     return true;
 }
 
+bool GPSNMEA::Disconnect()
+{
+    // The reader uses the port until it is joined
+    stopReader();
+
+    if (epochCallbackID >= 0)
+    {
+        IERmCallback(epochCallbackID);
+        epochCallbackID = -1;
+    }
+    for (int &fd : epochPipe)
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+
+    return INDI::GPS::Disconnect();
+}
+
 IPState GPSNMEA::updateGPS()
 {
     IPState rc = IPS_BUSY;
 
-    pthread_mutex_lock(&lock);
     if (locationPending == false && timePending == false)
     {
         rc = IPS_OK;
         locationPending = true;
         timePending = true;
     }
-    pthread_mutex_unlock(&lock);
 
     return rc;
 }
@@ -121,257 +162,243 @@ bool GPSNMEA::isNMEA()
 {
     char line[MINMEA_MAX_LENGTH];
 
-    int bytes_read = 0;
-    int tty_rc = tty_nread_section(PortFD, line, MINMEA_MAX_LENGTH, 0xA, 3, &bytes_read);
-    if (tty_rc < 0)
+    // The reader thread reconnects with short reads, so that a disconnection cancels it quickly
+    const int timeout = reconnecting ? RECONNECT_TIMEOUT : HANDSHAKE_TIMEOUT;
+
+    // Connecting in the middle of a sentence is likely at high update rates
+    for (int i = 0; i < MAX_HANDSHAKE_LINES; i++)
     {
-        LOGF_ERROR("Error getting device readings: %s", strerror(errno));
-        return false;
+        if (reconnecting && stopReading)
+            return false;
+
+        int bytes_read = 0;
+        int tty_rc = tty_nread_section(PortFD, line, MINMEA_MAX_LENGTH - 1, 0xA, timeout, &bytes_read);
+        if (tty_rc < 0)
+        {
+            LOGF_ERROR("Error getting device readings: %s", strerror(errno));
+            return false;
+        }
+        line[bytes_read] = '\0';
+
+        if (minmea_sentence_id(line, false) != MINMEA_INVALID)
+            return true;
     }
-    line[bytes_read] = '\0';
 
-    return (minmea_sentence_id(line, false) != MINMEA_INVALID);
+    return false;
 }
 
-void* GPSNMEA::parseNMEAHelper(void *obj)
+bool GPSNMEA::startReader()
 {
-    static_cast<GPSNMEA*>(obj)->parseNEMA();
-    return nullptr;
+    if (nmeaThread.joinable())
+        return true;
+
+    // Epochs are handed from the reader thread to the main loop through a pipe
+    if (epochPipe[0] < 0)
+    {
+        if (pipe(epochPipe) != 0)
+        {
+            LOGF_ERROR("Failed to create the epoch pipe. %s.", strerror(errno));
+            return false;
+        }
+        // The reader never waits for a busy main loop, only the latest epoch matters
+        fcntl(epochPipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(epochPipe[1], F_SETFL, O_NONBLOCK);
+        epochCallbackID = IEAddCallback(epochPipe[0], epochReadyHelper, this);
+    }
+
+    stopReading = false;
+    nmeaThread = std::thread(&GPSNMEA::readNMEA, this);
+    return true;
 }
 
-void GPSNMEA::parseNEMA()
+void GPSNMEA::stopReader()
 {
-    static char ts[32] = {0};
+    if (!nmeaThread.joinable())
+        return;
 
-    char line[MINMEA_MAX_LENGTH];
+    {
+        std::lock_guard<std::mutex> guard(stopLock);
+        stopReading = true;
+    }
+    stopCondition.notify_all();
+    nmeaThread.join();
+}
 
-    while (isConnected())
+/* Sleeps before a reconnection attempt. Returns false if the driver is disconnected meanwhile. */
+bool GPSNMEA::waitReconnect(int seconds)
+{
+    std::unique_lock<std::mutex> guard(stopLock);
+    return !stopCondition.wait_for(guard, std::chrono::seconds(seconds), [this]
     {
-        int bytes_read = 0;
-        int tty_rc = tty_nread_section(PortFD, line, MINMEA_MAX_LENGTH, 0xA, 3, &bytes_read);
-        if (tty_rc < 0)
+        return stopReading.load();
+    });
+}
+
+void GPSNMEA::readNMEA()
+{
+    NMEAEpochReader reader([this](const NMEAEpoch & epoch)
+    {
+        epochReceived(epoch);
+    });
+
+    auto lastData = std::chrono::steady_clock::now();
+    int backoff = RECONNECT_MIN;
+
+    while (!stopReading)
+    {
+        if (PortFD < 0)
         {
-            if (tty_rc == TTY_OVERFLOW)
-            {
-                LOG_WARN("Overflow detected. Possible remote GPS disconnection. Disconnecting driver...");
-                INDI::GPS::setConnected(false);
-                updateProperties();
+            if (!waitReconnect(backoff))
                 break;
+
+            LOG_INFO("Reconnecting to GPS...");
+            reconnecting = true;
+            bool connected = getActiveConnection()->Connect();
+            reconnecting = false;
+            // Disconnect() closes the port once the reader is joined
+            if (stopReading)
+                break;
+
+            if (connected)
+            {
+                LOG_INFO("GPS reconnected.");
+                reader.reset();
+                lastData = std::chrono::steady_clock::now();
+                backoff = RECONNECT_MIN;
             }
             else
             {
-                char errmsg[MAXRBUF];
-                tty_error_msg(tty_rc, errmsg, MAXRBUF);
-                if (tty_rc == TTY_TIME_OUT || errno == ECONNREFUSED)
-                {
-                    if (errno == ECONNREFUSED)
-                    {
-                        // sleep for 10 seconds
-                        tcpConnection->Disconnect();
-                        usleep(10 * 1e6);
-                        tcpConnection->Connect();
-                        PortFD = tcpConnection->getPortFD();
-                    }
-                    else if (timeoutCounter++ > MAX_TIMEOUT_COUNT)
-                    {
-                        LOG_WARN("Timeout limit reached, reconnecting...");
-
-                        tcpConnection->Disconnect();
-                        // sleep for 5 seconds
-                        usleep(5 * 1e6);
-                        tcpConnection->Connect();
-                        PortFD = tcpConnection->getPortFD();
-                        timeoutCounter = 0;
-                    }
-                }
-                continue;
+                PortFD = -1;
+                backoff = std::min(backoff * 2, RECONNECT_MAX);
+                LOGF_WARN("Reconnection failed, retrying in %d seconds.", backoff);
             }
+            continue;
         }
-        line[bytes_read] = '\0';
 
-        LOGF_DEBUG("%s", line);
-        switch (minmea_sentence_id(line, false))
+        int rc = reader.read(PortFD, READ_TIMEOUT);
+        auto now = std::chrono::steady_clock::now();
+        if (rc > 0)
         {
-            case MINMEA_SENTENCE_RMC:
-            {
-                struct minmea_sentence_rmc frame;
-                if (minmea_parse_rmc(&frame, line))
-                {
-                    if (frame.valid)
-                    {
-                        LocationNP[LOCATION_LATITUDE].value  = minmea_tocoord(&frame.latitude);
-                        LocationNP[LOCATION_LONGITUDE].value = minmea_tocoord(&frame.longitude);
-                        if (LocationNP[LOCATION_LONGITUDE].value < 0)
-                            LocationNP[LOCATION_LONGITUDE].value += 360;
-
-                        struct timespec timesp;
-                        time_t raw_time;
-                        struct tm *utc, *local;
-
-                        if (minmea_gettime(&timesp, &frame.date, &frame.time) == -1)
-                            break;
-
-                        raw_time = timesp.tv_sec;
-                        m_GPSTime = raw_time;
-                        utc = gmtime(&raw_time);
-                        strftime(ts, 32, "%Y-%m-%dT%H:%M:%S", utc);
-                        TimeTP[0].setText(ts);
-
-                        setSystemTime(raw_time);
-
-                        local = localtime(&raw_time);
-                        snprintf(ts, 32, "%4.2f", (local->tm_gmtoff / 3600.0));
-                        TimeTP[1].setText(ts);
-
-                        pthread_mutex_lock(&lock);
-                        locationPending = false;
-                        timePending = false;
-                        LOG_DEBUG("Threaded Location and Time updates complete.");
-                        pthread_mutex_unlock(&lock);
-                    }
-                }
-                else
-                {
-                    LOG_DEBUG("$xxRMC sentence is not parsed");
-                }
-            }
-            break;
+            lastData = now;
+            continue;
+        }
 
-            case MINMEA_SENTENCE_GGA:
-            {
-                struct minmea_sentence_gga frame;
-                if (minmea_parse_gga(&frame, line))
-                {
-                    if (frame.fix_quality == 1)
-                    {
-                        LocationNP[LOCATION_LATITUDE].value  = minmea_tocoord(&frame.latitude);
-                        LocationNP[LOCATION_LONGITUDE].value = minmea_tocoord(&frame.longitude);
-                        if (LocationNP[LOCATION_LONGITUDE].value < 0)
-                            LocationNP[LOCATION_LONGITUDE].value += 360;
-
-                        LocationNP[LOCATION_ELEVATION].value = minmea_tofloat(&frame.altitude);
-
-                        struct timespec timesp;
-                        time_t raw_time;
-                        struct tm *utc, *local;
-                        minmea_date gmt_date;
-
-                        time(&raw_time);
-                        utc = gmtime(&raw_time);
-                        gmt_date.day = utc->tm_mday;
-                        gmt_date.month = utc->tm_mon + 1;
-                        gmt_date.year = utc->tm_year;
-
-                        minmea_gettime(&timesp, &gmt_date, &frame.time);
-
-                        raw_time = timesp.tv_sec;
-                        utc = gmtime(&raw_time);
-                        strftime(ts, 32, "%Y-%m-%dT%H:%M:%S", utc);
-                        TimeTP[0].setText(ts);
-                        setSystemTime(raw_time);
-
-                        local = localtime(&raw_time);
-                        snprintf(ts, 32, "%4.2f", (local->tm_gmtoff / 3600.0));
-                        TimeTP[1].setText(ts);
-
-                        pthread_mutex_lock(&lock);
-                        timePending = false;
-                        locationPending = false;
-                        LOG_DEBUG("Threaded Location and Time updates complete.");
-                        pthread_mutex_unlock(&lock);
-                    }
-                }
-                else
-                {
-                    LOG_DEBUG("$xxGGA sentence is not parsed");
-                }
-            }
-            break;
+        if (rc < 0)
+            LOG_WARN("GPS connection lost.");
+        else if (now - lastData < std::chrono::seconds(NO_DATA_TIMEOUT))
+            continue;
+        else
+            LOGF_WARN("No data from GPS for %d seconds.", NO_DATA_TIMEOUT);
+
+        reader.flush();
+        getActiveConnection()->Disconnect();
+        PortFD = -1;
+        backoff = RECONNECT_MIN;
+    }
+}
 
-            case MINMEA_SENTENCE_GSA:
-            {
-                struct minmea_sentence_gsa frame;
-                if (minmea_parse_gsa(&frame, line))
-                {
-                    if (frame.fix_type == 1)
-                    {
-                        GPSstatusTP.s = IPS_BUSY;
-                        IUSaveText(&GPSstatusT[0], "NO FIX");
-                    }
-                    else if (frame.fix_type == 2)
-                    {
-                        GPSstatusTP.s = IPS_OK;
-                        IUSaveText(&GPSstatusT[0], "2D FIX");
-                    }
-                    else if (frame.fix_type == 3)
-                    {
-                        GPSstatusTP.s = IPS_OK;
-                        IUSaveText(&GPSstatusT[0], "3D FIX");
-                    }
-                    IDSetText(&GPSstatusTP, nullptr);
-
-                }
-                else
-                {
-                    LOG_DEBUG("$xxGSA sentence is not parsed.");
-                }
-            }
-            break;
-            case MINMEA_SENTENCE_ZDA:
-            {
-                struct minmea_sentence_zda frame;
-                if (minmea_parse_zda(&frame, line))
-                {
-                    LOGF_DEBUG("$xxZDA: %d:%d:%d %02d.%02d.%d UTC%+03d:%02d",
-                               frame.time.hours,
-                               frame.time.minutes,
-                               frame.time.seconds,
-                               frame.date.day,
-                               frame.date.month,
-                               frame.date.year,
-                               frame.hour_offset,
-                               frame.minute_offset);
-
-                    struct timespec timesp;
-                    time_t raw_time;
-                    struct tm *utc, *local;
-
-                    minmea_gettime(&timesp, &frame.date, &frame.time);
-
-                    raw_time = timesp.tv_sec;
-                    utc = gmtime(&raw_time);
-                    strftime(ts, 32, "%Y-%m-%dT%H:%M:%S", utc);
-                    TimeTP[0].setText(ts);
-                    setSystemTime(raw_time);
-
-                    local = localtime(&raw_time);
-                    snprintf(ts, 32, "%4.2f", (local->tm_gmtoff / 3600.0));
-                    TimeTP[1].setText(ts);
-
-                    pthread_mutex_lock(&lock);
-                    timePending = false;
-                    LOG_DEBUG("Threaded Time update complete.");
-                    pthread_mutex_unlock(&lock);
-                }
-                else
-                {
-                    LOG_DEBUG("$xxZDA sentence is not parsed");
-                }
-            }
-            break;
+/* Runs on the reader thread for each complete epoch. */
+void GPSNMEA::epochReceived(const NMEAEpoch &epoch)
+{
+    {
+        std::lock_guard<std::mutex> guard(epochLock);
+        latestEpoch = epoch;
+    }
 
-            case MINMEA_INVALID:
-            {
-                //LOG_WARN("$xxxxx sentence is not valid");
-            } break;
+    // A full pipe already has the main loop woken up
+    char ready = 1;
+    if (write(epochPipe[1], &ready, 1) != 1 && errno != EAGAIN)
+        LOGF_DEBUG("Failed to signal epoch: %s", strerror(errno));
+}
 
-            default:
-            {
-                LOG_DEBUG("$xxxxx sentence is not parsed");
-            }
-            break;
+void GPSNMEA::epochReadyHelper(int fd, void *context)
+{
+    INDI_UNUSED(fd);
+    static_cast<GPSNMEA *>(context)->epochReady();
+}
+
+/* Runs on the main loop, applies the latest epoch once however many arrived since the last call. */
+void GPSNMEA::epochReady()
+{
+    char ready;
+    bool pending = false;
+    while (epochPipe[0] >= 0 && read(epochPipe[0], &ready, 1) == 1)
+        pending = true;
+    if (!pending)
+        return;
+
+    NMEAEpoch epoch;
+    {
+        std::lock_guard<std::mutex> guard(epochLock);
+        epoch = latestEpoch;
+    }
+    applyEpoch(epoch);
+}
+
+void GPSNMEA::applyEpoch(const NMEAEpoch &epoch)
+{
+    LOGF_DEBUG("Epoch %02d:%02d:%02d.%03d: %d sentences, location %s, time %s, fix %d", epoch.time.hours,
+               epoch.time.minutes, epoch.time.seconds, epoch.time.microseconds / 1000, epoch.sentences,
+               epoch.hasLocation ? "yes" : "no", epoch.hasTime ? "yes" : "no", epoch.fixType);
+
+    if (epoch.fixType > 0)
+    {
+        IPState state = epoch.fixType == 1 ? IPS_BUSY : IPS_OK;
+        const char *fix = epoch.fixType == 3 ? "3D FIX" : (epoch.fixType == 2 ? "2D FIX" : "NO FIX");
+        if (GPSstatusTP.s != state || GPSstatusT[0].text == nullptr || strcmp(GPSstatusT[0].text, fix))
+        {
+            GPSstatusTP.s = state;
+            IUSaveText(&GPSstatusT[0], fix);
+            IDSetText(&GPSstatusTP, nullptr);
+        }
+    }
+
+    if (epoch.hasLocation)
+    {
+        double longitude = epoch.longitude < 0 ? epoch.longitude + 360 : epoch.longitude;
+        bool changed = LocationNP.getState() != IPS_OK ||
+                       LocationNP[LOCATION_LATITUDE].value != epoch.latitude ||
+                       LocationNP[LOCATION_LONGITUDE].value != longitude ||
+                       (epoch.hasElevation && LocationNP[LOCATION_ELEVATION].value != epoch.elevation);
+
+        LocationNP[LOCATION_LATITUDE].value  = epoch.latitude;
+        LocationNP[LOCATION_LONGITUDE].value = longitude;
+        if (epoch.hasElevation)
+            LocationNP[LOCATION_ELEVATION].value = epoch.elevation;
+        locationPending = false;
+
+        if (changed)
+        {
+            LocationNP.setState(IPS_OK);
+            LocationNP.apply();
         }
     }
 
-    pthread_exit(nullptr);
+    time_t raw_time;
+    if (epoch.utc(raw_time))
+    {
+        timePending = false;
+
+        // High rate receivers report the same second several times
+        if (raw_time != m_GPSTime || TimeTP.getState() != IPS_OK)
+        {
+            char ts[32] = {0};
+            struct tm *utc, *local;
+
+            if (raw_time != m_GPSTime)
+                setSystemTime(raw_time);
+            m_GPSTime = raw_time;
+
+            utc = gmtime(&raw_time);
+            strftime(ts, 32, "%Y-%m-%dT%H:%M:%S", utc);
+            TimeTP[0].setText(ts);
+
+            local = localtime(&raw_time);
+            snprintf(ts, 32, "%4.2f", (local->tm_gmtoff / 3600.0));
+            TimeTP[1].setText(ts);
+
+            TimeTP.setState(IPS_OK);
+            TimeTP.apply();
+        }
+    }
 }
@@ -24,35 +24,63 @@
 
 #pragma once
 
+#include "gpsnmea_epoch.h"
+
 #include <indigps.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 class GPSNMEA : public INDI::GPS
 {
   public:
     GPSNMEA();
-    virtual ~GPSNMEA() = default;
+    virtual ~GPSNMEA();
 
     IText GPSstatusT[1] {};
     ITextVectorProperty GPSstatusTP;
 
-    static void* parseNMEAHelper(void *);
+    static void epochReadyHelper(int fd, void *context);
 
   protected:    
     //  Generic indi device entries
     virtual const char *getDefaultName() override;
     virtual bool initProperties() override;
     virtual bool updateProperties() override;
+    virtual bool Disconnect() override;
     virtual IPState updateGPS() override;
 
 private:
     Connection::TCP *tcpConnection { nullptr };
+    Connection::Serial *serialConnection { nullptr };
     bool isNMEA();
-    void parseNEMA();
+
+    // Reader thread, reconnects in the background while the driver stays connected
+    bool startReader();
+    void stopReader();
+    void readNMEA();
+    bool waitReconnect(int seconds);
+    void epochReceived(const NMEAEpoch &epoch);
+
+    // Main loop side of the epoch hand-off
+    void epochReady();
+    void applyEpoch(const NMEAEpoch &epoch);
 
     int PortFD { -1 };
-    uint8_t timeoutCounter=0;
-    bool locationPending = true, timePending=true;
+    // Set by the reader thread while it reconnects, isNMEA() then reads with a short timeout
+    bool reconnecting { false };
+    bool locationPending = true, timePending = true;
+
+    std::thread nmeaThread;
+    std::atomic_bool stopReading { false };
+    std::mutex stopLock;
+    std::condition_variable stopCondition;
 
-    pthread_mutex_t lock;
-    pthread_t nmeaThread;
+    // Latest epoch from the reader, picked up by the main loop through epochPipe
+    std::mutex epochLock;
+    NMEAEpoch latestEpoch;
+    int epochPipe[2] {-1, -1};
+    int epochCallbackID {-1};
 };
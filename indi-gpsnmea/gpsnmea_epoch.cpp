@@ -0,0 +1,271 @@
+/*******************************************************************************
+  Copyright(c) 2017 Jasem Mutlaq. All rights reserved.
+
+  INDI GPS NMEA Driver
+
+  This program is free software; you can redistribute it and/or modify it
+  under the terms of the GNU General Public License as published by the Free
+  Software Foundation; either version 2 of the License, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+  more details.
+
+  You should have received a copy of the GNU Library General Public License
+  along with this library; see the file COPYING.LIB.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+
+  The full GNU General Public License is included in this distribution in the
+  file called LICENSE.
+*******************************************************************************/
+
+#include "gpsnmea_epoch.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+// Longest line kept while waiting for its end, NMEA sentences are at most 82 characters
+#define MAX_LINE_LENGTH 256
+
+static bool sameTime(const struct minmea_time &a, const struct minmea_time &b)
+{
+    return a.hours == b.hours && a.minutes == b.minutes && a.seconds == b.seconds && a.microseconds == b.microseconds;
+}
+
+bool NMEAEpoch::utc(time_t &raw_time) const
+{
+    if (!hasTime)
+        return false;
+
+    struct minmea_date fixDate = date;
+    if (!hasDate)
+    {
+        time_t now = ::time(nullptr);
+        struct tm *utc = gmtime(&now);
+        fixDate.day   = utc->tm_mday;
+        fixDate.month = utc->tm_mon + 1;
+        fixDate.year  = utc->tm_year + 1900;
+    }
+
+    struct timespec timesp;
+    if (minmea_gettime(&timesp, &fixDate, &time) == -1)
+        return false;
+
+    raw_time = timesp.tv_sec;
+    return true;
+}
+
+NMEAEpochReader::NMEAEpochReader(std::function<void(const NMEAEpoch &)> onEpoch) : onEpoch(std::move(onEpoch))
+{
+    buffer.reserve(MAX_LINE_LENGTH);
+}
+
+int NMEAEpochReader::read(int fd, int timeout)
+{
+    // The epoch in progress is complete once the receiver pauses after its burst
+    bool pending = epoch.sentences > 0;
+    if (pending && timeout > EPOCH_GAP)
+        timeout = EPOCH_GAP;
+
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    int rc = poll(&pfd, 1, timeout);
+    if (rc < 0)
+        return errno == EINTR ? 0 : -1;
+    if (rc == 0)
+    {
+        if (pending)
+            flush();
+        return 0;
+    }
+
+    char data[512];
+    ssize_t bytes_read = ::read(fd, data, sizeof(data));
+    if (bytes_read < 0)
+        return (errno == EINTR || errno == EAGAIN) ? 0 : -1;
+    // Hang up, or the TCP peer closed the connection
+    if (bytes_read == 0)
+        return -1;
+
+    feed(data, bytes_read);
+    return bytes_read;
+}
+
+void NMEAEpochReader::feed(const char *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        char c = data[i];
+        if (c == '\n')
+        {
+            if (!buffer.empty())
+                parseSentence(buffer.c_str());
+            buffer.clear();
+        }
+        else if (c != '\r')
+        {
+            // No line end in sight, this is noise and not NMEA
+            if (buffer.size() >= MAX_LINE_LENGTH)
+                buffer.clear();
+            buffer.push_back(c);
+        }
+    }
+}
+
+void NMEAEpochReader::flush()
+{
+    if (epoch.sentences > 0)
+        onEpoch(epoch);
+
+    epoch = NMEAEpoch();
+    epochTimed = false;
+}
+
+void NMEAEpochReader::reset()
+{
+    buffer.clear();
+    epoch = NMEAEpoch();
+    epochTimed = false;
+}
+
+bool NMEAEpochReader::sentenceTime(const char *sentence, struct minmea_time &time)
+{
+    switch (minmea_sentence_id(sentence, false))
+    {
+        case MINMEA_SENTENCE_RMC:
+        {
+            struct minmea_sentence_rmc frame;
+            if (!minmea_parse_rmc(&frame, sentence))
+                return false;
+            time = frame.time;
+        }
+        break;
+
+        case MINMEA_SENTENCE_GGA:
+        {
+            struct minmea_sentence_gga frame;
+            if (!minmea_parse_gga(&frame, sentence))
+                return false;
+            time = frame.time;
+        }
+        break;
+
+        case MINMEA_SENTENCE_GLL:
+        {
+            struct minmea_sentence_gll frame;
+            if (!minmea_parse_gll(&frame, sentence))
+                return false;
+            time = frame.time;
+        }
+        break;
+
+        case MINMEA_SENTENCE_ZDA:
+        {
+            struct minmea_sentence_zda frame;
+            if (!minmea_parse_zda(&frame, sentence))
+                return false;
+            time = frame.time;
+        }
+        break;
+
+        default:
+            return false;
+    }
+
+    // Receivers without a fix may leave the time field empty
+    return time.hours != -1;
+}
+
+void NMEAEpochReader::parseSentence(const char *sentence)
+{
+    enum minmea_sentence_id id = minmea_sentence_id(sentence, false);
+    if (id == MINMEA_INVALID || id == MINMEA_UNKNOWN)
+        return;
+
+    struct minmea_time time;
+    if (sentenceTime(sentence, time))
+    {
+        // A new time of day starts the next fix
+        if (epochTimed && !sameTime(time, epochTime))
+            flush();
+        epochTimed = true;
+        epochTime  = time;
+    }
+
+    epoch.sentences++;
+
+    switch (id)
+    {
+        case MINMEA_SENTENCE_RMC:
+        {
+            struct minmea_sentence_rmc frame;
+            if (minmea_parse_rmc(&frame, sentence) && frame.valid)
+            {
+                epoch.hasLocation = true;
+                epoch.latitude    = minmea_tocoord(&frame.latitude);
+                epoch.longitude   = minmea_tocoord(&frame.longitude);
+                epoch.hasTime     = true;
+                epoch.time        = frame.time;
+                epoch.hasDate     = true;
+                epoch.date        = frame.date;
+            }
+        }
+        break;
+
+        case MINMEA_SENTENCE_GGA:
+        {
+            // Any fix counts, DGPS and RTK ones as well as plain GPS
+            struct minmea_sentence_gga frame;
+            if (minmea_parse_gga(&frame, sentence) && frame.fix_quality > 0)
+            {
+                epoch.hasLocation  = true;
+                epoch.latitude     = minmea_tocoord(&frame.latitude);
+                epoch.longitude    = minmea_tocoord(&frame.longitude);
+                epoch.hasElevation = true;
+                epoch.elevation    = minmea_tofloat(&frame.altitude);
+                epoch.hasTime      = true;
+                epoch.time         = frame.time;
+            }
+        }
+        break;
+
+        case MINMEA_SENTENCE_GLL:
+        {
+            struct minmea_sentence_gll frame;
+            if (minmea_parse_gll(&frame, sentence) && frame.status == MINMEA_GLL_STATUS_DATA_VALID && !epoch.hasLocation)
+            {
+                epoch.hasLocation = true;
+                epoch.latitude    = minmea_tocoord(&frame.latitude);
+                epoch.longitude   = minmea_tocoord(&frame.longitude);
+            }
+        }
+        break;
+
+        case MINMEA_SENTENCE_GSA:
+        {
+            struct minmea_sentence_gsa frame;
+            if (minmea_parse_gsa(&frame, sentence))
+                epoch.fixType = frame.fix_type;
+        }
+        break;
+
+        case MINMEA_SENTENCE_ZDA:
+        {
+            struct minmea_sentence_zda frame;
+            if (minmea_parse_zda(&frame, sentence) && frame.time.hours != -1 && frame.date.year != -1)
+            {
+                epoch.hasTime = true;
+                epoch.time    = frame.time;
+                epoch.hasDate = true;
+                epoch.date    = frame.date;
+            }
+        }
+        break;
+
+        default:
+            break;
+    }
+}
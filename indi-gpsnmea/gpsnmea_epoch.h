@@ -0,0 +1,96 @@
+/*******************************************************************************
+  Copyright(c) 2017 Jasem Mutlaq. All rights reserved.
+
+  INDI GPS NMEA Driver
+
+  This program is free software; you can redistribute it and/or modify it
+  under the terms of the GNU General Public License as published by the Free
+  Software Foundation; either version 2 of the License, or (at your option)
+  any later version.
+
+  This program is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+  more details.
+
+  You should have received a copy of the GNU Library General Public License
+  along with this library; see the file COPYING.LIB.  If not, write to
+  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+
+  The full GNU General Public License is included in this distribution in the
+  file called LICENSE.
+*******************************************************************************/
+
+#pragma once
+
+#include "minmea.h"
+
+#include <functional>
+#include <string>
+#include <time.h>
+
+/**
+ * Everything a receiver reported about one fix. Receivers send a burst of sentences
+ * (RMC, GGA, GSA, ZDA...) per fix, all stamped with the same UTC time of day.
+ */
+struct NMEAEpoch
+{
+    // Time of the fix, from a valid RMC, a GGA with a fix, or ZDA
+    bool hasTime { false };
+    struct minmea_time time { -1, -1, -1, -1 };
+    // Date from RMC or ZDA, GGA alone has none
+    bool hasDate { false };
+    struct minmea_date date { -1, -1, -1 };
+
+    // Location from a valid RMC or a GGA with a fix, elevation from GGA only
+    bool hasLocation { false };
+    double latitude { 0 };
+    double longitude { 0 };
+    bool hasElevation { false };
+    double elevation { 0 };
+
+    // GSA fix type (1 none, 2 2D, 3 3D), 0 without GSA
+    int fixType { 0 };
+
+    int sentences { 0 };
+
+    /* UTC time of the fix, on today's date if the receiver sent none. Returns false without a time. */
+    bool utc(time_t &raw_time) const;
+};
+
+/**
+ * Buffers the NMEA stream, splits it into sentences and groups them into epochs.
+ * An epoch ends when a sentence with another time of day arrives, or when the stream
+ * pauses for EPOCH_GAP ms, whichever comes first, so it is published right after the
+ * burst at any update rate.
+ */
+class NMEAEpochReader
+{
+  public:
+    static constexpr int EPOCH_GAP = 50;
+
+    explicit NMEAEpochReader(std::function<void(const NMEAEpoch &)> onEpoch);
+
+    /* Reads what is available on fd, waiting up to timeout ms. Returns the bytes read, 0 on timeout, -1 on error or end of stream. */
+    int read(int fd, int timeout);
+    /* Adds received data, complete sentences are parsed. */
+    void feed(const char *data, size_t length);
+    /* Publishes the epoch in progress, if any. */
+    void flush();
+    /* Drops a partial sentence and epoch, after a reconnection. */
+    void reset();
+
+    /* Time of day of a sentence, false for sentences without one (GSA, GSV...). */
+    static bool sentenceTime(const char *sentence, struct minmea_time &time);
+
+  private:
+    void parseSentence(const char *sentence);
+
+    std::function<void(const NMEAEpoch &)> onEpoch;
+    std::string buffer;
+    NMEAEpoch epoch;
+    // time of day shared by the sentences of the epoch in progress
+    bool epochTimed { false };
+    struct minmea_time epochTime { -1, -1, -1, -1 };
+};
@@ -0,0 +1,265 @@
+/*******************************************************************************
+ NMEA log replay for testing the indi_gpsnmea driver without a receiver
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Library General Public
+ License version 2 as published by the Free Software Foundation.
+ .
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Library General Public License for more details.
+ .
+ You should have received a copy of the GNU Library General Public License
+ along with this library; see the file COPYING.LIB.  If not, write to
+ the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ Boston, MA 02110-1301, USA.
+*******************************************************************************/
+
+/*
+ Replays a recorded NMEA log on a pseudo terminal:
+
+     gpsnmea_replay [--rate hz] [--speed factor] [--loop] [--check] log.nmea
+
+ The slave device name is printed on startup, select the driver's serial connection and
+ point its port at it. Sentences sharing a time of day are sent as one burst, like the
+ receiver did, and bursts are paced by their timestamps (scaled by --speed) or at a fixed
+ --rate, to replay a 1 Hz log as a 10 Hz receiver for instance.
+
+ --check reads the pty with the driver's NMEAEpochReader instead of waiting for the driver,
+ then prints the epochs found against the bursts sent as JSON and exits nonzero on a mismatch.
+*/
+
+#include "gpsnmea_epoch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+struct Burst
+{
+    std::string data;
+    // seconds of the day, -1 for a log starting with untimed sentences
+    double time { -1 };
+    // sentences the epoch reader accepts
+    int sentences { 0 };
+};
+
+struct ReceivedEpoch
+{
+    Clock::time_point received;
+    int sentences;
+};
+
+static bool loadLog(const char *path, std::vector<Burst> &bursts)
+{
+    std::ifstream log(path);
+    if (!log)
+        return false;
+
+    std::string line;
+    bool timed = false;
+    struct minmea_time current { -1, -1, -1, -1 };
+    while (std::getline(log, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        // Loggers often prefix sentences with their own timestamp
+        size_t start = line.find('$');
+        if (start == std::string::npos)
+            continue;
+        line.erase(0, start);
+
+        struct minmea_time time;
+        if (NMEAEpochReader::sentenceTime(line.c_str(), time))
+        {
+            if (!timed || time.hours != current.hours || time.minutes != current.minutes ||
+                    time.seconds != current.seconds || time.microseconds != current.microseconds)
+            {
+                // Untimed sentences heading the log join the first burst
+                if (timed || bursts.empty())
+                    bursts.emplace_back();
+                bursts.back().time = time.hours * 3600 + time.minutes * 60 + time.seconds + time.microseconds / 1e6;
+                timed   = true;
+                current = time;
+            }
+        }
+        else if (bursts.empty())
+            bursts.emplace_back();
+
+        enum minmea_sentence_id id = minmea_sentence_id(line.c_str(), false);
+        if (id != MINMEA_INVALID && id != MINMEA_UNKNOWN)
+            bursts.back().sentences++;
+        bursts.back().data += line + "\r\n";
+    }
+
+    return true;
+}
+
+static void printUsage(const char *progName)
+{
+    fprintf(stderr, "Usage: %s [--rate hz] [--speed factor] [--loop] [--check] log.nmea\n", progName);
+}
+
+int main(int argc, char *argv[])
+{
+    double rate = 0, speed = 1;
+    bool loop = false, check = false;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+            speed = atof(argv[++i]);
+        else if (strcmp(argv[i], "--loop") == 0)
+            loop = true;
+        else if (strcmp(argv[i], "--check") == 0)
+            check = true;
+        else if (argv[i][0] != '-' && path == nullptr)
+            path = argv[i];
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (path == nullptr || rate < 0 || speed <= 0 || (loop && check))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Burst> bursts;
+    if (!loadLog(path, bursts) || bursts.empty())
+    {
+        fprintf(stderr, "No NMEA sentences in %s\n", path);
+        return 1;
+    }
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        fprintf(stderr, "Failed to create pseudo terminal: %s\n", strerror(errno));
+        return 1;
+    }
+    // keep the slave open, so that the master does not fail while the driver reconnects
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    // no echo or line editing until the driver configures the port
+    struct termios tty;
+    if (slave >= 0 && tcgetattr(slave, &tty) == 0)
+    {
+        cfmakeraw(&tty);
+        tcsetattr(slave, TCSANOW, &tty);
+    }
+    fprintf(check ? stderr : stdout, "Replaying %zu epochs of %s on %s\n", bursts.size(), path, ptsname(master));
+    fflush(check ? stderr : stdout);
+
+    // --check: the driver's reader on the slave side
+    std::atomic_bool reading { true };
+    std::mutex receivedLock;
+    std::vector<ReceivedEpoch> received;
+    std::thread reader;
+    if (check)
+    {
+        reader = std::thread([&]()
+        {
+            NMEAEpochReader epochReader([&](const NMEAEpoch & epoch)
+            {
+                std::lock_guard<std::mutex> guard(receivedLock);
+                received.push_back({ Clock::now(), epoch.sentences });
+            });
+            while (reading)
+            {
+                if (epochReader.read(slave, 100) < 0)
+                    break;
+            }
+            epochReader.flush();
+        });
+    }
+
+    std::vector<Clock::time_point> sent;
+    auto next = Clock::now();
+    do
+    {
+        for (size_t i = 0; i < bursts.size(); i++)
+        {
+            std::this_thread::sleep_until(next);
+
+            const std::string &data = bursts[i].data;
+            sent.push_back(Clock::now());
+            if (write(master, data.data(), data.size()) != static_cast<ssize_t>(data.size()))
+            {
+                fprintf(stderr, "Failed to write: %s\n", strerror(errno));
+                return 1;
+            }
+
+            // Pace by the log timestamps, across midnight too, unless the rate is fixed
+            double interval = rate > 0 ? 1 / rate : 1;
+            if (rate == 0 && i + 1 < bursts.size() && bursts[i].time >= 0)
+            {
+                double delta = bursts[i + 1].time - bursts[i].time;
+                if (delta < 0)
+                    delta += 86400;
+                if (delta > 0 && delta < 60)
+                    interval = delta;
+            }
+            next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval / speed));
+        }
+    }
+    while (loop);
+
+    if (!check)
+    {
+        close(slave);
+        close(master);
+        return 0;
+    }
+
+    // Leave the reader time to close the last epoch
+    std::this_thread::sleep_for(std::chrono::milliseconds(NMEAEpochReader::EPOCH_GAP * 4));
+    reading = false;
+    reader.join();
+
+    size_t matching = 0;
+    double totalLatency = 0, maxLatency = 0;
+    for (size_t i = 0; i < received.size() && i < bursts.size(); i++)
+    {
+        if (received[i].sentences != bursts[i].sentences)
+            continue;
+        matching++;
+        double latency = std::chrono::duration<double, std::milli>(received[i].received - sent[i]).count();
+        totalLatency += latency;
+        maxLatency = std::max(maxLatency, latency);
+    }
+
+    bool passed = received.size() == bursts.size() && matching == bursts.size();
+    printf("{\n");
+    printf("  \"log\": \"%s\",\n", path);
+    printf("  \"epochs_sent\": %zu,\n", bursts.size());
+    printf("  \"epochs_received\": %zu,\n", received.size());
+    printf("  \"epochs_matching\": %zu,\n", matching);
+    printf("  \"latency_ms\": {\"mean\": %.1f, \"max\": %.1f},\n", matching ? totalLatency / matching : 0.0, maxLatency);
+    printf("  \"passed\": %s\n", passed ? "true" : "false");
+    printf("}\n");
+
+    close(slave);
+    close(master);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+/*
+   INDI Driver for i-Nova PLX series
+   Copyright 2013/2014 i-Nova Technologies - Ilia Platone
+
+   Copyright (C) 2017 Jasem Mutlaq (mutlaqja@ikarustech.com)
+*/
+
+#include "inovaplx_bin.h"
+#include "frame_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+void INovaKernels::addRow8(uint32_t *sum, const uint8_t *row, size_t pixels)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i *s = reinterpret_cast<__m128i *>(sum + i);
+        _mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), _mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1), _mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_si128(s + 2, _mm_add_epi32(_mm_loadu_si128(s + 2), _mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_si128(s + 3, _mm_add_epi32(_mm_loadu_si128(s + 3), _mm_unpackhi_epi16(hi, zero)));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16_t v = vld1q_u8(row + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+        vst1q_u32(sum + i, vaddw_u16(vld1q_u32(sum + i), vget_low_u16(lo)));
+        vst1q_u32(sum + i + 4, vaddw_u16(vld1q_u32(sum + i + 4), vget_high_u16(lo)));
+        vst1q_u32(sum + i + 8, vaddw_u16(vld1q_u32(sum + i + 8), vget_low_u16(hi)));
+        vst1q_u32(sum + i + 12, vaddw_u16(vld1q_u32(sum + i + 12), vget_high_u16(hi)));
+    }
+#endif
+    for (; i < pixels; i++)
+        sum[i] += row[i];
+}
+
+/* Adds pairs of neighbours, the output never overtakes the input so this works in place. */
+static size_t foldPairs(uint32_t *sum, size_t pixels)
+{
+    size_t out = pixels / 2, i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= out; i += 4)
+    {
+        __m128 a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + i * 2)));
+        __m128 b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + i * 2 + 4)));
+        __m128i even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i odd  = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(sum + i), _mm_add_epi32(even, odd));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= out; i += 4)
+    {
+        uint32x4x2_t v = vld2q_u32(sum + i * 2);
+        vst1q_u32(sum + i, vaddq_u32(v.val[0], v.val[1]));
+    }
+#endif
+    for (; i < out; i++)
+        sum[i] = sum[i * 2] + sum[i * 2 + 1];
+    return out;
+}
+
+template <int BIN>
+static size_t foldBy(uint32_t *sum, size_t pixels)
+{
+    size_t out = pixels / BIN;
+    for (size_t i = 0; i < out; i++)
+    {
+        uint32_t t = 0;
+        for (int k = 0; k < BIN; k++)
+            t += sum[i * BIN + k];
+        sum[i] = t;
+    }
+    return out;
+}
+
+size_t INovaKernels::fold(uint32_t *sum, size_t pixels, int bin)
+{
+    switch (bin)
+    {
+        case 1:
+            return pixels;
+        case 2:
+            return foldPairs(sum, pixels);
+        case 3:
+            return foldBy<3>(sum, pixels);
+        case 4:
+            return foldPairs(sum, foldPairs(sum, pixels));
+        default:
+        {
+            size_t out = pixels / bin;
+            for (size_t i = 0; i < out; i++)
+            {
+                uint32_t t = 0;
+                for (int k = 0; k < bin; k++)
+                    t += sum[i * bin + k];
+                sum[i] = t;
+            }
+            return out;
+        }
+    }
+}
+
+void INovaKernels::saturate8(uint8_t *image, const uint32_t *sum, size_t pixels)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    // SSE2 has no unsigned 32 bit compare, clamp to 0xFF with signed compares (values above
+    // 2^31 look negative), then both packs are exact
+    const __m128i max = _mm_set1_epi32(0xFF);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + i + 4));
+        __m128i lomask = _mm_or_si128(_mm_cmpgt_epi32(lo, max), _mm_cmplt_epi32(lo, zero));
+        __m128i himask = _mm_or_si128(_mm_cmpgt_epi32(hi, max), _mm_cmplt_epi32(hi, zero));
+        lo = _mm_or_si128(_mm_andnot_si128(lomask, lo), _mm_and_si128(lomask, max));
+        hi = _mm_or_si128(_mm_andnot_si128(himask, hi), _mm_and_si128(himask, max));
+        __m128i v = _mm_packus_epi16(_mm_packs_epi32(lo, hi), zero);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(image + i), v);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= pixels; i += 8)
+        vst1_u8(image + i, vqmovn_u16(vcombine_u16(vqmovn_u32(vld1q_u32(sum + i)), vqmovn_u32(vld1q_u32(sum + i + 4)))));
+#endif
+    for (; i < pixels; i++)
+        image[i] = std::min<uint32_t>(sum[i], 0xFF);
+}
+
+size_t INovaBinning::bin(uint8_t *image, const uint8_t *raw, int rawWidth, int bytesPerPixel, int x, int y, int w,
+                         int h, int binX, int binY)
+{
+    binX = std::max(binX, 1);
+    binY = std::max(binY, 1);
+    if (x < 0 || y < 0 || w < binX || h < binY)
+        return 0;
+
+    // whole bins only, like the camera would
+    size_t pixels  = w / binX * binX;
+    size_t outW    = pixels / binX;
+    int rows       = h / binY;
+    size_t stride  = static_cast<size_t>(rawWidth) * bytesPerPixel;
+    const uint8_t *src = raw + y * stride + static_cast<size_t>(x) * bytesPerPixel;
+
+    if (binX == 1 && binY == 1)
+    {
+        for (int row = 0; row < rows; row++, src += stride)
+        {
+            if (bytesPerPixel > 1)
+                FrameKernels::swap16(reinterpret_cast<uint16_t *>(image) + row * outW, src, pixels);
+            else
+                memcpy(image + row * outW, src, pixels);
+        }
+        return outW * rows * bytesPerPixel;
+    }
+
+    rowSum.resize(pixels);
+    for (int row = 0; row < rows; row++)
+    {
+        std::fill(rowSum.begin(), rowSum.end(), 0);
+        for (int k = 0; k < binY; k++, src += stride)
+        {
+            if (bytesPerPixel > 1)
+                FrameKernels::addSwapped16(rowSum.data(), src, pixels);
+            else
+                INovaKernels::addRow8(rowSum.data(), src, pixels);
+        }
+
+        INovaKernels::fold(rowSum.data(), pixels, binX);
+
+        if (bytesPerPixel > 1)
+            FrameKernels::saturate16(reinterpret_cast<uint16_t *>(image) + row * outW, rowSum.data(), outW);
+        else
+            INovaKernels::saturate8(image + row * outW, rowSum.data(), outW);
+    }
+    return outW * rows * bytesPerPixel;
+}
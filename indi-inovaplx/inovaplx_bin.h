@@ -0,0 +1,45 @@
+/*
+   INDI Driver for i-Nova PLX series
+   Copyright 2013/2014 i-Nova Technologies - Ilia Platone
+
+   Copyright (C) 2017 Jasem Mutlaq (mutlaqja@ikarustech.com)
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Crops and bins a frame returned by iNovaSDK_GrabFrame into the chip buffer.
+ * 16 bit frames come from the camera in big endian words, 8 bit frames in bytes.
+ * The rows of a bin are added into a 32 bit row sum, the columns are then folded
+ * and the result saturated at the bit depth, which gives the same image as
+ * clamping after every addition.
+ */
+class INovaBinning
+{
+  public:
+    /*
+     * Writes the subframe (x, y, w, h) of raw, binned by binX x binY, to image in host byte order.
+     * Rows and columns left over by the binning are dropped. Returns the number of bytes written.
+     */
+    size_t bin(uint8_t *image, const uint8_t *raw, int rawWidth, int bytesPerPixel, int x, int y, int w, int h,
+               int binX, int binY);
+
+  private:
+    std::vector<uint32_t> rowSum;
+};
+
+/* 8 bit and folding kernels of the binning, SSE2 or NEON when available, exported for the benchmark.
+   The 16 bit ones are shared with indi-ffmv in common/frame_kernels.h. */
+namespace INovaKernels
+{
+/* sum[i] += row[i] */
+void addRow8(uint32_t *sum, const uint8_t *row, size_t pixels);
+/* sum[i] = sum[i * bin] + ... + sum[i * bin + bin - 1], in place, returns the folded pixels */
+size_t fold(uint32_t *sum, size_t pixels, int bin);
+/* image[i] = min(sum[i], 0xFF) */
+void saturate8(uint8_t *image, const uint32_t *sum, size_t pixels);
+}
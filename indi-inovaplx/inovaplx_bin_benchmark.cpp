@@ -0,0 +1,175 @@
+/*
+   INDI Driver for i-Nova PLX series
+   Copyright 2013/2014 i-Nova Technologies - Ilia Platone
+
+   Copyright (C) 2017 Jasem Mutlaq (mutlaqja@ikarustech.com)
+*/
+
+/*
+ * Offline benchmark of the iNova PLx binning.
+ *
+ * Synthetic frames laid out like iNovaSDK_GrabFrame returns them (8 bit, or 16 bit big endian
+ * words) with noise and a few saturated pixels are binned 1x1 to 4x4 by the loop the driver used
+ * before INovaBinning, and by INovaBinning. Both images are compared. No camera or INDI server
+ * is needed. Built with -DINDI_INOVAPLX_BENCHMARK=ON, results are printed as JSON on stdout.
+ */
+
+#include "inovaplx_bin.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void makeFrame(std::vector<uint8_t> &raw, int width, int height, int Bpp)
+{
+    size_t pixels = static_cast<size_t>(width) * height;
+    srand(1);
+    raw.resize(pixels * Bpp);
+    for (size_t i = 0; i < pixels; i++)
+    {
+        // 12 bit data in 16 bit words, as the camera sends it in LOW and NORMAL speed
+        int value = Bpp > 1 ? 1000 + (i % width) + rand() % 64 : 20 + (i % width) % 64 + rand() % 16;
+        // a hot pixel in about one pixel out of a thousand
+        if (rand() % 1000 == 0)
+            value = Bpp > 1 ? 0xFFF0 : 0xF0;
+        if (Bpp > 1)
+        {
+            raw[i * 2]     = value >> 8;
+            raw[i * 2 + 1] = value & 0xff;
+        }
+        else
+            raw[i] = value;
+    }
+}
+
+// The loop INovaCCD::grabImage ran on the main loop before INovaBinning
+static size_t oldBin(unsigned char *image, const unsigned char *RawData, int Bpp, int maxW, int maxH, int startX,
+                     int startY, int subW, int subH, int binX, int binY)
+{
+    int p = 0;
+    int endX = startX + subW;
+    int endY = startY + subH;
+    endX = (endX > maxW ? maxW : endX);
+    endY = (endY > maxH ? maxH : endY);
+
+    for(int y = startY; y < endY; y += binY)
+    {
+        if(endY - y < binY)
+            break;
+        for(int x = startX * Bpp; x < endX * Bpp; x += Bpp * binX)
+        {
+            if(endX * Bpp - x < binX * Bpp)
+                break;
+            int t = 0;
+            for(int yy = y; yy < y + binY; yy++)
+            {
+                for(int xx = x; xx < x + Bpp * binX; xx += Bpp)
+                {
+                    if(Bpp > 1)
+                    {
+                        t += RawData[1 + xx + yy * maxW * Bpp] + (RawData[xx + yy * maxW * Bpp] << 8);
+                        t = (t < 0xffff ? t : 0xffff);
+                    }
+                    else
+                    {
+                        t += RawData[xx + yy * maxW * Bpp];
+                        t = (t < 0xff ? t : 0xff);
+                    }
+                }
+            }
+            image[p++] = (unsigned char)(t & 0xff);
+            if(Bpp > 1)
+            {
+                image[p++] = (unsigned char)((t >> 8) & 0xff);
+            }
+        }
+    }
+    return p;
+}
+
+static double toMS(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static void printUsage(const char *progName)
+{
+    printf("Usage: %s [width height rounds]\n", progName);
+    printf("Example: %s 1280 960 50\n", progName);
+}
+
+int main(int argc, char *argv[])
+{
+    int width = 1280, height = 960, rounds = 50;
+
+    if (argc > 1 && (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")))
+    {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    if (argc > 1)
+        width = atoi(argv[1]);
+    if (argc > 2)
+        height = atoi(argv[2]);
+    if (argc > 3)
+        rounds = atoi(argv[3]);
+
+    if (width <= 0 || height <= 0 || rounds <= 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool identical = true;
+    INovaBinning binning;
+    std::vector<uint8_t> raw, reference(static_cast<size_t>(width) * height * 2), image(reference.size());
+
+    printf("{\n");
+    printf("  \"driver\": \"indi_inovaplx_ccd\",\n");
+    printf("  \"frame\": {\"width\": %d, \"height\": %d},\n", width, height);
+#if defined(__SSE2__)
+    printf("  \"kernels\": \"sse2\",\n");
+#elif defined(__ARM_NEON)
+    printf("  \"kernels\": \"neon\",\n");
+#else
+    printf("  \"kernels\": \"scalar\",\n");
+#endif
+    printf("  \"bin\": [\n");
+    for (int Bpp = 1; Bpp <= 2; Bpp++)
+    {
+        makeFrame(raw, width, height, Bpp);
+        for (int bin = 1; bin <= 4; bin++)
+        {
+            double oldMS = 0, newMS = 0;
+            size_t oldBytes = 0, newBytes = 0;
+            for (int round = 0; round < rounds; round++)
+            {
+                auto start = Clock::now();
+                oldBytes = oldBin(reference.data(), raw.data(), Bpp, width, height, 0, 0, width, height, bin, bin);
+                auto binned = Clock::now();
+                newBytes = binning.bin(image.data(), raw.data(), width, Bpp, 0, 0, width, height, bin, bin);
+                oldMS += toMS(binned - start);
+                newMS += toMS(Clock::now() - binned);
+            }
+            oldMS /= rounds;
+            newMS /= rounds;
+
+            bool same = oldBytes == newBytes && !memcmp(reference.data(), image.data(), newBytes);
+            identical &= same;
+            printf("    {\"bits\": %d, \"bin\": %d, \"old_ms\": %.3f, \"new_ms\": %.3f, \"speedup\": %.1f, "
+                   "\"old_fps\": %.0f, \"new_fps\": %.0f, \"matches_old\": %s}%s\n",
+                   Bpp * 8, bin, oldMS, newMS, newMS > 0 ? oldMS / newMS : 0.0, oldMS > 0 ? 1000 / oldMS : 0.0,
+                   newMS > 0 ? 1000 / newMS : 0.0, same ? "true" : "false", Bpp == 2 && bin == 4 ? "" : ",");
+        }
+    }
+    printf("  ],\n");
+    printf("  \"matches_old\": %s\n", identical ? "true" : "false");
+    printf("}\n");
+
+    return identical ? 0 : 1;
+}
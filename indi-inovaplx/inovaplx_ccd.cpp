@@ -5,10 +5,15 @@
    Copyright (C) 2017 Jasem Mutlaq (mutlaqja@ikarustech.com)
 */
 
+#include <math.h>
 #include <stdlib.h>
 #include <sys/file.h>
+#include <algorithm>
 #include <memory>
 #include "inovaplx_ccd.h"
+#include "ccd_ready_wait.h"
+
+#define STREAM_POLL    2   /* Frame poll interval while streaming (ms) */
 
 int timerNS = -1;
 int timerWE = -1;
@@ -27,9 +32,13 @@ unsigned char DIR          = 0xF;
 
 std::unique_ptr<INovaCCD> inova(new INovaCCD());
 
+// libinovasdk is called from the main loop and from the capture thread
+static std::mutex sdkLock;
+
 static void timerWestEast(void * arg)
 {
     INDI_UNUSED(arg);
+    std::lock_guard<std::mutex> guard(sdkLock);
     DIR |= 0x09;
     iNovaSDK_SendST4(DIR);
     IERmCallback(timerWE);
@@ -38,6 +47,7 @@ static void timerWestEast(void * arg)
 static void timerNorthSouth(void * arg)
 {
     INDI_UNUSED(arg);
+    std::lock_guard<std::mutex> guard(sdkLock);
     DIR |= 0x06;
     iNovaSDK_SendST4(DIR);
     IERmCallback(timerNS);
@@ -71,7 +81,8 @@ bool INovaCCD::Connect()
             CameraPropertiesNP.s = IPS_IDLE;
 
             // Set camera capabilities
-            uint32_t cap = CCD_CAN_ABORT | CCD_CAN_BIN | CCD_CAN_SUBFRAME | (iNovaSDK_HasST4() ? CCD_HAS_ST4_PORT : 0);
+            uint32_t cap = CCD_CAN_ABORT | CCD_CAN_BIN | CCD_CAN_SUBFRAME | CCD_HAS_STREAMING |
+                           (iNovaSDK_HasST4() ? CCD_HAS_ST4_PORT : 0);
             SetCCDCapability(cap);
             if(iNovaSDK_HasColorSensor())
             {
@@ -90,6 +101,10 @@ bool INovaCCD::Connect()
 
 bool INovaCCD::Disconnect()
 {
+    captureWorker.quit();
+    InExposure = false;
+
+    std::lock_guard<std::mutex> guard(sdkLock);
     iNovaSDK_SensorPowerDown();
     iNovaSDK_CloseVideo();
     iNovaSDK_CloseCamera();
@@ -177,9 +192,6 @@ bool INovaCCD::updateProperties()
 
         // Let's get parameters now from CCD
         setupParams();
-
-        // Start the timer
-        SetTimer(getCurrentPollingPeriod());
     }
     else
         // We're disconnected
@@ -204,6 +216,9 @@ void INovaCCD::setupParams()
     nbuf = PrimaryCCD.getXRes() * PrimaryCCD.getYRes() * PrimaryCCD.getBPP() / 8;
     nbuf += 512;  //  leave a little extra at the end
     PrimaryCCD.setFrameBufferSize(nbuf);
+
+    Streamer->setPixelFormat(iNovaSDK_HasColorSensor() ? INDI_BAYER_RGGB : INDI_MONO, bpp);
+    Streamer->setSize(PrimaryCCD.getXRes(), PrimaryCCD.getYRes());
 }
 
 /**************************************************************************************
@@ -211,14 +226,22 @@ void INovaCCD::setupParams()
 ***************************************************************************************/
 bool INovaCCD::StartExposure(float duration)
 {
-    double expTime = 1000.0 * duration;
-    iNovaSDK_SetExpTime(expTime);
+    // stop a capture thread still waiting for an earlier exposure
+    captureWorker.quit();
+
+    {
+        std::lock_guard<std::mutex> guard(sdkLock);
+        iNovaSDK_SetExpTime(1000.0 * duration);
+        // the camera keeps running in video mode, drop a frame taken before this exposure
+        iNovaSDK_GrabFrame();
+    }
 
     ExposureRequest = duration;
     PrimaryCCD.setExposureDuration(ExposureRequest);
     gettimeofday(&ExpStart, nullptr);
 
     InExposure = true;
+    captureWorker.start(std::bind(&INovaCCD::workerExposure, this, std::placeholders::_1));
 
     // We're done
     return true;
@@ -229,11 +252,47 @@ bool INovaCCD::StartExposure(float duration)
 ***************************************************************************************/
 bool INovaCCD::AbortExposure()
 {
+    captureWorker.quit();
+
+    std::lock_guard<std::mutex> guard(sdkLock);
     iNovaSDK_CancelLongExpTime();
     InExposure = false;
     return true;
 }
 
+/**************************************************************************************
+** Client is asking us to start streaming video, frames are binned like exposures
+***************************************************************************************/
+bool INovaCCD::StartStreaming()
+{
+    captureWorker.start(std::bind(&INovaCCD::workerStream, this, std::placeholders::_1));
+    return true;
+}
+
+bool INovaCCD::StopStreaming()
+{
+    captureWorker.quit();
+    return true;
+}
+
+bool INovaCCD::UpdateCCDFrame(int x, int y, int w, int h)
+{
+    if (!INDI::CCD::UpdateCCDFrame(x, y, w, h))
+        return false;
+
+    Streamer->setSize(PrimaryCCD.getSubW() / PrimaryCCD.getBinX(), PrimaryCCD.getSubH() / PrimaryCCD.getBinY());
+    return true;
+}
+
+bool INovaCCD::UpdateCCDBin(int binx, int biny)
+{
+    if (!INDI::CCD::UpdateCCDBin(binx, biny))
+        return false;
+
+    Streamer->setSize(PrimaryCCD.getSubW() / PrimaryCCD.getBinX(), PrimaryCCD.getSubH() / PrimaryCCD.getBinY());
+    return true;
+}
+
 /**************************************************************************************
 ** How much longer until exposure is done?
 ***************************************************************************************/
@@ -264,8 +323,10 @@ bool INovaCCD::ISNewNumber(const char *dev, const char *name, double values[], c
     {
         IUUpdateNumber(&CameraPropertiesNP, values, names, n);
 
+        std::unique_lock<std::mutex> guard(sdkLock);
         iNovaSDK_SetAnalogGain(static_cast<int16_t>(CameraPropertiesN[CCD_GAIN_N].value));
         iNovaSDK_SetBlackLevel(static_cast<int16_t>(CameraPropertiesN[CCD_BLACKLEVEL_N].value));
+        guard.unlock();
 
         CameraPropertiesNP.s = IPS_OK;
         IDSetNumber(&CameraPropertiesNP, nullptr);
@@ -293,49 +354,77 @@ void INovaCCD::addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FITS
 }
 
 /**************************************************************************************
-** Main device loop. We check for exposure and temperature progress here
+** Capture thread. Counts down to the end of the exposure, then polls for the frame.
 ***************************************************************************************/
-void INovaCCD::TimerHit()
+void INovaCCD::workerExposure(const std::atomic_bool &isAboutToQuit)
 {
-    long timeleft;
+    auto timeLeft = [this]()
+    {
+        return CalcTimeLeft();
+    };
+    auto showTimeLeft = [this](float timeleft)
+    {
+        PrimaryCCD.setExposureLeft(timeleft);
+    };
+    if (!ReadyWait::countdown(isAboutToQuit, timeLeft, showTimeLeft))
+        return;
 
-    if(isConnected() == false)
-        return;  //  No need to reset timer if we are not connected anymore
+    /* We're done exposing */
+    LOG_INFO("Exposure done, downloading image...");
 
-    if (InExposure)
+    const unsigned char *raw = nullptr;
+    auto frameReady = [this, &raw]()
     {
-        timeleft = CalcTimeLeft();
+        raw = grabFrame();
+        return raw != nullptr ? ReadyWait::State::Ready : ReadyWait::State::Busy;
+    };
+    if (!ReadyWait::poll(isAboutToQuit, frameReady))
+        return;
+
+    // We're no longer exposing...
+    InExposure = false;
+
+    grabImage(raw);
+}
 
-        // Less than a 0.1 second away from exposure completion
-        // This is an over simplified timing method, check CCDSimulator and inova for better timing checks
-        if(timeleft >= 0.0)
+/**************************************************************************************
+** Capture thread while streaming. Every frame of the camera is binned and sent on.
+***************************************************************************************/
+void INovaCCD::workerStream(const std::atomic_bool &isAboutToQuit)
+{
+    double frameDuration = 1.0 / Streamer->getTargetFPS();
+    {
+        std::lock_guard<std::mutex> guard(sdkLock);
+        iNovaSDK_SetExpTime(1000.0 * frameDuration);
+    }
+
+    while (!isAboutToQuit)
+    {
+        const unsigned char *raw = grabFrame();
+        if (raw == nullptr)
         {
-            // Just update time left in client
-            PrimaryCCD.setExposureLeft(timeleft);
+            usleep(STREAM_POLL * 1000);
+            continue;
         }
-        else
-        {
-            /* We're done exposing */
-            LOG_INFO("Exposure done, downloading image...");
-            RawData = (unsigned char*)iNovaSDK_GrabFrame();
-            if(RawData != nullptr)
-            {
-                // We're no longer exposing...
-                InExposure = false;
 
-                grabImage();
-            }
-        }
+        std::unique_lock<std::mutex> guard(ccdBufferLock);
+        size_t size = binFrame(raw);
+        Streamer->newFrame(PrimaryCCD.getFrameBuffer(), size);
     }
+}
 
-    SetTimer(getCurrentPollingPeriod());
-    return;
+const unsigned char *INovaCCD::grabFrame()
+{
+    // the frame stays valid until the next call, only the capture thread grabs while it runs
+    std::lock_guard<std::mutex> guard(sdkLock);
+    return iNovaSDK_GrabFrame();
 }
 
 IPState INovaCCD::GuideEast(uint32_t ms)
 {
     DIR |= 0x09;
     DIR &= 0x0E;
+    std::lock_guard<std::mutex> guard(sdkLock);
     iNovaSDK_SendST4(DIR);
     timerWE = IEAddTimer(ms, timerWestEast, (void *)this);
     return IPS_IDLE;
@@ -345,6 +434,7 @@ IPState INovaCCD::GuideWest(uint32_t ms)
 {
     DIR |= 0x09;
     DIR &= 0x07;
+    std::lock_guard<std::mutex> guard(sdkLock);
     iNovaSDK_SendST4(DIR);
     timerWE = IEAddTimer(ms, timerWestEast, (void *)this);
     return IPS_IDLE;
@@ -354,6 +444,7 @@ IPState INovaCCD::GuideNorth(uint32_t ms)
 {
     DIR |= 0x06;
     DIR &= 0x0D;
+    std::lock_guard<std::mutex> guard(sdkLock);
     iNovaSDK_SendST4(DIR);
     timerNS = IEAddTimer(ms, timerNorthSouth, (void *)this);
     return IPS_IDLE;
@@ -363,64 +454,35 @@ IPState INovaCCD::GuideSouth(uint32_t ms)
 {
     DIR |= 0x06;
     DIR &= 0x0B;
+    std::lock_guard<std::mutex> guard(sdkLock);
     iNovaSDK_SendST4(DIR);
     timerNS = IEAddTimer(ms, timerNorthSouth, (void *)this);
     return IPS_IDLE;
 }
 
-void INovaCCD::grabImage()
+/**************************************************************************************
+** Crops and bins a frame into the chip buffer, ccdBufferLock must be held.
+***************************************************************************************/
+size_t INovaCCD::binFrame(const unsigned char *raw)
+{
+    int maxW = PrimaryCCD.getXRes();
+    int maxH = PrimaryCCD.getYRes();
+    int startX = PrimaryCCD.getSubX();
+    int startY = PrimaryCCD.getSubY();
+    int w = std::min(PrimaryCCD.getSubW(), maxW - startX);
+    int h = std::min(PrimaryCCD.getSubH(), maxH - startY);
+
+    return binning.bin(PrimaryCCD.getFrameBuffer(), raw, maxW, PrimaryCCD.getBPP() / 8, startX, startY, w, h,
+                       PrimaryCCD.getBinX(), PrimaryCCD.getBinY());
+}
+
+void INovaCCD::grabImage(const unsigned char *raw)
 {
     std::unique_lock<std::mutex> guard(ccdBufferLock);
     // Let's get a pointer to the frame buffer
-    unsigned char * image = PrimaryCCD.getFrameBuffer();
-    if(image != nullptr)
+    if (PrimaryCCD.getFrameBuffer() != nullptr)
     {
-        int Bpp = iNovaSDK_GetDataWide() > 0 ? 2 : 1;
-        int p = 0;
-
-        int binX = PrimaryCCD.getBinX();
-        int binY = PrimaryCCD.getBinY();
-        int startX = PrimaryCCD.getSubX();
-        int startY = PrimaryCCD.getSubY();
-        int endX = startX + PrimaryCCD.getSubW();
-        int endY = startY + PrimaryCCD.getSubH();
-        int maxW = PrimaryCCD.getXRes();
-        int maxH = PrimaryCCD.getYRes();
-        endX = (endX > maxW ? maxW : endX);
-        endY = (endY > maxH ? maxH : endY);
-
-        for(int y = startY; y < endY; y += binY)
-        {
-            if(endY - y < binY)
-                break;
-            for(int x = startX * Bpp; x < endX * Bpp; x += Bpp * binX)
-            {
-                if(endX * Bpp - x < binX * Bpp)
-                    break;
-                int t = 0;
-                for(int yy = y; yy < y + binY; yy++)
-                {
-                    for(int xx = x; xx < x + Bpp * binX; xx += Bpp)
-                    {
-                        if(Bpp > 1)
-                        {
-                            t += RawData[1 + xx + yy * maxW * Bpp] + (RawData[xx + yy * maxW * Bpp] << 8);
-                            t = (t < 0xffff ? t : 0xffff);
-                        }
-                        else
-                        {
-                            t += RawData[xx + yy * maxW * Bpp];
-                            t = (t < 0xff ? t : 0xff);
-                        }
-                    }
-                }
-                image[p++] = (unsigned char)(t & 0xff);
-                if(Bpp > 1)
-                {
-                    image[p++] = (unsigned char)((t >> 8) & 0xff);
-                }
-            }
-        }
+        binFrame(raw);
         guard.unlock();
         // Let INDI::CCD know we're done filling the image buffer
         LOG_INFO("Download complete.");
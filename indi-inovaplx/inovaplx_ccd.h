@@ -10,11 +10,16 @@
 #include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <indiccd.h>
+#include <indisinglethreadpool.h>
 
 #include <inovasdk.h>
 
+#include "inovaplx_bin.h"
+
 int instanceN = 0;
 class INovaCCD : public INDI::CCD
 {
@@ -24,7 +29,6 @@ public:
     bool ISNewNumber (const char *dev, const char *name, double values[], char *names[], int n);
     void ISGetProperties(const char *dev);
 
-    void CaptureThread();
 protected:
 
     // General device functions
@@ -38,7 +42,10 @@ protected:
     // CCD specific functions
     bool StartExposure(float duration);
     bool AbortExposure();
-    void TimerHit();
+    bool StartStreaming();
+    bool StopStreaming();
+    bool UpdateCCDFrame(int x, int y, int w, int h);
+    bool UpdateCCDBin(int binx, int biny);
     void addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FITSRecord> &fitsKeywords);
 
     // Guiding
@@ -52,12 +59,18 @@ private:
     // Utility functions
     float CalcTimeLeft();
     void  setupParams();
-    void  grabImage();
+    const unsigned char *grabFrame();
+    size_t binFrame(const unsigned char *raw);
+    void  grabImage(const unsigned char *raw);
 
-    // Are we exposing?
-    bool InExposure;
+    // Capture thread, waits for the exposure or streams frames
+    void workerExposure(const std::atomic_bool &isAboutToQuit);
+    void workerStream(const std::atomic_bool &isAboutToQuit);
+    INDI::SingleThreadPool captureWorker;
+    INovaBinning binning;
 
-    unsigned char *RawData;
+    // Are we exposing?
+    std::atomic_bool InExposure;
 
     // Struct to keep timing
     struct timeval ExpStart;
@@ -55,13 +55,14 @@ class MGCMD_NOP1 : MGC
         if (CR_SUCCESS != MGC::ask(root))
             return CR_FAILURE;
 
-        if (root.lock())
+        MGenDevice::Lock lock(root);
+        if (lock)
         {
             root.write(query);
 
             int const bytes_read = root.read(answer);
 
-            root.unlock();
+            lock.release();
 
             if (answer[0] == query[0] && 1 == bytes_read)
                 return CR_SUCCESS;
@@ -55,11 +55,12 @@ class MGCP_ENTER_NORMAL_MODE : MGC
         if (CR_SUCCESS != MGC::ask(root))
             return CR_FAILURE;
 
-        if (root.lock())
+        MGenDevice::Lock lock(root);
+        if (lock)
         {
             root.write(query);
             sleep(1);
-            root.unlock();
+            lock.release();
         }
         return CR_SUCCESS;
     }
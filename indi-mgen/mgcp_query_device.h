@@ -55,13 +55,14 @@ class MGCP_QUERY_DEVICE : MGC
         if (CR_SUCCESS != MGC::ask(root))
             return CR_FAILURE;
 
-        if (root.lock())
+        MGenDevice::Lock lock(root);
+        if (lock)
         {
             root.write(query);
 
             int const bytes_read = root.read(answer);
 
-            root.unlock();
+            lock.release();
 
             if (answer[0] == (unsigned char)~query[0] && 5 == bytes_read)
             {
@@ -48,6 +48,32 @@ class MGenDevice
     bool lock();
     void unlock();
 
+  public:
+    /** \brief Holding the device lock for the duration of a command.
+     *
+     * The lock is released by release() or when leaving the scope, including when an IOError is thrown while
+     * talking to the device, so that the other threads using the device are not locked out.
+     */
+    class Lock
+    {
+      public:
+        explicit Lock(MGenDevice &device): device(device), locked(device.lock()) {}
+        ~Lock() { release(); }
+        Lock(Lock const &) = delete;
+        Lock &operator=(Lock const &) = delete;
+        explicit operator bool() const { return locked; }
+        void release()
+        {
+            if (locked)
+                device.unlock();
+            locked = false;
+        }
+
+      protected:
+        MGenDevice &device;
+        bool locked;
+    };
+
   public:
     /** \brief Connecting a device identified by VID:PID.
      *
@@ -40,13 +40,18 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <fcntl.h>
 
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <memory>
 #include <vector>
 #include <queue>
 #include <array>
 
 #include "indidevapi.h"
+#include "eventloop.h"
 #include "indilogger.h"
 #include "indiccd.h"
 
@@ -85,7 +90,10 @@ bool MGenAutoguider::ISNewSwitch(const char *dev, const char *name, ISState *sta
                 ISwitch *const key_switch = IUFindOnSwitch(&ui.remote.property);
                 if (key_switch)
                 {
+                    std::unique_lock<std::mutex> guard(ui.lock);
                     ui.is_enabled = key_switch->aux == nullptr ? false : true;
+                    guard.unlock();
+                    ui.wakeup.notify_all();
                     ui.remote.property.s = IPS_OK;
                 }
                 else ui.remote.property.s = IPS_ALERT;
@@ -180,11 +188,12 @@ bool MGenAutoguider::ISNewNumber(char const *dev, char const *name, double value
         {
             if (!strcmp(name, "MGEN_UI_OPTIONS"))
             {
+                std::unique_lock<std::mutex> guard(ui.lock);
                 IUUpdateNumber(&ui.framerate.property, values, names, n);
+                guard.unlock();
+                ui.wakeup.notify_all();
                 ui.framerate.property.s = IPS_OK;
                 IDSetNumber(&ui.framerate.property, NULL);
-                RemoveTimer(ui.timer);
-                TimerHit();
                 _S("UI refresh rate is now %+02.2f frames per second", ui.framerate.number.value);
                 return true;
             }
@@ -214,6 +223,7 @@ void ISSnoopDevice(XMLEle *root)
 
 MGenAutoguider::MGenAutoguider(): device(nullptr)
 {
+    SetCCDCapability(CCD_HAS_STREAMING);
     SetCCDParams(128, 64, 8, 5.0f, 5.0f);
     PrimaryCCD.setFrameBufferSize(PrimaryCCD.getXRes() * PrimaryCCD.getYRes() * PrimaryCCD.getBPP() / 8, true);
 }
@@ -342,6 +352,7 @@ bool MGenAutoguider::Connect()
 
     _D("initiating connection.", "");
 
+    stopUIReader();
     if (device)
         delete device;
     device = new MGenDevice();
@@ -416,7 +427,7 @@ bool MGenAutoguider::Connect()
                         if (getHeartbeat())
                         {
                             _S("considering device connected", "");
-                            /* FIXME: currently no way to tell which timer hit, so set one for the UI only */
+                            startUIReader();
                             TimerHit();
                             return device->isConnected();
                         }
@@ -444,6 +455,9 @@ bool MGenAutoguider::Connect()
 ***************************************************************************************/
 bool MGenAutoguider::Disconnect()
 {
+    /* The reader must be gone before the device is disabled */
+    stopUIReader();
+
     if (device->isConnected())
     {
         _D("initiating disconnection.", "");
@@ -540,44 +554,244 @@ void MGenAutoguider::TimerHit()
                 voltage.timestamp = tm;
             }
 
-            /* Update UI frame - I'm trading efficiency for code clarity, sorry for the computation with doubles */
-            if (ui.is_enabled && (0 == ui.timestamp.tv_sec || 0 < ui.framerate.number.value))
+            /* Rearm the timer, remote UI frames are read by readUIFrames() */
+            ui.timer = SetTimer(1000);
+        }
+        catch (IOError &e)
+        {
+            _S("device disconnected (%s)", e.what());
+            device->disable();
+            setConnected(false, IPS_ALERT);
+            updateProperties();
+        }
+}
+
+bool MGenAutoguider::StartStreaming()
+{
+    Streamer->setPixelFormat(INDI_MONO, 8);
+    Streamer->setSize(PrimaryCCD.getXRes(), PrimaryCCD.getYRes());
+
+    std::unique_lock<std::mutex> guard(ui.lock);
+    ui.is_streaming = true;
+    /* Make sure the first frame is sent even if the UI did not change */
+    ui.has_checksum = false;
+    guard.unlock();
+    ui.wakeup.notify_all();
+    _S("streaming remote UI", "");
+    return true;
+}
+
+bool MGenAutoguider::StopStreaming()
+{
+    std::unique_lock<std::mutex> guard(ui.lock);
+    ui.is_streaming = false;
+    ui.has_checksum = false;
+    guard.unlock();
+    ui.wakeup.notify_all();
+    _S("stopped streaming remote UI", "");
+    return true;
+}
+
+/**************************************************************************************
+ * Remote UI reader
+ **************************************************************************************/
+
+void MGenAutoguider::startUIReader()
+{
+    stopUIReader();
+
+    if (pipe(ui.wake_pipe))
+    {
+        _E("failed creating the remote UI pipe (%s)", strerror(errno));
+        ui.wake_pipe[0] = ui.wake_pipe[1] = -1;
+        return;
+    }
+    fcntl(ui.wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(ui.wake_pipe[1], F_SETFL, O_NONBLOCK);
+    ui.callback = IEAddCallback(ui.wake_pipe[0], publishUIFrameHelper, this);
+
+    std::unique_lock<std::mutex> guard(ui.lock);
+    ui.is_reading   = true;
+    ui.has_frame    = false;
+    ui.has_checksum = false;
+    ui.timestamp    = { .tv_sec = 0, .tv_nsec = 0 };
+    ui.error.clear();
+    guard.unlock();
+
+    ui.reader = std::thread(&MGenAutoguider::readUIFrames, this);
+}
+
+void MGenAutoguider::stopUIReader()
+{
+    std::unique_lock<std::mutex> guard(ui.lock);
+    ui.is_reading = false;
+    guard.unlock();
+    ui.wakeup.notify_all();
+
+    if (ui.reader.joinable())
+        ui.reader.join();
+
+    if (0 <= ui.callback)
+        IERmCallback(ui.callback);
+    ui.callback = -1;
+
+    for (int &fd : ui.wake_pipe)
+    {
+        if (0 <= fd)
+            close(fd);
+        fd = -1;
+    }
+}
+
+void MGenAutoguider::readUIFrames()
+{
+    char const wake = 0;
+    std::unique_lock<std::mutex> guard(ui.lock);
+
+    while (ui.is_reading && device->isConnected())
+    {
+        /* Streaming reads frames back to back, the device paces the actual frame rate */
+        bool const streaming = ui.is_streaming;
+
+        if (!streaming)
+        {
+            /* The preview is refreshed at the frame rate requested, once if it is zero */
+            if (!ui.is_enabled || (0 != ui.timestamp.tv_sec && ui.framerate.number.value <= 0))
             {
-                double const ui_period = 1.0f / ui.framerate.number.value;
-                double const ui_next =
-                    (double)ui.timestamp.tv_sec + (double)ui.timestamp.tv_nsec / 1000000000.0f + ui_period;
+                ui.wakeup.wait(guard);
+                continue;
+            }
+
+            if (0 != ui.timestamp.tv_sec)
+            {
+                struct timespec tm = { .tv_sec = 0, .tv_nsec = 0 };
+                clock_gettime(CLOCK_MONOTONIC, &tm);
+
+                double const ui_next = (double)ui.timestamp.tv_sec + (double)ui.timestamp.tv_nsec / 1000000000.0f +
+                                       1.0f / ui.framerate.number.value;
                 double const now = tm.tv_sec + tm.tv_nsec / 1000000000.0f;
 
-                if (ui_next < now)
+                if (now < ui_next)
                 {
-                    MGIO_READ_DISPLAY_FRAME read_frame;
-
-                    if (CR_SUCCESS == read_frame.ask(*device))
-                    {
-                        std::unique_lock<std::mutex> guard(ccdBufferLock);
-                        MGIO_READ_DISPLAY_FRAME::ByteFrame frame;
-                        read_frame.get_frame(frame);
-                        memcpy(PrimaryCCD.getFrameBuffer(), frame.data(), frame.size());
-                        guard.unlock();
-                        ExposureComplete(&PrimaryCCD);
-                    }
-                    else
-                        _E("failed reading remote UI frame", "");
-
-                    ui.timestamp = tm;
+                    ui.wakeup.wait_for(guard, std::chrono::duration<double>(ui_next - now));
+                    continue;
                 }
             }
+        }
+
+        guard.unlock();
 
-            /* Rearm the timer, use a minimal timer period of 1s, and shorter if frame rate is higher than 1fps */
-            ui.timer = SetTimer(1.0f < ui.framerate.number.value ? (long)(1000.0f / ui.framerate.number.value) : 1000);
+        /* Streaming reads the frame blocks pipelined, to follow the device as closely as possible */
+        MGIO_READ_DISPLAY_FRAME read_frame(streaming);
+        IOResult result = CR_FAILURE;
+        std::string error;
+        try
+        {
+            result = read_frame.ask(*device);
         }
         catch (IOError &e)
         {
-            _S("device disconnected (%s)", e.what());
-            device->disable();
-            setConnected(false, IPS_ALERT);
-            updateProperties();
+            error = e.what();
+        }
+
+        struct timespec tm = { .tv_sec = 0, .tv_nsec = 0 };
+        clock_gettime(CLOCK_MONOTONIC, &tm);
+
+        guard.lock();
+        ui.timestamp = tm;
+
+        if (!error.empty())
+        {
+            /* The main loop disconnects */
+            ui.error = error;
+            if (write(ui.wake_pipe[1], &wake, 1) < 0)
+                _E("failed signaling the remote UI frame (%s)", strerror(errno));
+            break;
         }
+
+        if (CR_SUCCESS != result)
+        {
+            _E("failed reading remote UI frame", "");
+            ui.wakeup.wait_for(guard, std::chrono::seconds(1));
+            continue;
+        }
+
+        /* Streaming was started or stopped while reading, the frame is for the other view */
+        if (streaming != ui.is_streaming)
+            continue;
+
+        /* The UI is mostly static, only send frames that changed */
+        uint32_t const checksum = read_frame.checksum();
+        if (ui.has_checksum && checksum == ui.checksum)
+            continue;
+
+        ui.checksum     = checksum;
+        ui.has_checksum = true;
+
+        MGIO_READ_DISPLAY_FRAME::ByteFrame frame;
+        if (streaming)
+            read_frame.get_frame(frame, 0xFF, 0x00);
+        else
+            read_frame.get_frame(frame);
+        ui.frame.assign(frame.begin(), frame.end());
+        ui.frame_is_streamed = streaming;
+
+        /* A frame the main loop did not publish yet is replaced, the main loop was already woken up for it */
+        if (!ui.has_frame && write(ui.wake_pipe[1], &wake, 1) < 0)
+            _E("failed signaling the remote UI frame (%s)", strerror(errno));
+        ui.has_frame = true;
+    }
+}
+
+void MGenAutoguider::publishUIFrameHelper(int fd, void *context)
+{
+    INDI_UNUSED(fd);
+    static_cast<MGenAutoguider *>(context)->publishUIFrame();
+}
+
+void MGenAutoguider::publishUIFrame()
+{
+    char drain[16];
+    while (0 < read(ui.wake_pipe[0], drain, sizeof(drain)))
+        ;
+
+    std::unique_lock<std::mutex> guard(ui.lock);
+
+    if (!ui.error.empty())
+    {
+        std::string const error = ui.error;
+        ui.error.clear();
+        guard.unlock();
+
+        _S("device disconnected (%s)", error.c_str());
+        device->disable();
+        setConnected(false, IPS_ALERT);
+        updateProperties();
+        return;
+    }
+
+    if (!ui.has_frame)
+        return;
+
+    std::vector<unsigned char> frame;
+    frame.swap(ui.frame);
+    ui.has_frame = false;
+    bool const streamed = ui.frame_is_streamed;
+    bool const streaming = ui.is_streaming;
+    guard.unlock();
+
+    if (streamed)
+    {
+        if (streaming)
+            Streamer->newFrame(frame.data(), frame.size());
+    }
+    else
+    {
+        std::unique_lock<std::mutex> buffer_guard(ccdBufferLock);
+        memcpy(PrimaryCCD.getFrameBuffer(), frame.data(), frame.size());
+        buffer_guard.unlock();
+        ExposureComplete(&PrimaryCCD);
+    }
 }
 
 /**************************************************************************************
@@ -113,6 +113,12 @@
 #include "indidevapi.h"
 #include "indiccd.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 class MGenAutoguider : public INDI::CCD
 {
   public:
@@ -169,9 +175,22 @@ class MGenAutoguider : public INDI::CCD
   protected:
     struct ui
     {
-        int timer;                 /*!< The timer counting for the refresh event updating the remote user interface. */
+        int timer;                 /*!< The timer polling the device status, heartbeat and voltages. */
         bool is_enabled;           /*!< Whether the remote UI is being transferred to the client. */
+        bool is_streaming;         /*!< Whether the remote UI is being transferred through the video stream. */
+        bool has_checksum;         /*!< Whether checksum holds the hash of the last frame sent to the client. */
+        uint32_t checksum;         /*!< Hash of the last frame sent to the client, unchanged frames are not sent again. */
         struct timespec timestamp; /*!< The last time this structure was read from the device. */
+        std::thread reader;        /*!< The thread reading the remote UI frames, off the main loop. */
+        std::mutex lock;           /*!< Protects the settings above and the frame handed over by the reader. */
+        std::condition_variable wakeup; /*!< Wakes the reader up when the settings change. */
+        bool is_reading;           /*!< Whether the reader should keep running. */
+        bool has_frame;            /*!< Whether frame holds a frame not published yet. */
+        bool frame_is_streamed;    /*!< Whether frame goes to the video stream rather than to the preview. */
+        std::vector<unsigned char> frame; /*!< The last frame read, published on the main loop. */
+        std::string error;         /*!< Set by the reader when the device disconnected. */
+        int wake_pipe[2];          /*!< The reader wakes the main loop up through this pipe when it has a frame. */
+        int callback;              /*!< The main loop callback reading wake_pipe. */
         struct remote
         {
             ISwitch switches[2]; /*!< Remote UI enable/disable. */
@@ -187,7 +206,9 @@ class MGenAutoguider : public INDI::CCD
             ISwitch switches[6];                 /*!< Button switches for ESC, SET, UP, LEFT, RIGHT and DOWN. */
             ISwitchVectorProperty properties[4]; /*!< Button INDI properties, {ESC,SET}, {UP}, {LEFT,RIGHT} and {DOWN}. */
         } buttons;
-        ui(): timer(0), is_enabled(false), timestamp({ .tv_sec = 0, .tv_nsec = 0 }) {}
+        ui(): timer(0), is_enabled(false), is_streaming(false), has_checksum(false), checksum(0),
+            timestamp({ .tv_sec = 0, .tv_nsec = 0 }), is_reading(false), has_frame(false), frame_is_streamed(false),
+            wake_pipe{ -1, -1 }, callback(-1) {}
     } ui;
 
   protected:
@@ -207,6 +228,22 @@ class MGenAutoguider : public INDI::CCD
     virtual bool Connect();
     virtual bool Disconnect();
 
+  protected:
+    /** \brief Mirroring the remote UI through the video stream, at the rate the device can provide frames. */
+    virtual bool StartStreaming();
+    virtual bool StopStreaming();
+
+  protected:
+    /** \internal Starting and stopping the thread reading the remote UI frames.
+     * Frame reads take tens of milliseconds of USB exchanges, so they are kept off the main loop. The reader hands
+     * the frames that changed over to publishUIFrame(), which sends them from the main loop.
+     */
+    void startUIReader();
+    void stopUIReader();
+    void readUIFrames();
+    static void publishUIFrameHelper(int fd, void *context);
+    void publishUIFrame();
+
   protected:
     virtual const char *getDefaultName();
 
@@ -68,7 +68,8 @@ class MGIO_INSERT_BUTTON : MGC
         if (CR_SUCCESS != MGC::ask(root))
             return CR_FAILURE;
 
-        if (root.lock())
+        MGenDevice::Lock lock(root);
+        if (lock)
         {
             IOByte const b = query[2];
             _D("sending button %d", b);
@@ -83,7 +84,7 @@ class MGIO_INSERT_BUTTON : MGC
 
             _D("button %d sent", b);
 
-            root.unlock();
+            lock.release();
         }
         return CR_SUCCESS;
     }
@@ -41,6 +41,10 @@
 #ifndef _3RDPARTY_INDI_MGEN_MGIO_READ_DISPLAY_FRAME_H_
 #define _3RDPARTY_INDI_MGEN_MGIO_READ_DISPLAY_FRAME_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <unistd.h>
+
 #include "mgc.h"
 
 class MGIO_READ_DISPLAY_FRAME : MGC
@@ -52,10 +56,22 @@ class MGIO_READ_DISPLAY_FRAME : MGC
   protected:
     static std::size_t const frame_size = (128 * 64) / 8;
     IOBuffer bitmap_frame;
+    /** \internal Whether all block queries are sent at once instead of one query/answer per block */
+    bool const pipelined;
+
+  public:
+    /** \brief Returning a FNV-1a hash of the bitmap, to detect frames that did not change */
+    uint32_t checksum() const
+    {
+        uint32_t hash = 2166136261u;
+        for (IOByte const b : bitmap_frame)
+            hash = (hash ^ b) * 16777619u;
+        return hash;
+    }
 
   public:
     typedef std::array<unsigned char, frame_size * 8> ByteFrame;
-    ByteFrame &get_frame(ByteFrame &frame) const
+    ByteFrame &get_frame(ByteFrame &frame, unsigned char on = '0', unsigned char off = ' ') const
     {
         /* A display byte is 8 display bits shaping a column, LSB at the top
          *
@@ -77,7 +93,7 @@ class MGIO_READ_DISPLAY_FRAME : MGC
             unsigned int const B = c + (l / 8) * 128;
             unsigned int const b = l % 8;
 
-            frame[i] = ((bitmap_frame[B] >> b) & 0x01) ? '0' : ' ';
+            frame[i] = ((bitmap_frame[B] >> b) & 0x01) ? on : off;
         }
 #if 0
         _D("    0123456789|123456789|123456789|123456789|123456789|123456789|123456789|123456789|123456789|123456789|123456789|123456789|1234567","");
@@ -112,25 +128,31 @@ class MGIO_READ_DISPLAY_FRAME : MGC
         /* We'll read 8 blocks of 128 bytes, not optimal, but it's working */
         answer.resize(1 + 128);
 
-        if (root.lock())
+        MGenDevice::Lock lock(root);
+        if (lock)
         {
             _D("reading UI frame",0);
 
-            for (unsigned int block = 0; block < 8 * 128; block += 128)
+            if (pipelined)
+                askPipelined(root);
+            else
             {
-                /* Query is using 10 bits of the address over two bytes, then 1 byte for the count */
-                IOByte const length = 128;
-                query[2]            = (unsigned char)((block & 0x03FF) >> 0);
-                query[3]            = (unsigned char)((block & 0x03FF) >> 8);
-                query[4]            = length;
-
-                root.write(query);
-                /* Reply is SUBFUNC plus the frame block */
-                if (root.read(answer) < length + 1)
-                    _E("failed reading frame block, pushing back nonetheless", "");
-                if (opCode() != answer[0])
-                    _E("failed acking frame block, command is desynced, pushing back nonetheless", "");
-                bitmap_frame.insert(bitmap_frame.end(), answer.begin() + 1, answer.end());
+                for (unsigned int block = 0; block < 8 * 128; block += 128)
+                {
+                    /* Query is using 10 bits of the address over two bytes, then 1 byte for the count */
+                    IOByte const length = 128;
+                    query[2]            = (unsigned char)((block & 0x03FF) >> 0);
+                    query[3]            = (unsigned char)((block & 0x03FF) >> 8);
+                    query[4]            = length;
+
+                    root.write(query);
+                    /* Reply is SUBFUNC plus the frame block */
+                    if (root.read(answer) < length + 1)
+                        _E("failed reading frame block, pushing back nonetheless", "");
+                    if (opCode() != answer[0])
+                        _E("failed acking frame block, command is desynced, pushing back nonetheless", "");
+                    bitmap_frame.insert(bitmap_frame.end(), answer.begin() + 1, answer.end());
+                }
             }
 
             /* FIXME: don't ever try to reuse this command after ask() was called... */
@@ -144,14 +166,64 @@ class MGIO_READ_DISPLAY_FRAME : MGC
 
             _D("done reading UI frame",0);
 
-            root.unlock();
+            lock.release();
         }
 
         return CR_SUCCESS;
     }
 
+  protected:
+    /** \internal Sending the eight block queries in one write, then collecting the eight answers.
+     * This saves the device absorption delay and the USB round trip of each block.
+     */
+    void askPipelined(MGenDevice &root) //throw(IOError)
+    {
+        IOByte const length = 128;
+        IOBuffer queries;
+        queries.reserve(8 * query.size());
+        for (unsigned int block = 0; block < 8 * 128; block += 128)
+        {
+            queries.push_back(query[0]);
+            queries.push_back(query[1]);
+            queries.push_back((unsigned char)((block & 0x03FF) >> 0));
+            queries.push_back((unsigned char)((block & 0x03FF) >> 8));
+            queries.push_back(length);
+        }
+        root.write(queries);
+
+        /* Answers may arrive in several USB transfers, give up after ~100ms without data */
+        IOBuffer answers(8 * (1 + length));
+        std::size_t received = 0;
+        for (int idle = 0; received < answers.size() && idle < 50;)
+        {
+            IOBuffer chunk(answers.size() - received);
+            int const bytes_read = root.read(chunk);
+            if (bytes_read > 0)
+            {
+                std::copy(chunk.begin(), chunk.begin() + bytes_read, answers.begin() + received);
+                received += bytes_read;
+                idle = 0;
+            }
+            else
+            {
+                idle++;
+                usleep(2000);
+            }
+        }
+
+        if (received < answers.size())
+            _E("failed reading frame blocks, got %zu bytes out of %zu, pushing back nonetheless", received, answers.size());
+
+        for (std::size_t offset = 0; offset < answers.size(); offset += 1 + length)
+        {
+            if (opCode() != answers[offset])
+                _E("failed acking frame block, command is desynced, pushing back nonetheless", "");
+            bitmap_frame.insert(bitmap_frame.end(), answers.begin() + offset + 1, answers.begin() + offset + 1 + length);
+        }
+    }
+
   public:
-    MGIO_READ_DISPLAY_FRAME() : MGC(IOBuffer{ opCode(), 0x0D, 0, 0, 0 }, IOBuffer(1)), bitmap_frame(frame_size){};
+    MGIO_READ_DISPLAY_FRAME(bool pipelined = false) : MGC(IOBuffer{ opCode(), 0x0D, 0, 0, 0 }, IOBuffer(1)), bitmap_frame(frame_size), pipelined(pipelined){};
 };
 
 #endif /* _3RDPARTY_INDI_MGEN_MGIO_READ_DISPLAY_FRAME_H_ */
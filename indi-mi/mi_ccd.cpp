@@ -24,10 +24,14 @@
 #include "mi_ccd.h"
 
 #include "config.h"
+#include "ccd_ready_wait.h"
 
 #include <math.h>
+#include <algorithm>
+#include <cstring>
 #include <deque>
 #include <memory>
+#include <unistd.h>
 #include <utility>
 
 #define TEMP_THRESHOLD  0.2  /* Differential temperature threshold (°C) */
@@ -134,6 +138,9 @@ MICCD::MICCD(int camId, bool eth) : FilterInterface(this)
 
     canDoPreflash = false;
 
+    maxPixelValue      = -1;
+    chipDescription[0] = '\0';
+
     setDeviceName(name);
     setVersion(INDI_MI_VERSION_MAJOR, INDI_MI_VERSION_MINOR);
 }
@@ -280,8 +287,6 @@ bool MICCD::updateProperties()
 
         // Let's get parameters now from CCD
         setupParams();
-
-        timerID = SetTimer(getCurrentPollingPeriod());
     }
     else
     {
@@ -311,7 +316,6 @@ bool MICCD::updateProperties()
         {
             INDI::FilterInterface::updateProperties();
         }
-        RemoveTimer(timerID);
     }
 
     return true;
@@ -371,6 +375,10 @@ bool MICCD::Connect()
 
     gxccd_get_boolean_parameter(cameraHandle, GBP_PREFLASH, &canDoPreflash);
 
+    if (gxccd_get_string_parameter(cameraHandle, GSP_CHIP_DESCRIPTION, chipDescription, sizeof(chipDescription)) < 0)
+        chipDescription[0] = '\0';
+    rtrim(chipDescription);
+
     SetCCDCapability(cap);
 
     gxccd_get_integer_parameter(cameraHandle, GIP_MAX_BINNING_X, &maxBinX);
@@ -395,6 +403,10 @@ bool MICCD::Connect()
 
 bool MICCD::Disconnect()
 {
+    readoutWorker.quit();
+    encodeWorker.quit();
+
+    std::lock_guard<std::mutex> lock(cameraLock);
     LOGF_INFO("Disconnected from %s.", name);
     gxccd_release(cameraHandle);
     cameraHandle = nullptr;
@@ -469,6 +481,7 @@ int MICCD::SetTemperature(double temperature)
 
     TemperatureRequest = temperature;
 
+    std::lock_guard<std::mutex> lock(cameraLock);
     if (!isSimulation() && gxccd_set_temperature(cameraHandle, temperature) < 0)
     {
         char errorStr[MAX_ERROR_LEN];
@@ -485,8 +498,12 @@ bool MICCD::StartExposure(float duration)
     imageFrameType = PrimaryCCD.getFrameType();
     useShutter = (imageFrameType == INDI::CCDChip::LIGHT_FRAME || imageFrameType == INDI::CCDChip::FLAT_FRAME);
 
+    int width  = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
+    int height = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
+
     if (!isSimulation())
     {
+        std::lock_guard<std::mutex> lock(cameraLock);
         int mode = IUFindOnSwitchIndex(&ReadModeSP);
         gxccd_set_read_mode(cameraHandle, mode);
 
@@ -499,15 +516,20 @@ bool MICCD::StartExposure(float duration)
         int fd = PrimaryCCD.getYRes() / PrimaryCCD.getBinY();
         int fy = fd - y - d;
         gxccd_start_exposure(cameraHandle, duration, useShutter, x, fy, w, d);
+
+        // depends on read mode and binning
+        if (gxccd_get_integer_parameter(cameraHandle, GIP_MAX_PIXEL_VALUE, &maxPixelValue) < 0)
+            maxPixelValue = -1;
     }
 
     ExposureRequest = duration;
     PrimaryCCD.setExposureDuration(duration);
 
     gettimeofday(&ExpStart, nullptr);
-    InExposure  = true;
-    downloading = false;
+    InExposure = true;
     LOGF_DEBUG("Taking a %.3f seconds frame...", ExposureRequest);
+
+    readoutWorker.start(std::bind(&MICCD::workerExposure, this, std::placeholders::_1, width, height));
     return true;
 }
 
@@ -515,6 +537,7 @@ bool MICCD::AbortExposure()
 {
     if (InExposure && !isSimulation())
     {
+        std::lock_guard<std::mutex> lock(cameraLock);
         if (gxccd_abort_exposure(cameraHandle, false) < 0)
         {
             char errorStr[MAX_ERROR_LEN];
@@ -524,8 +547,8 @@ bool MICCD::AbortExposure()
         }
     }
 
-    InExposure  = false;
-    downloading = false;
+    readoutWorker.quit();
+    InExposure = false;
     LOG_INFO("Exposure aborted.");
     return true;
 }
@@ -569,6 +592,7 @@ bool MICCD::UpdateCCDBin(int hor, int ver)
                    hor, ver, maxBinX, maxBinY);
         return false;
     }
+    std::unique_lock<std::mutex> lock(cameraLock);
     if (gxccd_set_binning(cameraHandle, hor, ver) < 0)
     {
         char errorStr[MAX_ERROR_LEN];
@@ -576,6 +600,7 @@ bool MICCD::UpdateCCDBin(int hor, int ver)
         LOGF_ERROR("Setting binning failed: %s.", errorStr);
         return false;
     }
+    lock.unlock();
     PrimaryCCD.setBin(hor, ver);
     return UpdateCCDFrame(PrimaryCCD.getSubX(), PrimaryCCD.getSubY(), PrimaryCCD.getSubW(), PrimaryCCD.getSubH());
 }
@@ -590,107 +615,132 @@ float MICCD::calcTimeLeft()
     return ExposureRequest - timesince / 1000.0;
 }
 
-static void mirror_image(void *buf, size_t w, size_t d)
+/* Copies the frame read bottom line first into the CCD buffer top line first, one memcpy per line. */
+static void flip_image(uint16_t *dst, const uint16_t *src, size_t w, size_t d)
 {
-    size_t w2     = w * 2;
-    size_t half_d = d / 2;
-
-    for (size_t line = 1; line <= half_d; line++)
+    const uint16_t *line = src + w * d;
+    for (size_t index = 0; index < d; index++)
     {
-        uint16_t *sa = (uint16_t *)((char *)buf + (line - 1) * w2);
-        uint16_t *da = (uint16_t *)((char *)buf + (d - line) * w2);
-        for (size_t index = 1; index <= w; index++)
-        {
-            uint16_t tmp = *sa;
-            *sa          = *da;
-            *da          = tmp;
-            ++sa;
-            ++da;
-        }
+        line -= w;
+        memcpy(dst, line, w * sizeof(uint16_t));
+        dst += w;
     }
 }
 
-/* Downloads the image from the CCD. */
-int MICCD::grabImage()
+bool MICCD::waitImageReady(const std::atomic_bool &isAboutToQuit)
 {
-    std::unique_lock<std::mutex> guard(ccdBufferLock);
-    int ret              = 0;
-    unsigned char *image = (unsigned char *)PrimaryCCD.getFrameBuffer();
-    int width  = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
-    int height = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
+    auto timeLeft = [this]()
+    {
+        return calcTimeLeft();
+    };
+    auto showTimeLeft = [this](float timeleft)
+    {
+        LOGF_DEBUG("Exposure in progress: Time left %.2fs", timeleft);
+        PrimaryCCD.setExposureLeft(timeleft);
+    };
+    if (!ReadyWait::countdown(isAboutToQuit, timeLeft, showTimeLeft))
+        return false;
 
     if (isSimulation())
-    {
-        uint16_t *buffer = (uint16_t *)image;
+        return true;
 
-        for (int i = 0; i < height; i++)
-            for (int j = 0; j < width; j++)
-                buffer[i * width + j] = rand() % UINT16_MAX;
-    }
-    else
+    return ReadyWait::poll(isAboutToQuit, [this]()
     {
-        ret = gxccd_read_image(cameraHandle, image, PrimaryCCD.getFrameBufferSize());
-        if (ret < 0)
+        bool ready = false;
+        std::lock_guard<std::mutex> lock(cameraLock);
+        if (gxccd_image_ready(cameraHandle, &ready) < 0)
         {
             char errorStr[MAX_ERROR_LEN];
             gxccd_get_last_error(cameraHandle, errorStr, sizeof(errorStr));
-            LOGF_ERROR("Error getting image: %s.", errorStr);
+            LOGF_ERROR("Getting image ready failed: %s.", errorStr);
+            return ReadyWait::State::Failed;
         }
-        else
+        return ready ? ReadyWait::State::Ready : ReadyWait::State::Busy;
+    });
+}
+
+void MICCD::workerExposure(const std::atomic_bool &isAboutToQuit, int width, int height)
+{
+    if (!waitImageReady(isAboutToQuit))
+    {
+        if (!isAboutToQuit)
         {
-            mirror_image(image, width, height);
+            InExposure = false;
+            PrimaryCCD.setExposureFailed();
         }
+        return;
     }
 
-    guard.unlock();
+    PrimaryCCD.setExposureLeft(0);
 
-    if (ExposureRequest > 5 && !ret)
-        LOG_INFO("Download complete.");
+    // Don't spam the session log unless it is a long exposure > 5 seconds
+    if (ExposureRequest > 5)
+        LOG_INFO("Exposure done, downloading image...");
 
-    downloading = false;
-    ExposureComplete(&PrimaryCCD);
+    if (grabImage(width, height) < 0)
+    {
+        InExposure = false;
+        PrimaryCCD.setExposureFailed();
+        return;
+    }
 
-    return ret;
+    InExposure = false;
+    if (ExposureRequest > 5)
+        LOG_INFO("Download complete.");
+
+    // waits for the previous frame to be encoded
+    encodeWorker.start([this, width, height](const std::atomic_bool &)
+    {
+        workerComplete(width, height);
+    });
 }
 
-void MICCD::TimerHit()
+/* Downloads the image from the CCD into the readout buffer. */
+int MICCD::grabImage(int width, int height)
 {
-    if (!isConnected())
-        return; // No need to reset timer if we are not connected anymore
+    std::lock_guard<std::mutex> guard(readoutBufferLock);
+    int ret = 0;
 
-    if (InExposure)
-    {
-        float timeleft = calcTimeLeft();
-        bool ready     = false;
+    readoutBuffer.resize(static_cast<size_t>(width) * height);
 
-        if (!downloading && (gxccd_image_ready(cameraHandle, &ready) < 0))
+    if (isSimulation())
+    {
+        for (auto &pixel : readoutBuffer)
+            pixel = rand() % UINT16_MAX;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(cameraLock);
+        ret = gxccd_read_image(cameraHandle, readoutBuffer.data(), readoutBuffer.size() * sizeof(uint16_t));
+        if (ret < 0)
         {
             char errorStr[MAX_ERROR_LEN];
             gxccd_get_last_error(cameraHandle, errorStr, sizeof(errorStr));
-            LOGF_ERROR("Getting image ready failed: %s.", errorStr);
+            LOGF_ERROR("Error getting image: %s.", errorStr);
         }
-        if (ready)
-        {
-            PrimaryCCD.setExposureLeft(0);
-            InExposure  = false;
-            downloading = true;
+    }
 
-            // Don't spam the session log unless it is a long exposure > 5 seconds
-            if (ExposureRequest > 5)
-                LOG_INFO("Exposure done, downloading image...");
+    return ret;
+}
 
-            // grab and save image
-            grabImage();
-        }
-        // camera may need some time for image download -> update client only for positive values
-        else if (timeleft >= 0)
+/* Runs on the encode worker, the camera may already expose the next frame. */
+void MICCD::workerComplete(int width, int height)
+{
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    {
+        std::lock_guard<std::mutex> lock(readoutBufferLock);
+        if (readoutBuffer.size() * sizeof(uint16_t) > static_cast<size_t>(PrimaryCCD.getFrameBufferSize()))
         {
-            LOGF_DEBUG("Exposure in progress: Time left %.2fs", timeleft);
-            PrimaryCCD.setExposureLeft(timeleft);
+            guard.unlock();
+            LOG_ERROR("Frame buffer too small for the downloaded image.");
+            PrimaryCCD.setExposureFailed();
+            return;
         }
+        flip_image(reinterpret_cast<uint16_t *>(PrimaryCCD.getFrameBuffer()), readoutBuffer.data(), width, height);
     }
+    guard.unlock();
 
-    SetTimer(getCurrentPollingPeriod());
+    ExposureComplete(&PrimaryCCD);
 }
 
 int MICCD::QueryFilter()
@@ -700,6 +750,7 @@ int MICCD::QueryFilter()
 
 bool MICCD::SelectFilter(int position)
 {
+    std::unique_lock<std::mutex> lock(cameraLock);
     if (!isSimulation() && gxccd_set_filter(cameraHandle, position - 1) < 0)
     {
         char errorStr[MAX_ERROR_LEN];
@@ -707,6 +758,7 @@ bool MICCD::SelectFilter(int position)
         LOGF_ERROR("Setting filter failed: %s.", errorStr);
         return false;
     }
+    lock.unlock();
 
     CurrentFilter = position;
     SelectFilterDone(position);
@@ -716,6 +768,7 @@ bool MICCD::SelectFilter(int position)
 
 IPState MICCD::GuideNorth(uint32_t ms)
 {
+    std::lock_guard<std::mutex> lock(cameraLock);
     if (gxccd_move_telescope(cameraHandle, 0, static_cast<int16_t>(ms)) < 0)
     {
         char errorStr[MAX_ERROR_LEN];
@@ -728,6 +781,7 @@ IPState MICCD::GuideNorth(uint32_t ms)
 
 IPState MICCD::GuideSouth(uint32_t ms)
 {
+    std::lock_guard<std::mutex> lock(cameraLock);
     if (gxccd_move_telescope(cameraHandle, 0, (-1 * static_cast<int16_t>(ms))) < 0)
     {
         char errorStr[MAX_ERROR_LEN];
@@ -740,6 +794,7 @@ IPState MICCD::GuideSouth(uint32_t ms)
 
 IPState MICCD::GuideEast(uint32_t ms)
 {
+    std::lock_guard<std::mutex> lock(cameraLock);
     if (gxccd_move_telescope(cameraHandle, (-1 * static_cast<int16_t>(ms)), 0) < 0)
     {
         char errorStr[MAX_ERROR_LEN];
@@ -752,6 +807,7 @@ IPState MICCD::GuideEast(uint32_t ms)
 
 IPState MICCD::GuideWest(uint32_t ms)
 {
+    std::lock_guard<std::mutex> lock(cameraLock);
     if (gxccd_move_telescope(cameraHandle, static_cast<int16_t>(ms), 0) < 0)
     {
         char errorStr[MAX_ERROR_LEN];
@@ -784,6 +840,7 @@ bool MICCD::ISNewSwitch(const char *dev, const char *name, ISState *states, char
                 bool on = !IUFindOnSwitchIndex(&CoolerSP);
                 double temp = on ? TemperatureRequest : TEMP_COOLER_OFF;
 
+                std::lock_guard<std::mutex> lock(cameraLock);
                 if (gxccd_set_temperature(cameraHandle, temp) < 0)
                 {
                     char errorStr[MAX_ERROR_LEN];
@@ -825,6 +882,7 @@ bool MICCD::ISNewNumber(const char *dev, const char *name, double values[], char
         {
             IUUpdateNumber(&FanNP, values, names, n);
 
+            std::lock_guard<std::mutex> lock(cameraLock);
             if (!isSimulation() && gxccd_set_fan(cameraHandle, FanN[0].value) < 0)
             {
                 char errorStr[MAX_ERROR_LEN];
@@ -845,6 +903,7 @@ bool MICCD::ISNewNumber(const char *dev, const char *name, double values[], char
         {
             IUUpdateNumber(&WindowHeatingNP, values, names, n);
 
+            std::lock_guard<std::mutex> lock(cameraLock);
             if (!isSimulation() && gxccd_set_window_heating(cameraHandle, WindowHeatingN[0].value) < 0)
             {
                 char errorStr[MAX_ERROR_LEN];
@@ -868,6 +927,7 @@ bool MICCD::ISNewNumber(const char *dev, const char *name, double values[], char
             // set NIR pre-flash if available.
             if (canDoPreflash)
             {
+                std::lock_guard<std::mutex> lock(cameraLock);
                 if (!isSimulation() && gxccd_set_preflash(cameraHandle, PreflashN[0].value, PreflashN[1].value) < 0)
                 {
                     char errorStr[MAX_ERROR_LEN];
@@ -889,6 +949,7 @@ bool MICCD::ISNewNumber(const char *dev, const char *name, double values[], char
         {
             IUUpdateNumber(&GainNP, values, names, n);
 
+            std::lock_guard<std::mutex> lock(cameraLock);
             if (!isSimulation() && gxccd_set_gain(cameraHandle, static_cast<uint16_t>(GainN[0].value)) < 0)
             {
                 char errorStr[MAX_ERROR_LEN];
@@ -933,6 +994,14 @@ void MICCD::updateTemperature()
     }
     else
     {
+        // skip this update while a frame is being downloaded
+        std::unique_lock<std::mutex> lock(cameraLock, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            temperatureID = IEAddTimer(getCurrentPollingPeriod(), MICCD::updateTemperatureHelper, this);
+            return;
+        }
+
         if (gxccd_get_value(cameraHandle, GV_CHIP_TEMPERATURE, &ccdtemp) < 0)
         {
             char errorStr[MAX_ERROR_LEN];
@@ -1006,11 +1075,13 @@ void MICCD::addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FITSRec
     char svalue[256];
     int ivalue = 0;
 
+    // called from the encode worker while the camera may be downloading the next frame,
+    // so only values cached at connection and exposure start are used
     if (hasGain)
         fitsKeywords.push_back({"GAIN", GainN[0].value, 3, "Gain"});
 
-    if (!gxccd_get_integer_parameter(cameraHandle, GIP_MAX_PIXEL_VALUE, &ivalue))
-        fitsKeywords.push_back({"DATAMAX", ivalue, nullptr});
+    if (maxPixelValue >= 0)
+        fitsKeywords.push_back({"DATAMAX", maxPixelValue, nullptr});
 
     if (numReadModes > 0)
     {
@@ -1024,12 +1095,11 @@ void MICCD::addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FITSRec
     }
     fitsKeywords.push_back({"READMODE", ivalue, svalue});
 
-    if (!gxccd_get_string_parameter(cameraHandle, GSP_CHIP_DESCRIPTION, svalue, 256))
+    if (chipDescription[0])
     {
-        rtrim(svalue);
-        fitsKeywords.push_back({"CHIPTYPE", svalue, nullptr});
+        fitsKeywords.push_back({"CHIPTYPE", chipDescription, nullptr});
 
-        if (!strcmp(svalue, "GSENSE4040"))
+        if (!strcmp(chipDescription, "GSENSE4040"))
         {
             // we use hardcoded values here, because:
             // - so far there is no possibility to read / set HDR threshold in libgxccd
@@ -25,6 +25,11 @@
 
 #include <indiccd.h>
 #include <indifilterinterface.h>
+#include <indisinglethreadpool.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 class MICCD : public INDI::CCD, public INDI::FilterInterface
 {
@@ -56,7 +61,6 @@ class MICCD : public INDI::CCD, public INDI::FilterInterface
 
     protected:
         // Misc.
-        virtual void TimerHit() override;
         virtual bool saveConfigItems(FILE *fp) override;
         virtual void addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FITSRecord> &fitsKeywords) override;
 
@@ -107,11 +111,10 @@ class MICCD : public INDI::CCD, public INDI::FilterInterface
         int maxBinX;
         int maxBinY;
         int maxGainValue;
+        int maxPixelValue;
+        char chipDescription[MAXINDILABEL];
 
         int temperatureID;
-        int timerID;
-
-        bool downloading;
 
         bool canDoPreflash;
 
@@ -124,7 +127,21 @@ class MICCD : public INDI::CCD, public INDI::FilterInterface
         bool setupParams();
 
         float calcTimeLeft();
-        int grabImage();
+        bool waitImageReady(const std::atomic_bool &isAboutToQuit);
+        int grabImage(int width, int height);
+        void workerExposure(const std::atomic_bool &isAboutToQuit, int width, int height);
+        void workerComplete(int width, int height);
+
+        // libgxccd calls from the main loop and the workers are serialized
+        std::mutex cameraLock;
+
+        // Waits for the end of exposure and downloads the frame into readoutBuffer
+        INDI::SingleThreadPool readoutWorker;
+        // Hands the frame over to the CCD buffer and encodes it, the next frame is downloaded meanwhile
+        INDI::SingleThreadPool encodeWorker;
+        // Frame as read from the camera, bottom line first
+        std::vector<uint16_t> readoutBuffer;
+        std::mutex readoutBufferLock;
 
         void updateTemperature();
         static void updateTemperatureHelper(void *);
@@ -0,0 +1,271 @@
+/*
+ Moravian INDI Driver - mock libgxccd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ libgxccd for -DINDI_MI_MOCK=ON, see common/README.md. One camera is enumerated, 4096 x 4096
+ and 40 MB/s unless set otherwise. MI_MOCK_DIGITIZE is the time from the end of exposure to
+ gxccd_image_ready returning true (ms, default 500).
+
+ Image ready polls and downloads are counted, the counters are printed to stderr on release.
+*/
+
+#include <gxccd.h>
+#include "sdk_mock.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+struct camera
+{
+    int width;
+    int height;
+    int binx {1};
+    int biny {1};
+    int frameW {0};
+    int frameH {0};
+    int digitize;
+    double bandwidth;
+    bool exposing {false};
+    std::chrono::steady_clock::time_point ready;
+    float temperature {20};
+    char error[64] {""};
+
+    std::atomic<int> readyPolls {0};
+    std::atomic<int> downloads {0};
+};
+
+static int fail(camera_t *camera, const char *error)
+{
+    snprintf(camera->error, sizeof(camera->error), "%s", error);
+    return -1;
+}
+
+void gxccd_enumerate_usb(enum_callback_t callback)
+{
+    callback(1);
+}
+
+void gxccd_enumerate_eth(enum_callback_t callback)
+{
+    callback(1);
+}
+
+camera_t *gxccd_initialize_usb(int camera_id)
+{
+    if (camera_id != 1)
+        return nullptr;
+
+    camera_t *camera  = new camera_t();
+    camera->width     = SDKMock::env("MI_MOCK_WIDTH", 4096);
+    camera->height    = SDKMock::env("MI_MOCK_HEIGHT", 4096);
+    camera->digitize  = SDKMock::env("MI_MOCK_DIGITIZE", 500);
+    camera->bandwidth = std::max(SDKMock::env("MI_MOCK_BANDWIDTH", 40.0), 0.001);
+    camera->frameW    = camera->width;
+    camera->frameH    = camera->height;
+    return camera;
+}
+
+camera_t *gxccd_initialize_eth(int camera_id)
+{
+    return gxccd_initialize_usb(camera_id);
+}
+
+void gxccd_release(camera_t *camera)
+{
+    if (camera == nullptr)
+        return;
+    fprintf(stderr, "gxccd mock: %d image ready polls, %d downloads\n", camera->readyPolls.load(),
+            camera->downloads.load());
+    delete camera;
+}
+
+int gxccd_get_boolean_parameter(camera_t *camera, int index, bool *value)
+{
+    switch (index)
+    {
+        case GBP_CONNECTED:
+        case GBP_SUB_FRAME:
+        case GBP_SHUTTER:
+        case GBP_COOLER:
+        case GBP_GUIDE:
+            *value = true;
+            return 0;
+        default:
+            *value = false;
+            return index < GBP_CONFIGURED ? 0 : fail(camera, "Unknown parameter");
+    }
+}
+
+int gxccd_get_integer_parameter(camera_t *camera, int index, int *value)
+{
+    switch (index)
+    {
+        case GIP_CAMERA_ID:        *value = 1; return 0;
+        case GIP_CHIP_W:           *value = camera->width; return 0;
+        case GIP_CHIP_D:           *value = camera->height; return 0;
+        case GIP_PIXEL_W:
+        case GIP_PIXEL_D:          *value = 3760; return 0;
+        case GIP_MAX_BINNING_X:
+        case GIP_MAX_BINNING_Y:    *value = 4; return 0;
+        case GIP_READ_MODES:       *value = 1; return 0;
+        case GIP_MINIMAL_EXPOSURE: *value = 100; return 0;
+        case GIP_MAX_PIXEL_VALUE:  *value = 65535; return 0;
+        case GIP_FILTERS:
+        case GIP_MAX_FAN:
+        case GIP_MAX_WINDOW_HEATING:
+        case GIP_MAX_GAIN:
+        case GIP_DEFAULT_READ_MODE:
+            *value = 0;
+            return 0;
+        default:
+            return fail(camera, "Unknown parameter");
+    }
+}
+
+int gxccd_get_string_parameter(camera_t *camera, int index, char *buf, size_t size)
+{
+    switch (index)
+    {
+        case GSP_CAMERA_DESCRIPTION: snprintf(buf, size, "Mock %dx%d", camera->width, camera->height); return 0;
+        case GSP_MANUFACTURER:       snprintf(buf, size, "INDI"); return 0;
+        case GSP_CAMERA_SERIAL:      snprintf(buf, size, "0001"); return 0;
+        case GSP_CHIP_DESCRIPTION:   snprintf(buf, size, "MOCK"); return 0;
+        default:                     return fail(camera, "Unknown parameter");
+    }
+}
+
+int gxccd_get_value(camera_t *camera, int index, float *value)
+{
+    switch (index)
+    {
+        case GV_CHIP_TEMPERATURE:   *value = camera->temperature; return 0;
+        case GV_POWER_UTILIZATION:  *value = 0.5; return 0;
+        case GV_ADC_GAIN:           *value = 0.35; return 0;
+        default:                    return fail(camera, "Unknown value");
+    }
+}
+
+int gxccd_set_temperature(camera_t *camera, float temp)
+{
+    camera->temperature = temp;
+    return 0;
+}
+
+int gxccd_set_binning(camera_t *camera, int x, int y)
+{
+    camera->binx = x;
+    camera->biny = y;
+    return 0;
+}
+
+int gxccd_set_preflash(camera_t *, double, int)
+{
+    return 0;
+}
+
+int gxccd_start_exposure(camera_t *camera, double exp_time, bool, int, int, int w, int h)
+{
+    camera->frameW   = w;
+    camera->frameH   = h;
+    camera->exposing = true;
+    camera->ready    = std::chrono::steady_clock::now() +
+                       std::chrono::microseconds(static_cast<int64_t>(exp_time * 1000000) + camera->digitize * 1000);
+    return 0;
+}
+
+int gxccd_abort_exposure(camera_t *camera, bool)
+{
+    camera->exposing = false;
+    return 0;
+}
+
+int gxccd_image_ready(camera_t *camera, bool *ready)
+{
+    camera->readyPolls++;
+    if (!camera->exposing)
+        return fail(camera, "No exposure in progress");
+    *ready = std::chrono::steady_clock::now() >= camera->ready;
+    return 0;
+}
+
+int gxccd_read_image(camera_t *camera, void *buf, size_t size)
+{
+    size_t length = static_cast<size_t>(camera->frameW) * camera->frameH * 2;
+    if (!camera->exposing)
+        return fail(camera, "No image to read");
+    if (size < length)
+        return fail(camera, "Buffer too small");
+
+    // horizontal gradient growing with the line number, so that a wrong flip is visible
+    uint16_t *pixels = static_cast<uint16_t *>(buf);
+    for (int y = 0; y < camera->frameH; y++)
+        for (int x = 0; x < camera->frameW; x++)
+            *pixels++ = static_cast<uint16_t>(y * 16 + x);
+
+    std::this_thread::sleep_for(SDKMock::transferTime(length, camera->bandwidth));
+    camera->exposing = false;
+    camera->downloads++;
+    return 0;
+}
+
+int gxccd_enumerate_read_modes(camera_t *camera, int index, char *buf, size_t size)
+{
+    if (index != 0)
+        return fail(camera, "Unknown read mode");
+    snprintf(buf, size, "Normal");
+    return 0;
+}
+
+int gxccd_set_read_mode(camera_t *, int)
+{
+    return 0;
+}
+
+int gxccd_set_gain(camera_t *, uint16_t)
+{
+    return 0;
+}
+
+int gxccd_set_filter(camera_t *camera, int)
+{
+    return fail(camera, "No filter wheel");
+}
+
+int gxccd_set_fan(camera_t *, uint8_t)
+{
+    return 0;
+}
+
+int gxccd_set_window_heating(camera_t *, uint8_t)
+{
+    return 0;
+}
+
+int gxccd_move_telescope(camera_t *, int16_t, int16_t)
+{
+    return 0;
+}
+
+void gxccd_get_last_error(camera_t *camera, char *buf, size_t size)
+{
+    snprintf(buf, size, "%s", camera->error);
+}
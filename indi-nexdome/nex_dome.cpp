@@ -32,9 +32,15 @@
 #include <string.h>
 #include <memory>
 #include <regex>
+#include <unordered_map>
+#include <algorithm>
 #include <termios.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/select.h>
 
 #include <indicom.h>
+#include <eventloop.h>
 #include <cmath>
 
 #include "config.h"
@@ -54,6 +60,11 @@ NexDome::NexDome()
                       DOME_CAN_SYNC);
 }
 
+NexDome::~NexDome()
+{
+    stopReader();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
@@ -163,6 +174,8 @@ bool NexDome::Handshake()
     std::string value;
     bool rotatorOK = false;
 
+    startReader();
+
     if (getParameter(ND::SEMANTIC_VERSION, ND::ROTATOR, value))
     {
         LOGF_INFO("Detected rotator firmware version %s", value.c_str());
@@ -196,9 +209,22 @@ bool NexDome::Handshake()
     else
         LOG_WARN("No shutter detected.");
 
+    if (!rotatorOK)
+        stopReader();
+
     return rotatorOK;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+bool NexDome::Disconnect()
+{
+    // Reader must be gone before the port is closed.
+    stopReader();
+    return INDI::Dome::Disconnect();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
@@ -591,17 +617,22 @@ bool NexDome::Sync(double az)
 ///////////////////////////////////////////////////////////////////////////////
 void NexDome::TimerHit()
 {
-    std::string response;
-
-    if (checkEvents(response))
-        processEvent(response);
-
+    // Events are processed by eventsReady() as they arrive, the timer only polls.
     if (getDomeState() == DOME_MOVING || getDomeState() == DOME_PARKING)
     {
-        std::string value;
-        if (getParameter(ND::REPORT, ND::ROTATOR, value))
-            processEvent(value);
+        // The firmware streams reports while rotating. Only ask for one if none arrived
+        // lately, otherwise extrapolate the azimuth until the next report comes in.
+        if (!m_RotatorReported || std::chrono::steady_clock::now() - m_LastRotatorTime > std::chrono::seconds(1))
+        {
+            std::string value;
+            if (getParameter(ND::REPORT, ND::ROTATOR, value))
+                processEvent(value);
+        }
+        else
+            extrapolateAzimuth();
     }
+    else
+        m_RotatorVelocity = 0;
 
     if (HasShutter() && getShutterState() == SHUTTER_MOVING)
     {
@@ -877,8 +908,9 @@ bool NexDome::setParameter(ND::Commands command, ND::Targets target, int32_t val
         cmd << value;
     }
 
-    char res[ND::DRIVER_LEN] = {0};
-    return sendCommand(cmd.str().c_str(), res);
+    // Wait for the firmware to echo the command back, e.g. GSR for @GSR,1000
+    std::string echo = cmd.str().substr(1, cmd.str().find(',') - 1);
+    return sendCommand(cmd.str().c_str(), echo);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -916,9 +948,6 @@ bool NexDome::executeFactoryCommand(uint8_t command, ND::Targets target)
 //////////////////////////////////////////////////////////////////////////////
 bool NexDome::getParameter(ND::Commands command, ND::Targets target, std::string &value)
 {
-    char res[ND::DRIVER_LEN] = {0};
-    bool response_found = false;
-
     std::string verb = ND::CommandsMap.at(command) + "R";
 
     std::ostringstream cmd;
@@ -929,213 +958,216 @@ bool NexDome::getParameter(ND::Commands command, ND::Targets target, std::string
     // Target (Rotator or Shutter)
     cmd << ((target == ND::ROTATOR) ? "R" : "S");
 
-    if (sendCommand(cmd.str().c_str(), res))
-    {
-        std::string response(res);
-
-        // Since we can get many unrelated responses from the firmware
-        // i.e. events, we need to parse all responses, and see which
-        // one is related to our get command.
-        std::vector<std::string> all = split(response, "\r\n");
-
-        // Let's find our match using this regex
-        std::regex re;
-
-        // Firmware is exception since the response does not include the target
-        // for everything else, the echo back includes the target.
-        if (command != ND::SEMANTIC_VERSION)
-            re = (verb + ((target == ND::ROTATOR) ? "R" : "S") + "([^#]+)");
-        else
-            re = (verb + "([^#]+)");
+    // Firmware is exception since the response does not include the target
+    // for everything else, the echo back includes the target.
+    // Unrelated output received meanwhile, i.e. events, stays queued for TimerHit.
+    std::string echo = (command != ND::SEMANTIC_VERSION) ? cmd.str().substr(1) : verb;
+    std::string response;
 
-        std::smatch match;
+    if (!sendCommand(cmd.str().c_str(), echo, &response) || response.empty())
+        return false;
 
-        // Not iterate over all responses
-        for (auto &oneEvent : all)
-        {
-            std::string trimmedEvent = trim(oneEvent);
+    value = response;
+    return true;
+}
 
-            // If we find the match, tag it.
-            if (std::regex_search(trimmedEvent, match, re))
-            {
-                value = match.str(1);
-                response_found = true;
-            }
-            // Otherwise process the event
-            else
-                processEvent(trimmedEvent);
-        }
-    }
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+bool NexDome::matchToken(const std::string &message, const std::string &token, std::string &value)
+{
+    // Equivalent to searching for token([^#]+), messages never contain the stop char.
+    size_t pos = message.find(token);
+    if (pos == std::string::npos || pos + token.size() >= message.size())
+        return false;
 
-    return response_found;
+    value = message.substr(pos + token.size());
+    return true;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
-bool NexDome::checkEvents(std::string &response)
+bool NexDome::findEvent(const std::string &message, ND::Events &event, std::string &value)
 {
-    int nbytes_read = 0;
-    char res[ND::DRIVER_LEN] = {0};
+    static const std::unordered_map<std::string, ND::Events> tokens = []()
+    {
+        std::unordered_map<std::string, ND::Events> map;
+        for (const auto &kv : ND::EventsMap)
+            map.emplace(kv.second, kv.first);
+        return map;
+    }();
+    static const size_t longestToken = std::max_element(ND::EventsMap.begin(), ND::EventsMap.end(),
+                                       [](const auto & a, const auto & b)
+    {
+        return a.second.size() < b.second.size();
+    })->second.size();
 
-    int rc = tty_nread_section(PortFD, res, ND::DRIVER_LEN, ND::DRIVER_EVENT_CHAR, ND::DRIVER_EVENT_TIMEOUT, &nbytes_read);
+    // Events start with their token, look up the longest one the message starts with.
+    size_t start = (!message.empty() && message[0] == ':') ? 1 : 0;
+    for (size_t length = std::min(longestToken, message.size() - start); length > 0; length--)
+    {
+        auto token = tokens.find(message.substr(start, length));
+        if (token == tokens.end())
+            continue;
 
-    if (rc != TTY_OK || nbytes_read < 3)
-        return false;
+        event = token->second;
+        value = (start + length < message.size()) ? message.substr(start + length) : message;
+        return true;
+    }
 
-    std::string raw_response = res;
+    // Replies handed over by getParameter() may carry the token further in.
+    for (const auto &kv : ND::EventsMap)
+    {
+        if (message == kv.second)
+            value = message;
+        else if (!matchToken(message, kv.second, value))
+            continue;
 
-    // Trim
-    response = trim(raw_response);
+        event = kv.first;
+        return true;
+    }
 
-    return true;
+    return false;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
-bool NexDome::processEvent(const std::string &event)
+bool NexDome::processEvent(const std::string &event, std::chrono::steady_clock::time_point received)
 {
-    for (const auto &kv : ND::EventsMap)
-    {
-        std::regex re(kv.second + "([^#]+)");
-        std::smatch match;
-        std::string value;
+    ND::Events type;
+    std::string value;
+    if (!findEvent(event, type, value))
+        return false;
 
-        if (event == kv.second)
-            value = event;
-        else if (std::regex_search(event, match, re))
-            value = match.str(1);
-        else
-            continue;
+    LOGF_DEBUG("Processing event <%s> with value <%s>", event.c_str(), value.c_str());
 
-        LOGF_DEBUG("Processing event <%s> with value <%s>", event.c_str(), value.c_str());
+    switch (type)
+    {
+        case ND::XBEE_STATE:
+            if (!m_ShutterConnected && value == "Online")
+            {
+                m_ShutterConnected = true;
+                LOG_INFO("Shutter is connected.");
+            }
+            else if (m_ShutterConnected && value != "Online")
+            {
+                m_ShutterConnected = false;
+                LOG_WARN("Lost connection to the shutter!");
+            }
+            return true;
 
-        switch (kv.first)
+        case ND::ROTATOR_POSITION:
         {
-            case ND::XBEE_STATE:
-                if (!m_ShutterConnected && value == "Online")
-                {
-                    m_ShutterConnected = true;
-                    LOG_INFO("Shutter is connected.");
-                }
-                else if (m_ShutterConnected && value != "Online")
-                {
-                    m_ShutterConnected = false;
-                    LOG_WARN("Lost connection to the shutter!");
-                }
-                return true;
-
-            case ND::ROTATOR_POSITION:
+            try
             {
-                try
-                {
-                    // 153 = full_steps_circumference / 360 = 55080 / 360
-                    double newAngle = range360(std::stoi(value) / StepsPerDegree);
-                    if (std::abs(DomeAbsPosNP[0].getValue() - newAngle) > 0.001)
-                    {
-                        DomeAbsPosNP[0].setValue(newAngle);
-                        DomeAbsPosNP.apply();
-                    }
-                }
-                catch (...)
+                // 153 = full_steps_circumference / 360 = 55080 / 360
+                double newAngle = range360(std::stoi(value) / StepsPerDegree);
+                noteRotatorPosition(newAngle, received);
+                if (std::abs(DomeAbsPosNP[0].getValue() - newAngle) > 0.001)
                 {
-                    return false;
+                    DomeAbsPosNP[0].setValue(newAngle);
+                    DomeAbsPosNP.apply();
                 }
             }
-            return true;
+            catch (...)
+            {
+                return false;
+            }
+        }
+        return true;
 
-            case ND::SHUTTER_POSITION:
+        case ND::SHUTTER_POSITION:
+        {
+            try
             {
-                try
+                int32_t position = std::stoi(value);
+                if (std::abs(position - ShutterSyncNP[0].getValue()) > 0)
                 {
-                    int32_t position = std::stoi(value);
-                    if (std::abs(position - ShutterSyncNP[0].getValue()) > 0)
-                    {
-                        ShutterSyncNP[0].setValue(position);
-                        ShutterSyncNP.apply();
-                    }
-                }
-                catch (...)
-                {
-                    return false;
+                    ShutterSyncNP[0].setValue(position);
+                    ShutterSyncNP.apply();
                 }
             }
-            return true;
+            catch (...)
+            {
+                return false;
+            }
+        }
+        return true;
 
-            case ND::ROTATOR_REPORT:
-                return processRotatorReport(value);
+        case ND::ROTATOR_REPORT:
+            return processRotatorReport(value, received);
 
-            case ND::SHUTTER_REPORT:
-                return processShutterReport(value);
+        case ND::SHUTTER_REPORT:
+            return processShutterReport(value);
 
-            case ND::ROTATOR_LEFT:
-            case ND::ROTATOR_RIGHT:
-                if (getDomeState() != DOME_MOVING && getDomeState() != DOME_PARKING)
-                {
-                    setDomeState(DOME_MOVING);
-                    LOGF_INFO("Dome is rotating %s.", ((kv.first == ND::ROTATOR_LEFT) ? "counter-clock wise" : "clock-wise"));
-                }
-                return true;
+        case ND::ROTATOR_LEFT:
+        case ND::ROTATOR_RIGHT:
+            if (getDomeState() != DOME_MOVING && getDomeState() != DOME_PARKING)
+            {
+                setDomeState(DOME_MOVING);
+                LOGF_INFO("Dome is rotating %s.", ((type == ND::ROTATOR_LEFT) ? "counter-clock wise" : "clock-wise"));
+            }
+            return true;
 
-            case ND::ROTATOR_STOPPED:
-                if (getDomeState() == DOME_MOVING)
-                {
-                    LOG_INFO("Dome reached target position.");
-                    setDomeState(DOME_SYNCED);
-                }
-                else if (getDomeState() == DOME_PARKING)
-                {
-                    LOG_INFO("Dome is parked.");
-                    setDomeState(DOME_PARKED);
-                }
-                else
-                    setDomeState(DOME_IDLE);
-                return true;
+        case ND::ROTATOR_STOPPED:
+            if (getDomeState() == DOME_MOVING)
+            {
+                LOG_INFO("Dome reached target position.");
+                setDomeState(DOME_SYNCED);
+            }
+            else if (getDomeState() == DOME_PARKING)
+            {
+                LOG_INFO("Dome is parked.");
+                setDomeState(DOME_PARKED);
+            }
+            else
+                setDomeState(DOME_IDLE);
+            return true;
 
-            case ND::SHUTTER_OPENING:
-                if (getShutterState() != SHUTTER_MOVING)
-                {
-                    setShutterState(SHUTTER_MOVING);
-                    LOG_INFO("Shutter is opening...");
-                    break;
-                }
-                return true;
+        case ND::SHUTTER_OPENING:
+            if (getShutterState() != SHUTTER_MOVING)
+            {
+                setShutterState(SHUTTER_MOVING);
+                LOG_INFO("Shutter is opening...");
+                break;
+            }
+            return true;
 
-            case ND::SHUTTER_CLOSING:
-                if (getShutterState() != SHUTTER_MOVING)
-                {
-                    setShutterState(SHUTTER_MOVING);
-                    LOG_INFO("Shutter is closing...");
-                    break;
-                }
-                return true;
+        case ND::SHUTTER_CLOSING:
+            if (getShutterState() != SHUTTER_MOVING)
+            {
+                setShutterState(SHUTTER_MOVING);
+                LOG_INFO("Shutter is closing...");
+                break;
+            }
+            return true;
 
-            case ND::SHUTTER_BATTERY:
+        case ND::SHUTTER_BATTERY:
+        {
+            try
             {
-                try
+                uint32_t battery_adu = std::stoul(value);
+                double vref = battery_adu * ND::ADU_TO_VREF;
+                if (std::fabs(vref - ShutterBatteryLevelNP[0].getValue()) > 0.01)
                 {
-                    uint32_t battery_adu = std::stoul(value);
-                    double vref = battery_adu * ND::ADU_TO_VREF;
-                    if (std::fabs(vref - ShutterBatteryLevelNP[0].getValue()) > 0.01)
-                    {
-                        ShutterBatteryLevelNP[0].setValue(vref);
-                        // TODO: Must check if batter is OK, warning, or in critical level
-                        ShutterBatteryLevelNP.setState(IPS_OK);
-                        ShutterBatteryLevelNP.apply();
-                    }
-                }
-                catch(...)
-                {
-                    return false;
+                    ShutterBatteryLevelNP[0].setValue(vref);
+                    // TODO: Must check if batter is OK, warning, or in critical level
+                    ShutterBatteryLevelNP.setState(IPS_OK);
+                    ShutterBatteryLevelNP.apply();
                 }
             }
-            break;
-
-            default:
-                LOGF_DEBUG("Unhandled event: %s", value.c_str());
-                break;
+            catch(...)
+            {
+                return false;
+            }
         }
+        break;
+
+        default:
+            LOGF_DEBUG("Unhandled event: %s", value.c_str());
+            break;
     }
 
     return false;
@@ -1144,9 +1176,9 @@ bool NexDome::processEvent(const std::string &event)
 //////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////
-bool NexDome::processRotatorReport(const std::string &report)
+bool NexDome::processRotatorReport(const std::string &report, std::chrono::steady_clock::time_point received)
 {
-    std::regex re(R"((\d+),(\d+),(\d+),(\d+),(\d+))");
+    static const std::regex re(R"((\d+),(\d+),(\d+),(\d+),(\d+))");
     std::smatch match;
     if (std::regex_search(report, match, re))
     {
@@ -1169,6 +1201,7 @@ bool NexDome::processRotatorReport(const std::string &report)
             }
 
             double posAngle = range360(position / StepsPerDegree);
+            noteRotatorPosition(posAngle, received);
             if (std::fabs(posAngle - DomeAbsPosNP[0].getValue()) > 0.01)
             {
                 DomeAbsPosNP[0].setValue(posAngle);
@@ -1249,7 +1282,7 @@ bool NexDome::processRotatorReport(const std::string &report)
 //////////////////////////////////////////////////////////////////////
 bool NexDome::processShutterReport(const std::string &report)
 {
-    std::regex re(R"((-?\d+),(\d+),(\d+),(\d+))");
+    static const std::regex re(R"((-?\d+),(\d+),(\d+),(\d+))");
     std::smatch match;
     if (std::regex_search(report, match, re))
     {
@@ -1302,27 +1335,22 @@ bool NexDome::processShutterReport(const std::string &report)
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
-bool NexDome::sendCommand(const char * cmd, char * res, int cmd_len, int res_len)
+bool NexDome::sendCommand(const char * cmd, const std::string &echo, std::string * value)
 {
-    int nbytes_written = 0, nbytes_read = 0, rc = -1;
+    int nbytes_written = 0, rc = -1;
+    uint64_t sentAfter = 0;
 
-    tcflush(PortFD, TCIOFLUSH);
-
-    if (cmd_len > 0)
-    {
-        char hex_cmd[ND::DRIVER_LEN * 3] = {0};
-        hexDump(hex_cmd, cmd, cmd_len);
-        LOGF_DEBUG("CMD <%s>", hex_cmd);
-        rc = tty_write(PortFD, cmd, cmd_len, &nbytes_written);
-    }
-    else
     {
-        LOGF_DEBUG("CMD <%s>", cmd);
-        char cmd_terminated[ND::DRIVER_LEN * 2] = {0};
-        snprintf(cmd_terminated, ND::DRIVER_LEN * 2, "%s\r\n", cmd);
-        rc = tty_write_string(PortFD, cmd_terminated, &nbytes_written);
+        // Replies queued before the command was sent cannot be ours.
+        std::lock_guard<std::mutex> lock(m_MessageMutex);
+        sentAfter = m_MessageCounter;
     }
 
+    LOGF_DEBUG("CMD <%s>", cmd);
+    char cmd_terminated[ND::DRIVER_LEN * 2] = {0};
+    snprintf(cmd_terminated, ND::DRIVER_LEN * 2, "%s\r\n", cmd);
+    rc = tty_write_string(PortFD, cmd_terminated, &nbytes_written);
+
     if (rc != TTY_OK)
     {
         char errstr[MAXRBUF] = {0};
@@ -1331,62 +1359,245 @@ bool NexDome::sendCommand(const char * cmd, char * res, int cmd_len, int res_len
         return false;
     }
 
-    if (res == nullptr)
+    if (echo.empty())
         return true;
 
-    if (res_len > 0)
-        rc = tty_read(PortFD, res, res_len, ND::DRIVER_TIMEOUT, &nbytes_read);
-    else
-        rc = tty_nread_section(PortFD, res, ND::DRIVER_LEN, ND::DRIVER_STOP_CHAR, ND::DRIVER_TIMEOUT, &nbytes_read);
+    // The reader thread queues all output, wait until the echo of our command shows up.
+    std::unique_lock<std::mutex> lock(m_MessageMutex);
+    auto findReply = [&]()
+    {
+        for (auto it = m_Messages.begin(); it != m_Messages.end(); ++it)
+        {
+            size_t pos = it->text.find(echo);
+            if (it->id <= sentAfter || pos == std::string::npos)
+                continue;
 
-    if (rc != TTY_OK)
+            if (value)
+                *value = it->text.substr(pos + echo.size());
+            m_Messages.erase(it);
+            return true;
+        }
+        return false;
+    };
+
+    if (!m_MessageCV.wait_for(lock, std::chrono::seconds(ND::DRIVER_TIMEOUT), findReply))
     {
-        char errstr[MAXRBUF] = {0};
-        tty_error_msg(rc, errstr, MAXRBUF);
-        LOGF_ERROR("Serial read error: %s.", errstr);
+        LOGF_ERROR("Serial read error: timeout waiting for %s.", echo.c_str());
         return false;
     }
 
-    if (res_len > 0)
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::startReader()
+{
+    if (m_ReaderRunning)
+        return;
+
+    tcflush(PortFD, TCIOFLUSH);
+    {
+        std::lock_guard<std::mutex> lock(m_MessageMutex);
+        m_Messages.clear();
+    }
+    m_RotatorReported = false;
+    m_RotatorVelocity = 0;
+
+    // The reader wakes up the main loop through this pipe whenever it queued messages.
+    if (pipe(m_EventPipe) != 0)
     {
-        char hex_res[ND::DRIVER_LEN * 3] = {0};
-        hexDump(hex_res, res, res_len);
-        LOGF_DEBUG("RES <%s>", hex_res);
+        LOGF_ERROR("Failed to create the event pipe. %s.", strerror(errno));
+        m_EventPipe[0] = m_EventPipe[1] = -1;
     }
     else
     {
-        res[nbytes_read - 1] = 0;
-        LOGF_DEBUG("RES <%s>", res);
+        fcntl(m_EventPipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(m_EventPipe[1], F_SETFL, O_NONBLOCK);
+        m_EventCallbackID = IEAddCallback(m_EventPipe[0], eventsReadyHelper, this);
     }
 
-    tcflush(PortFD, TCIOFLUSH);
+    m_ReaderRunning = true;
+    m_ReaderThread = std::thread(&NexDome::readerLoop, this);
+}
 
-    return true;
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::stopReader()
+{
+    m_ReaderRunning = false;
+    if (m_ReaderThread.joinable())
+        m_ReaderThread.join();
+
+    if (m_EventCallbackID >= 0)
+    {
+        IERmCallback(m_EventCallbackID);
+        m_EventCallbackID = -1;
+    }
+    for (int &fd : m_EventPipe)
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
 }
 
 //////////////////////////////////////////////////////////////////////////////
 ///
 //////////////////////////////////////////////////////////////////////////////
-void NexDome::hexDump(char * buf, const char * data, int size)
+void NexDome::readerLoop()
 {
-    for (int i = 0; i < size; i++)
-        sprintf(buf + 3 * i, "%02X ", static_cast<uint8_t>(data[i]));
+    char buffer[ND::DRIVER_LEN];
+    std::string partial;
+    const char wakeUp = 0;
 
-    if (size > 0)
-        buf[3 * size - 1] = '\0';
+    while (m_ReaderRunning)
+    {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(PortFD, &readfds);
+        struct timeval tv = {0, 50000};
+
+        // Wake up regularly to check whether we should stop.
+        int rc = select(PortFD + 1, &readfds, nullptr, nullptr, &tv);
+        if (rc == 0)
+            continue;
+
+        ssize_t nbytes_read = (rc > 0) ? read(PortFD, buffer, sizeof(buffer)) : -1;
+        if (nbytes_read <= 0)
+        {
+            usleep(50000);
+            continue;
+        }
+
+        // Replies end with the stop char, events with a new line. Split on both so every
+        // message is queued on its own, stamped with the time it was read.
+        auto received = std::chrono::steady_clock::now();
+        bool queued = false;
+        for (ssize_t i = 0; i < nbytes_read; i++)
+        {
+            if (buffer[i] != ND::DRIVER_STOP_CHAR && buffer[i] != ND::DRIVER_EVENT_CHAR)
+            {
+                if (partial.size() < ND::DRIVER_LEN)
+                    partial += buffer[i];
+                continue;
+            }
+
+            trim(partial);
+            if (!partial.empty())
+            {
+                LOGF_DEBUG("RES <%s>", partial.c_str());
+                std::lock_guard<std::mutex> lock(m_MessageMutex);
+                m_Messages.push_back({++m_MessageCounter, received, partial});
+                // Nobody is consuming the queue, keep the newest messages only.
+                if (m_Messages.size() > ND::DRIVER_LEN)
+                    m_Messages.pop_front();
+                queued = true;
+            }
+            partial.clear();
+        }
+
+        if (queued)
+        {
+            m_MessageCV.notify_all();
+            // A full pipe already has a wake up pending.
+            if (m_EventPipe[1] >= 0 && write(m_EventPipe[1], &wakeUp, 1) != 1 && errno != EAGAIN)
+                LOGF_DEBUG("Failed to signal events. %s.", strerror(errno));
+        }
+    }
 }
 
-//////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 ///
-//////////////////////////////////////////////////////////////////////
-std::vector<std::string> NexDome::split(const std::string &input, const std::string &regex)
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::eventsReadyHelper(int fd, void *context)
 {
-    // passing -1 as the submatch index parameter performs splitting
-    std::regex re(regex);
-    std::sregex_token_iterator
-    first{input.begin(), input.end(), re, -1},
-          last;
-    return {first, last};
+    INDI_UNUSED(fd);
+    static_cast<NexDome *>(context)->eventsReady();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// Processes the events queued by the reader on the main loop, each with the
+/// time it arrived. Command replies have been taken out by sendCommand() already.
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::eventsReady()
+{
+    char drain[64];
+    while (read(m_EventPipe[0], drain, sizeof(drain)) > 0)
+        ;
+
+    std::deque<Message> messages;
+    {
+        std::lock_guard<std::mutex> lock(m_MessageMutex);
+        messages.swap(m_Messages);
+    }
+    for (const auto &oneMessage : messages)
+        processEvent(oneMessage.text, oneMessage.received);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::noteRotatorPosition(double angle, std::chrono::steady_clock::time_point received)
+{
+    if (m_RotatorReported)
+    {
+        // A reply fetched by a command can be processed after newer events.
+        if (received < m_LastRotatorTime)
+            return;
+
+        double dt = std::chrono::duration<double>(received - m_LastRotatorTime).count();
+        // Reports closer than 10ms apart keep the current rate.
+        if (dt >= 0.01 && dt < 2)
+        {
+            double diff = angle - m_LastRotatorAngle;
+            if (diff > 180)
+                diff -= 360;
+            else if (diff < -180)
+                diff += 360;
+            m_RotatorVelocity = diff / dt;
+        }
+        else if (dt >= 2)
+            m_RotatorVelocity = 0;
+    }
+
+    m_LastRotatorAngle = angle;
+    m_LastRotatorTime = received;
+    m_RotatorReported = true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+///
+//////////////////////////////////////////////////////////////////////////////
+void NexDome::extrapolateAzimuth()
+{
+    if (!m_RotatorReported || m_RotatorVelocity == 0)
+        return;
+
+    double age = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_LastRotatorTime).count();
+    // Fresh enough already, or too old to trust the rate.
+    if (age < 0.05 || age > 1)
+        return;
+
+    double travel = m_RotatorVelocity * age;
+
+    // Never run past the target.
+    double remaining = range360(m_TargetAZSteps / StepsPerDegree) - m_LastRotatorAngle;
+    if (remaining > 180)
+        remaining -= 360;
+    else if (remaining < -180)
+        remaining += 360;
+    if (travel * remaining > 0 && std::fabs(travel) > std::fabs(remaining))
+        travel = remaining;
+
+    double predicted = range360(m_LastRotatorAngle + travel);
+    if (std::fabs(predicted - DomeAbsPosNP[0].getValue()) > 0.01)
+    {
+        DomeAbsPosNP[0].setValue(predicted);
+        DomeAbsPosNP.apply();
+    }
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -29,8 +29,14 @@
 #include <indidome.h>
 
 #include <math.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <sys/time.h>
 
 #include "nex_dome_constants.h"
@@ -39,6 +45,7 @@ class NexDome : public INDI::Dome
 {
     public:
         NexDome();
+        virtual ~NexDome() override;
 
         virtual bool ISNewSwitch(const char *dev, const char *name, ISState *states, char *names[], int n) override;
         virtual bool ISNewNumber(const char *dev, const char *name, double values[], char *names[], int n) override;
@@ -50,6 +57,7 @@ class NexDome : public INDI::Dome
 
     protected:
         bool Handshake() override;
+        virtual bool Disconnect() override;
         void TimerHit() override;
 
         // Motion
@@ -127,7 +135,7 @@ class NexDome : public INDI::Dome
         /// Settings
         ///////////////////////////////////////////////////////////////////////////////
         bool executeFactoryCommand(uint8_t command, ND::Targets target);
-        bool processRotatorReport(const std::string &report);
+        bool processRotatorReport(const std::string &report, std::chrono::steady_clock::time_point received);
         bool processShutterReport(const std::string &report);
 
         ///////////////////////////////////////////////////////////////////////////////
@@ -135,15 +143,26 @@ class NexDome : public INDI::Dome
         ///////////////////////////////////////////////////////////////////////////////
         bool setParameter(ND::Commands command, ND::Targets target, int32_t value = -1e6);
         bool getParameter(ND::Commands command, ND::Targets target, std::string &value);
-        bool checkEvents(std::string &response);
-        bool processEvent(const std::string &event);
-        bool sendCommand(const char * cmd, char * res = nullptr, int cmd_len = -1, int res_len = -1);
-        void hexDump(char * buf, const char * data, int size);
+        bool processEvent(const std::string &event,
+                          std::chrono::steady_clock::time_point received = std::chrono::steady_clock::now());
+        bool findEvent(const std::string &message, ND::Events &event, std::string &value);
+        bool matchToken(const std::string &message, const std::string &token, std::string &value);
+        bool sendCommand(const char * cmd, const std::string &echo = "", std::string * value = nullptr);
 
         std::string &ltrim(std::string &str, const std::string &chars = "\t\n\v\f\r ");
         std::string &rtrim(std::string &str, const std::string &chars = "\t\n\v\f\r ");
         std::string &trim(std::string &str, const std::string &chars = "\t\n\v\f\r ");
-        std::vector<std::string> split(const std::string &input, const std::string &regex);
+
+        ///////////////////////////////////////////////////////////////////////////////
+        /// Serial Reader
+        ///////////////////////////////////////////////////////////////////////////////
+        void startReader();
+        void stopReader();
+        void readerLoop();
+        static void eventsReadyHelper(int fd, void *context);
+        void eventsReady();
+        void noteRotatorPosition(double angle, std::chrono::steady_clock::time_point received);
+        void extrapolateAzimuth();
 
         ///////////////////////////////////////////////////////////////////////////////
         /// Private Members
@@ -152,5 +171,31 @@ class NexDome : public INDI::Dome
         int32_t m_TargetAZSteps {1000000};
         double StepsPerDegree { 153.0 };
 
+        // Firmware output as read by the reader thread, stamped with the time it arrived.
+        struct Message
+        {
+            uint64_t id;
+            std::chrono::steady_clock::time_point received;
+            std::string text;
+        };
+
+        // All firmware output is read by the reader thread and queued here. Command replies
+        // are taken out by sendCommand(), everything else is processed as events by eventsReady(),
+        // which the reader wakes up on the main loop through m_EventPipe.
+        std::thread m_ReaderThread;
+        std::atomic<bool> m_ReaderRunning { false };
+        std::mutex m_MessageMutex;
+        std::condition_variable m_MessageCV;
+        std::deque<Message> m_Messages;
+        uint64_t m_MessageCounter { 0 };
+        int m_EventPipe[2] { -1, -1 };
+        int m_EventCallbackID { -1 };
+
+        // Last reported rotator position and its rate, used to extrapolate the azimuth between reports.
+        bool m_RotatorReported { false };
+        double m_LastRotatorAngle { 0 };
+        double m_RotatorVelocity { 0 };
+        std::chrono::steady_clock::time_point m_LastRotatorTime;
+
 };
 
@@ -38,6 +38,8 @@ USB and network connections supported.
 #include "ocs.h"
 #include "termios.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <ctime>
 #include <memory>
@@ -65,7 +67,7 @@ OCS::OCS() : INDI::Dome(), WI(this)
     // kill(getpid(), SIGSTOP);
     // Debug only end
 
-    setVersion(1, 4);
+    setVersion(1, 5);
     SetDomeCapability(DOME_CAN_ABORT | DOME_HAS_SHUTTER);
     SlowTimer.callOnTimeout(std::bind(&OCS::SlowTimerHit, this));
 }
@@ -600,6 +602,18 @@ bool OCS::initProperties()
                        MANUAL_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
     IUFillSwitch(&Watchdog_ResetS[0], "Watchdog Reset", "REBOOT", ISS_OFF);
 
+    // Serial transaction trace, replay it with ocs_replay
+    IUFillSwitch(&SerialTraceS[INDI_ENABLED], "INDI_ENABLED", "Record", ISS_OFF);
+    IUFillSwitch(&SerialTraceS[INDI_DISABLED], "INDI_DISABLED", "Off", ISS_ON);
+    IUFillSwitchVector(&SerialTraceSP, SerialTraceS, 2, getDeviceName(), "SERIAL_TRACE", "Serial Trace",
+                       OPTIONS_TAB, IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+    IUFillText(&SerialTraceFileT[0], "FILE", "File", "/tmp/indi_ocs.trace");
+    IUFillTextVector(&SerialTraceFileTP, SerialTraceFileT, 1, getDeviceName(), "SERIAL_TRACE_FILE", "Trace File",
+                     OPTIONS_TAB, IP_RW, 60, IPS_IDLE);
+    IUFillText(&SerialLatencyT[0], "REPORT", "Latency", "");
+    IUFillTextVector(&SerialLatencyTP, SerialLatencyT, 1, getDeviceName(), "SERIAL_LATENCY", "Serial Latency",
+                     INFO_TAB, IP_RO, 60, IPS_IDLE);
+
     // Debug only
     // IUFillTextVector(&Arbitary_CommandTP, Arbitary_CommandT, 1, getDeviceName(), "ARBITARY_COMMAND", "Command",
     //                  MANUAL_TAB, IP_RW, 60, IPS_IDLE);
@@ -702,6 +716,9 @@ bool OCS::updateProperties()
         defineProperty(&Safety_Interlock_OverrideSP);
         defineProperty(&Roof_High_PowerSP);
         defineProperty(&Watchdog_ResetSP);
+        defineProperty(&SerialTraceSP);
+        defineProperty(&SerialTraceFileTP);
+        defineProperty(&SerialLatencyTP);
 
         // Debug only
         // defineProperty(&Arbitary_CommandTP);
@@ -783,6 +800,9 @@ bool OCS::updateProperties()
         deleteProperty(Safety_Interlock_OverrideSP.name);
         deleteProperty(Roof_High_PowerSP.name);
         deleteProperty(Watchdog_ResetSP.name);
+        deleteProperty(SerialTraceSP.name);
+        deleteProperty(SerialTraceFileTP.name);
+        deleteProperty(SerialLatencyTP.name);
 
         // Debug only
         // deleteProperty(Arbitary_CommandTP.name);
@@ -790,6 +810,9 @@ bool OCS::updateProperties()
 
         // As we're disconnected, stop calling one minute updates
         SlowTimer.stop();
+        // and poll everything on the next connection
+        relay_schedule.clear();
+        poll_schedule.clear();
     }
 
     return true;
@@ -800,10 +823,15 @@ bool OCS::updateProperties()
 *************************************************************/
 void OCS::TimerHit()
 {
-    // Get the roof/shutter status
-    char roof_status_response[RB_MAX_LEN] = {0};
-    int roof_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, roof_status_response,
-                                                                             OCS_get_roof_status);
+    // Get the roof/shutter status, and with a dome its status and position, in one pipelined exchange
+    enum { POLL_ROOF_STATUS, POLL_DOME_STATUS, POLL_DOME_AZIMUTH, POLL_COUNT };
+    const char poll_commands[POLL_COUNT][CMD_MAX_LEN] = { OCS_get_roof_status, OCS_get_dome_status, OCS_get_dome_azimuth };
+    char poll_responses[POLL_COUNT][RB_MAX_LEN] = {};
+    int poll_results[POLL_COUNT] = {0};
+    getCommandsPipelined(PortFD, hasDome ? POLL_COUNT : 1, poll_commands, poll_responses, poll_results);
+
+    char *roof_status_response = poll_responses[POLL_ROOF_STATUS];
+    int roof_status_error_or_fail = poll_results[POLL_ROOF_STATUS];
     if (roof_status_error_or_fail > 1) {
         bool roof_was_in_error = (getShutterState() == SHUTTER_ERROR);
 
@@ -861,17 +889,17 @@ void OCS::TimerHit()
             sprintf(last_shutter_status, "%s", roof_message);
         }
 
-        IUSaveText(&ShutterStatusT[0], roof_message);
-        IDSetText(&ShutterStatusTP, nullptr);
+        if (saveStatusText(&ShutterStatusT[0], roof_message)) {
+            IDSetText(&ShutterStatusTP, nullptr);
+        }
     }
 
     // Dome updates
     if (hasDome) {
         // Get the dome status
         char dome_message[10];
-        char dome_status_response[RB_MAX_LEN] = {0};
-        int dome_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, dome_status_response,
-                                                                                 OCS_get_dome_status);
+        char *dome_status_response = poll_responses[POLL_DOME_STATUS];
+        int dome_status_error_or_fail = poll_results[POLL_DOME_STATUS];
         if (dome_status_error_or_fail > 1) { //> 1 as an OCS error would be 1 char in response
             if (strcmp(dome_status_response, "H") == 0) {
                 if (getDomeState() != DOME_IDLE) {
@@ -919,29 +947,30 @@ void OCS::TimerHit()
                 }
                 sprintf(dome_message, "Idle");
             }
-            IUSaveText(&DomeStatusT[0], dome_message);
-            IDSetText(&DomeStatusTP, nullptr);
+            if (saveStatusText(&DomeStatusT[0], dome_message)) {
+                IDSetText(&DomeStatusTP, nullptr);
+            }
         } else {
             LOGF_WARN("Communication error on get Dome status %s, this update aborted, will try again...", OCS_get_dome_status);
             LOGF_WARN("Received %S", dome_status_response);
         }
 
         // Get the dome position
-        char dome_position_response[RB_MAX_LEN] = {0};
         double position = conversion_error ;
-        int dome_position_error_or_fail = getCommandDoubleResponse(PortFD, &position, dome_position_response,
-                                                                   OCS_get_dome_azimuth);
-        if (dome_position_error_or_fail > 1 && position != conversion_error) {
+        int dome_position_error_or_fail = poll_results[POLL_DOME_AZIMUTH];
+        if (dome_position_error_or_fail > 1 && sscanf(poll_responses[POLL_DOME_AZIMUTH], "%lf", &position) == 1) {
             // DomeAbsPosN->value = position;
-            DomeAbsPosNP[0].setValue(position);
-            DomeAbsPosNP.apply();
+            if (DomeAbsPosNP[0].getValue() != position) {
+                DomeAbsPosNP[0].setValue(position);
+                DomeAbsPosNP.apply();
+            }
         } else {
             LOGF_WARN("Communication error on get Dome position %s, this update aborted, will try again...", OCS_get_dome_azimuth);
-            LOGF_WARN("Received %d", position);
+            LOGF_WARN("Received %s", poll_responses[POLL_DOME_AZIMUTH]);
         }
     }
 
-    IDSetText(&Status_ItemsTP, nullptr);
+    updateSerialLatency();
 
     // Timer loop control
     if (!isConnected())
@@ -955,38 +984,66 @@ void OCS::TimerHit()
 ****************************************/
 void OCS::SlowTimerHit()
 {
-    // Status tab
-    char power_status_response[RB_MAX_LEN] = {0};
-    int power_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, power_status_response,
-                                                                              OCS_get_power_status);
-    if (power_status_error_or_fail > 1) {
-        IUSaveText(&Status_ItemsT[STATUS_MAINS], power_status_response);
-        IDSetText(&Status_ItemsTP, nullptr);
-    } else {
-        LOGF_WARN("Communication error on get Power Status %s, this update aborted, will try again...", OCS_get_power_status);
+    // Status tab, published once at the end and only if something changed
+    bool status_items_changed = false;
+
+    // Power and safety status are always # terminated, so the due ones are pipelined
+    struct {
+        const char *command;
+        int item;
+        const char *label;
+    } const status_polls[] = {
+        { OCS_get_power_status, STATUS_MAINS, "Power Status" },
+        { OCS_get_safety_status, STATUS_OCS_SAFETY, "OCS Safety Status" }
+    };
+    int const status_poll_count = sizeof(status_polls) / sizeof(status_polls[0]);
+    char poll_commands[status_poll_count][CMD_MAX_LEN];
+    char poll_responses[status_poll_count][RB_MAX_LEN] = {};
+    int poll_results[status_poll_count] = {0};
+    int poll_index[status_poll_count] = {0};
+    int poll_count = 0;
+    for (int poll = 0; poll < status_poll_count; poll++) {
+        if (poll_schedule[status_polls[poll].command].due()) {
+            indi_strlcpy(poll_commands[poll_count], status_polls[poll].command, CMD_MAX_LEN);
+            poll_index[poll_count++] = poll;
+        }
+    }
+    if (poll_count > 0) {
+        getCommandsPipelined(PortFD, poll_count, poll_commands, poll_responses, poll_results);
     }
 
-    char safety_status_response[RB_MAX_LEN] = {0};
-    int safety_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, safety_status_response,
-                                                                                     OCS_get_safety_status);
-    if (safety_status_error_or_fail > 1) {
-        IUSaveText(&Status_ItemsT[STATUS_OCS_SAFETY], safety_status_response);
-        IDSetText(&Status_ItemsTP, nullptr);
-    } else {
-        LOGF_WARN("Communication error on get OCS Safety Status %s, this update aborted, will try again...", OCS_get_safety_status);
+    for (int i = 0; i < poll_count; i++) {
+        auto const &status_poll = status_polls[poll_index[i]];
+        PollSchedule &schedule = poll_schedule[status_poll.command];
+        if (poll_results[i] > 1) {
+            bool changed = saveStatusText(&Status_ItemsT[status_poll.item], poll_responses[i]);
+            status_items_changed |= changed;
+            schedule.polled(changed);
+        } else {
+            LOGF_WARN("Communication error on get %s %s, this update aborted, will try again...", status_poll.label,
+                      status_poll.command);
+            schedule = PollSchedule();
+        }
     }
 
-    char MCU_temp_response[RB_MAX_LEN] = {0};
-    int MCU_temp_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, MCU_temp_response,
-                                                                                 OCS_get_MCU_temperature);
-    if (MCU_temp_status_error_or_fail > 1) {
-        IUSaveText(&Status_ItemsT[STATUS_MCU_TEMPERATURE], MCU_temp_response);
-        IDSetText(&Status_ItemsTP, nullptr);
-    } else {
-        LOGF_WARN("Communication error on get MCU temperature %s, this update aborted, will try again...", OCS_get_thermostat_status);
+    // An unsupported MCU temperature is an unterminated 0, so it is queried on its own
+    PollSchedule &MCU_temp_schedule = poll_schedule[OCS_get_MCU_temperature];
+    if (MCU_temp_schedule.due()) {
+        char MCU_temp_response[RB_MAX_LEN] = {0};
+        int MCU_temp_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, MCU_temp_response,
+                                                                                     OCS_get_MCU_temperature);
+        if (MCU_temp_status_error_or_fail > 1) {
+            bool changed = saveStatusText(&Status_ItemsT[STATUS_MCU_TEMPERATURE], MCU_temp_response);
+            status_items_changed |= changed;
+            MCU_temp_schedule.polled(changed);
+        } else {
+            LOGF_WARN("Communication error on get MCU temperature %s, this update aborted, will try again...", OCS_get_MCU_temperature);
+            MCU_temp_schedule = PollSchedule();
+        }
     }
 
     // Get the last roof error (if any)
+    // It sets the shutter error state, so unlike the other status items it is polled every cycle.
     // This is here because although the 1 second polled get roof status would return any error flagged
     // at the time it could miss a transient condition that has been cleared in-between poll periods.
     // Last roof error holds the condition until cleared by a shutter/roof action.
@@ -1136,267 +1193,234 @@ void OCS::SlowTimerHit()
                }
                LOG_WARN("Roof/shutter error - Timeout waiting for mount to park before closing");
         }
-        IUSaveText(&Status_ItemsT[STATUS_ROOF_LAST_ERROR], last_shutter_error);
+        status_items_changed |= saveStatusText(&Status_ItemsT[STATUS_ROOF_LAST_ERROR], last_shutter_error);
     } else if (roof_error_error_or_fail == 1) {
         LOGF_WARN("Communication error on get Roof/Shutter last error %s, this update aborted, will try again...", OCS_get_roof_last_error);
     }
 
+    if (status_items_changed) {
+        IDSetText(&Status_ItemsTP, nullptr);
+    }
+
+    // Relays of all tabs are polled together at the end, in pipelined batches
+    std::vector<RelayPoll> relays;
+
     // Thermostat tab
     if (thermostat_controls_enabled) {
-        // Get the Obsy Thermostat readings
-        char thermostat_status_response[RB_MAX_LEN] = {0};
-        int thermostat_status_error_or_fail  = getCommandSingleCharErrorOrLongResponse(PortFD, thermostat_status_response,
-                                                                                       OCS_get_thermostat_status);
-        if (thermostat_status_error_or_fail > 1) {
-            char *split;
-            split = strtok(thermostat_status_response, ",");
-            IUSaveText(&Thermostat_StatusT[THERMOSTAT_TEMERATURE], split);
-            split = strtok(NULL, ",");
-            IUSaveText(&Thermostat_StatusT[THERMOSTAT_HUMIDITY], split);
-            IDSetText(&Thermostat_StatusTP, nullptr);
-        } else {
-            LOGF_WARN("Communication error on get Thermostat Status %s, this update aborted, will try again...", OCS_get_thermostat_status);
-        }
-
-        // Get the Thermostat setpoints
-        if (thermostat_relays[THERMOSTAT_HEAT_RELAY] > 0) {
-            char heat_response[RB_MAX_LEN] = {0};
-            int heat_int_response = 0;
-            int heat_setpoint_error_or_fail = getCommandIntFromCharResponse(PortFD, heat_response, &heat_int_response,
-                                                                            OCS_get_thermostat_heat_setpoint);
-            if (heat_setpoint_error_or_fail >= 0 && heat_int_response != conversion_error) { // errors are negative
-                Thermostat_heat_setpointN[0].value = heat_int_response;
-            } else {
-                LOGF_WARN("Communication error on get Thermostat Heat Setpoint %d, this update aborted, will try again...", heat_int_response);
+        // Get the Obsy Thermostat readings and the setpoints of the defined relays that are due
+        // in one pipelined exchange
+        struct {
+            int relay;
+            const char *command;
+            INumber *number;
+            INumberVectorProperty *property;
+            const char *label;
+        } const setpoints[THERMOSTAT_SETPOINT_COUNT] = {
+            { THERMOSTAT_HEAT_RELAY, OCS_get_thermostat_heat_setpoint, Thermostat_heat_setpointN, &Thermostat_heat_setpointNP, "Heat" },
+            { THERMOSTAT_COOL_RELAY, OCS_get_thermostat_cool_setpoint, Thermostat_cool_setpointN, &Thermostat_cool_setpointNP, "Cool" },
+            { THERMOSTAT_HUMIDITY_RELAY, OCS_get_thermostat_humidity_setpoint, Thermostat_humidity_setpointN, &Thermostat_humidity_setpointNP, "Humidity" }
+        };
+        char thermostat_commands[THERMOSTAT_SETPOINT_COUNT + 1][CMD_MAX_LEN];
+        char thermostat_responses[THERMOSTAT_SETPOINT_COUNT + 1][RB_MAX_LEN] = {};
+        int thermostat_results[THERMOSTAT_SETPOINT_COUNT + 1] = {0};
+        int thermostat_setpoint_index[THERMOSTAT_SETPOINT_COUNT + 1] = {0}; // -1 for the readings
+        int thermostat_count = 0;
+        if (poll_schedule[OCS_get_thermostat_status].due()) {
+            indi_strlcpy(thermostat_commands[thermostat_count], OCS_get_thermostat_status, CMD_MAX_LEN);
+            thermostat_setpoint_index[thermostat_count++] = -1;
+        }
+        for (int setpoint = 0; setpoint < THERMOSTAT_SETPOINT_COUNT; setpoint++) {
+            if (thermostat_relays[setpoints[setpoint].relay] > 0 && poll_schedule[setpoints[setpoint].command].due()) {
+                indi_strlcpy(thermostat_commands[thermostat_count], setpoints[setpoint].command, CMD_MAX_LEN);
+                thermostat_setpoint_index[thermostat_count++] = setpoint;
             }
-            IDSetNumber(&Thermostat_heat_setpointNP, nullptr);
+        }
+        if (thermostat_count > 0) {
+            getCommandsPipelined(PortFD, thermostat_count, thermostat_commands, thermostat_responses, thermostat_results);
         }
 
-        if (thermostat_relays[THERMOSTAT_COOL_RELAY] > 0) {
-            char cool_response[RB_MAX_LEN] = {0};
-            int cool_int_response = 0;
-            int cool_setpoint_error_or_fail = getCommandIntFromCharResponse(PortFD, cool_response, &cool_int_response,
-                                                                            OCS_get_thermostat_cool_setpoint);
-            if (cool_setpoint_error_or_fail >= 0 && cool_int_response != conversion_error) { // errors are negative
-                Thermostat_cool_setpointN[0].value =cool_int_response;
-            } else {
-                LOGF_WARN("Communication error on get Thermostat Cool Setpoint %d, this update aborted, will try again...", cool_int_response);
+        for (int i = 0; i < thermostat_count; i++) {
+            PollSchedule &schedule = poll_schedule[thermostat_commands[i]];
+
+            // Get the Thermostat readings
+            if (thermostat_setpoint_index[i] < 0) {
+                if (thermostat_results[i] > 1) {
+                    char *split;
+                    bool thermostat_changed = false;
+                    split = strtok(thermostat_responses[i], ",");
+                    thermostat_changed |= saveStatusText(&Thermostat_StatusT[THERMOSTAT_TEMERATURE], split);
+                    split = strtok(NULL, ",");
+                    thermostat_changed |= saveStatusText(&Thermostat_StatusT[THERMOSTAT_HUMIDITY], split);
+                    if (thermostat_changed) {
+                        IDSetText(&Thermostat_StatusTP, nullptr);
+                    }
+                    schedule.polled(thermostat_changed);
+                } else {
+                    LOGF_WARN("Communication error on get Thermostat Status %s, this update aborted, will try again...", OCS_get_thermostat_status);
+                    schedule = PollSchedule();
+                }
+                continue;
             }
-            IDSetNumber(&Thermostat_cool_setpointNP, nullptr);
-        }
 
-        if (thermostat_relays[THERMOSTAT_HUMIDITY_RELAY] > 0) {
-            char humidity_response[RB_MAX_LEN] = {0};
-            int humidity_int_response = 0;
-            int humidity_setpoint_error_or_fail = getCommandIntFromCharResponse(PortFD, humidity_response, &humidity_int_response,
-                                                                                OCS_get_thermostat_humidity_setpoint);
-            if (humidity_setpoint_error_or_fail >= 0 && humidity_int_response != conversion_error) { // errors are negative
-                Thermostat_humidity_setpointN[0].value = humidity_int_response;
+            // Get the Thermostat setpoints
+            auto const &setpoint = setpoints[thermostat_setpoint_index[i]];
+            int setpoint_response = thermostat_results[i] > 0 ? charToInt(thermostat_responses[i]) : conversion_error;
+            if (setpoint_response != conversion_error) {
+                bool changed = setpoint.number[0].value != setpoint_response;
+                if (changed) {
+                    setpoint.number[0].value = setpoint_response;
+                    IDSetNumber(setpoint.property, nullptr);
+                }
+                schedule.polled(changed);
             } else {
-                LOGF_WARN("Communication error on get Thermostat Humidity Setpoint %d, this update aborted, will try again...", humidity_int_response);
+                LOGF_WARN("Communication error on get Thermostat %s Setpoint %s, this update aborted, will try again...",
+                          setpoint.label, thermostat_responses[i]);
+                schedule = PollSchedule();
             }
-            IDSetNumber(&Thermostat_humidity_setpointNP, nullptr);
         }
 
-        // Get the Thermostat relay status'
+        // Thermostat relay status
+        RelayPoll thermostat_polls[THERMOSTAT_RELAY_COUNT] = {
+            { thermostat_relays[THERMOSTAT_HEAT_RELAY], Thermostat_heat_relayS, &Thermostat_heat_relaySP },
+            { thermostat_relays[THERMOSTAT_COOL_RELAY], Thermostat_cool_relayS, &Thermostat_cool_relaySP },
+            { thermostat_relays[THERMOSTAT_HUMIDITY_RELAY], Thermostat_humidity_relayS, &Thermostat_humidity_relaySP }
+        };
         for (int relay = 0; relay < THERMOSTAT_RELAY_COUNT; relay++) {
             if (thermostat_relays[relay] > 0) {
-                char thermo_relay_response[RB_MAX_LEN] = {0};
-                char thermo_relay_command[RB_MAX_LEN] = {0};
-                sprintf(thermo_relay_command, "%s%d%s", OCS_get_relay_part, thermostat_relays[relay], OCS_command_terminator);
-                int thermo_relay_error_or_fail = getCommandSingleCharErrorOrLongResponse(PortFD, thermo_relay_response,
-                                                                                         thermo_relay_command);
-                if (thermo_relay_error_or_fail > 1) {
-                    switch(relay) {
-                        case THERMOSTAT_HEAT_RELAY:
-                            if (strcmp(thermo_relay_response, "ON") == 0) {
-                                Thermostat_heat_relayS[ON_SWITCH].s = ISS_ON;
-                                Thermostat_heat_relayS[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(thermo_relay_response, "OFF") == 0) {
-                                Thermostat_heat_relayS[ON_SWITCH].s = ISS_OFF;
-                                Thermostat_heat_relayS[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Thermostat_heat_relaySP, nullptr);
-                            break;
-                        case THERMOSTAT_COOL_RELAY:
-                            if (strcmp(thermo_relay_response, "ON") == 0) {
-                                Thermostat_cool_relayS[ON_SWITCH].s = ISS_ON;
-                                Thermostat_cool_relayS[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(thermo_relay_response, "OFF") == 0) {
-                                Thermostat_cool_relayS[ON_SWITCH].s = ISS_OFF;
-                                Thermostat_cool_relayS[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Thermostat_cool_relaySP, nullptr);
-                            break;
-                        case THERMOSTAT_HUMIDITY_RELAY:
-                            if (strcmp(thermo_relay_response, "ON") == 0) {
-                                Thermostat_humidity_relayS[ON_SWITCH].s = ISS_ON;
-                                Thermostat_humidity_relayS[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(thermo_relay_response, "OFF") == 0) {
-                                Thermostat_humidity_relayS[ON_SWITCH].s = ISS_OFF;
-                                Thermostat_humidity_relayS[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Thermostat_humidity_relaySP, nullptr);
-                            break;
-                        default:
-                            break;
-                    }
-                }
+                relays.push_back(thermostat_polls[relay]);
             }
         }
     }
 
     // Power tab
     if (power_tab_enabled) {
-        // Get the Power relay status'
+        RelayPoll power_polls[POWER_DEVICE_COUNT] = {
+            { power_device_relays[POWER_DEVICE1], Power_Device1S, &Power_Device1SP },
+            { power_device_relays[POWER_DEVICE2], Power_Device2S, &Power_Device2SP },
+            { power_device_relays[POWER_DEVICE3], Power_Device3S, &Power_Device3SP },
+            { power_device_relays[POWER_DEVICE4], Power_Device4S, &Power_Device4SP },
+            { power_device_relays[POWER_DEVICE5], Power_Device5S, &Power_Device5SP },
+            { power_device_relays[POWER_DEVICE6], Power_Device6S, &Power_Device6SP }
+        };
         for (int relay = 0; relay < POWER_DEVICE_COUNT; relay++) {
             if (power_device_relays[relay] > 0) {
-                char power_relay_response[RB_MAX_LEN] = {0};
-                char power_relay_command[RB_MAX_LEN] = {0};
-                sprintf(power_relay_command, "%s%d%s", OCS_get_relay_part, power_device_relays[relay], OCS_command_terminator);
-                int power_relay_error_or_fail = getCommandSingleCharErrorOrLongResponse(PortFD, power_relay_response,
-                                                                                        power_relay_command);
-                if (power_relay_error_or_fail > 1) {
-                    switch(relay) {
-                        case POWER_DEVICE1:
-                            if (strcmp(power_relay_response, "ON") == 0) {
-                                Power_Device1S[ON_SWITCH].s = ISS_ON;
-                                Power_Device1S[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(power_relay_response, "OFF") == 0) {
-                                Power_Device1S[ON_SWITCH].s = ISS_OFF;
-                                Power_Device1S[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Power_Device1SP, nullptr);
-                            break;
-                        case POWER_DEVICE2:
-                            if (strcmp(power_relay_response, "ON") == 0) {
-                                Power_Device2S[ON_SWITCH].s = ISS_ON;
-                                Power_Device2S[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(power_relay_response, "OFF") == 0) {
-                                Power_Device2S[ON_SWITCH].s = ISS_OFF;
-                                Power_Device2S[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Power_Device2SP, nullptr);
-                            break;
-                        case POWER_DEVICE3:
-                            if (strcmp(power_relay_response, "ON") == 0) {
-                                Power_Device3S[ON_SWITCH].s = ISS_ON;
-                                Power_Device3S[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(power_relay_response, "OFF") == 0) {
-                                Power_Device3S[ON_SWITCH].s = ISS_OFF;
-                                Power_Device3S[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Power_Device3SP, nullptr);
-                            break;
-                        case POWER_DEVICE4:
-                            if (strcmp(power_relay_response, "ON") == 0) {
-                                Power_Device4S[ON_SWITCH].s = ISS_ON;
-                                Power_Device4S[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(power_relay_response, "OFF") == 0) {
-                                Power_Device4S[ON_SWITCH].s = ISS_OFF;
-                                Power_Device4S[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Power_Device4SP, nullptr);
-                            break;
-                        case POWER_DEVICE5:
-                            if (strcmp(power_relay_response, "ON") == 0) {
-                                Power_Device5S[ON_SWITCH].s = ISS_ON;
-                                Power_Device5S[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(power_relay_response, "OFF") == 0) {
-                                Power_Device5S[ON_SWITCH].s = ISS_OFF;
-                                Power_Device5S[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Power_Device5SP, nullptr);
-                            break;
-                        case POWER_DEVICE6:
-                            if (strcmp(power_relay_response, "ON") == 0) {
-                                Power_Device6S[ON_SWITCH].s = ISS_ON;
-                                Power_Device6S[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(power_relay_response, "OFF") == 0) {
-                                Power_Device6S[ON_SWITCH].s = ISS_OFF;
-                                Power_Device6S[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&Power_Device6SP, nullptr);
-                            break;
-                        default:
-                            break;
-                    }
-                }
+                relays.push_back(power_polls[relay]);
             }
         }
     }
 
     // Lights tab
     if (lights_tab_enabled) {
-        // Get the Lights relay status'
+        RelayPoll light_polls[LIGHT_COUNT] = {
+            { light_relays[LIGHT_WRW_RELAY], LIGHT_WRWS, &LIGHT_WRWSP },
+            { light_relays[LIGHT_WRR_RELAY], LIGHT_WRRS, &LIGHT_WRRSP },
+            { light_relays[LIGHT_ORW_RELAY], LIGHT_ORWS, &LIGHT_ORWSP },
+            { light_relays[LIGHT_ORR_RELAY], LIGHT_ORRS, &LIGHT_ORRSP },
+            { light_relays[LIGHT_OUTSIDE_RELAY], LIGHT_OUTSIDES, &LIGHT_OUTSIDESP }
+        };
         for (int relay = 0; relay < LIGHT_COUNT; relay++) {
             if (light_relays[relay] > 0) {
-                char light_relay_response[RB_MAX_LEN] = {0};
-                char light_relay_command[RB_MAX_LEN] = {0};
-                sprintf(light_relay_command, "%s%d%s", OCS_get_relay_part, light_relays[relay], OCS_command_terminator);
-                int light_relay_error_or_fail = getCommandSingleCharErrorOrLongResponse(PortFD, light_relay_response,
-                                                                                        light_relay_command);
-                if (light_relay_error_or_fail > 1) {
-                    switch (relay) {
-                        case LIGHT_WRW_RELAY:
-                            if (strcmp(light_relay_response, "ON") == 0) {
-                                LIGHT_WRWS[ON_SWITCH].s = ISS_ON;
-                                LIGHT_WRWS[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(light_relay_response, "OFF") == 0) {
-                                LIGHT_WRWS[ON_SWITCH].s = ISS_OFF;
-                                LIGHT_WRWS[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&LIGHT_WRWSP, nullptr);
-                            break;
-                        case LIGHT_WRR_RELAY:
-                            if (strcmp(light_relay_response, "ON") == 0) {
-                                LIGHT_WRRS[ON_SWITCH].s = ISS_ON;
-                                LIGHT_WRRS[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(light_relay_response, "OFF") == 0) {
-                                LIGHT_WRRS[ON_SWITCH].s = ISS_OFF;
-                                LIGHT_WRRS[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&LIGHT_WRRSP, nullptr);
-                            break;
-                        case LIGHT_ORW_RELAY:
-                            if (strcmp(light_relay_response, "ON") == 0) {
-                                LIGHT_ORWS[ON_SWITCH].s = ISS_ON;
-                                LIGHT_ORWS[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(light_relay_response, "OFF") == 0) {
-                                LIGHT_ORWS[ON_SWITCH].s = ISS_OFF;
-                                LIGHT_ORWS[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&LIGHT_ORWSP, nullptr);
-                            break;
-                        case LIGHT_ORR_RELAY:
-                            if (strcmp(light_relay_response, "ON") == 0) {
-                                LIGHT_ORRS[ON_SWITCH].s = ISS_ON;
-                                LIGHT_ORRS[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(light_relay_response, "OFF") == 0) {
-                                LIGHT_ORRS[ON_SWITCH].s = ISS_OFF;
-                                LIGHT_ORRS[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&LIGHT_ORRSP, nullptr);
-                            break;
-                        case LIGHT_OUTSIDE_RELAY:
-                            if (strcmp(light_relay_response, "ON") == 0) {
-                                LIGHT_OUTSIDES[ON_SWITCH].s = ISS_ON;
-                                LIGHT_OUTSIDES[OFF_SWITCH].s = ISS_OFF;
-                            } else if (strcmp(light_relay_response, "OFF") == 0) {
-                                LIGHT_OUTSIDES[ON_SWITCH].s = ISS_OFF;
-                                LIGHT_OUTSIDES[OFF_SWITCH].s = ISS_ON;
-                            }
-                            IDSetSwitch(&LIGHT_OUTSIDESP, nullptr);
-                            break;
-                        default:
-                            break;
-                    }
+                relays.push_back(light_polls[relay]);
+            }
+        }
+    }
+
+    pollRelays(relays);
+}
+
+/****************************************************************************
+* Poll relay states in pipelined batches. Relays that did not change since
+* the last poll are polled less often, up to every POLL_MAX_INTERVAL
+* slow timer cycles, and switches are only published when the state changed
+*****************************************************************************/
+void OCS::pollRelays(std::vector<RelayPoll> &relays)
+{
+    std::vector<RelayPoll *> due;
+    for (auto &relay_poll : relays) {
+        if (relay_schedule[relay_poll.relay].due()) {
+            due.push_back(&relay_poll);
+        }
+    }
+
+    size_t next = 0;
+    while (next < due.size()) {
+        char relay_commands[PIPELINE_MAX_COMMANDS][CMD_MAX_LEN];
+        char relay_responses[PIPELINE_MAX_COMMANDS][RB_MAX_LEN] = {};
+        int relay_results[PIPELINE_MAX_COMMANDS] = {0};
+        int count = 0;
+        int bytes = 0;
+        while (next + count < due.size() && count < PIPELINE_MAX_COMMANDS) {
+            int length = snprintf(relay_commands[count], CMD_MAX_LEN, "%s%d%s", OCS_get_relay_part,
+                                  due[next + count]->relay, OCS_command_terminator);
+            if (bytes + length > PIPELINE_MAX_BYTES) {
+                break;
+            }
+            bytes += length;
+            count++;
+        }
+        getCommandsPipelined(PortFD, count, relay_commands, relay_responses, relay_results);
+
+        for (int i = 0; i < count; i++) {
+            RelayPoll *relay_poll = due[next + i];
+            PollSchedule &schedule = relay_schedule[relay_poll->relay];
+            ISState state;
+            if (relay_results[i] > 1 && strcmp(relay_responses[i], "ON") == 0) {
+                state = ISS_ON;
+            } else if (relay_results[i] > 1 && strcmp(relay_responses[i], "OFF") == 0) {
+                state = ISS_OFF;
+            } else {
+                if (relay_results[i] <= 1) {
+                    LOGF_WARN("Communication error on get relay %d state, this update aborted, will try again...", relay_poll->relay);
                 }
+                schedule = PollSchedule();
+                continue;
+            }
+
+            bool changed = relay_poll->switches[ON_SWITCH].s != state;
+            if (changed) {
+                relay_poll->switches[ON_SWITCH].s = state;
+                relay_poll->switches[OFF_SWITCH].s = (state == ISS_ON) ? ISS_OFF : ISS_ON;
+                IDSetSwitch(relay_poll->property, nullptr);
             }
+            schedule.polled(changed);
         }
+        next += count;
     }
 }
 
+/****************************************************************
+* Publish the serial latency statistics, at most every 10 seconds
+* unless forced
+*****************************************************************/
+void OCS::updateSerialLatency(bool force)
+{
+    time_t const now = time(nullptr);
+    if (!force && now - serialLatencyUpdate < 10)
+        return;
+    serialLatencyUpdate = now;
+
+    std::unique_lock<std::mutex> guard(ocsCommsLock);
+    std::string report = serialTrace.report();
+    guard.unlock();
+
+    IUSaveText(&SerialLatencyT[0], report.c_str());
+    SerialLatencyTP.s = IPS_OK;
+    IDSetText(&SerialLatencyTP, nullptr);
+}
+
+/*********************************************************
+* Save a text value, returns true if it differs from the
+* published one so that the caller only publishes changes
+**********************************************************/
+bool OCS::saveStatusText(IText *text, const char *value)
+{
+    if (value == nullptr || (text->text != nullptr && strcmp(text->text, value) == 0)) {
+        return false;
+    }
+    IUSaveText(text, value);
+    return true;
+}
+
 /*****************************************************************
 * Poll Weather properties for updates - period set by Weather poll
 ******************************************************************/
@@ -1405,107 +1429,156 @@ IPState OCS::updateWeather() {
 
         LOG_DEBUG("Weather update called");
 
+        // Enabled measurements always return a # terminated value, so they are requested in pipelined batches
+        int measurements[WEATHER_MEASUREMENTS_COUNT];
+        char measurement_commands[WEATHER_MEASUREMENTS_COUNT][CMD_MAX_LEN];
+        char measurement_responses[WEATHER_MEASUREMENTS_COUNT][RB_MAX_LEN] = {};
+        int measurement_results[WEATHER_MEASUREMENTS_COUNT] = {0};
+        int measurement_count = 0;
+
         for (int measurement = 0; measurement < WEATHER_MEASUREMENTS_COUNT; measurement ++) {
             if (weather_enabled[measurement] == 1) {
-                char measurement_reponse[RB_MAX_LEN];
-                char measurement_command[CMD_MAX_LEN];
-
-                LOGF_DEBUG("In weather measurements loop, %u", measurement);
+                char *measurement_command = measurement_commands[measurement_count];
 
                 switch (measurement) {
                     case WEATHER_TEMPERATURE:
-                        indi_strlcpy(measurement_command, OCS_get_outside_temperature, sizeof(measurement_command));
+                        indi_strlcpy(measurement_command, OCS_get_outside_temperature, CMD_MAX_LEN);
                         break;
                     case WEATHER_PRESSURE:
-                        indi_strlcpy(measurement_command, OCS_get_pressure, sizeof(measurement_command));
+                        indi_strlcpy(measurement_command, OCS_get_pressure, CMD_MAX_LEN);
                         break;
                     case WEATHER_HUMIDITY:
-                        indi_strlcpy(measurement_command, OCS_get_humidity, sizeof(measurement_command));
+                        indi_strlcpy(measurement_command, OCS_get_humidity, CMD_MAX_LEN);
                         break;
                     case WEATHER_WIND:
-                        indi_strlcpy(measurement_command, OCS_get_wind_speed, sizeof(measurement_command));
+                        indi_strlcpy(measurement_command, OCS_get_wind_speed, CMD_MAX_LEN);
                         break;
                     case WEATHER_RAIN:
-                        indi_strlcpy(measurement_command, OCS_get_rain_sensor_status, sizeof(measurement_command));
+                        indi_strlcpy(measurement_command, OCS_get_rain_sensor_status, CMD_MAX_LEN);
                         break;
                     case WEATHER_DIFF_SKY_TEMP:
-                        indi_strlcpy(measurement_command, OCS_get_sky_diff_temperature, sizeof(measurement_command));
+                        indi_strlcpy(measurement_command, OCS_get_sky_diff_temperature, CMD_MAX_LEN);
+                        break;
+                    case WEATHER_CLOUD:
+                        indi_strlcpy(measurement_command, OCS_get_cloud_description, CMD_MAX_LEN);
                         break;
-
-                    // case WEATHER_CLOUD: Not handled in this switch as it returns a string so needs a different call
-
                     case WEATHER_SKY:
-                        indi_strlcpy(measurement_command, OCS_get_sky_quality, sizeof(measurement_command));
+                        indi_strlcpy(measurement_command, OCS_get_sky_quality, CMD_MAX_LEN);
                         break;
                     case WEATHER_SKY_TEMP:
-                        indi_strlcpy(measurement_command, OCS_get_sky_IR_temperature, sizeof(measurement_command));
+                        indi_strlcpy(measurement_command, OCS_get_sky_IR_temperature, CMD_MAX_LEN);
                         break;
                     default:
-                        break;
+                        continue;
+                }
+                // Critical parameters are read on every update so that the weather safety never lags,
+                // the others back off while they do not change
+                if (!isCriticalMeasurement(measurement) && !poll_schedule[measurement_command].due()) {
+                    continue;
                 }
+                measurements[measurement_count++] = measurement;
+            }
+        }
 
-                double value = conversion_error;
-                int measurement_error_or_fail = getCommandDoubleResponse(PortFD, &value, measurement_reponse,
-                                                                         measurement_command);
-                if ((measurement_error_or_fail >= 0) && (value != conversion_error) &&
-                    (weather_enabled[measurement] == 1)) {
-                    switch(measurement) {
-                        case WEATHER_TEMPERATURE:
-                            setParameterValue("WEATHER_TEMPERATURE", value);
-                            break;
-                        case WEATHER_PRESSURE:
-                            setParameterValue("WEATHER_PRESSURE", value);
-                            break;
-                        case WEATHER_HUMIDITY:
-                            setParameterValue("WEATHER_HUMIDITY", value);
-                            break;
-                        case WEATHER_WIND:
-                            setParameterValue("WEATHER_WIND", value);
-                            break;
-                        case WEATHER_RAIN:
-                            setParameterValue("WEATHER_RAIN", value);
-                            break;
-                        case WEATHER_DIFF_SKY_TEMP:
-                            setParameterValue("WEATHER_SKY_DIFF_TEMP", value);
-                            break;
+        for (int batch = 0; batch < measurement_count; batch += PIPELINE_MAX_COMMANDS) {
+            getCommandsPipelined(PortFD, std::min(PIPELINE_MAX_COMMANDS, measurement_count - batch), &measurement_commands[batch],
+                                 &measurement_responses[batch], &measurement_results[batch]);
+        }
 
-                     // case WEATHER_CLOUD: Not handled in this switch as it returns a string so needs a different call
+        for (int i = 0; i < measurement_count; i++) {
+            int measurement = measurements[i];
+            char *measurement_reponse = measurement_responses[i];
+            LOGF_DEBUG("In weather measurements loop, %u", measurement);
 
-                        case WEATHER_SKY:
-                            IUSaveText(&Weather_SkyT[0], measurement_reponse);
-                            IDSetText(&Weather_SkyTP, nullptr);
-                            break;
-                        case WEATHER_SKY_TEMP:
-                            IUSaveText(&Weather_Sky_TempT[0], measurement_reponse);
-                            IDSetText(&Weather_Sky_TempTP, nullptr);
-                            break;
-                        default:
-                            break;
-                    }
-                }
+            // Only used by the measurements that are not critical
+            PollSchedule &schedule = poll_schedule[measurement_commands[i]];
 
-                // Separate because WEATHER_CLOUD is the only weather parameter that return a string
-                if ((measurement == WEATHER_CLOUD) && (weather_enabled[WEATHER_CLOUD] == 1)) {
-                    char measurement_reponse[RB_MAX_LEN];
-                    int measurement_error_or_fail = getCommandSingleCharErrorOrLongResponse(PortFD, measurement_reponse,
-                                                                             OCS_get_cloud_description);
-                    if (measurement_error_or_fail > 1) {
-                        IUSaveText(&Weather_CloudT[0], measurement_reponse);
+            // WEATHER_CLOUD is the only weather parameter that return a string
+            if (measurement == WEATHER_CLOUD) {
+                if (measurement_results[i] > 1) {
+                    bool changed = saveStatusText(&Weather_CloudT[0], measurement_reponse);
+                    if (changed) {
                         IDSetText(&Weather_CloudTP, nullptr);
                     }
+                    schedule.polled(changed);
+                } else {
+                    schedule = PollSchedule();
                 }
+                continue;
             }
-            if (WI::syncCriticalParameters()) {
-                LOG_DEBUG("SyncCriticalParameters = true");
+
+            double value = conversion_error;
+            if ((measurement_results[i] <= 0) || (sscanf(measurement_reponse, "%lf", &value) != 1) ||
+                (value == conversion_error)) {
+                schedule = PollSchedule();
             } else {
-                LOG_DEBUG("SyncCriticalParameters = false");
+                switch(measurement) {
+                    case WEATHER_TEMPERATURE:
+                        setParameterValue("WEATHER_TEMPERATURE", value);
+                        break;
+                    case WEATHER_PRESSURE:
+                        setParameterValue("WEATHER_PRESSURE", value);
+                        break;
+                    case WEATHER_HUMIDITY:
+                        setParameterValue("WEATHER_HUMIDITY", value);
+                        break;
+                    case WEATHER_WIND:
+                        setParameterValue("WEATHER_WIND", value);
+                        break;
+                    case WEATHER_RAIN:
+                        setParameterValue("WEATHER_RAIN", value);
+                        break;
+                    case WEATHER_DIFF_SKY_TEMP:
+                        setParameterValue("WEATHER_SKY_DIFF_TEMP", value);
+                        break;
+                    case WEATHER_SKY: {
+                        bool changed = saveStatusText(&Weather_SkyT[0], measurement_reponse);
+                        if (changed) {
+                            IDSetText(&Weather_SkyTP, nullptr);
+                        }
+                        schedule.polled(changed);
+                        break;
+                    }
+                    case WEATHER_SKY_TEMP: {
+                        bool changed = saveStatusText(&Weather_Sky_TempT[0], measurement_reponse);
+                        if (changed) {
+                            IDSetText(&Weather_Sky_TempTP, nullptr);
+                        }
+                        schedule.polled(changed);
+                        break;
+                    }
+                    default:
+                        break;
+                }
             }
         }
+
+        if (WI::syncCriticalParameters()) {
+            LOG_DEBUG("SyncCriticalParameters = true");
+        } else {
+            LOG_DEBUG("SyncCriticalParameters = false");
+        }
     }
 
     return IPS_OK;
 }
 
+/*****************************************************************
+* Measurements registered with setCriticalParameter, they decide
+* the weather safety status
+******************************************************************/
+bool OCS::isCriticalMeasurement(int measurement)
+{
+    switch (measurement) {
+        case WEATHER_CLOUD:
+        case WEATHER_SKY:
+        case WEATHER_SKY_TEMP:
+            return false;
+        default:
+            return true;
+    }
+}
+
 /*************************************
  * Stop any roof/shutter/dome movement
  * ***********************************/
@@ -1773,6 +1846,14 @@ bool OCS::Connect()
 ************************************************************/
 bool OCS::Disconnect()
 {
+    {
+        std::unique_lock<std::mutex> guard(ocsCommsLock);
+        serialTrace.close();
+    }
+    IUResetSwitch(&SerialTraceSP);
+    SerialTraceS[INDI_DISABLED].s = ISS_ON;
+    SerialTraceSP.s = IPS_IDLE;
+
     bool status = INDI::Dome::Disconnect();
     return status;
 }
@@ -1796,6 +1877,7 @@ bool OCS::saveConfigItems(FILE *fp)
 {
     INDI::Dome::saveConfigItems(fp);
     WI::saveConfigItems(fp);
+    IUSaveConfigText(fp, &SerialTraceFileTP);
     return true;
 }
 
@@ -2017,6 +2099,33 @@ bool OCS::ISNewSwitch(const char *dev, const char *name, ISState *states, char *
 
         // Reset Watchdog
         //---------------
+        } else if (strcmp(SerialTraceSP.name, name) == 0) {
+            if (IUUpdateSwitch(&SerialTraceSP, states, names, n) < 0)
+                return false;
+
+            std::unique_lock<std::mutex> guard(ocsCommsLock);
+            if (IUFindOnSwitchIndex(&SerialTraceSP) == INDI_ENABLED) {
+                // Start statistics together with the trace, so that both cover the same exchanges
+                serialTrace.resetStatistics();
+                if (serialTrace.open(SerialTraceFileT[0].text)) {
+                    LOGF_INFO("Recording serial trace to %s", SerialTraceFileT[0].text);
+                    SerialTraceSP.s = IPS_BUSY;
+                } else {
+                    LOGF_ERROR("Cannot create serial trace file %s: %s", SerialTraceFileT[0].text, strerror(errno));
+                    IUResetSwitch(&SerialTraceSP);
+                    SerialTraceS[INDI_DISABLED].s = ISS_ON;
+                    SerialTraceSP.s = IPS_ALERT;
+                }
+            } else {
+                if (serialTrace.isRecording())
+                    LOGF_INFO("Serial trace %s closed.", SerialTraceFileT[0].text);
+                serialTrace.close();
+                SerialTraceSP.s = IPS_OK;
+            }
+            guard.unlock();
+            IDSetSwitch(&SerialTraceSP, nullptr);
+            updateSerialLatency(true);
+            return true;
         } else if (strcmp(Watchdog_ResetSP.name, name) == 0) {
             char watchdog_response[RB_MAX_LEN] = {0};
             int watchdog_fail_or_error = getCommandSingleCharErrorOrLongResponse(PortFD, watchdog_response, OCS_set_watchdog_flag);
@@ -2155,6 +2264,15 @@ bool OCS::ISNewText(const char *dev,const char *name,char *texts[],char *names[]
     // }
     // Debug only end
 
+    if (dev != nullptr && strcmp(dev, getDeviceName()) == 0) {
+        if (strcmp(SerialTraceFileTP.name, name) == 0) {
+            IUUpdateText(&SerialTraceFileTP, texts, names, n);
+            SerialTraceFileTP.s = IPS_OK;
+            IDSetText(&SerialTraceFileTP, nullptr);
+            return true;
+        }
+    }
+
     return INDI::Dome::ISNewText(dev,name,texts,names,n);
 }
 
@@ -2190,6 +2308,7 @@ bool OCS::sendOCSCommandBlind(const char *cmd)
         return 0; //Fail if we can't write
         //return error_type;
     }
+    serialTrace.transmitted(cmd);
     return 1;
 }
 
@@ -2213,8 +2332,11 @@ bool OCS::sendOCSCommand(const char *cmd)
 
     if ((error_type = tty_write_string(PortFD, cmd, &nbytes_write)) != TTY_OK)
         return error_type;
+    serialTrace.transmitted(cmd);
 
     error_type = tty_read_expanded(PortFD, response, 1, OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
+    if (nbytes_read > 0)
+        serialTrace.received(response, nbytes_read);
 
     tcflush(PortFD, TCIFLUSH);
     DEBUGF(INDI::Logger::DBG_DEBUG, "RES <%c>", response[0]);
@@ -2248,8 +2370,11 @@ int OCS::getCommandSingleCharResponse(int fd, char *data, const char *cmd)
 
     if ((error_type = tty_write_string(fd, cmd, &nbytes_write)) != TTY_OK)
         return error_type;
+    serialTrace.transmitted(cmd);
 
     error_type = tty_read_expanded(fd, data, 1, OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
+    if (nbytes_read > 0)
+        serialTrace.received(data, nbytes_read);
     tcflush(fd, TCIFLUSH);
 
     if (error_type != TTY_OK)
@@ -2292,8 +2417,11 @@ int OCS::getCommandDoubleResponse(int fd, double *value, char *data, const char
 
     if ((error_type = tty_write_string(fd, cmd, &nbytes_write)) != TTY_OK)
         return error_type;
+    serialTrace.transmitted(cmd);
 
     error_type = tty_read_section_expanded(fd, data, '#', OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
+    if (nbytes_read > 0)
+        serialTrace.received(data, nbytes_read);
     tcflush(fd, TCIFLUSH);
 
     term = strchr(data, '#');
@@ -2347,8 +2475,11 @@ int OCS::getCommandIntResponse(int fd, int *value, char *data, const char *cmd)
 
     if ((error_type = tty_write_string(fd, cmd, &nbytes_write)) != TTY_OK)
         return error_type;
+    serialTrace.transmitted(cmd);
 
     error_type = tty_read_expanded(fd, data, sizeof(char), OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
+    if (nbytes_read > 0)
+        serialTrace.received(data, nbytes_read);
     tcflush(fd, TCIFLUSH);
 
     term = strchr(data, '#');
@@ -2401,8 +2532,11 @@ int OCS::getCommandSingleCharErrorOrLongResponse(int fd, char *data, const char
 
     if ((error_type = tty_write_string(fd, cmd, &nbytes_write)) != TTY_OK)
         return error_type;
+    serialTrace.transmitted(cmd);
 
     error_type = tty_read_section_expanded(fd, data, '#', OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
+    if (nbytes_read > 0)
+        serialTrace.received(data, nbytes_read);
     tcflush(fd, TCIFLUSH);
 
     term = strchr(data, '#');
@@ -2451,6 +2585,87 @@ int OCS::getCommandIntFromCharResponse(int fd, char *data, int *response, const
 }
 
 
+/*****************************************************************************
+ * Send several commands to OCS back-to-back and read their responses in order
+ * Only commands whose response is always # terminated may be pipelined, an
+ * unterminated response (unconfigured items return 0) would be merged into the
+ * next one. results[] holds the bytes read or the tty error for each command.
+ * ***************************************************************************/
+int OCS::getCommandsPipelined(int fd, int count, const char commands[][CMD_MAX_LEN], char responses[][RB_MAX_LEN],
+                              int results[])
+{
+    if (count <= 0) {
+        return 0;
+    }
+    if (count == 1) {
+        results[0] = getCommandSingleCharErrorOrLongResponse(fd, responses[0], commands[0]);
+        return results[0] > 0 ? 1 : 0;
+    }
+
+    blockUntilClear();
+
+    char batch[PIPELINE_MAX_COMMANDS * CMD_MAX_LEN] = {0};
+    int batch_length = 0;
+    int error_type;
+    int nbytes_write = 0, nbytes_read = 0;
+    int received = 0;
+
+    count = std::min(count, PIPELINE_MAX_COMMANDS);
+    for (int i = 0; i < count; i++) {
+        batch_length += snprintf(batch + batch_length, sizeof(batch) - batch_length, "%s", commands[i]);
+        results[i] = TTY_TIME_OUT;
+    }
+
+    DEBUGF(INDI::Logger::DBG_DEBUG, "CMD <%s>", batch);
+
+    flushIO(fd);
+    /* Add mutex */
+    std::unique_lock<std::mutex> guard(ocsCommsLock);
+    tcflush(fd, TCIFLUSH);
+
+    if ((error_type = tty_write(fd, batch, batch_length, &nbytes_write)) != TTY_OK) {
+        clearBlock();
+        for (int i = 0; i < count; i++) {
+            results[i] = error_type;
+        }
+        return 0;
+    }
+    for (int i = 0; i < count; i++) {
+        serialTrace.transmitted(commands[i], i > 0);
+    }
+
+    for (int i = 0; i < count; i++) {
+        error_type = tty_read_section_expanded(fd, responses[i], '#', OCSTimeoutSeconds, OCSTimeoutMicroSeconds, &nbytes_read);
+        if (nbytes_read > 0)
+            serialTrace.received(responses[i], nbytes_read);
+        if (error_type != TTY_OK) {
+            // Responses are matched by position, once one is lost the remaining ones cannot be trusted
+            LOGF_DEBUG("Error %d on response %d of <%s>", error_type, i, batch);
+            for (int j = i; j < count; j++) {
+                results[j] = error_type;
+            }
+            break;
+        }
+
+        char *term = strchr(responses[i], '#');
+        if (term)
+            *term = '\0';
+        if (nbytes_read < RB_MAX_LEN) {
+            responses[i][nbytes_read] = '\0';
+        } else {
+            responses[i][RB_MAX_LEN - 1] = '\0';
+        }
+        DEBUGF(INDI::Logger::DBG_DEBUG, "RES <%s>", responses[i]);
+        results[i] = nbytes_read;
+        received++;
+    }
+
+    tcflush(fd, TCIFLUSH);
+    clearBlock();
+
+    return received;
+}
+
 /**********************
  * Flush the comms port
  * ********************/
@@ -24,9 +24,20 @@
 #include "connectionplugins/connectionserial.h"
 #include "indipropertyswitch.h"
 #include "inditimer.h"
+#include "serial_trace.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
 
 #define RB_MAX_LEN 64
 #define CMD_MAX_LEN 32
+// Pipelined polling, commands sent back-to-back must fit into the OCS serial receive buffer
+#define PIPELINE_MAX_COMMANDS 4
+#define PIPELINE_MAX_BYTES 48
+// Items that do not change are polled every 2nd, then every 4th cycle
+#define POLL_MAX_INTERVAL 4
 enum ResponseErrors {RES_ERR_FORMAT = -1001};
 
 /**********************************************************************
@@ -446,6 +457,8 @@ class OCS : public INDI::Dome, public INDI::WeatherInterface
                                  const char *cmd); //Reimplemented from getCommandString Will return a double, and raw value.
     int getCommandIntResponse(int fd, int *value, char *data, const char *cmd);
     int getCommandIntFromCharResponse(int fd, char *data, int *response, const char *cmd); //Calls getCommandSingleCharErrorOrLongResponse with conversion of return
+    int getCommandsPipelined(int fd, int count, const char commands[][CMD_MAX_LEN], char responses[][RB_MAX_LEN],
+                             int results[]); //Sends up to PIPELINE_MAX_COMMANDS at once, responses matched in order
     int charToInt(char *inString);
     void blockUntilClear();
     void clearBlock();
@@ -467,6 +480,36 @@ private:
     // Command sequence enforcement
     bool waitingForResponse = false;
 
+    // Relay status polling
+    // Only relays whose response is always # terminated (defined relays) may be pipelined
+    struct RelayPoll {
+        int relay;
+        ISwitch *switches;
+        ISwitchVectorProperty *property;
+    };
+    struct PollSchedule {
+        int interval = 1;   // cycles between polls
+        int countdown = 0;  // cycles left until the next poll
+        // Counts one cycle down, true if the item is due this cycle
+        bool due() {
+            if (countdown > 0) {
+                countdown--;
+                return false;
+            }
+            return true;
+        }
+        // Unchanged items back off, changed ones are polled every cycle again
+        void polled(bool changed) {
+            interval = changed ? 1 : std::min(interval * 2, POLL_MAX_INTERVAL);
+            countdown = interval - 1;
+        }
+    };
+    std::map<int, PollSchedule> relay_schedule;
+    std::map<std::string, PollSchedule> poll_schedule; // status, thermostat and weather items, by command
+    static bool isCriticalMeasurement(int measurement);
+    void pollRelays(std::vector<RelayPoll> &relays);
+    bool saveStatusText(IText *text, const char *value); // true if value differs from the published one
+
     // Roof/Shutter control
     //---------------------
     int ROOF_TIME_PRE_MOTION = 0;
@@ -703,6 +746,17 @@ private:
     ISwitchVectorProperty Watchdog_ResetSP;
     ISwitch Watchdog_ResetS[1];
 
+    // Serial transaction trace and latency statistics, replay the trace with ocs_replay
+    ISwitchVectorProperty SerialTraceSP;
+    ISwitch SerialTraceS[2];
+    ITextVectorProperty SerialTraceFileTP;
+    IText SerialTraceFileT[1] {};
+    ITextVectorProperty SerialLatencyTP;
+    IText SerialLatencyT[1] {};
+    SerialTrace::Recorder serialTrace; // guarded by ocsCommsLock
+    time_t serialLatencyUpdate = 0;
+    void updateSerialLatency(bool force = false);
+
     // Debug only
     // ITextVectorProperty Arbitary_CommandTP;
     // IText Arbitary_CommandT[1];
@@ -0,0 +1,178 @@
+/*******************************************************************************
+ OCS emulator for testing the indi_ocs driver without an observatory controller
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Library General Public
+ License version 2 as published by the Free Software Foundation.
+ .
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Library General Public License for more details.
+ .
+ You should have received a copy of the GNU Library General Public License
+ along with this library; see the file COPYING.LIB.  If not, write to
+ the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ Boston, MA 02110-1301, USA.
+*******************************************************************************/
+
+/*
+ Answers the subset of the OCS lexicon used by the driver on a pseudo terminal:
+
+     ocs_emulator [--no-dome] [--delay ms]
+
+ The slave device name is printed on startup, point the driver's serial port at it.
+ Commands are processed in the order they arrive, so pipelined requests are answered
+ in sequence like the controller does. --delay adds a per command processing time,
+ to compare sequential and pipelined polling. Unknown or unconfigured items answer
+ with an unterminated 0, like OCS.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+// Emulated configuration: thermostat relays 1,2 power devices on 3,4 and lights on 5,6
+static std::map<int, bool> relays = { {1, false}, {2, false}, {3, true}, {4, false}, {5, false}, {6, true} };
+static bool has_dome = true;
+static bool roof_open = false;
+static double dome_azimuth = 180.0;
+static double dome_target = 180.0;
+
+static std::string terminated(const char *value)
+{
+    return std::string(value) + "#";
+}
+
+static std::string answer(const std::string &command)
+{
+    char value[64];
+
+    // General
+    if (command == ":IP") return terminated("OCS");
+    if (command == ":IN") return terminated("3.10a");
+    if (command == ":IT") return terminated("0,0");
+    if (command == ":GP") return terminated("OK");
+    if (command == ":Gs") return terminated("SAFE");
+    if (command == ":GX9F") return terminated("35.2");
+
+    // Roof
+    if (command == ":RO") { roof_open = true; return ""; }
+    if (command == ":RC") { roof_open = false; return ""; }
+    if (command == ":RH") return "";
+    if (command == ":RS") return terminated(roof_open ? "i,OPEN" : "i,CLOSED");
+    if (command == ":RSL") return ""; // never errored
+
+    // Dome, moves 5 degrees towards the target per position query
+    if (command == ":DU") return has_dome ? terminated(dome_azimuth == dome_target ? "I" : "S") : "0";
+    if (command == ":DZ" && has_dome) {
+        double step = std::max(-5.0, std::min(5.0, dome_target - dome_azimuth));
+        dome_azimuth += step;
+        snprintf(value, sizeof(value), "%.1f", dome_azimuth);
+        return terminated(value);
+    }
+    if (command.compare(0, 3, ":Dz") == 0 && has_dome) { dome_target = atof(command.c_str() + 3); return ""; }
+    if (command == ":DS" && has_dome) return terminated("0");
+    if (command == ":DH" && has_dome) { dome_target = dome_azimuth; return ""; }
+
+    // Thermostat
+    if (command == ":GT") return terminated("18.5,45.0");
+    if (command == ":It") return terminated("1,2,-1");
+    if (command == ":GH") return terminated("20");
+    if (command == ":GV") return terminated("30");
+    if (command == ":GD") return terminated("0");
+    if (command.compare(0, 3, ":SH") == 0 || command.compare(0, 3, ":SC") == 0 || command.compare(0, 3, ":SD") == 0)
+        return terminated("1");
+
+    // Power and lights
+    if (command == ":Ip") return terminated("3,4,-1,-1,-1,-1");
+    if (command.compare(0, 3, ":Ip") == 0) {
+        snprintf(value, sizeof(value), "Device %s", command.c_str() + 3);
+        return terminated(value);
+    }
+    if (command == ":IL") return terminated("5,-1,-1,-1,6");
+
+    // Relays, :GR without a number is the rain sensor
+    if (command.compare(0, 3, ":GR") == 0 && command.size() > 3) {
+        auto relay = relays.find(atoi(command.c_str() + 3));
+        return relay == relays.end() ? "0" : terminated(relay->second ? "ON" : "OFF");
+    }
+    if (command.compare(0, 3, ":SR") == 0) {
+        int relay = atoi(command.c_str() + 3);
+        const char *state = strchr(command.c_str(), ',');
+        if (relays.count(relay) == 0 || state == nullptr)
+            return terminated("0");
+        relays[relay] = strcmp(state + 1, "ON") == 0;
+        return terminated("1");
+    }
+
+    // Weather
+    if (command == ":G1") return terminated("12.5");
+    if (command == ":G2") return terminated("-18.0");
+    if (command == ":G3") return terminated("-30.5");
+    if (command == ":Gb") return terminated("1013.2");
+    if (command == ":Gh") return terminated("65.0");
+    if (command == ":Gw") return terminated("5");
+    if (command == ":GR") return terminated("3");
+    if (command == ":GC") return terminated("Clear");
+    if (command == ":GQ") return terminated("21.3");
+    if (command == ":IW") return terminated("20,-14");
+
+    return "0";
+}
+
+int main(int argc, char *argv[])
+{
+    int delay_ms = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-dome") == 0) {
+            has_dome = false;
+        } else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) {
+            delay_ms = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [--no-dome] [--delay ms]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        fprintf(stderr, "Failed to create pseudo terminal: %s\n", strerror(errno));
+        return 1;
+    }
+    // keep the slave open, so that the master does not fail while the driver reconnects
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    printf("OCS emulator on %s\n", ptsname(master));
+    fflush(stdout);
+
+    std::string command;
+    char buffer[256];
+    ssize_t count;
+    while ((count = read(master, buffer, sizeof(buffer))) > 0 || (count < 0 && errno == EINTR)) {
+        for (ssize_t i = 0; i < count; i++) {
+            if (buffer[i] == ':') {
+                command.assign(1, ':');
+            } else if (buffer[i] == '#') {
+                if (delay_ms > 0)
+                    usleep(delay_ms * 1000);
+                std::string response = answer(command);
+                if (!response.empty() && write(master, response.data(), response.size()) < 0) {
+                    fprintf(stderr, "Failed to answer %s: %s\n", command.c_str(), strerror(errno));
+                }
+                command.clear();
+            } else if (!command.empty()) {
+                command += buffer[i];
+            }
+        }
+    }
+
+    close(slave);
+    close(master);
+    return 0;
+}
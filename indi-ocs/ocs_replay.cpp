@@ -0,0 +1,34 @@
+/*******************************************************************************
+ OCS serial trace replay for testing the indi_ocs driver without an observatory controller
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Library General Public
+ License version 2 as published by the Free Software Foundation.
+ .
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Library General Public License for more details.
+ .
+ You should have received a copy of the GNU Library General Public License
+ along with this library; see the file COPYING.LIB.  If not, write to
+ the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ Boston, MA 02110-1301, USA.
+*******************************************************************************/
+
+/*
+ Plays back a trace recorded by the driver (SERIAL_TRACE property) on a pseudo terminal:
+
+     ocs_replay <trace file> [speed]
+
+ The slave device name is printed on startup, point the driver's serial port at it.
+ Commands written by the driver are compared to the recorded ones, answers are sent
+ after the recorded delay divided by speed (default 1, 0 answers immediately).
+*/
+
+#include "serial_trace_replay.h"
+
+int main(int argc, char *argv[])
+{
+    return SerialTrace::replay(argc, argv);
+}
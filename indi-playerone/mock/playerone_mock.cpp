@@ -0,0 +1,493 @@
+/*
+ PlayerOne CCD Driver - mock libPlayerOneCamera
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ libPlayerOneCamera for playerone_download_benchmark, see common/README.md. One colour camera is
+ enumerated, 1920 x 1080 and 300 MB/s unless set otherwise, with RAW8, RAW16, RGB24 and MONO8.
+
+ Once POAStartExposure is called the camera finishes a frame per exposure time (or per transfer
+ time, if longer), only one in single frame mode. POAImageReady reports a finished frame that
+ was not read yet, POAGetImageData waits for one and copies the newest out of the SDK's buffer.
+ Frames finished before POAStopExposure can still be read, as the driver does for exposures.
+*/
+
+#include <PlayerOneCamera.h>
+#include "playerone_mock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+POAConfigAttributes intConfig(POAConfig id, const char *name, long min, long max, long value, bool writable = true)
+{
+    POAConfigAttributes attributes {};
+    attributes.isWritable = writable ? POA_TRUE : POA_FALSE;
+    attributes.isReadable = POA_TRUE;
+    attributes.configID   = id;
+    attributes.valueType  = VAL_INT;
+    attributes.minValue.intValue     = min;
+    attributes.maxValue.intValue     = max;
+    attributes.defaultValue.intValue = value;
+    snprintf(attributes.szConfName, sizeof(attributes.szConfName), "%s", name);
+    return attributes;
+}
+
+POAConfigAttributes floatConfig(POAConfig id, const char *name, double min, double max, double value, bool writable)
+{
+    POAConfigAttributes attributes {};
+    attributes.isWritable = writable ? POA_TRUE : POA_FALSE;
+    attributes.isReadable = POA_TRUE;
+    attributes.configID   = id;
+    attributes.valueType  = VAL_FLOAT;
+    attributes.minValue.floatValue     = min;
+    attributes.maxValue.floatValue     = max;
+    attributes.defaultValue.floatValue = value;
+    snprintf(attributes.szConfName, sizeof(attributes.szConfName), "%s", name);
+    return attributes;
+}
+
+const POAConfigAttributes configs[] =
+{
+    intConfig(POA_EXPOSURE, "Exposure", 10, 2000000000, 10000),
+    intConfig(POA_GAIN, "Gain", 0, 500, 0),
+    floatConfig(POA_TEMPERATURE, "Temperature", -50, 100, 20, false),
+    intConfig(POA_OFFSET, "Offset", 0, 255, 12),
+    intConfig(POA_USB_BANDWIDTH_LIMIT, "USBBandwidthLimit", 35, 100, 90),
+    floatConfig(POA_EXP, "Exp", 0.00001, 7200, 0.01, true),
+};
+const int configCount = sizeof(configs) / sizeof(configs[0]);
+
+struct MockCamera
+{
+    int width;
+    int height;
+    double bandwidth;
+    bool color;
+
+    int roiW {0}, roiH {0}, bin {1};
+    int startX {0}, startY {0};
+    POAImgFormat format {POA_RAW8};
+    long gain {0}, offset {12}, usbLimit {90};
+    double exposureUs {10000};
+    bool opened {false};
+
+    // one frame of the largest format, the SDK's own buffer
+    std::vector<uint8_t> sensor;
+
+    SDKMock::FrameClock frames;
+    bool single {false};
+    SDKMock::Counters counters;
+
+    std::mutex lock;
+} camera;
+
+bool configured = false;
+
+void configure()
+{
+    if (configured)
+        return;
+    configured       = true;
+    camera.width     = SDKMock::env("PLAYERONE_MOCK_WIDTH", 1920);
+    camera.height    = SDKMock::env("PLAYERONE_MOCK_HEIGHT", 1080);
+    camera.bandwidth = std::max(SDKMock::env("PLAYERONE_MOCK_BANDWIDTH", 300.0), 0.001);
+    camera.color     = SDKMock::env("PLAYERONE_MOCK_COLOR", 1) != 0;
+    camera.roiW      = camera.width;
+    camera.roiH      = camera.height;
+}
+
+size_t bytesPerPixel(POAImgFormat format)
+{
+    switch (format)
+    {
+        case POA_RGB24: return 3;
+        case POA_RAW16: return 2;
+        default:        return 1;
+    }
+}
+
+size_t frameBytes()
+{
+    return static_cast<size_t>(camera.roiW) * camera.roiH * bytesPerPixel(camera.format);
+}
+
+POAErrors checkCamera(int nCameraID)
+{
+    if (nCameraID != 0)
+        return POA_ERROR_INVALID_ID;
+    return camera.opened ? POA_OK : POA_ERROR_NOT_OPENED;
+}
+
+const POAConfigAttributes *findConfig(POAConfig id)
+{
+    for (const auto &config : configs)
+        if (config.configID == id)
+            return &config;
+    return nullptr;
+}
+}
+
+extern "C" void POAMockGetStats(SDKMock::Stats *stats)
+{
+    camera.counters.get(stats);
+}
+
+extern "C" void POAMockResetStats()
+{
+    camera.counters.reset();
+}
+
+int POAGetCameraCount()
+{
+    configure();
+    return 1;
+}
+
+POAErrors POAGetCameraProperties(int nIndex, POACameraProperties *pProp)
+{
+    if (nIndex != 0)
+        return POA_ERROR_INVALID_INDEX;
+    return POAGetCameraPropertiesByID(0, pProp);
+}
+
+POAErrors POAGetCameraPropertiesByID(int nCameraID, POACameraProperties *pProp)
+{
+    if (nCameraID != 0)
+        return POA_ERROR_INVALID_ID;
+    configure();
+
+    memset(pProp, 0, sizeof(*pProp));
+    snprintf(pProp->cameraModelName, sizeof(pProp->cameraModelName), "PlayerOne Mock %dx%d", camera.width, camera.height);
+    snprintf(pProp->SN, sizeof(pProp->SN), "MOCK0001");
+    pProp->cameraID      = 0;
+    pProp->maxWidth      = camera.width;
+    pProp->maxHeight     = camera.height;
+    pProp->bitDepth      = 12;
+    pProp->isColorCamera = camera.color ? POA_TRUE : POA_FALSE;
+    pProp->isHasST4Port  = POA_TRUE;
+    pProp->isUSB3Speed   = POA_TRUE;
+    pProp->bayerPattern  = camera.color ? POA_BAYER_RG : POA_BAYER_MONO;
+    pProp->pixelSize     = 2.9;
+    pProp->bins[0]       = 1;
+    pProp->bins[1]       = 2;
+    pProp->imgFormats[0] = POA_RAW8;
+    pProp->imgFormats[1] = POA_RAW16;
+    pProp->imgFormats[2] = POA_RGB24;
+    pProp->imgFormats[3] = POA_MONO8;
+    pProp->imgFormats[4] = POA_END;
+    return POA_OK;
+}
+
+POAErrors POAOpenCamera(int nCameraID)
+{
+    if (nCameraID != 0)
+        return POA_ERROR_INVALID_ID;
+    configure();
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    // a horizontal gradient growing with the line number, so that a wrong flip or R/B swap is visible
+    camera.sensor.resize(static_cast<size_t>(camera.width) * camera.height * 3);
+    for (size_t i = 0; i < camera.sensor.size(); i++)
+        camera.sensor[i] = static_cast<uint8_t>(i % 251 + i / (camera.width * 3));
+    camera.opened = true;
+    return POA_OK;
+}
+
+POAErrors POAInitCamera(int nCameraID)
+{
+    return checkCamera(nCameraID);
+}
+
+POAErrors POACloseCamera(int nCameraID)
+{
+    if (nCameraID != 0)
+        return POA_ERROR_INVALID_ID;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.opened = false;
+    camera.frames.clear();
+    return POA_OK;
+}
+
+POAErrors POAGetConfigsCount(int nCameraID, int *pConfCount)
+{
+    *pConfCount = configCount;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetConfigAttributes(int nCameraID, int nConfIndex, POAConfigAttributes *pConfAttr)
+{
+    if (nConfIndex < 0 || nConfIndex >= configCount)
+        return POA_ERROR_INVALID_INDEX;
+    *pConfAttr = configs[nConfIndex];
+    return checkCamera(nCameraID);
+}
+
+POAErrors POASetConfig(int nCameraID, POAConfig confID, POAConfigValue confValue, POABool)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    switch (confID)
+    {
+        case POA_EXPOSURE:
+            camera.exposureUs = std::max(confValue.intValue, 10L);
+            break;
+        case POA_EXP:
+            camera.exposureUs = std::max(confValue.floatValue, 0.00001) * 1e6;
+            break;
+        case POA_GAIN:
+            camera.gain = confValue.intValue;
+            break;
+        case POA_OFFSET:
+            camera.offset = confValue.intValue;
+            break;
+        case POA_USB_BANDWIDTH_LIMIT:
+            camera.usbLimit = confValue.intValue;
+            break;
+        // guiding and flips are accepted and ignored
+        case POA_GUIDE_NORTH:
+        case POA_GUIDE_SOUTH:
+        case POA_GUIDE_EAST:
+        case POA_GUIDE_WEST:
+        case POA_FLIP_NONE:
+        case POA_FLIP_HORI:
+        case POA_FLIP_VERT:
+        case POA_FLIP_BOTH:
+            break;
+        default:
+            return POA_ERROR_INVALID_CONFIG;
+    }
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetConfig(int nCameraID, POAConfig confID, POAConfigValue *pConfValue, POABool *pIsAuto)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *pIsAuto = POA_FALSE;
+    switch (confID)
+    {
+        case POA_EXPOSURE:
+            pConfValue->intValue = static_cast<long>(camera.exposureUs);
+            break;
+        case POA_EXP:
+            pConfValue->floatValue = camera.exposureUs / 1e6;
+            break;
+        case POA_GAIN:
+            pConfValue->intValue = camera.gain;
+            break;
+        case POA_OFFSET:
+            pConfValue->intValue = camera.offset;
+            break;
+        case POA_USB_BANDWIDTH_LIMIT:
+            pConfValue->intValue = camera.usbLimit;
+            break;
+        case POA_TEMPERATURE:
+            pConfValue->floatValue = 20;
+            break;
+        default:
+            return findConfig(confID) ? POA_ERROR_CONF_CANNOT_READ : POA_ERROR_INVALID_CONFIG;
+    }
+    return checkCamera(nCameraID);
+}
+
+POAErrors POASetImageStartPos(int nCameraID, int startX, int startY)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (startX < 0 || startY < 0 || startX + camera.roiW > camera.width / camera.bin ||
+            startY + camera.roiH > camera.height / camera.bin)
+        return POA_ERROR_OUT_OF_LIMIT;
+    camera.startX = startX;
+    camera.startY = startY;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetImageSize(int nCameraID, int *pWidth, int *pHeight)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *pWidth  = camera.roiW;
+    *pHeight = camera.roiH;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POASetImageSize(int nCameraID, int width, int height)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.frames.running())
+        return POA_ERROR_EXPOSING;
+    if (width <= 0 || height <= 0 || width * camera.bin > camera.width || height * camera.bin > camera.height ||
+            width % 4 != 0 || height % 2 != 0)
+        return POA_ERROR_OUT_OF_LIMIT;
+    camera.roiW = width;
+    camera.roiH = height;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetImageBin(int nCameraID, int *pBin)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *pBin = camera.bin;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POASetImageBin(int nCameraID, int bin)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.frames.running())
+        return POA_ERROR_EXPOSING;
+    if (bin < 1 || bin > 2)
+        return POA_ERROR_INVALID_ARGU;
+    // like the SDK, the image size follows the bin
+    camera.roiW = std::min(camera.roiW * camera.bin / bin, camera.width / bin) & ~3;
+    camera.roiH = std::min(camera.roiH * camera.bin / bin, camera.height / bin) & ~1;
+    camera.bin  = bin;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetImageFormat(int nCameraID, POAImgFormat *pImgFormat)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *pImgFormat = camera.format;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POASetImageFormat(int nCameraID, POAImgFormat imgFormat)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.frames.running())
+        return POA_ERROR_EXPOSING;
+    if (imgFormat < POA_RAW8 || imgFormat > POA_MONO8)
+        return POA_ERROR_INVALID_ARGU;
+    camera.format = imgFormat;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAStartExposure(int nCameraID, POABool bSingleFrame)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.frames.running())
+        return POA_ERROR_EXPOSING;
+
+    auto exposure = std::chrono::microseconds(static_cast<int64_t>(camera.exposureUs));
+    auto transfer = SDKMock::transferTime(frameBytes(), camera.bandwidth);
+    camera.single = bSingleFrame == POA_TRUE;
+    // a single frame is exposed, then sent; in video mode the next frame is exposed while one is sent
+    camera.frames.start(camera.single ? exposure + transfer : std::max<Clock::duration>(exposure, transfer), camera.single);
+    camera.counters.exposures++;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAStopExposure(int nCameraID)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.frames.stop();
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetCameraState(int nCameraID, POACameraState *pCameraState)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.counters.statusPolls++;
+    if (!camera.opened)
+        *pCameraState = STATE_CLOSED;
+    else if (camera.frames.running() && !(camera.single && camera.frames.ready()))
+        *pCameraState = STATE_EXPOSING;
+    else
+        *pCameraState = STATE_OPENED;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAImageReady(int nCameraID, POABool *pIsReady)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.counters.statusPolls++;
+    *pIsReady = camera.frames.ready() ? POA_TRUE : POA_FALSE;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetImageData(int nCameraID, unsigned char *pBuf, long lBufSize, int nTimeoutms)
+{
+    std::unique_lock<std::mutex> guard(camera.lock);
+    size_t length = frameBytes();
+    if (lBufSize < static_cast<long>(length))
+        return POA_ERROR_SIZE_LESS;
+
+    // wait for a frame not read yet
+    if (!camera.frames.ready())
+    {
+        if (!camera.frames.pending())
+            return POA_ERROR_EXPOSURE_FAILED;
+
+        Clock::time_point next = camera.frames.next();
+        if (nTimeoutms >= 0 && next > Clock::now() + std::chrono::milliseconds(nTimeoutms))
+        {
+            guard.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(nTimeoutms));
+            return POA_ERROR_TIMEOUT;
+        }
+        guard.unlock();
+        std::this_thread::sleep_until(next);
+        guard.lock();
+        if (!camera.frames.ready())
+            return POA_ERROR_EXPOSURE_FAILED;
+    }
+
+    uint64_t skipped = camera.frames.take();
+    memcpy(pBuf, camera.sensor.data(), length);
+    camera.counters.bytesCopied += length;
+    if (camera.single)
+        camera.counters.downloads++;
+    else
+    {
+        camera.counters.videoSkipped += skipped;
+        camera.counters.videoFrames++;
+    }
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetSensorModeCount(int nCameraID, int *pModeCount)
+{
+    *pModeCount = 0;
+    return checkCamera(nCameraID);
+}
+
+POAErrors POAGetSensorModeInfo(int, int, POASensorModeInfo *)
+{
+    return POA_ERROR_INVALID_INDEX;
+}
+
+POAErrors POASetSensorMode(int, int)
+{
+    return POA_ERROR_INVALID_INDEX;
+}
+
+POAErrors POAGetSensorMode(int, int *)
+{
+    return POA_ERROR_INVALID_INDEX;
+}
+
+const char *POAGetSDKVersion()
+{
+    return "3.8.0 (mock)";
+}
@@ -120,15 +120,31 @@ bool POABase::isImgDataAvailable()
 }
 
 
-bool POABase::getImageData(unsigned char *pDataBuffer, unsigned long size)
+CameraPipeline::ReadStatus POAPipelineTraits::readVideo(uint8_t *buffer, size_t bytes)
 {
-    long exposureUs = getExposure();
-    POAErrors error = POAGetImageData(mCameraInfo.cameraID, pDataBuffer, size, exposureUs /1000 + 500);
+    // Poll until the frame is ready, yielding between polls instead of spinning a core at 100%.
+    POABool pIsReady = POA_FALSE;
+    for (int polls = 0; polls < waitMS * 2; polls++)
+    {
+        POAImageReady(cameraID, &pIsReady);
+        if (pIsReady == POA_TRUE)
+            break;
+        usleep(500);
+    }
+    if (pIsReady == POA_FALSE)
+        return CameraPipeline::ReadStatus::Timeout;
 
-    if (error != POA_OK )
-        LOGF_ERROR("GetImageData failed:  (%s).", Helpers::toString(error));
+    error = POAGetImageData(cameraID, buffer, bytes, waitMS);
+    if (error == POA_OK)
+        return CameraPipeline::ReadStatus::Ok;
+    return error == POA_ERROR_TIMEOUT ? CameraPipeline::ReadStatus::Timeout : CameraPipeline::ReadStatus::Failed;
+}
 
-    return error == POA_OK ? true : false;
+/* Blocking, waits exposure + 500 ms */
+CameraPipeline::ReadStatus POAPipelineTraits::readImage(uint8_t *buffer, size_t bytes)
+{
+    error = POAGetImageData(cameraID, buffer, bytes, waitMS);
+    return error == POA_OK ? CameraPipeline::ReadStatus::Ok : CameraPipeline::ReadStatus::Failed;
 }
 
 bool POABase::stopExposure()
@@ -170,42 +186,21 @@ void POABase::workerStreamVideo(const std::atomic_bool &isAbortToQuit)
         LOGF_ERROR("Failed to start video capture (%s).", Helpers::toString(ret));
     }
 
-    uint8_t *targetFrame = PrimaryCCD.getFrameBuffer();
-    uint32_t totalBytes  = PrimaryCCD.getFrameBufferSize();
-    int waitMS           = static_cast<int>((ExposureRequest * 1000.0) + 500);
+    POAPipelineTraits &sdk = mPipeline.traits();
+    sdk.cameraID = mCameraInfo.cameraID;
+    sdk.waitMS   = static_cast<int>((ExposureRequest * 1000.0) + 500);
 
-    while (!isAbortToQuit)
+    bool ok = mPipeline.stream(isAbortToQuit, PrimaryCCD.getFrameBufferSize(), mCurrentVideoFormat == POA_RGB24 ? 3 : 0,
+                               [this](const uint8_t *frame, size_t bytes)
     {
-        POABool pIsReady = POA_FALSE;
-        while (pIsReady == POA_FALSE)
-        {
-            //if (isAbortToQuit) //Triggered by external conditions
-            //    break;
-
-            //usleep(ExposureRequest / 10);
-            POAImageReady(mCameraInfo.cameraID, &pIsReady);
-        }
-
-        ret = POAGetImageData(mCameraInfo.cameraID, targetFrame, totalBytes, waitMS);
-        if (ret != POA_OK)
-        {
-            if (ret != POA_ERROR_TIMEOUT)
-            {
-                Streamer->setStream(false);
-                LOGF_ERROR("Failed to read video data (%s).", Helpers::toString(ret));
-                break;
-            }
-
-            usleep(100);
-            continue;
-        }
-
-        if (mCurrentVideoFormat == POA_RGB24)
-            for (uint32_t i = 0; i < totalBytes; i += 3)
-                std::swap(targetFrame[i], targetFrame[i + 2]);
-
-        Streamer->newFrame(targetFrame, totalBytes);
+        Streamer->newFrame(frame, bytes);
+    });
+    if (!ok)
+    {
+        Streamer->setStream(false);
+        LOGF_ERROR("Failed to read video data (%s).", Helpers::toString(sdk.error));
     }
+    LOGF_DEBUG("Stream stopped: %s.", mPipeline.streamStats().summary().c_str());
 
     // stop video capture
     POAStopExposure(mCameraInfo.cameraID);
@@ -1278,58 +1273,28 @@ bool POABase::UpdateCCDBin(int binx, int biny)
  N.B. No processing is done on the image */
 int POABase::grabImage(float duration)
 {
-
-
     POAImgFormat type = getImageType();
 
     std::unique_lock<std::mutex> guard(ccdBufferLock);
     uint8_t *image = PrimaryCCD.getFrameBuffer();
-    uint8_t *buffer = image;
 
     uint16_t subW = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
     uint16_t subH = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
     int nChannels = (type == POA_RGB24) ? 3 : 1;
     size_t nTotalBytes = subW * subH * nChannels * (PrimaryCCD.getBPP() / 8);
 
-    if (type == POA_RGB24)
-    {
-        buffer = static_cast<uint8_t *>(malloc(nTotalBytes));
-        if (buffer == nullptr)
-        {
-            LOGF_ERROR("%s: %d malloc failed (RGB 24).", getDeviceName());
-            return -1;
-        }
-    }
-
-    /* getImageData:Blocking function wait exposure+500ms */
-    if (!getImageData(buffer,nTotalBytes))
+    POAPipelineTraits &sdk = mPipeline.traits();
+    sdk.cameraID = mCameraInfo.cameraID;
+    sdk.waitMS   = static_cast<int>(getExposure() / 1000 + 500);
+    if (mPipeline.download(image, nTotalBytes, subW * subH, type == POA_RGB24 ? 3 : 0) != CameraPipeline::ReadStatus::Ok)
     {
-        LOG_ERROR("getImageData failed ");
-        if (type == POA_RGB24)
-            free(buffer);
+        LOGF_ERROR("GetImageData failed:  (%s).", Helpers::toString(sdk.error));
         return -1;
     }
-
-    if (type == POA_RGB24)
-    {
-        uint8_t *dstR = image;
-        uint8_t *dstG = image + subW * subH;
-        uint8_t *dstB = image + subW * subH * 2;
-
-        const uint8_t *src = buffer;
-        const uint8_t *end = buffer + subW * subH * 3;
-
-        while (src != end)
-        {
-            *dstB++ = *src++;
-            *dstG++ = *src++;
-            *dstR++ = *src++;
-        }
-
-        free(buffer);
-    }
     guard.unlock();
 
+    LOGF_DEBUG("Download took %.0f ms.", mPipeline.lastDownloadMS());
+
     PrimaryCCD.setNAxis(type == POA_RGB24 ? 3 : 2);
 
     // If mono camera or we're sending Luma or RGB, turn off bayering
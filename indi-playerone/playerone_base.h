@@ -26,6 +26,7 @@
 #include "indipropertynumber.h"
 #include "indipropertytext.h"
 #include "indisinglethreadpool.h"
+#include "camera_pipeline.h"
 
 #include <vector>
 
@@ -33,6 +34,17 @@
 #include <inditimer.h>
 
 class SingleWorker;
+/* SDK calls used by the shared download and streaming pipeline */
+struct POAPipelineTraits
+{
+    int cameraID {0};
+    int waitMS {0};
+    POAErrors error {POA_OK};
+
+    CameraPipeline::ReadStatus readVideo(uint8_t *buffer, size_t bytes);
+    CameraPipeline::ReadStatus readImage(uint8_t *buffer, size_t bytes);
+};
+
 class POABase : public INDI::CCD
 {
     public:
@@ -150,9 +162,6 @@ class POABase : public INDI::CCD
         /** Check if image data is available */
         bool isImgDataAvailable();
 
-        /** Get Image Data */
-        bool getImageData(unsigned char *pDataBuffer, unsigned long size);
-
         /** Compatibilities for ZWO cameras */
         POAErrors POASetROIFormat(int CameraID, int width, int height, int bin, POAImgFormat imgType);
         POAErrors POAGetROIFormat(int CameraID, int *width, int *height, int *bin, POAImgFormat *imgType);
@@ -194,6 +203,7 @@ class POABase : public INDI::CCD
         POACameraProperties mCameraInfo;
         uint8_t mExposureRetry {0};
         POAImgFormat                      mCurrentVideoFormat;
+        CameraPipeline::Pipeline<POAPipelineTraits> mPipeline {POAPipelineTraits()};
         std::vector<POAConfigAttributes>  mControlCaps;
 
 
@@ -0,0 +1,60 @@
+/*
+    PlayerOne CCD Driver - download benchmark
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+    Offline benchmark of the PlayerOne download path, see common/ccd_benchmark.h.
+
+    The real POABase (playerone_base.cpp) is linked against the mock libPlayerOneCamera in mock/,
+    memcpy calls are counted in playerone_base.cpp.
+*/
+
+#include "playerone_base.h"
+#include "playerone_mock.h"
+#include "ccd_benchmark.h"
+
+/**
+ * @brief POABase on the first mock camera.
+ */
+class BenchmarkPOA : public CCDBenchmark::Camera<POABase>
+{
+    public:
+        BenchmarkPOA()
+        {
+            POAGetCameraProperties(0, &mCameraInfo);
+            mCameraName = mCameraInfo.cameraModelName;
+            setDeviceName("PlayerOne CCD Benchmark");
+        }
+
+        static bool listed()
+        {
+            return POAGetCameraCount() > 0;
+        }
+};
+
+static const CCDBenchmark::Format formats[] =
+{
+    { "raw8",  "POA_RAW8",  1 },
+    { "raw16", "POA_RAW16", 2 },
+    { "rgb24", "POA_RGB24", 3 },
+};
+
+int main(int argc, char *argv[])
+{
+    const CCDBenchmark::Driver driver = { "indi_playerone_ccd", "PLAYERONE", formats, 3, POAMockGetStats, POAMockResetStats };
+    return CCDBenchmark::run<BenchmarkPOA>(argc, argv, driver);
+}
@@ -0,0 +1,523 @@
+/*
+ QHY INDI Driver - mock libqhyccd
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ libqhyccd for qhy_download_benchmark, see common/README.md. One 16 bit colour camera is
+ enumerated, 1920 x 1080 and 300 MB/s unless set otherwise, without filter wheel, cooler or GPS.
+
+ ExpQHYCCDSingleFrame starts an exposure, GetQHYCCDSingleFrame blocks until it has been exposed
+ and has crossed the USB link and copies it out of the SDK's buffer. In live mode the camera
+ finishes a frame per exposure time (or per transfer time, if longer) whether it is read or not,
+ GetQHYCCDLiveFrame returns the newest frame not read yet or fails at once if there is none.
+*/
+
+#include <qhyccd.h>
+#include "qhy_mock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+#define MOCK_CAMERA_ID "QHY600M-MOCK0001"
+
+namespace
+{
+struct MockCamera
+{
+    uint32_t width;
+    uint32_t height;
+    double bandwidth;
+    bool color;
+
+    uint32_t roiX {0}, roiY {0}, roiW {0}, roiH {0}, bin {1};
+    uint32_t bits {16};
+    uint8_t streamMode {0};
+    double values[CONTROL_MAX_ID] {};
+    bool opened {false};
+
+    // one frame of the largest format, the SDK's own buffer
+    std::vector<uint8_t> sensor;
+
+    SDKMock::FrameClock frames;
+    bool live {false};
+    SDKMock::Counters counters;
+
+    std::mutex lock;
+} camera;
+
+bool configured = false;
+
+void configure()
+{
+    if (configured)
+        return;
+    configured       = true;
+    camera.width     = SDKMock::env("QHY_MOCK_WIDTH", 1920);
+    camera.height    = SDKMock::env("QHY_MOCK_HEIGHT", 1080);
+    camera.bandwidth = std::max(SDKMock::env("QHY_MOCK_BANDWIDTH", 300.0), 0.001);
+    camera.color     = SDKMock::env("QHY_MOCK_COLOR", 1) != 0;
+    camera.roiW      = camera.width;
+    camera.roiH      = camera.height;
+    camera.values[CONTROL_EXPOSURE]   = 1000;
+    camera.values[CONTROL_GAIN]       = 0;
+    camera.values[CONTROL_OFFSET]     = 10;
+    camera.values[CONTROL_USBTRAFFIC] = 30;
+    camera.values[CONTROL_CURTEMP]    = 20;
+}
+
+size_t frameBytes()
+{
+    return static_cast<size_t>(camera.roiW) * camera.roiH * camera.bits / 8;
+}
+
+Clock::duration exposureTime()
+{
+    return std::chrono::microseconds(static_cast<int64_t>(camera.values[CONTROL_EXPOSURE]));
+}
+
+uint32_t checkCamera(qhyccd_handle *handle)
+{
+    return handle == &camera && camera.opened ? QHYCCD_SUCCESS : QHYCCD_ERROR;
+}
+
+void copyFrame(uint32_t *w, uint32_t *h, uint32_t *bpp, uint32_t *channels, uint8_t *imgdata)
+{
+    size_t length = frameBytes();
+    memcpy(imgdata, camera.sensor.data(), length);
+    camera.counters.bytesCopied += length;
+    *w        = camera.roiW;
+    *h        = camera.roiH;
+    *bpp      = camera.bits;
+    *channels = 1;
+}
+}
+
+extern "C" void QHYMockGetStats(SDKMock::Stats *stats)
+{
+    camera.counters.get(stats);
+}
+
+extern "C" void QHYMockResetStats()
+{
+    camera.counters.reset();
+}
+
+void SetQHYCCDLogLevel(uint8_t)
+{
+}
+
+void SetQHYCCDLogFunction(std::function<void(const std::string &message)>)
+{
+}
+
+void SetQHYCCDBufferNumber(uint32_t)
+{
+}
+
+void EnableQHYCCDMessage(bool)
+{
+}
+
+void EnableQHYCCDLogFile(bool)
+{
+}
+
+uint32_t InitQHYCCDResource()
+{
+    configure();
+    return QHYCCD_SUCCESS;
+}
+
+uint32_t ReleaseQHYCCDResource()
+{
+    return QHYCCD_SUCCESS;
+}
+
+uint32_t ScanQHYCCD()
+{
+    configure();
+    return 1;
+}
+
+uint32_t GetQHYCCDId(uint32_t index, char *id)
+{
+    if (index != 0)
+        return QHYCCD_ERROR;
+    strcpy(id, MOCK_CAMERA_ID);
+    return QHYCCD_SUCCESS;
+}
+
+uint32_t GetQHYCCDModel(char *, char *model)
+{
+    strcpy(model, "QHY600M");
+    return QHYCCD_SUCCESS;
+}
+
+uint32_t GetQHYCCDSDKVersion(uint32_t *year, uint32_t *month, uint32_t *day, uint32_t *subday)
+{
+    *year   = 24;
+    *month  = 1;
+    *day    = 1;
+    *subday = 0;
+    return QHYCCD_SUCCESS;
+}
+
+qhyccd_handle *OpenQHYCCD(char *id)
+{
+    if (strcmp(id, MOCK_CAMERA_ID) != 0)
+        return nullptr;
+    configure();
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    // a horizontal gradient growing with the line number, so that a wrong flip is visible
+    camera.sensor.resize(static_cast<size_t>(camera.width) * camera.height * 2);
+    for (size_t i = 0; i < camera.sensor.size(); i++)
+        camera.sensor[i] = static_cast<uint8_t>(i % 251 + i / (camera.width * 2));
+    camera.opened = true;
+    return &camera;
+}
+
+uint32_t CloseQHYCCD(qhyccd_handle *handle)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    uint32_t rc = checkCamera(handle);
+    camera.opened = false;
+    camera.frames.clear();
+    return rc;
+}
+
+uint32_t InitQHYCCD(qhyccd_handle *handle)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.frames.clear();
+    camera.live = false;
+    return checkCamera(handle);
+}
+
+uint32_t SetQHYCCDStreamMode(qhyccd_handle *handle, uint8_t mode)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.streamMode = mode;
+    return checkCamera(handle);
+}
+
+uint32_t IsQHYCCDControlAvailable(qhyccd_handle *handle, CONTROL_ID controlId)
+{
+    if (checkCamera(handle) != QHYCCD_SUCCESS)
+        return QHYCCD_ERROR;
+
+    switch (controlId)
+    {
+        case CAM_COLOR:
+            return camera.color ? static_cast<uint32_t>(BAYER_RG) : QHYCCD_ERROR;
+        case CAM_BIN1X1MODE:
+        case CAM_BIN2X2MODE:
+        case CAM_LIVEVIDEOMODE:
+        case CAM_SINGLEFRAMEMODE:
+        case CONTROL_ST4PORT:
+        case CONTROL_EXPOSURE:
+        case CONTROL_GAIN:
+        case CONTROL_OFFSET:
+        case CONTROL_USBTRAFFIC:
+            return QHYCCD_SUCCESS;
+        default:
+            return QHYCCD_ERROR;
+    }
+}
+
+uint32_t GetQHYCCDParamMinMaxStep(qhyccd_handle *handle, CONTROL_ID controlId, double *min, double *max, double *step)
+{
+    *step = 1;
+    switch (controlId)
+    {
+        case CONTROL_EXPOSURE:
+            *min = 1;
+            *max = 3600e6;
+            break;
+        case CONTROL_GAIN:
+            *min = 0;
+            *max = 200;
+            break;
+        case CONTROL_OFFSET:
+            *min = 0;
+            *max = 255;
+            break;
+        case CONTROL_USBTRAFFIC:
+            *min = 0;
+            *max = 60;
+            break;
+        default:
+            return QHYCCD_ERROR;
+    }
+    return checkCamera(handle);
+}
+
+double GetQHYCCDParam(qhyccd_handle *handle, CONTROL_ID controlId)
+{
+    if (checkCamera(handle) != QHYCCD_SUCCESS || controlId < 0 || controlId >= CONTROL_MAX_ID)
+        return QHYCCD_ERROR;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    return camera.values[controlId];
+}
+
+uint32_t SetQHYCCDParam(qhyccd_handle *handle, CONTROL_ID controlId, double value)
+{
+    if (controlId < 0 || controlId >= CONTROL_MAX_ID)
+        return QHYCCD_ERROR;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.values[controlId] = value;
+    return checkCamera(handle);
+}
+
+uint32_t GetQHYCCDNumberOfReadModes(qhyccd_handle *handle, uint32_t *numModes)
+{
+    *numModes = 1;
+    return checkCamera(handle);
+}
+
+uint32_t GetQHYCCDReadModeName(qhyccd_handle *handle, uint32_t modeNumber, char *name)
+{
+    if (modeNumber != 0)
+        return QHYCCD_ERROR;
+    strcpy(name, "STANDARD MODE");
+    return checkCamera(handle);
+}
+
+uint32_t GetQHYCCDReadModeResolution(qhyccd_handle *handle, uint32_t modeNumber, uint32_t *width, uint32_t *height)
+{
+    if (modeNumber != 0)
+        return QHYCCD_ERROR;
+    *width  = camera.width;
+    *height = camera.height;
+    return checkCamera(handle);
+}
+
+uint32_t GetQHYCCDReadMode(qhyccd_handle *handle, uint32_t *modeNumber)
+{
+    *modeNumber = 0;
+    return checkCamera(handle);
+}
+
+uint32_t SetQHYCCDReadMode(qhyccd_handle *handle, uint32_t modeNumber)
+{
+    return modeNumber == 0 ? checkCamera(handle) : QHYCCD_ERROR;
+}
+
+uint32_t GetQHYCCDChipInfo(qhyccd_handle *h, double *chipw, double *chiph, uint32_t *imagew, uint32_t *imageh,
+                           double *pixelw, double *pixelh, uint32_t *bpp)
+{
+    *pixelw = *pixelh = 3.76;
+    *imagew = camera.width;
+    *imageh = camera.height;
+    *chipw  = camera.width * *pixelw / 1000;
+    *chiph  = camera.height * *pixelh / 1000;
+    *bpp    = 16;
+    return checkCamera(h);
+}
+
+uint32_t GetQHYCCDEffectiveArea(qhyccd_handle *h, uint32_t *startX, uint32_t *startY, uint32_t *sizeX, uint32_t *sizeY)
+{
+    *startX = 0;
+    *startY = 0;
+    *sizeX  = camera.width;
+    *sizeY  = camera.height;
+    return checkCamera(h);
+}
+
+uint32_t GetQHYCCDOverScanArea(qhyccd_handle *h, uint32_t *startX, uint32_t *startY, uint32_t *sizeX, uint32_t *sizeY)
+{
+    *startX = *startY = *sizeX = *sizeY = 0;
+    return checkCamera(h);
+}
+
+uint32_t GetQHYCCDHumidity(qhyccd_handle *, double *)
+{
+    return QHYCCD_ERROR;
+}
+
+uint32_t SetQHYCCDBinMode(qhyccd_handle *handle, uint32_t wbin, uint32_t hbin)
+{
+    if (wbin != hbin || wbin < 1 || wbin > 2)
+        return QHYCCD_ERROR;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.bin = wbin;
+    return checkCamera(handle);
+}
+
+uint32_t SetQHYCCDResolution(qhyccd_handle *handle, uint32_t x, uint32_t y, uint32_t xsize, uint32_t ysize)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (xsize == 0 || ysize == 0 || (x + xsize) * camera.bin > camera.width || (y + ysize) * camera.bin > camera.height)
+        return QHYCCD_ERROR;
+    camera.roiX = x;
+    camera.roiY = y;
+    camera.roiW = xsize;
+    camera.roiH = ysize;
+    return checkCamera(handle);
+}
+
+uint32_t SetQHYCCDBitsMode(qhyccd_handle *handle, uint32_t bits)
+{
+    if (bits != 8 && bits != 16)
+        return QHYCCD_ERROR;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.bits = bits;
+    return checkCamera(handle);
+}
+
+uint32_t ExpQHYCCDSingleFrame(qhyccd_handle *handle)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.live)
+        return QHYCCD_ERROR;
+
+    // the frame is exposed, then sent
+    camera.frames.start(exposureTime() + SDKMock::transferTime(frameBytes(), camera.bandwidth), true);
+    camera.counters.exposures++;
+    return checkCamera(handle);
+}
+
+uint32_t GetQHYCCDSingleFrame(qhyccd_handle *handle, uint32_t *w, uint32_t *h, uint32_t *bpp, uint32_t *channels,
+                              uint8_t *imgdata)
+{
+    std::unique_lock<std::mutex> guard(camera.lock);
+    camera.counters.statusPolls++;
+    if (camera.live || !camera.frames.pending())
+        return QHYCCD_ERROR;
+
+    // blocks until the frame has been read out
+    if (!camera.frames.ready())
+    {
+        Clock::time_point next = camera.frames.next();
+        guard.unlock();
+        std::this_thread::sleep_until(next);
+        guard.lock();
+        if (!camera.frames.ready())
+            return QHYCCD_ERROR;
+    }
+
+    camera.frames.take();
+    copyFrame(w, h, bpp, channels, imgdata);
+    camera.counters.downloads++;
+    return checkCamera(handle);
+}
+
+uint32_t CancelQHYCCDExposingAndReadout(qhyccd_handle *handle)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (!camera.live)
+        camera.frames.clear();
+    return checkCamera(handle);
+}
+
+uint32_t BeginQHYCCDLive(qhyccd_handle *handle)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.streamMode != 1)
+        return QHYCCD_ERROR;
+
+    // the next frame is exposed while one is sent
+    camera.live = true;
+    camera.frames.start(std::max<Clock::duration>(exposureTime(), SDKMock::transferTime(frameBytes(), camera.bandwidth)));
+    camera.counters.exposures++;
+    return checkCamera(handle);
+}
+
+uint32_t StopQHYCCDLive(qhyccd_handle *handle)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.live = false;
+    camera.frames.clear();
+    return checkCamera(handle);
+}
+
+uint32_t GetQHYCCDLiveFrame(qhyccd_handle *handle, uint32_t *w, uint32_t *h, uint32_t *bpp, uint32_t *channels,
+                            uint8_t *imgdata)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.counters.statusPolls++;
+    if (!camera.live || !camera.frames.ready())
+        return QHYCCD_ERROR;
+
+    camera.counters.videoSkipped += camera.frames.take();
+    copyFrame(w, h, bpp, channels, imgdata);
+    camera.counters.videoFrames++;
+    return checkCamera(handle);
+}
+
+uint32_t ControlQHYCCDGuide(qhyccd_handle *handle, uint32_t, uint16_t)
+{
+    return checkCamera(handle);
+}
+
+uint32_t ControlQHYCCDShutter(qhyccd_handle *handle, uint8_t)
+{
+    return checkCamera(handle);
+}
+
+uint32_t IsQHYCCDCFWPlugged(qhyccd_handle *)
+{
+    return QHYCCD_ERROR;
+}
+
+uint32_t GetQHYCCDCFWStatus(qhyccd_handle *, char *)
+{
+    return QHYCCD_ERROR;
+}
+
+uint32_t SendOrder2QHYCCDCFW(qhyccd_handle *, char *, uint32_t)
+{
+    return QHYCCD_ERROR;
+}
+
+uint32_t SetQHYCCDGPSVCOXFreq(qhyccd_handle *, uint16_t)
+{
+    return QHYCCD_ERROR;
+}
+
+uint32_t SetQHYCCDGPSLedCalMode(qhyccd_handle *, uint8_t)
+{
+    return QHYCCD_ERROR;
+}
+
+void SetQHYCCDGPSPOSA(qhyccd_handle *, uint8_t, uint32_t, uint8_t)
+{
+}
+
+void SetQHYCCDGPSPOSB(qhyccd_handle *, uint8_t, uint32_t, uint8_t)
+{
+}
+
+uint32_t SetQHYCCDGPSMasterSlave(qhyccd_handle *, uint8_t)
+{
+    return QHYCCD_ERROR;
+}
+
+void SetQHYCCDGPSSlaveModeParameter(qhyccd_handle *, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t)
+{
+}
@@ -32,12 +32,17 @@
 #include <math.h>
 #include <memory>
 #include <deque>
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
 
 #define UPDATE_THRESHOLD       0.05   /* Differential temperature threshold (C)*/
 
 //NB Disable for real driver
 //#define USE_SIMULATION
 
+// The download benchmark creates its own camera on the mock SDK
+#ifndef QHY_DOWNLOAD_BENCHMARK
 static class Loader
 {
         std::shared_ptr<QHYCCDHotPlugHandler> hotPlugHandler;
@@ -49,6 +54,7 @@ static class Loader
             INDI::HotPlugManager::getInstance().start(1000); // Start hot-plug checks every 1 second
         }
 } loader;
+#endif
 
 QHYCCD::QHYCCD(const char *name, const char *camID) : FilterInterface(this)
 {
@@ -207,6 +213,12 @@ bool QHYCCD::initProperties()
     IUFillSwitchVector(&GPSControlSP, GPSControlS, 2, getDeviceName(), "GPS_CONTROL", "GPS Header", GPS_CONTROL_TAB,
                        IP_RW, ISR_1OFMANY, 0, IPS_IDLE);
 
+    // GPS timing sidecar
+    IUFillSwitch(&GPSSidecarS[INDI_ENABLED], "INDI_ENABLED", "Enable", ISS_OFF);
+    IUFillSwitch(&GPSSidecarS[INDI_DISABLED], "INDI_DISABLED", "Disable", ISS_ON);
+    IUFillSwitchVector(&GPSSidecarSP, GPSSidecarS, 2, getDeviceName(), "GPS_SIDECAR", "Timing Log", GPS_CONTROL_TAB,
+                       IP_RW, ISR_1OFMANY, 60, IPS_IDLE);
+
     /////////////////////////////////////////////////////////////////////////////
     /// Properties: GPS Data
     /////////////////////////////////////////////////////////////////////////////
@@ -319,6 +331,7 @@ void QHYCCD::ISGetProperties(const char *dev)
             defineProperty(&GPSLEDEndPosNP);
 
             defineProperty(&GPSControlSP);
+            defineProperty(&GPSSidecarSP);
 
             defineProperty(&GPSStateLP);
             defineProperty(&GPSDataHeaderTP);
@@ -547,6 +560,7 @@ bool QHYCCD::updateProperties()
             defineProperty(&GPSLEDStartPosNP);
             defineProperty(&GPSLEDEndPosNP);
             defineProperty(&GPSControlSP);
+            defineProperty(&GPSSidecarSP);
 
             defineProperty(&GPSStateLP);
             defineProperty(&GPSDataHeaderTP);
@@ -623,6 +637,7 @@ bool QHYCCD::updateProperties()
             deleteProperty(GPSLEDStartPosNP.name);
             deleteProperty(GPSLEDEndPosNP.name);
             deleteProperty(GPSControlSP.name);
+            deleteProperty(GPSSidecarSP.name);
 
             deleteProperty(GPSStateLP.name);
             deleteProperty(GPSDataHeaderTP.name);
@@ -1088,6 +1103,7 @@ bool QHYCCD::Disconnect()
     pthread_cond_signal(&cv);
     pthread_mutex_unlock(&condMutex);
     pthread_join(m_ImagingThread, nullptr);
+    closeGPSSidecar();
     //tState = StateNone;
     if (isSimulation() == false)
     {
@@ -1381,6 +1397,13 @@ bool QHYCCD::AbortExposure()
 
 bool QHYCCD::UpdateCCDFrame(int x, int y, int w, int h)
 {
+    // The streaming buffers are sized for the frame streaming or recording started with
+    if (Streamer->isBusy())
+    {
+        LOG_ERROR("Cannot change the frame while streaming/recording is active.");
+        return false;
+    }
+
     // Set UNBINNED coords
     PrimaryCCD.setFrame(x, y, w, h);
     // Total bytes required for image buffer
@@ -1405,6 +1428,11 @@ bool QHYCCD::UpdateCCDBin(int hor, int ver)
         LOG_ERROR("Invalid binning mode. Maximum theoritical binning is 4x4");
         return false;
     }
+    else if (Streamer->isBusy())
+    {
+        LOG_ERROR("Cannot change binning while streaming/recording is active.");
+        return false;
+    }
 
     auto supported = m_SupportedBins[hor - 1];
 
@@ -1706,6 +1734,19 @@ bool QHYCCD::ISNewSwitch(const char *dev, const char *name, ISState *states, cha
             return true;
         }
 
+        //////////////////////////////////////////////////////////////////////
+        /// GPS Timing Sidecar
+        //////////////////////////////////////////////////////////////////////
+        else if (!strcmp(GPSSidecarSP.name, name))
+        {
+            IUUpdateSwitch(&GPSSidecarSP, states, names, n);
+            GPSSidecarSP.s = IPS_OK;
+            LOGF_INFO("GPS timing log is %s. It is written next to SER recordings while streaming.",
+                      GPSSidecarS[INDI_ENABLED].s == ISS_ON ? "enabled" : "disabled");
+            IDSetSwitch(&GPSSidecarSP, nullptr);
+            return true;
+        }
+
         //////////////////////////////////////////////////////////////////////
         /// GPS Slaving Mode
         //////////////////////////////////////////////////////////////////////
@@ -1836,7 +1877,6 @@ bool QHYCCD::ISNewText(const char *dev, const char *name, char *texts[], char *n
         //  Now lets see if it's something we process here
         if (INDI::FilterInterface::processText(dev, name, texts, names, n))
             return true;
-
     }
 
     return INDI::CCD::ISNewText(dev, name, texts, names, n);
@@ -2288,6 +2328,7 @@ bool QHYCCD::saveConfigItems(FILE *fp)
     if (HasGPS)
     {
         IUSaveConfigSwitch(fp, &GPSControlSP);
+        IUSaveConfigSwitch(fp, &GPSSidecarSP);
         IUSaveConfigSwitch(fp, &GPSSlavingSP);
         IUSaveConfigNumber(fp, &VCOXFreqNP);
     }
@@ -2408,6 +2449,12 @@ bool QHYCCD::StartStreaming()
 
     //LOG_INFO("start live mode"); //DEBUG
 
+    // Capture into a rotating set of private buffers so a frame is never overwritten while it is being
+    // published, and the capture does not contend with the main thread for the primary frame buffer.
+    m_StreamBuffers.assign(STREAM_BUFFER_COUNT, std::vector<uint8_t>(PrimaryCCD.getFrameBufferSize()));
+    m_StreamBufferIndex = 0;
+    m_GPSPropertiesUpdate = std::chrono::steady_clock::time_point();
+
     LOGF_INFO("Starting video streaming with exposure %.f seconds (%.f FPS), w=%d h=%d", m_ExposureRequest,
               Streamer->getTargetFPS(), subW, subH);
     BeginQHYCCDLive(m_CameraHandle);
@@ -2430,6 +2477,8 @@ bool QHYCCD::StopStreaming()
     }
     pthread_mutex_unlock(&condMutex);
     StopQHYCCDLive(m_CameraHandle);
+    closeGPSSidecar();
+    m_StreamBuffers.clear();
 
     //LOG_INFO("stopped live mode"); //DEBUG
 
@@ -2514,8 +2563,8 @@ void QHYCCD::streamVideo()
     {
         pthread_mutex_unlock(&condMutex);
         uint32_t retries = 0;
-        std::unique_lock<std::mutex> guard(ccdBufferLock);
-        uint8_t *buffer = PrimaryCCD.getFrameBuffer();
+        uint8_t *buffer = m_StreamBuffers[m_StreamBufferIndex].data();
+        m_StreamBufferIndex = (m_StreamBufferIndex + 1) % m_StreamBuffers.size();
         while (retries++ < 10)
         {
 
@@ -2525,19 +2574,36 @@ void QHYCCD::streamVideo()
             else
                 break;
         }
-        guard.unlock();
         if (ret == QHYCCD_SUCCESS)
         {
             uint64_t timestamp = 0;
-            if (HasGPS && GPSControlS[INDI_ENABLED].s == ISS_ON)
+            bool gpsEnabled = HasGPS && GPSControlS[INDI_ENABLED].s == ISS_ON;
+            // Sample before newFrame(), which may stop the recording once its limits are reached.
+            bool recording = Streamer->isRecording();
+            if (gpsEnabled)
             {
-                decodeGPSHeader();
+                parseGPSHeader(buffer);
                 timestamp = (uint64_t)GPSHeader.start_sec * 1e6;
                 timestamp += GPSHeader.start_us + QHY_SER_US_EPOCH;
             }
 
             Streamer->newFrame(buffer, w * h * bpp / 8 * channels, timestamp);
 
+            if (gpsEnabled)
+            {
+                writeGPSSidecar(recording, timestamp);
+
+                // Text properties are only refreshed at a human readable rate.
+                auto now = std::chrono::steady_clock::now();
+                if (now - m_GPSPropertiesUpdate >= std::chrono::milliseconds(GPS_PROPERTIES_INTERVAL_MS))
+                {
+                    m_GPSPropertiesUpdate = now;
+                    updateGPSProperties();
+                }
+            }
+            else
+                closeGPSSidecar();
+
             //DEBUG
             //if(!frames)
             //    LOGF_DEBUG("Receiving frames ...");
@@ -2759,27 +2825,21 @@ void QHYCCD::setLEDStartPosNP(const INumberVectorProperty &value)
 
 void QHYCCD::decodeGPSHeader()
 {
-    char ts[64] = {0}, iso8601[64] = {0}, data[64] = {0};
-
-    uint8_t gpsarray[64] = {0};
-    memcpy(gpsarray, PrimaryCCD.getFrameBuffer(), 64);
+    parseGPSHeader(PrimaryCCD.getFrameBuffer());
+    updateGPSProperties();
+}
 
+void QHYCCD::parseGPSHeader(const uint8_t *gpsarray)
+{
     // Sequence Number
     GPSHeader.seqNumber = gpsarray[0] << 24 | gpsarray[1] << 16 | gpsarray[2] << 8 | gpsarray[3];
-    snprintf(data, 64, "%u", GPSHeader.seqNumber);
-    IUSaveText(&GPSDataHeaderT[GPS_DATA_SEQ_NUMBER], data);
-
     GPSHeader.tempNumber = gpsarray[4];
 
     // Width
     GPSHeader.width = gpsarray[5] << 8 | gpsarray[6];
-    snprintf(data, 64, "%u", GPSHeader.width);
-    IUSaveText(&GPSDataHeaderT[GPS_DATA_WIDTH], data);
 
     // Height
     GPSHeader.height = gpsarray[7] << 8 | gpsarray[8];
-    snprintf(data, 64, "%u", GPSHeader.height);
-    IUSaveText(&GPSDataHeaderT[GPS_DATA_HEIGHT], data);
 
     // Latitude
     uint32_t latitude = gpsarray[9] << 24 | gpsarray[10] << 16 | gpsarray[11] << 8 | gpsarray[12];
@@ -2787,8 +2847,6 @@ void QHYCCD::decodeGPSHeader()
     GPSHeader.latitude = (latitude % 1000000000) / 10000000;
     GPSHeader.latitude += (latitude % 10000000) / 6000000.0;
     GPSHeader.latitude *= latitude > 1000000000 ? -1.0 : 1.0;
-    snprintf(data, 64, "%f", GPSHeader.latitude);
-    IUSaveText(&GPSDataHeaderT[GPS_DATA_LATITUDE], data);
 
     // Longitude
     uint32_t longitude = gpsarray[13] << 24 | gpsarray[14] << 16 | gpsarray[15] << 8 | gpsarray[16];
@@ -2796,84 +2854,88 @@ void QHYCCD::decodeGPSHeader()
     GPSHeader.longitude = (longitude % 1000000000) / 1000000;
     GPSHeader.longitude += (longitude % 1000000) / 600000.0;
     GPSHeader.longitude *= longitude > 1000000000 ? -1.0 : 1.0;
-    snprintf(data, 64, "%f", GPSHeader.longitude);
-    IUSaveText(&GPSDataHeaderT[GPS_DATA_LONGITUDE], data);
 
     // Start Flag
     GPSHeader.start_flag = gpsarray[17];
-    snprintf(data, 64, "%u", GPSHeader.start_flag);
-    IUSaveText(&GPSDataStartT[GPS_DATA_START_FLAG], data);
-
     // Start Seconds
     GPSHeader.start_sec = gpsarray[18] << 24 | gpsarray[19] << 16 | gpsarray[20] << 8 | gpsarray[21];
-    snprintf(data, 64, "%u", GPSHeader.start_sec);
-    IUSaveText(&GPSDataStartT[GPS_DATA_START_SEC], data);
-
     // Start microseconds
     // It's a 10Mhz crystal so we divide by 10 to get microseconds
     GPSHeader.start_us = (gpsarray[22] << 16 | gpsarray[23] << 8 | gpsarray[24]) / 10.0;
+    GPSHeader.start_jd = JStoJD(GPSHeader.start_sec, GPSHeader.start_us);
+
+    // End Flag
+    GPSHeader.end_flag = gpsarray[25];
+    // End Seconds
+    GPSHeader.end_sec = gpsarray[26] << 24 | gpsarray[27] << 16 | gpsarray[28] << 8 | gpsarray[29];
+    // End Microseconds
+    GPSHeader.end_us = (gpsarray[30] << 16 | gpsarray[31] << 8 | gpsarray[32]) / 10.0;
+    GPSHeader.end_jd = JStoJD(GPSHeader.end_sec, GPSHeader.end_us);
+
+    // Now Flag
+    GPSHeader.now_flag = gpsarray[33];
+    // Now Seconds
+    GPSHeader.now_sec = gpsarray[34] << 24 | gpsarray[35] << 16 | gpsarray[36] << 8 | gpsarray[37];
+    // Now microseconds
+    GPSHeader.now_us = (gpsarray[38] << 16 | gpsarray[39] << 8 | gpsarray[40]) / 10.0;
+    GPSHeader.now_jd = JStoJD(GPSHeader.now_sec, GPSHeader.now_us);
+
+    // PPS
+    GPSHeader.max_clock = gpsarray[41] << 16 | gpsarray[42] << 8 | gpsarray[43];
+}
+
+void QHYCCD::updateGPSProperties()
+{
+    char ts[64] = {0}, iso8601[64] = {0}, data[64] = {0};
+
+    snprintf(data, 64, "%u", GPSHeader.seqNumber);
+    IUSaveText(&GPSDataHeaderT[GPS_DATA_SEQ_NUMBER], data);
+    snprintf(data, 64, "%u", GPSHeader.width);
+    IUSaveText(&GPSDataHeaderT[GPS_DATA_WIDTH], data);
+    snprintf(data, 64, "%u", GPSHeader.height);
+    IUSaveText(&GPSDataHeaderT[GPS_DATA_HEIGHT], data);
+    snprintf(data, 64, "%f", GPSHeader.latitude);
+    IUSaveText(&GPSDataHeaderT[GPS_DATA_LATITUDE], data);
+    snprintf(data, 64, "%f", GPSHeader.longitude);
+    IUSaveText(&GPSDataHeaderT[GPS_DATA_LONGITUDE], data);
+    snprintf(data, 64, "%u", GPSHeader.max_clock);
+    IUSaveText(&GPSDataHeaderT[GPS_DATA_MAX_CLOCK], data);
+
+    // Start
+    snprintf(data, 64, "%u", GPSHeader.start_flag);
+    IUSaveText(&GPSDataStartT[GPS_DATA_START_FLAG], data);
+    snprintf(data, 64, "%u", GPSHeader.start_sec);
+    IUSaveText(&GPSDataStartT[GPS_DATA_START_SEC], data);
     snprintf(data, 64, "%.1f", GPSHeader.start_us);
     IUSaveText(&GPSDataStartT[GPS_DATA_START_USEC], data);
-
-    // Start JD
-    GPSHeader.start_jd = JStoJD(GPSHeader.start_sec, GPSHeader.start_us);
     // Get ISO8601
     JDtoISO8601(GPSHeader.start_jd, iso8601);
     // Add millisecond
     snprintf(ts, sizeof(ts), "%s.%03d", iso8601, static_cast<int>(GPSHeader.start_us / 1000.0));
     IUSaveText(&GPSDataStartT[GPS_DATA_START_TS], ts);
 
-    // End Flag
-    GPSHeader.end_flag = gpsarray[25];
+    // End
     snprintf(data, 64, "%u", GPSHeader.end_flag);
     IUSaveText(&GPSDataEndT[GPS_DATA_END_FLAG], data);
-
-    // End Seconds
-    GPSHeader.end_sec = gpsarray[26] << 24 | gpsarray[27] << 16 | gpsarray[28] << 8 | gpsarray[29];
     snprintf(data, 64, "%u", GPSHeader.end_sec);
     IUSaveText(&GPSDataEndT[GPS_DATA_END_SEC], data);
-
-    // End Microseconds
-    GPSHeader.end_us = (gpsarray[30] << 16 | gpsarray[31] << 8 | gpsarray[32]) / 10.0;
     snprintf(data, 64, "%.1f", GPSHeader.end_us);
     IUSaveText(&GPSDataEndT[GPS_DATA_END_USEC], data);
-
-    // End JD
-    GPSHeader.end_jd = JStoJD(GPSHeader.end_sec, GPSHeader.end_us);
-    // Get ISO8601
     JDtoISO8601(GPSHeader.end_jd, iso8601);
-    // Add millisecond
     snprintf(ts, sizeof(ts), "%s.%03d", iso8601, static_cast<int>(GPSHeader.end_us / 1000.0));
     IUSaveText(&GPSDataEndT[GPS_DATA_END_TS], ts);
 
-    // Now Flag
-    GPSHeader.now_flag = gpsarray[33];
+    // Now
     snprintf(data, 64, "%u", GPSHeader.now_flag);
     IUSaveText(&GPSDataNowT[GPS_DATA_NOW_FLAG], data);
-
-    // Now Seconds
-    GPSHeader.now_sec = gpsarray[34] << 24 | gpsarray[35] << 16 | gpsarray[36] << 8 | gpsarray[37];
     snprintf(data, 64, "%u", GPSHeader.now_sec);
     IUSaveText(&GPSDataNowT[GPS_DATA_NOW_SEC], data);
-
-    // Now microseconds
-    GPSHeader.now_us = (gpsarray[38] << 16 | gpsarray[39] << 8 | gpsarray[40]) / 10.0;
     snprintf(data, 64, "%.1f", GPSHeader.now_us);
     IUSaveText(&GPSDataNowT[GPS_DATA_NOW_USEC], data);
-
-    // Now JD
-    GPSHeader.now_jd = JStoJD(GPSHeader.now_sec, GPSHeader.now_us);
-    // Get ISO8601
     JDtoISO8601(GPSHeader.now_jd, iso8601);
-    // Add millisecond
     snprintf(ts, sizeof(ts), "%s.%03d", iso8601, static_cast<int>(GPSHeader.now_us / 1000.0));
     IUSaveText(&GPSDataNowT[GPS_DATA_NOW_TS], ts);
 
-    // PPS
-    GPSHeader.max_clock = gpsarray[41] << 16 | gpsarray[42] << 8 | gpsarray[43];
-    snprintf(data, 64, "%u", GPSHeader.max_clock);
-    IUSaveText(&GPSDataHeaderT[GPS_DATA_MAX_CLOCK], data);
-
     IDSetText(&GPSDataHeaderTP, nullptr);
     IDSetText(&GPSDataStartTP, nullptr);
     IDSetText(&GPSDataEndTP, nullptr);
@@ -2893,6 +2955,103 @@ void QHYCCD::decodeGPSHeader()
     }
 }
 
+void QHYCCD::writeGPSSidecar(bool recording, uint64_t timestamp)
+{
+    if (!recording || GPSSidecarS[INDI_ENABLED].s != ISS_ON)
+    {
+        closeGPSSidecar();
+        return;
+    }
+
+    // A new recording started, open a log next to its SER file.
+    if (m_GPSSidecarFile == nullptr)
+    {
+        std::string path = gpsSidecarPath();
+        m_GPSSidecarFile = fopen(path.c_str(), "w");
+        if (m_GPSSidecarFile == nullptr)
+        {
+            LOGF_ERROR("Failed to create GPS timing log %s: %s", path.c_str(), strerror(errno));
+            GPSSidecarS[INDI_ENABLED].s = ISS_OFF;
+            GPSSidecarS[INDI_DISABLED].s = ISS_ON;
+            GPSSidecarSP.s = IPS_ALERT;
+            IDSetSwitch(&GPSSidecarSP, nullptr);
+            return;
+        }
+
+        LOGF_INFO("Recording GPS timing log to %s", path.c_str());
+        fprintf(m_GPSSidecarFile, "frame,seq,start_flag,start_sec,start_us,end_flag,end_sec,end_us,"
+                "now_flag,now_sec,now_us,pps,ser_timestamp\n");
+        m_GPSSidecarFrame = 0;
+    }
+
+    fprintf(m_GPSSidecarFile, "%u,%u,%u,%u,%.1f,%u,%u,%.1f,%u,%u,%.1f,%u,%llu\n",
+            m_GPSSidecarFrame++, GPSHeader.seqNumber,
+            GPSHeader.start_flag, GPSHeader.start_sec, GPSHeader.start_us,
+            GPSHeader.end_flag, GPSHeader.end_sec, GPSHeader.end_us,
+            GPSHeader.now_flag, GPSHeader.now_sec, GPSHeader.now_us,
+            GPSHeader.max_clock, static_cast<unsigned long long>(timestamp));
+}
+
+std::string QHYCCD::gpsSidecarPath()
+{
+    // The recorder does not publish its file name, find the SER file it is writing in the
+    // recording directory, expanded like the stream manager does (~ and the _D_ date).
+    std::string dir = "/tmp";
+    auto recordFile = getText("RECORD_FILE");
+    if (recordFile.isValid() && recordFile.findWidgetByName("RECORD_FILE_DIR"))
+        dir = recordFile.findWidgetByName("RECORD_FILE_DIR")->getText();
+
+    char date[16] = {0};
+    time_t now = time(nullptr);
+    struct tm local;
+    strftime(date, sizeof(date), "%Y-%m-%d", localtime_r(&now, &local));
+    for (size_t pos = dir.find("_D_"); pos != std::string::npos; pos = dir.find("_D_"))
+        dir.replace(pos, 3, date);
+    const char *homeDir = getenv("HOME");
+    if (!dir.empty() && dir[0] == '~' && homeDir)
+        dir.replace(0, 1, homeDir);
+
+    // The active recording is the SER file written last
+    std::string newest;
+    time_t newestTime = 0;
+    if (DIR *handle = opendir(dir.c_str()))
+    {
+        while (struct dirent *entry = readdir(handle))
+        {
+            std::string name = entry->d_name;
+            struct stat info;
+            if (name.size() <= 4 || name.compare(name.size() - 4, 4, ".ser") != 0 ||
+                    stat((dir + "/" + name).c_str(), &info) != 0)
+                continue;
+            if (newest.empty() || info.st_mtime > newestTime)
+            {
+                newest = name;
+                newestTime = info.st_mtime;
+            }
+        }
+        closedir(handle);
+    }
+
+    if (!newest.empty())
+        return dir + "/" + newest.substr(0, newest.size() - 4) + "_gps.csv";
+
+    char iso8601[64] = {0};
+    struct tm utc;
+    strftime(iso8601, sizeof(iso8601), "%Y-%m-%dT%H-%M-%S", gmtime_r(&now, &utc));
+    LOGF_WARN("No SER recording found in %s, naming the GPS timing log after the current time.", dir.c_str());
+    return dir + "/" + getDeviceName() + "_gps_" + iso8601 + ".csv";
+}
+
+void QHYCCD::closeGPSSidecar()
+{
+    if (m_GPSSidecarFile == nullptr)
+        return;
+
+    fclose(m_GPSSidecarFile);
+    m_GPSSidecarFile = nullptr;
+    LOGF_INFO("GPS timing log closed after %u frames.", m_GPSSidecarFrame);
+}
+
 double QHYCCD::JStoJD(uint32_t JS, double us)
 {
     // Convert Julian seconds (plus microsecond) to Julian Days since epoch 2450000
@@ -2903,11 +3062,11 @@ double QHYCCD::JStoJD(uint32_t JS, double us)
 
 void QHYCCD::JDtoISO8601(double JD, char *iso8601)
 {
-    struct tm *tp = nullptr;
+    struct tm utc;
     time_t gpstime;
     ln_get_timet_from_julian(JD, &gpstime);
-    // Get UTC timestamp
-    tp = gmtime(&gpstime);
+    // Get UTC timestamp, reentrant as this runs on the streaming thread
+    gmtime_r(&gpstime, &utc);
     // Format it in ISO8601 format
-    strftime(iso8601, MAXINDIDEVICE, "%Y-%m-%dT%H:%M:%S", tp);
+    strftime(iso8601, MAXINDIDEVICE, "%Y-%m-%dT%H:%M:%S", &utc);
 }
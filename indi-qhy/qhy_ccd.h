@@ -27,6 +27,8 @@
 #include <unistd.h>
 #include <functional>
 #include <pthread.h>
+#include <chrono>
+#include <vector>
 
 #define DEVICE struct usb_device *
 
@@ -246,6 +248,10 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         ISwitchVectorProperty GPSControlSP;
         ISwitch GPSControlS[2];
 
+        // GPS timing sidecar written alongside SER recordings
+        ISwitchVectorProperty GPSSidecarSP;
+        ISwitch GPSSidecarS[2];
+
         // GPS Status
         ILightVectorProperty GPSStateLP;
         ILight GPSStateL[4];
@@ -421,8 +427,17 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         bool isQHY5PIIC();
         // Call when max filter count is known
         bool updateFilterProperties();
-        // Decode GPS Header
+        // Decode GPS Header and update GPS properties
         void decodeGPSHeader();
+        // Decode the binary GPS header embedded in the first bytes of a frame
+        void parseGPSHeader(const uint8_t *frame);
+        // Update GPS data properties from the last decoded header
+        void updateGPSProperties();
+        // Write the last decoded header to the timing sidecar while SER recording is active
+        void writeGPSSidecar(bool recording, uint64_t timestamp);
+        // Path of the timing sidecar of the active SER recording, <recording>_gps.csv
+        std::string gpsSidecarPath();
+        void closeGPSSidecar();
         /**
          * @brief JStoJD Convert Julian Second to Julian Date
          * @param JS Julian Second
@@ -485,6 +500,14 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         uint32_t currentQHYReadMode;
         // dynamic array to hold read mode information
         QHYReadModeInfo *readModeInfo = nullptr;
+        // Rotating capture buffers used while streaming
+        std::vector<std::vector<uint8_t>> m_StreamBuffers;
+        size_t m_StreamBufferIndex {0};
+        // Last time GPS data properties were sent while streaming
+        std::chrono::steady_clock::time_point m_GPSPropertiesUpdate;
+        // GPS timing sidecar
+        FILE *m_GPSSidecarFile {nullptr};
+        uint32_t m_GPSSidecarFrame {0};
 
 
         /////////////////////////////////////////////////////////////////////////////
@@ -505,4 +528,7 @@ class QHYCCD : public INDI::CCD, public INDI::FilterInterface
         static constexpr const char * GPS_CONTROL_TAB = "GPS Control";
         static constexpr const char * GPS_DATA_TAB = "GPS Data";
         static constexpr uint64_t QHY_SER_US_EPOCH = 62948880000000000; // offset to SER epoch January 1, 1 AD
+        static constexpr uint8_t STREAM_BUFFER_COUNT = 3;
+        // Minimum interval between GPS data property updates while streaming
+        static constexpr uint32_t GPS_PROPERTIES_INTERVAL_MS = 1000;
 };
@@ -0,0 +1,62 @@
+/*
+ QHY INDI Driver - download benchmark
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+    Offline benchmark of the QHY download path, see common/ccd_benchmark.h.
+
+    The real QHYCCD (qhy_ccd.cpp, built without its hot plug loader) is linked against the mock
+    libqhyccd in mock/, memcpy calls are counted in qhy_ccd.cpp.
+*/
+
+#include "qhy_ccd.h"
+#include "qhy_mock.h"
+#include "ccd_benchmark.h"
+
+/**
+ * @brief QHYCCD on the first mock camera.
+ */
+class BenchmarkQHY : public CCDBenchmark::Camera<QHYCCD>
+{
+    public:
+        BenchmarkQHY() : CCDBenchmark::Camera<QHYCCD>("Benchmark", cameraID()) {}
+
+        static bool listed()
+        {
+            return ScanQHYCCD() > 0;
+        }
+
+    private:
+        static const char *cameraID()
+        {
+            static char id[MAXINDINAME] = {0};
+            GetQHYCCDId(0, id);
+            return id;
+        }
+};
+
+// Exposures are read at the 16 bit depth of the sensor, streams at 8 bits
+static const CCDBenchmark::Format formats[] =
+{
+    { "raw16", "INDI_RAW", 2, 1 },
+};
+
+int main(int argc, char *argv[])
+{
+    const CCDBenchmark::Driver driver = { "indi_qhy_ccd", "QHY", formats, 1, QHYMockGetStats, QHYMockResetStats };
+    return CCDBenchmark::run<BenchmarkQHY>(argc, argv, driver);
+}
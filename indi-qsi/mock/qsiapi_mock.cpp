@@ -0,0 +1,457 @@
+/*
+ QSI INDI Driver - mock QSI API
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ QSICamera for -DINDI_QSI_MOCK=ON, see common/README.md. The camera is 3326 x 2504 and
+ 10 MB/s unless set otherwise, QSI_MOCK_DIGITIZE is the time from the end of exposure to
+ get_ImageReady returning true (ms, default 300).
+
+ Like libqsi, calls are serialized, so a status query waits for a running download.
+ Image ready polls and the time from image ready to the download are printed to stderr
+ on disconnect, together with the process CPU time.
+*/
+
+#include <qsiapi.h>
+#include "sdk_mock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
+struct MockCamera
+{
+    long width;
+    long height;
+    int digitize;
+    double bandwidth;
+
+    bool structuredExceptions {false};
+    bool connected {false};
+    bool exposing {false};
+    bool imageTaken {false};
+    short binx {1}, biny {1};
+    long startx {0}, starty {0}, numx, numy;
+    std::chrono::steady_clock::time_point ready;
+    double setpoint {-10};
+    bool coolerOn {false};
+    short position {0};
+    std::string names[5] {"Red", "Green", "Blue", "Luminance", "Ha"};
+    QSICamera::FanMode fanMode {QSICamera::fanFull};
+    QSICamera::ReadoutSpeed readoutSpeed {QSICamera::HighImageQuality};
+    QSICamera::CameraGain gain {QSICamera::CameraGainAuto};
+    QSICamera::AntiBloom antiBloom {QSICamera::AntiBloomNormal};
+
+    int readyPolls {0};
+    int downloads {0};
+    double readyToDownload {0};
+    std::chrono::steady_clock::time_point readySeen;
+
+    std::recursive_mutex lock;
+};
+
+#define CAMERA MockCamera *cam = static_cast<MockCamera *>(pCam); \
+    std::lock_guard<std::recursive_mutex> guard(cam->lock)
+
+static int fail(MockCamera *cam, const char *error)
+{
+    if (cam->structuredExceptions)
+        throw std::runtime_error(error);
+    return 1;
+}
+
+QSICamera::QSICamera()
+{
+    MockCamera *cam = new MockCamera();
+    cam->width      = SDKMock::env("QSI_MOCK_WIDTH", 3326);
+    cam->height     = SDKMock::env("QSI_MOCK_HEIGHT", 2504);
+    cam->digitize   = SDKMock::env("QSI_MOCK_DIGITIZE", 300);
+    cam->bandwidth  = std::max(SDKMock::env("QSI_MOCK_BANDWIDTH", 10.0), 0.001);
+    cam->numx       = cam->width;
+    cam->numy       = cam->height;
+    pCam            = cam;
+}
+
+QSICamera::~QSICamera()
+{
+    delete static_cast<MockCamera *>(pCam);
+}
+
+int QSICamera::put_UseStructuredExceptions(bool newVal)
+{
+    CAMERA;
+    cam->structuredExceptions = newVal;
+    return 0;
+}
+
+int QSICamera::get_Connected(bool *pVal)
+{
+    CAMERA;
+    *pVal = cam->connected;
+    return 0;
+}
+
+int QSICamera::put_Connected(bool newVal)
+{
+    CAMERA;
+    if (cam->connected && !newVal)
+    {
+        fprintf(stderr, "qsi mock: %d image ready polls, %d downloads, %.1f ms from image ready to download, "
+                "%.2f s CPU\n", cam->readyPolls, cam->downloads,
+                cam->downloads ? cam->readyToDownload / cam->downloads : 0.0,
+                static_cast<double>(clock()) / CLOCKS_PER_SEC);
+    }
+    cam->connected = newVal;
+    return 0;
+}
+
+int QSICamera::get_Name(std::string &pVal)
+{
+    pVal = "QSI Mock";
+    return 0;
+}
+
+int QSICamera::get_ModelNumber(std::string &pVal)
+{
+    pVal = "683";
+    return 0;
+}
+
+int QSICamera::get_PixelSizeX(double *pVal)
+{
+    *pVal = 5.4;
+    return 0;
+}
+
+int QSICamera::get_PixelSizeY(double *pVal)
+{
+    *pVal = 5.4;
+    return 0;
+}
+
+int QSICamera::get_NumX(long *pVal)
+{
+    CAMERA;
+    *pVal = cam->width;
+    return 0;
+}
+
+int QSICamera::put_NumX(long newVal)
+{
+    CAMERA;
+    cam->numx = newVal;
+    return 0;
+}
+
+int QSICamera::get_NumY(long *pVal)
+{
+    CAMERA;
+    *pVal = cam->height;
+    return 0;
+}
+
+int QSICamera::put_NumY(long newVal)
+{
+    CAMERA;
+    cam->numy = newVal;
+    return 0;
+}
+
+int QSICamera::put_StartX(long newVal)
+{
+    CAMERA;
+    cam->startx = newVal;
+    return 0;
+}
+
+int QSICamera::put_StartY(long newVal)
+{
+    CAMERA;
+    cam->starty = newVal;
+    return 0;
+}
+
+int QSICamera::put_BinX(short newVal)
+{
+    CAMERA;
+    cam->binx = newVal;
+    return 0;
+}
+
+int QSICamera::put_BinY(short newVal)
+{
+    CAMERA;
+    cam->biny = newVal;
+    return 0;
+}
+
+int QSICamera::get_CCDTemperature(double *pVal)
+{
+    CAMERA;
+    *pVal = cam->coolerOn ? cam->setpoint : 15.0;
+    return 0;
+}
+
+int QSICamera::get_CanSetCCDTemperature(bool *pVal)
+{
+    *pVal = true;
+    return 0;
+}
+
+int QSICamera::put_SetCCDTemperature(double newVal)
+{
+    CAMERA;
+    cam->setpoint = newVal;
+    return 0;
+}
+
+int QSICamera::get_CoolerOn(bool *pVal)
+{
+    CAMERA;
+    *pVal = cam->coolerOn;
+    return 0;
+}
+
+int QSICamera::put_CoolerOn(bool newVal)
+{
+    CAMERA;
+    cam->coolerOn = newVal;
+    return 0;
+}
+
+int QSICamera::get_CoolerPower(double *pVal)
+{
+    CAMERA;
+    *pVal = cam->coolerOn ? 45.0 : 0.0;
+    return 0;
+}
+
+int QSICamera::get_CanAbortExposure(bool *pVal)
+{
+    *pVal = true;
+    return 0;
+}
+
+int QSICamera::get_CanPulseGuide(bool *pVal)
+{
+    *pVal = true;
+    return 0;
+}
+
+int QSICamera::get_CanSetGain(bool *pVal)
+{
+    *pVal = true;
+    return 0;
+}
+
+int QSICamera::get_CameraGain(CameraGain *pVal)
+{
+    CAMERA;
+    *pVal = cam->gain;
+    return 0;
+}
+
+int QSICamera::put_CameraGain(CameraGain newVal)
+{
+    CAMERA;
+    cam->gain = newVal;
+    return 0;
+}
+
+int QSICamera::get_AntiBlooming(AntiBloom *pVal)
+{
+    CAMERA;
+    *pVal = cam->antiBloom;
+    return 0;
+}
+
+int QSICamera::put_AntiBlooming(AntiBloom newVal)
+{
+    CAMERA;
+    cam->antiBloom = newVal;
+    return 0;
+}
+
+int QSICamera::get_FanMode(FanMode &pVal)
+{
+    CAMERA;
+    pVal = cam->fanMode;
+    return 0;
+}
+
+int QSICamera::put_FanMode(FanMode newVal)
+{
+    CAMERA;
+    cam->fanMode = newVal;
+    return 0;
+}
+
+int QSICamera::get_ReadoutSpeed(ReadoutSpeed &pVal)
+{
+    CAMERA;
+    pVal = cam->readoutSpeed;
+    return 0;
+}
+
+int QSICamera::put_ReadoutSpeed(ReadoutSpeed newVal)
+{
+    CAMERA;
+    cam->readoutSpeed = newVal;
+    return 0;
+}
+
+int QSICamera::put_PreExposureFlush(PreExposureFlush)
+{
+    return 0;
+}
+
+int QSICamera::get_MinExposureTime(double *pVal)
+{
+    *pVal = 0.03;
+    return 0;
+}
+
+int QSICamera::get_ElectronsPerADU(double *pVal)
+{
+    *pVal = 0.5;
+    return 0;
+}
+
+int QSICamera::get_HasShutter(bool *pVal)
+{
+    *pVal = true;
+    return 0;
+}
+
+int QSICamera::put_ManualShutterMode(bool)
+{
+    return 0;
+}
+
+int QSICamera::put_ManualShutterOpen(bool)
+{
+    return 0;
+}
+
+int QSICamera::get_FilterCount(int &count)
+{
+    count = 5;
+    return 0;
+}
+
+int QSICamera::get_Names(std::string names[])
+{
+    CAMERA;
+    std::copy(cam->names, cam->names + 5, names);
+    return 0;
+}
+
+int QSICamera::put_Names(std::string names[])
+{
+    CAMERA;
+    std::copy(names, names + 5, cam->names);
+    return 0;
+}
+
+int QSICamera::get_Position(short *pVal)
+{
+    CAMERA;
+    *pVal = cam->position;
+    return 0;
+}
+
+int QSICamera::put_Position(short newVal)
+{
+    CAMERA;
+    if (newVal < 0 || newVal >= 5)
+        return fail(cam, "Invalid filter position");
+    cam->position = newVal;
+    return 0;
+}
+
+int QSICamera::PulseGuide(GuideDirections, long)
+{
+    return 0;
+}
+
+int QSICamera::StartExposure(double Duration, bool)
+{
+    CAMERA;
+    if (!cam->connected)
+        return fail(cam, "Not Connected");
+    cam->exposing   = true;
+    cam->imageTaken = false;
+    cam->ready      = std::chrono::steady_clock::now() +
+                      std::chrono::microseconds(static_cast<int64_t>(Duration * 1000000) + cam->digitize * 1000);
+    return 0;
+}
+
+int QSICamera::AbortExposure()
+{
+    CAMERA;
+    cam->exposing = false;
+    return 0;
+}
+
+int QSICamera::get_ImageReady(bool *pVal)
+{
+    CAMERA;
+    cam->readyPolls++;
+    if (!cam->exposing && !cam->imageTaken)
+        return fail(cam, "No exposure taken");
+    if (cam->exposing && std::chrono::steady_clock::now() >= cam->ready)
+    {
+        cam->exposing   = false;
+        cam->imageTaken = true;
+        cam->readySeen  = std::chrono::steady_clock::now();
+    }
+    *pVal = cam->imageTaken;
+    return 0;
+}
+
+int QSICamera::get_ImageArraySize(int &xSize, int &ySize, int &elementSize)
+{
+    CAMERA;
+    xSize       = cam->numx;
+    ySize       = cam->numy;
+    elementSize = 2;
+    return 0;
+}
+
+int QSICamera::get_ImageArray(unsigned short *pVal)
+{
+    CAMERA;
+    if (!cam->imageTaken)
+        return fail(cam, "Image not ready");
+
+    cam->readyToDownload += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                            cam->readySeen).count();
+
+    // the camera stays locked during the download, like libqsi
+    size_t length = static_cast<size_t>(cam->numx) * cam->numy;
+    for (size_t i = 0; i < length; i++)
+        pVal[i] = static_cast<unsigned short>(i % cam->numx + i / cam->numx);
+    std::this_thread::sleep_for(SDKMock::transferTime(length * 2, cam->bandwidth));
+
+    cam->imageTaken = false;
+    cam->downloads++;
+    return 0;
+}
@@ -63,6 +63,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301  USA
 #include <netdb.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 
 #include <fitsio.h>
@@ -74,6 +76,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301  USA
 #include "indicom.h"
 #include "qsi_ccd.h"
 #include "config.h"
+#include "ccd_ready_wait.h"
 
 void ISInit(void);
 void ISPoll(void *);
@@ -755,6 +758,7 @@ bool QSICCD::StartExposure(float duration)
     LOGF_DEBUG("Taking a %g seconds frame...", ExposureRequest);
 
     InExposure = true;
+    readoutWorker.start(std::bind(&QSICCD::workerExposure, this, std::placeholders::_1));
     return true;
 }
 
@@ -772,6 +776,8 @@ bool QSICCD::AbortExposure()
             return false;
         }
 
+        readoutWorker.quit();
+        dropPendingFrames();
         InExposure = false;
         return true;
     }
@@ -871,39 +877,136 @@ bool QSICCD::UpdateCCDBin(int binx, int biny)
     return UpdateCCDFrame(PrimaryCCD.getSubX(), PrimaryCCD.getSubY(), PrimaryCCD.getSubW(), PrimaryCCD.getSubH());
 }
 
-/* Downloads the image from the CCD.
- N.B. No processing is done on the image */
-int QSICCD::grabImage()
+bool QSICCD::waitImageReady(const std::atomic_bool &isAboutToQuit)
 {
-    unsigned short *image = (unsigned short *)PrimaryCCD.getFrameBuffer();
+    auto timeLeft = [this]()
+    {
+        return CalcTimeLeft(ExpStart, ExposureRequest);
+    };
+    auto showTimeLeft = [this](float timeleft)
+    {
+        PrimaryCCD.setExposureLeft(timeleft);
+    };
+    if (!ReadyWait::countdown(isAboutToQuit, timeLeft, showTimeLeft))
+        return false;
 
-    int x, y, z;
-    try
+    return ReadyWait::poll(isAboutToQuit, [this]()
     {
         bool imageReady = false;
-        QSICam.get_ImageReady(&imageReady);
-        while (!imageReady)
+        try
         {
-            usleep(500);
             QSICam.get_ImageReady(&imageReady);
         }
+        catch (std::runtime_error &err)
+        {
+            LOGF_ERROR("get_ImageReady() failed. %s.", err.what());
+            return ReadyWait::State::Failed;
+        }
+        return imageReady ? ReadyWait::State::Ready : ReadyWait::State::Busy;
+    });
+}
+
+void QSICCD::workerExposure(const std::atomic_bool &isAboutToQuit)
+{
+    if (!waitImageReady(isAboutToQuit))
+    {
+        if (!isAboutToQuit)
+        {
+            char failed = 0;
+            if (write(readyPipe[1], &failed, 1) != 1)
+                LOG_ERROR("Failed to hand over the exposure.");
+        }
+        return;
+    }
 
+    PrimaryCCD.setExposureLeft(0);
+    LOG_INFO("Exposure done, downloading image...");
+    LOGF_DEBUG("Image ready %.3f s after the end of exposure.", -CalcTimeLeft(ExpStart, ExposureRequest));
+
+    struct timeval start;
+    gettimeofday(&start, nullptr);
+
+    char result = grabImage() == 0 ? 1 : 0;
+    if (result)
+        LOGF_DEBUG("Downloaded in %.3f s.", -CalcTimeLeft(start, 0));
+
+    if (write(readyPipe[1], &result, 1) != 1)
+        LOG_ERROR("Failed to hand over the downloaded image.");
+}
+
+/* Downloads the image from the CCD into the readout buffer.
+ N.B. No processing is done on the image */
+int QSICCD::grabImage()
+{
+    std::lock_guard<std::mutex> guard(readoutBufferLock);
+
+    int x, y, z;
+    downloading = true;
+    try
+    {
         QSICam.get_ImageArraySize(x, y, z);
-        QSICam.get_ImageArray(image);
+        readoutBuffer.resize(static_cast<size_t>(x) * y);
+        QSICam.get_ImageArray(readoutBuffer.data());
         imageWidth  = x;
         imageHeight = y;
     }
     catch (std::runtime_error &err)
     {
+        downloading = false;
         LOGF_ERROR("get_ImageArray() failed. %s.", err.what());
         return -1;
     }
+    downloading = false;
+
+    return 0;
+}
+
+void QSICCD::frameReadyHelper(int fd, void *context)
+{
+    INDI_UNUSED(fd);
+    static_cast<QSICCD *>(context)->frameReady();
+}
+
+/* Runs on the main loop once the worker has downloaded a frame, or failed to. */
+void QSICCD::frameReady()
+{
+    char result = 0;
+    if (read(readyPipe[0], &result, 1) != 1)
+        return;
+
+    InExposure = false;
+    if (result == 0)
+    {
+        PrimaryCCD.setExposureFailed();
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(ccdBufferLock);
+    {
+        std::lock_guard<std::mutex> lock(readoutBufferLock);
+        size_t size = readoutBuffer.size() * sizeof(unsigned short);
+        if (size > static_cast<size_t>(PrimaryCCD.getFrameBufferSize()))
+        {
+            guard.unlock();
+            LOG_ERROR("Frame buffer too small for the downloaded image.");
+            PrimaryCCD.setExposureFailed();
+            return;
+        }
+        memcpy(PrimaryCCD.getFrameBuffer(), readoutBuffer.data(), size);
+    }
+    guard.unlock();
 
     LOG_INFO("Download complete.");
 
     ExposureComplete(&PrimaryCCD);
+}
 
-    return 0;
+/* Discards frames the worker handed over after the exposure was aborted. */
+void QSICCD::dropPendingFrames()
+{
+    char result;
+    while (readyPipe[0] >= 0 && read(readyPipe[0], &result, 1) == 1)
+        ;
 }
 
 void QSICCD::addFITSKeywords(INDI::CCDChip *targetChip, std::vector<INDI::FITSRecord> &fitsKeywords)
@@ -1021,6 +1124,15 @@ bool QSICCD::Connect()
 
     SetCCDCapability(cap);
 
+    // Downloaded frames are handed from the readout worker to the main loop through a pipe
+    if (pipe(readyPipe) != 0)
+    {
+        LOGF_ERROR("Failed to create the readout pipe. %s.", strerror(errno));
+        return false;
+    }
+    fcntl(readyPipe[0], F_SETFL, O_NONBLOCK);
+    readyCallbackID = IEAddCallback(readyPipe[0], frameReadyHelper, this);
+
     /* Success! */
     LOG_INFO("CCD is online. Retrieving basic data.");
     return true;
@@ -1030,6 +1142,19 @@ bool QSICCD::Disconnect()
 {
     bool connected;
 
+    readoutWorker.quit();
+    if (readyCallbackID >= 0)
+    {
+        IERmCallback(readyCallbackID);
+        readyCallbackID = -1;
+    }
+    for (int &fd : readyPipe)
+    {
+        if (fd >= 0)
+            close(fd);
+        fd = -1;
+    }
+
     try
     {
         QSICam.get_Connected(&connected);
@@ -1199,40 +1324,18 @@ void QSICCD::shutterControl()
 
 void QSICCD::TimerHit()
 {
-    long timeleft = 0;
     double ccdTemp = 0;
     double coolerPower = 0;
 
     if (isConnected() == false)
         return; //  No need to reset timer if we are not connected anymore
 
-    if (InExposure)
+    // The exposure is followed by the readout worker. While it downloads, libqsi holds the
+    // camera, skip the status queries rather than blocking the main loop until it is done.
+    if (downloading)
     {
-        bool imageReady;
-
-        timeleft = CalcTimeLeft(ExpStart, ExposureRequest);
-
-        if (timeleft < 1)
-        {
-            QSICam.get_ImageReady(&imageReady);
-
-            while (!imageReady)
-            {
-                usleep(100);
-                QSICam.get_ImageReady(&imageReady);
-            }
-
-            /* We're done exposing */
-            LOG_INFO("Exposure done, downloading image...");
-            PrimaryCCD.setExposureLeft(0);
-            InExposure = false;
-            /* grab and save image */
-            grabImage();
-        }
-        else
-        {
-            PrimaryCCD.setExposureLeft(timeleft);
-        }
+        SetTimer(getCurrentPollingPeriod());
+        return;
     }
 
     switch (TemperatureNP.getState())
@@ -35,7 +35,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <indiccd.h>
 #include <indiguiderinterface.h>
 #include <indifilterinterface.h>
+#include <indisinglethreadpool.h>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 using namespace std;
 
@@ -129,6 +133,19 @@ private:
     INDI::CCDChip::CCD_FRAME imageFrameType;
     int grabImage();
 
+    // Readout, runs on the worker until the frame is downloaded, then hands it to the main loop
+    INDI::SingleThreadPool readoutWorker;
+    std::vector<unsigned short> readoutBuffer;
+    std::mutex readoutBufferLock;
+    std::atomic_bool downloading {false};
+    int readyPipe[2] {-1, -1};
+    int readyCallbackID {-1};
+    void workerExposure(const std::atomic_bool &isAboutToQuit);
+    bool waitImageReady(const std::atomic_bool &isAboutToQuit);
+    static void frameReadyHelper(int fd, void *context);
+    void frameReady();
+    void dropPendingFrames();
+
     // Timers
     int timerID;
     float CalcTimeLeft(timeval, float);
@@ -26,6 +26,7 @@
  * controllers that it in turn uses.
  */
 
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <memory>
@@ -364,7 +365,7 @@ void RollOffIno::TimerHit()
     }
     else
     {
-        checkConditions();  // In case external / manually moved
+        checkConditions(false);  // In case external / manually moved, reuse the status read above
     }
 
     // Added to highlight WiFi issues, not able to recover lost connection without a reconnect
@@ -390,11 +391,12 @@ void RollOffIno::msSleep (int mSec)
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
-// Establish conditions on a connect.
+// Establish conditions on a connect, or from the timer with the status it just read.
 ////////////////////////////////////////////////////////////////////////////////////////
-bool RollOffIno::checkConditions()
+bool RollOffIno::checkConditions(bool refresh)
 {
-    updateRoofStatus();
+    if (refresh)
+        updateRoofStatus();
     Dome::DomeState curState = getDomeState();
 
     // If the roof is clearly fully opened or fully closed, set the Dome::IsParked status to match.
@@ -635,10 +637,35 @@ void RollOffIno::updateRoofStatus()
     bool auxiliaryStatus = false;
     bool openedStatus = false;
     bool closedStatus = false;
-    getRoofSwitch(ROOF_OPENED_SWITCH, &openedStatus, &fullyOpenedLimitSwitch);
-    getRoofSwitch(ROOF_CLOSED_SWITCH, &closedStatus, &fullyClosedLimitSwitch);
-    getRoofSwitch(ROOF_LOCKED_SWITCH, &lockedStatus, &roofLockedSwitch);
-    getRoofSwitch(ROOF_AUX_SWITCH, &auxiliaryStatus, &roofAuxiliarySwitch);
+    unsigned int mask = 0;
+
+    // Newer controllers report every switch in a single exchange
+    if (statusAllSupported && getRoofStatusAll(&mask))
+    {
+        openedStatus = mask & STATUS_OPENED;
+        closedStatus = mask & STATUS_CLOSED;
+        lockedStatus = mask & STATUS_LOCKED;
+        auxiliaryStatus = mask & STATUS_AUXSTATE;
+        fullyOpenedLimitSwitch = openedStatus ? ISS_ON : ISS_OFF;
+        fullyClosedLimitSwitch = closedStatus ? ISS_ON : ISS_OFF;
+        roofLockedSwitch = lockedStatus ? ISS_ON : ISS_OFF;
+        roofAuxiliarySwitch = auxiliaryStatus ? ISS_ON : ISS_OFF;
+        statusSnapshot = mask;
+        statusSnapshotValid = true;
+    }
+    else
+    {
+        getRoofSwitch(ROOF_OPENED_SWITCH, &openedStatus, &fullyOpenedLimitSwitch);
+        getRoofSwitch(ROOF_CLOSED_SWITCH, &closedStatus, &fullyClosedLimitSwitch);
+        getRoofSwitch(ROOF_LOCKED_SWITCH, &lockedStatus, &roofLockedSwitch);
+        getRoofSwitch(ROOF_AUX_SWITCH, &auxiliaryStatus, &roofAuxiliarySwitch);
+    }
+
+    // Only send the lights to clients when something changed
+    IPState previousState = RoofStatusLP.getState();
+    IPState previousLights[5];
+    for (int i = 0; i < 5; i++)
+        previousLights[i] = RoofStatusLP[i].getState();
 
     if (!openedStatus && !closedStatus && !roofOpening && !roofClosing)
     {
@@ -655,7 +682,6 @@ void RollOffIno::updateRoofStatus()
     RoofStatusLP[ROOF_STATUS_OPENED].setState(IPS_IDLE);
     RoofStatusLP[ROOF_STATUS_CLOSED].setState(IPS_IDLE);
     RoofStatusLP[ROOF_STATUS_MOVING].setState(IPS_IDLE);
-    RoofStatusLP.apply();
 
     if (auxiliaryStatus)
     {
@@ -724,7 +750,12 @@ void RollOffIno::updateRoofStatus()
             RoofStatusLP.setState(IPS_ALERT);
         }
     }
-    RoofStatusLP.apply();
+
+    bool changed = RoofStatusLP.getState() != previousState;
+    for (int i = 0; i < 5; i++)
+        changed |= RoofStatusLP[i].getState() != previousLights[i];
+    if (changed)
+        RoofStatusLP.apply();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -770,6 +801,41 @@ bool RollOffIno::getRoofSwitch(const char *switchId, bool *result,  ISState *swi
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// Read all switches in one exchange, response is (ACK:STATUS:bitmask) with the mask in hex
+////////////////////////////////////////////////////////////////////////////////////////
+bool RollOffIno::getRoofStatusAll(unsigned int *mask)
+{
+    char readBuffer[MAXINPBUF] = {};
+    char writeBuffer[MAXOUTBUF] = {"(GET:" ROOF_STATUS_ALL ":0)"};
+    if (!contactEstablished)
+    {
+        if (communicationErrors < MAX_CNTRL_COM_ERR)
+            LOG_WARN("No contact with the roof controller has been established");
+        return false;
+    }
+
+    if (!writeIno(writeBuffer))
+        return false;
+    if (!readIno(readBuffer))
+        return false;
+
+    const char *value = strstr(readBuffer, "(ACK:" ROOF_STATUS_ALL ":");
+    char *end = nullptr;
+    if (value != nullptr)
+    {
+        value += strlen("(ACK:" ROOF_STATUS_ALL ":");
+        *mask = strtoul(value, &end, 16);
+    }
+    if (value == nullptr || end == value || *end != RORINO_STOP_CHAR)
+    {
+        if (communicationErrors < MAX_CNTRL_COM_ERR)
+            LOGF_WARN("Unable to obtain from the controller status: %s, errors: %d", readBuffer, ++communicationErrors);
+        return false;
+    }
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 // Type of roof controller and whether roof is moving or stopped, along with the command sent will
 // determine the effect on the roof. This could mean stopping or starting in a reversed direction.
@@ -863,6 +929,8 @@ bool RollOffIno::initialContact()
     char init[MAXOUTBUF] = {"(CON:0:0)"};
     contactEstablished = false;
     actionCount = 0;
+    statusAllSupported = false;
+    statusSnapshotValid = false;
     if (!writeIno(init))
     {
         return false;
@@ -915,9 +983,13 @@ bool RollOffIno::initialContact()
         {
             LOGF_ERROR("Regex error during initial contact: %s. Regex pattern: \\[ACT(\\d+)\\]", e.what());
         }
+        // Controller can report all switches with a single (GET:STATUS:0) request
+        statusAllSupported = s_response.find("[STA]") != std::string::npos;
         contactEstablished = true;
         //DEBUGF(INDI::Logger::DBG_SESSION, "Initial contact response: %s", readBuffer);
         LOGF_INFO("Number of Action commands enabled by controller. %d", actionCount);
+        if (statusAllSupported)
+            LOG_INFO("Controller reports all switches in a single status request.");
         return true;
     }
     LOGF_WARN("Initial contact returned a negative acknowledgement %s", readBuffer);
@@ -931,12 +1003,26 @@ bool RollOffIno::UpdateDigitalInputs()
 {
     char get[MAXOUTBUF] = {0};
     char response[MAXINPBUF] = {0};
+    // Action states were already part of the status read in this timer tick
+    bool useSnapshot = statusSnapshotValid;
+    statusSnapshotValid = false;
     for (unsigned int i = 0; i < MAX_ACTIONS; i++)
     {
         std::string ack = "ACK";
         std::string on = "ON";
         // Do not get Action values beyond what controller indicates it will support
-        if (i < actionCount)
+        if (i < actionCount && useSnapshot)
+        {
+            auto state = (statusSnapshot & (1u << (STATUS_ACT1 + i))) ? ISS_ON : ISS_OFF;
+            if (DigitalInputsSP[i].findOnSwitchIndex() != state)
+            {
+                DigitalInputsSP[i].reset();
+                DigitalInputsSP[i][state].setState(ISS_ON);
+                DigitalInputsSP[i].setState(IPS_OK);
+                DigitalInputsSP[i].apply();
+            }
+        }
+        else if (i < actionCount)
         {
             auto state = ISS_OFF;
             strncpy(get, inpRoRino[i], MAXOUTBUF - 1);
@@ -60,13 +60,14 @@ private:
     bool Handshake() override;
     void updateRoofStatus();
     bool getRoofSwitch(const char *, bool *, ISState *);
+    bool getRoofStatusAll(unsigned int *);
     bool sendRoofCommand(const char *, bool, bool);
     bool initialContact();
     bool evaluateResponse(char *, char *, bool *);
     bool writeIno(const char *);
     bool readIno(char *);
     void msSleep(int);
-    bool checkConditions();
+    bool checkConditions(bool refresh = true);
     void roofTimerExpired();
 
 #define MAX_CNTRL_COM_ERR 10         // Maximum consecutive errors communicating with Arduino
@@ -81,6 +82,7 @@ private:
 #define ROOF_CLOSED_SWITCH "CLOSED"
 #define ROOF_LOCKED_SWITCH "LOCKED"
 #define ROOF_AUX_SWITCH    "AUXSTATE"
+#define ROOF_STATUS_ALL    "STATUS"
 #define ROOF_OPEN_CMD     "OPEN"
 #define ROOF_CLOSE_CMD    "CLOSE"
 #define ROOF_ABORT_CMD    "ABORT"
@@ -140,6 +142,8 @@ const char* inpRoRino[MAX_ACTIONS] = {
 
     static const char RORINO_STOP_CHAR {0x29};         // ')'
     enum {EXPIRED_CLEAR, EXPIRED_OPEN, EXPIRED_CLOSE, EXPIRED_ABORT};
+    // Bits of the (GET:STATUS:0) response, Action n state is bit STATUS_ACT1 + n - 1
+    enum {STATUS_OPENED = 0x01, STATUS_CLOSED = 0x02, STATUS_LOCKED = 0x04, STATUS_AUXSTATE = 0x08, STATUS_ACT1 = 4};
     unsigned int roofTimedOut = EXPIRED_CLEAR;
     INDI::Timer roofMoveTimer;
     bool contactEstablished = false;
@@ -147,6 +151,9 @@ const char* inpRoRino[MAX_ACTIONS] = {
     bool roofClosing = false;
     unsigned int communicationErrors = 0; // Added for WiFi benefit
     unsigned int actionCount = 0;         // # of optional input/output Actions set by Arduino
+    bool statusAllSupported = false;      // Arduino answers (GET:STATUS:0) with all switches in one bitmask
+    bool statusSnapshotValid = false;     // statusSnapshot read in this timer tick, Action bits still unused
+    unsigned int statusSnapshot = 0;
     ISState fullyOpenedLimitSwitch{ISS_OFF};
     ISState fullyClosedLimitSwitch{ISS_OFF};
     ISState roofLockedSwitch{ISS_OFF};
@@ -41,6 +41,8 @@
 
 #include <memory>
 #include <deque>
+#include <algorithm>
+#include <chrono>
 
 #ifdef __APPLE__
 #include <sys/stat.h>
@@ -52,6 +54,7 @@
 #define MAX_DEVICES         20   /* Max device cameraCount */
 #define MAX_THREAD_RETRIES  3
 #define MAX_THREAD_WAIT     300000
+#define READOUT_BATCH_LINES 32   /* Lines read per sbigLock acquisition */
 
 static class Loader
 {
@@ -901,6 +904,8 @@ bool SBIGCCD::Disconnect()
 {
     if (!isConnected())
         return true;
+    m_ImagingReadout.quit();
+    m_GuideReadout.quit();
     m_useExternalTrackingCCD = false;
     m_hasGuideHead           = false;
 #ifdef ASYNC_READOUT
@@ -1451,37 +1456,27 @@ bool SBIGCCD::grabImage(INDI::CCDChip *targetChip)
 
     LOGF_DEBUG("%s readout in progress...", targetChip == &PrimaryCCD ? "Primary camera" : "Guide head");
 
-    if (isSimulation())
+    // in simulation mode the readout goes through the simulated universal driver
+    auto readoutStart = std::chrono::steady_clock::now();
+    uint16_t *buffer  = reinterpret_cast<uint16_t *>(targetChip->getFrameBuffer());
+    int res           = 0;
+    for (int i = 0; i < MAX_THREAD_RETRIES; i++)
     {
-        uint8_t *image = targetChip->getFrameBuffer();
-        for (int i = 0; i < height * 2; i++)
-        {
-            for (int j = 0; j < width; j++)
-            {
-                image[i * width + j] = rand() % 255;
-            }
-        }
+        res = readoutCCD(left, top, width, height, buffer, targetChip);
+        if (res == CE_NO_ERROR)
+            break;
+        LOGF_DEBUG("Readout error, retrying...", res);
+        usleep(MAX_THREAD_WAIT);
     }
-    else
+    if (res != CE_NO_ERROR)
     {
-        uint16_t *buffer = reinterpret_cast<uint16_t *>(targetChip->getFrameBuffer());
-        int res                = 0;
-        for (int i = 0; i < MAX_THREAD_RETRIES; i++)
-        {
-            res = readoutCCD(left, top, width, height, buffer, targetChip);
-            if (res == CE_NO_ERROR)
-                break;
-            LOGF_DEBUG("Readout error, retrying...", res);
-            usleep(MAX_THREAD_WAIT);
-        }
-        if (res != CE_NO_ERROR)
-        {
-            LOGF_ERROR("%s readout error",
-                       targetChip == &PrimaryCCD ? "Primary camera" : "Guide head");
-            return false;
-        }
+        LOGF_ERROR("%s readout error",
+                   targetChip == &PrimaryCCD ? "Primary camera" : "Guide head");
+        return false;
     }
-    LOGF_DEBUG("%s readout complete", targetChip == &PrimaryCCD ? "Primary camera" : "Guide head");
+    std::chrono::duration<double> readoutTime = std::chrono::steady_clock::now() - readoutStart;
+    LOGF_DEBUG("%s readout of %dx%d complete in %.3f s", targetChip == &PrimaryCCD ? "Primary camera" : "Guide head",
+               width, height, readoutTime.count());
     ExposureComplete(targetChip);
     return true;
 }
@@ -1519,8 +1514,11 @@ void SBIGCCD::TimerHit()
             LOG_DEBUG("Primay camera exposure done, downloading image...");
             targetChip->setExposureLeft(0);
             InExposure = false;
-            if (grabImage(targetChip) == false)
-                targetChip->setExposureFailed();
+            m_ImagingReadout.start([this](const std::atomic_bool &)
+            {
+                if (grabImage(&PrimaryCCD) == false)
+                    PrimaryCCD.setExposureFailed();
+            });
         }
         else
         {
@@ -1539,8 +1537,11 @@ void SBIGCCD::TimerHit()
             LOG_DEBUG("Guide head exposure done, downloading image...");
             targetChip->setExposureLeft(0);
             InGuideExposure = false;
-            if (grabImage(targetChip) == false)
-                targetChip->setExposureFailed();
+            m_GuideReadout.start([this](const std::atomic_bool &)
+            {
+                if (grabImage(&GuideCCD) == false)
+                    GuideCCD.setExposureFailed();
+            });
         }
         else
         {
@@ -1614,7 +1615,7 @@ int SBIGCCD::EndExposure(EndExposureParams *eep)
 
 int SBIGCCD::StartReadout(StartReadoutParams *srp)
 {
-    int res = SBIGUnivDrvCommand(CC_START_READOUT, srp, nullptr);
+    int res = isSimulation() ? m_Simulator.StartReadout(srp) : SBIGUnivDrvCommand(CC_START_READOUT, srp, nullptr);
     if (res != CE_NO_ERROR)
     {
         LOGF_ERROR("%s: CC_START_READOUT -> (%s)", __FUNCTION__, GetErrorString(res));
@@ -1625,7 +1626,11 @@ int SBIGCCD::StartReadout(StartReadoutParams *srp)
 int SBIGCCD::ReadoutLine(ReadoutLineParams *rlp, uint16_t *results, bool bSubtract)
 {
     int res;
-    if (bSubtract)
+    if (isSimulation())
+    {
+        res = m_Simulator.ReadoutLine(rlp, results);
+    }
+    else if (bSubtract)
     {
         res = SBIGUnivDrvCommand(CC_READ_SUBTRACT_LINE, rlp, results);
     }
@@ -1653,7 +1658,7 @@ int SBIGCCD::DumpLines(DumpLinesParams *dlp)
 
 int SBIGCCD::EndReadout(EndReadoutParams *erp)
 {
-    int res = SBIGUnivDrvCommand(CC_END_READOUT, erp, nullptr);
+    int res = isSimulation() ? m_Simulator.EndReadout(erp) : SBIGUnivDrvCommand(CC_END_READOUT, erp, nullptr);
     if (res != CE_NO_ERROR)
     {
         LOGF_ERROR("%s: CC_END_READOUT -> (%s)", __FUNCTION__, GetErrorString(res));
@@ -2642,7 +2647,7 @@ bool SBIGCCD::isExposureDone(INDI::CCDChip *targetChip)
 int SBIGCCD::readoutCCD(uint16_t left, uint16_t top, uint16_t width, uint16_t height,
                         uint16_t *buffer, INDI::CCDChip *targetChip)
 {
-    int h, ccd, binning, res;
+    int ccd, binning, res;
     if (targetChip == &PrimaryCCD)
     {
         ccd = CCD_IMAGING;
@@ -2651,6 +2656,7 @@ int SBIGCCD::readoutCCD(uint16_t left, uint16_t top, uint16_t width, uint16_t he
     {
         ccd = m_useExternalTrackingCCD ? CCD_EXT_TRACKING : CCD_TRACKING;
     }
+    std::unique_lock<std::mutex> guard(sbigLock);
     if ((res = getBinningMode(targetChip, binning)) != CE_NO_ERROR)
     {
         return res;
@@ -2662,35 +2668,45 @@ int SBIGCCD::readoutCCD(uint16_t left, uint16_t top, uint16_t width, uint16_t he
     srp.top         = top;
     srp.width       = width;
     srp.height      = height;
-    std::unique_lock<std::mutex> guard(sbigLock);
     res = StartReadout(&srp);
     if (res != CE_NO_ERROR)
     {
         LOGF_ERROR("%s readoutCCD - StartReadout error! (%s)",
                    (targetChip == &PrimaryCCD) ? "Primary" : "Guide", GetErrorString(res));
-        guard.unlock();
         return res;
     }
+    guard.unlock();
+
+    // The universal driver reads one line per command. The lines are read in batches and
+    // the lock is released in between, so that the other CCD, the guide relays and the
+    // temperature are served during the readout of a large frame.
     ReadoutLineParams rlp;
     rlp.ccd         = ccd;
     rlp.readoutMode = binning;
     rlp.pixelStart  = left;
     rlp.pixelLength = width;
-    for (h = 0; h < height; h++)
+    for (int h = 0; h < height && res == CE_NO_ERROR;)
     {
-        ReadoutLine(&rlp, buffer + (h * width), false);
+        int batchEnd = std::min<int>(h + READOUT_BATCH_LINES, height);
+        guard.lock();
+        for (; h < batchEnd && res == CE_NO_ERROR; h++)
+        {
+            res = ReadoutLine(&rlp, buffer + (h * width), false);
+        }
+        guard.unlock();
     }
+
     EndReadoutParams erp;
     erp.ccd = ccd;
-    if ((res = EndReadout(&erp)) != CE_NO_ERROR)
+    guard.lock();
+    int endRes = EndReadout(&erp);
+    guard.unlock();
+    if (endRes != CE_NO_ERROR)
     {
         LOGF_ERROR("%s readoutCCD - EndReadout error! (%s)",
-                   (targetChip == &PrimaryCCD) ? "Primary" : "Guide", GetErrorString(res));
-        guard.unlock();
-        return res;
+                   (targetChip == &PrimaryCCD) ? "Primary" : "Guide", GetErrorString(endRes));
     }
-    guard.unlock();
-    return res;
+    return res != CE_NO_ERROR ? res : endRes;
 }
 
 //==========================================================================
@@ -29,6 +29,7 @@
 
 #include <indiccd.h>
 #include <indifilterinterface.h>
+#include <indisinglethreadpool.h>
 
 #ifdef __APPLE__
 #include <libusb.h>
@@ -37,6 +38,8 @@
 #include <sbigudrv.h>
 #endif
 
+#include "sbig_sim.h"
+
 #include <string>
 
 #define DEVICE struct usb_device *
@@ -277,6 +280,10 @@ class SBIGCCD : public INDI::CCD, public INDI::FilterInterface
         /// Threading Variables
         /////////////////////////////////////////////////////////////////////////////
         std::mutex sbigLock;
+        // Readouts run on their own workers, a guide frame is not queued behind a main frame download
+        INDI::SingleThreadPool m_ImagingReadout;
+        INDI::SingleThreadPool m_GuideReadout;
+        SBIGSimulator m_Simulator;
 
         /////////////////////////////////////////////////////////////////////////////
         /// Exposure Variables
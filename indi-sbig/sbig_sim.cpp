@@ -0,0 +1,71 @@
+/*
+    Driver type: SBIG CCD Camera INDI Driver
+
+    Simulated readout commands of the SBIG Universal Driver.
+
+    This library is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+    or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+    License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this library; if not, write to the Free Software Foundation,
+    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+
+ */
+
+#include "sbig_sim.h"
+#include "sdk_mock.h"
+
+#include <unistd.h>
+
+SBIGSimulator::SBIGSimulator()
+{
+    commandDelay = SDKMock::env("SBIG_SIM_COMMAND_US", 250);
+    pixelDelay   = SDKMock::env("SBIG_SIM_PIXEL_NS", 250);
+}
+
+int SBIGSimulator::StartReadout(const StartReadoutParams *srp)
+{
+    if (srp->ccd > CCD_EXT_TRACKING)
+        return CE_BAD_PARAMETER;
+
+    usleep(commandDelay);
+    readouts[srp->ccd].active = true;
+    readouts[srp->ccd].line   = 0;
+    readouts[srp->ccd].height = srp->height;
+    return CE_NO_ERROR;
+}
+
+int SBIGSimulator::ReadoutLine(const ReadoutLineParams *rlp, unsigned short *results)
+{
+    if (rlp->ccd > CCD_EXT_TRACKING || !readouts[rlp->ccd].active)
+        return CE_NO_EXPOSURE_IN_PROGRESS;
+
+    Readout &readout = readouts[rlp->ccd];
+    if (readout.line >= readout.height)
+        return CE_BAD_PARAMETER;
+
+    usleep(commandDelay + static_cast<long>(rlp->pixelLength) * pixelDelay / 1000);
+
+    // sky background with a little noise and a gradient along the columns
+    for (unsigned short x = 0; x < rlp->pixelLength; x++)
+        results[x] = 1000 + (rlp->pixelStart + x) / 4 + rand() % 64;
+    readout.line++;
+    return CE_NO_ERROR;
+}
+
+int SBIGSimulator::EndReadout(const EndReadoutParams *erp)
+{
+    if (erp->ccd > CCD_EXT_TRACKING)
+        return CE_BAD_PARAMETER;
+
+    usleep(commandDelay);
+    readouts[erp->ccd].active = false;
+    return CE_NO_ERROR;
+}
@@ -0,0 +1,60 @@
+/*
+    Driver type: SBIG CCD Camera INDI Driver
+
+    Simulated readout commands of the SBIG Universal Driver, used in simulation mode
+    so that the readout path of the driver can be timed without a camera.
+
+    This library is free software; you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful, but
+    WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+    or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+    License for more details.
+
+    You should have received a copy of the GNU Lesser General Public License
+    along with this library; if not, write to the Free Software Foundation,
+    Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+
+ */
+
+#pragma once
+
+#ifdef __APPLE__
+#include <libsbig/sbigudrv.h>
+#else
+#include <sbigudrv.h>
+#endif
+
+/*
+    Each command costs a fixed latency, each digitized pixel a fixed time. Defaults are
+    close to a USB 2 camera and can be changed from the environment:
+
+        SBIG_SIM_COMMAND_US   latency of one driver command (us, default 250)
+        SBIG_SIM_PIXEL_NS     digitization time of one pixel (ns, default 250)
+
+    Readouts of the imaging and tracking CCDs are tracked separately, like the driver does.
+*/
+class SBIGSimulator
+{
+    public:
+        SBIGSimulator();
+
+        int StartReadout(const StartReadoutParams *srp);
+        int ReadoutLine(const ReadoutLineParams *rlp, unsigned short *results);
+        int EndReadout(const EndReadoutParams *erp);
+
+    private:
+        struct Readout
+        {
+            bool active {false};
+            unsigned short line {0};
+            unsigned short height {0};
+        };
+
+        Readout readouts[3];
+        int commandDelay;
+        int pixelDelay;
+};
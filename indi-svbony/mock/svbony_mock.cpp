@@ -0,0 +1,431 @@
+/*
+ SVBONY CCD Driver - mock libSVBCameraSDK
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ libSVBCameraSDK for svbony_download_benchmark, see common/README.md. One colour camera is
+ enumerated, 1920 x 1080 and 300 MB/s unless set otherwise, with RAW8, RAW16, Y8, RGB24 and
+ RGB32.
+
+ Once SVBStartVideoCapture is called, the camera in normal mode finishes a frame per exposure
+ time (or per transfer time, if longer) whether it is read or not. In soft trigger mode it
+ finishes one frame per SVBSendSoftTrigger, exposure and transfer time after the trigger.
+ SVBGetVideoData waits for a frame not read yet and copies the newest out of the SDK's buffer.
+*/
+
+#include <SVBCameraSDK.h>
+#include "svbony_mock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+SVB_CONTROL_CAPS control(SVB_CONTROL_TYPE type, const char *name, long min, long max, long value, bool writable = true)
+{
+    SVB_CONTROL_CAPS caps {};
+    snprintf(caps.Name, sizeof(caps.Name), "%s", name);
+    snprintf(caps.Description, sizeof(caps.Description), "%s", name);
+    caps.MinValue        = min;
+    caps.MaxValue        = max;
+    caps.DefaultValue    = value;
+    caps.IsAutoSupported = SVB_FALSE;
+    caps.IsWritable      = writable ? SVB_TRUE : SVB_FALSE;
+    caps.ControlType     = type;
+    return caps;
+}
+
+const SVB_CONTROL_CAPS controls[] =
+{
+    control(SVB_GAIN, "Gain", 0, 720, 0),
+    control(SVB_EXPOSURE, "Exposure", 30, 2000000000, 1000000),
+    control(SVB_FRAME_SPEED_MODE, "FrameSpeed", 0, 2, 2),
+    control(SVB_BLACK_LEVEL, "BlackLevel", 0, 255, 10),
+    control(SVB_CURRENT_TEMPERATURE, "Temperature", -500, 1000, 200, false),
+};
+const int controlCount = sizeof(controls) / sizeof(controls[0]);
+
+struct MockCamera
+{
+    int width;
+    int height;
+    double bandwidth;
+    bool color;
+
+    int roiX {0}, roiY {0}, roiW {0}, roiH {0}, bin {1};
+    SVB_IMG_TYPE format {SVB_IMG_RAW8};
+    long values[SVB_BAD_PIXEL_CORRECTION_THRESHOLD + 1] {};
+    SVB_CAMERA_MODE mode {SVB_MODE_NORMAL};
+    bool opened {false};
+    bool capturing {false};
+
+    // one frame of the largest format, the SDK's own buffer
+    std::vector<uint8_t> sensor;
+
+    SDKMock::FrameClock frames;
+    SDKMock::Counters counters;
+
+    std::mutex lock;
+} camera;
+
+bool configured = false;
+
+void configure()
+{
+    if (configured)
+        return;
+    configured       = true;
+    camera.width     = SDKMock::env("SVBONY_MOCK_WIDTH", 1920);
+    camera.height    = SDKMock::env("SVBONY_MOCK_HEIGHT", 1080);
+    camera.bandwidth = std::max(SDKMock::env("SVBONY_MOCK_BANDWIDTH", 300.0), 0.001);
+    camera.color     = SDKMock::env("SVBONY_MOCK_COLOR", 1) != 0;
+    camera.roiW      = camera.width;
+    camera.roiH      = camera.height;
+    for (const auto &caps : controls)
+        camera.values[caps.ControlType] = caps.DefaultValue;
+}
+
+size_t bytesPerPixel(SVB_IMG_TYPE format)
+{
+    switch (format)
+    {
+        case SVB_IMG_RGB32: return 4;
+        case SVB_IMG_RGB24: return 3;
+        case SVB_IMG_RAW8:
+        case SVB_IMG_Y8:    return 1;
+        default:            return 2;
+    }
+}
+
+size_t frameBytes()
+{
+    return static_cast<size_t>(camera.roiW) * camera.roiH * bytesPerPixel(camera.format);
+}
+
+Clock::duration exposureTime()
+{
+    return std::chrono::microseconds(camera.values[SVB_EXPOSURE]);
+}
+
+// Frames of a capture just started, in normal mode the next frame is exposed while one is sent
+void startFrames()
+{
+    if (camera.mode == SVB_MODE_NORMAL)
+    {
+        camera.frames.start(std::max<Clock::duration>(exposureTime(), SDKMock::transferTime(frameBytes(), camera.bandwidth)));
+        camera.counters.exposures++;
+    }
+    else
+        camera.frames.clear();
+}
+
+SVB_ERROR_CODE checkCamera(int iCameraID)
+{
+    if (iCameraID != 0)
+        return SVB_ERROR_INVALID_ID;
+    return camera.opened ? SVB_SUCCESS : SVB_ERROR_CAMERA_CLOSED;
+}
+}
+
+extern "C" void SVBMockGetStats(SDKMock::Stats *stats)
+{
+    camera.counters.get(stats);
+}
+
+extern "C" void SVBMockResetStats()
+{
+    camera.counters.reset();
+}
+
+int SVBGetNumOfConnectedCameras()
+{
+    configure();
+    return 1;
+}
+
+SVB_ERROR_CODE SVBGetCameraInfo(SVB_CAMERA_INFO *pSVBCameraInfo, int iCameraIndex)
+{
+    if (iCameraIndex != 0)
+        return SVB_ERROR_INVALID_INDEX;
+    configure();
+
+    memset(pSVBCameraInfo, 0, sizeof(*pSVBCameraInfo));
+    snprintf(pSVBCameraInfo->FriendlyName, sizeof(pSVBCameraInfo->FriendlyName), "SVBONY Mock %dx%d",
+             camera.width, camera.height);
+    snprintf(pSVBCameraInfo->CameraSN, sizeof(pSVBCameraInfo->CameraSN), "MOCK0001");
+    snprintf(pSVBCameraInfo->PortType, sizeof(pSVBCameraInfo->PortType), "USB3.0");
+    pSVBCameraInfo->CameraID = 0;
+    return SVB_SUCCESS;
+}
+
+SVB_ERROR_CODE SVBGetCameraProperty(int iCameraID, SVB_CAMERA_PROPERTY *pCameraProperty)
+{
+    memset(pCameraProperty, 0, sizeof(*pCameraProperty));
+    pCameraProperty->MaxWidth         = camera.width;
+    pCameraProperty->MaxHeight        = camera.height;
+    pCameraProperty->IsColorCam       = camera.color ? SVB_TRUE : SVB_FALSE;
+    pCameraProperty->BayerPattern     = SVB_BAYER_RG;
+    pCameraProperty->SupportedBins[0] = 1;
+    pCameraProperty->SupportedBins[1] = 2;
+    pCameraProperty->SupportedVideoFormat[0] = SVB_IMG_RAW8;
+    pCameraProperty->SupportedVideoFormat[1] = SVB_IMG_RAW16;
+    pCameraProperty->SupportedVideoFormat[2] = SVB_IMG_Y8;
+    pCameraProperty->SupportedVideoFormat[3] = SVB_IMG_RGB24;
+    pCameraProperty->SupportedVideoFormat[4] = SVB_IMG_RGB32;
+    pCameraProperty->SupportedVideoFormat[5] = SVB_IMG_END;
+    pCameraProperty->MaxBitDepth      = 12;
+    pCameraProperty->IsTriggerCam     = SVB_FALSE;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBGetCameraPropertyEx(int iCameraID, SVB_CAMERA_PROPERTY_EX *pCameraPorpertyEx)
+{
+    memset(pCameraPorpertyEx, 0, sizeof(*pCameraPorpertyEx));
+    pCameraPorpertyEx->bSupportPulseGuide  = SVB_TRUE;
+    pCameraPorpertyEx->bSupportControlTemp = SVB_FALSE;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBOpenCamera(int iCameraID)
+{
+    if (iCameraID != 0)
+        return SVB_ERROR_INVALID_ID;
+    configure();
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    // a horizontal gradient growing with the line number, so that a wrong flip or R/B swap is visible
+    camera.sensor.resize(static_cast<size_t>(camera.width) * camera.height * 4);
+    for (size_t i = 0; i < camera.sensor.size(); i++)
+        camera.sensor[i] = static_cast<uint8_t>(i % 251 + i / (camera.width * 4));
+    camera.opened = true;
+    return SVB_SUCCESS;
+}
+
+SVB_ERROR_CODE SVBCloseCamera(int iCameraID)
+{
+    if (iCameraID != 0)
+        return SVB_ERROR_INVALID_ID;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.opened    = false;
+    camera.capturing = false;
+    camera.frames.clear();
+    return SVB_SUCCESS;
+}
+
+SVB_ERROR_CODE SVBRestoreDefaultParam(int iCameraID)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    for (const auto &caps : controls)
+        camera.values[caps.ControlType] = caps.DefaultValue;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBSetAutoSaveParam(int iCameraID, SVB_BOOL)
+{
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBGetNumOfControls(int iCameraID, int *piNumberOfControls)
+{
+    *piNumberOfControls = controlCount;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBGetControlCaps(int iCameraID, int iControlIndex, SVB_CONTROL_CAPS *pControlCaps)
+{
+    if (iControlIndex < 0 || iControlIndex >= controlCount)
+        return SVB_ERROR_INVALID_INDEX;
+    *pControlCaps = controls[iControlIndex];
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBGetControlValue(int iCameraID, SVB_CONTROL_TYPE ControlType, long *plValue, SVB_BOOL *pbAuto)
+{
+    if (ControlType < SVB_GAIN || ControlType > SVB_BAD_PIXEL_CORRECTION_THRESHOLD)
+        return SVB_ERROR_INVALID_CONTROL_TYPE;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *plValue = camera.values[ControlType];
+    *pbAuto  = SVB_FALSE;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBSetControlValue(int iCameraID, SVB_CONTROL_TYPE ControlType, long lValue, SVB_BOOL)
+{
+    if (ControlType < SVB_GAIN || ControlType > SVB_BAD_PIXEL_CORRECTION_THRESHOLD)
+        return SVB_ERROR_INVALID_CONTROL_TYPE;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.values[ControlType] = ControlType == SVB_EXPOSURE ? std::max(lValue, 30L) : lValue;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBGetOutputImageType(int iCameraID, SVB_IMG_TYPE *pImageType)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *pImageType = camera.format;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBSetOutputImageType(int iCameraID, SVB_IMG_TYPE ImageType)
+{
+    if (ImageType != SVB_IMG_RAW8 && ImageType != SVB_IMG_RAW16 && ImageType != SVB_IMG_Y8 &&
+            ImageType != SVB_IMG_RGB24 && ImageType != SVB_IMG_RGB32)
+        return SVB_ERROR_INVALID_IMGTYPE;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.format = ImageType;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBSetROIFormat(int iCameraID, int iStartX, int iStartY, int iWidth, int iHeight, int iBin)
+{
+    if (iBin < 1 || iBin > 2 || iWidth <= 0 || iHeight <= 0 || iWidth % 8 != 0 || iHeight % 2 != 0 ||
+            iWidth * iBin > camera.width || iHeight * iBin > camera.height)
+        return SVB_ERROR_INVALID_SIZE;
+    if (iStartX < 0 || iStartY < 0 || (iStartX + iWidth) * iBin > camera.width || (iStartY + iHeight) * iBin > camera.height)
+        return SVB_ERROR_OUTOF_BOUNDARY;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.roiX = iStartX;
+    camera.roiY = iStartY;
+    camera.roiW = iWidth;
+    camera.roiH = iHeight;
+    camera.bin  = iBin;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBGetROIFormat(int iCameraID, int *piStartX, int *piStartY, int *piWidth, int *piHeight, int *piBin)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    *piStartX = camera.roiX;
+    *piStartY = camera.roiY;
+    *piWidth  = camera.roiW;
+    *piHeight = camera.roiH;
+    *piBin    = camera.bin;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBSetCameraMode(int iCameraID, SVB_CAMERA_MODE mode)
+{
+    if (mode != SVB_MODE_NORMAL && mode != SVB_MODE_TRIG_SOFT)
+        return SVB_ERROR_INVALID_MODE;
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (camera.capturing && mode != camera.mode)
+    {
+        // like the SDK, the capture carries on in the new mode
+        camera.mode = mode;
+        startFrames();
+    }
+    camera.mode = mode;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBStartVideoCapture(int iCameraID)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    // the driver starts the capture again for every exposure in soft trigger mode
+    if (camera.capturing)
+        return checkCamera(iCameraID);
+
+    camera.capturing = true;
+    startFrames();
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBStopVideoCapture(int iCameraID)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.capturing = false;
+    camera.frames.clear();
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBSendSoftTrigger(int iCameraID)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (!camera.capturing || camera.mode != SVB_MODE_TRIG_SOFT)
+        return SVB_ERROR_INVALID_SEQUENCE;
+
+    // a triggered frame is exposed, then sent
+    camera.frames.start(exposureTime() + SDKMock::transferTime(frameBytes(), camera.bandwidth), true);
+    camera.counters.exposures++;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBGetVideoData(int iCameraID, unsigned char *pBuffer, long lBuffSize, int iWaitms)
+{
+    std::unique_lock<std::mutex> guard(camera.lock);
+    if (!camera.capturing)
+        return SVB_ERROR_INVALID_SEQUENCE;
+
+    size_t length = frameBytes();
+    if (lBuffSize < static_cast<long>(length))
+        return SVB_ERROR_BUFFER_TOO_SMALL;
+
+    // wait for a frame not read yet, untriggered frames never come
+    camera.counters.statusPolls++;
+    if (!camera.frames.ready())
+    {
+        Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(iWaitms);
+        Clock::time_point next = camera.frames.pending() ? camera.frames.next() : Clock::time_point::max();
+        guard.unlock();
+        std::this_thread::sleep_until(std::min(next, deadline));
+        guard.lock();
+        if (!camera.capturing)
+            return SVB_ERROR_INVALID_SEQUENCE;
+        if (!camera.frames.ready())
+            return SVB_ERROR_TIMEOUT;
+    }
+
+    uint64_t skipped = camera.frames.take();
+    memcpy(pBuffer, camera.sensor.data(), length);
+    camera.counters.bytesCopied += length;
+    if (camera.mode == SVB_MODE_TRIG_SOFT)
+        camera.counters.downloads++;
+    else
+    {
+        camera.counters.videoSkipped += skipped;
+        camera.counters.videoFrames++;
+    }
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBGetSensorPixelSize(int iCameraID, float *fPixelSize)
+{
+    *fPixelSize = 2.9;
+    return checkCamera(iCameraID);
+}
+
+SVB_ERROR_CODE SVBPulseGuide(int iCameraID, SVB_GUIDE_DIRECTION, int)
+{
+    return checkCamera(iCameraID);
+}
+
+const char *SVBGetSDKVersion()
+{
+    return "1.13.4 (mock)";
+}
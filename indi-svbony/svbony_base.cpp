@@ -89,6 +89,20 @@ void SVBONYBase::discardVideoData()
 }
 #endif
 
+CameraPipeline::ReadStatus SVBONYPipelineTraits::readVideo(uint8_t *buffer, size_t bytes)
+{
+    error = SVBGetVideoData(cameraID, buffer, bytes, waitMS);
+    if (error == SVB_SUCCESS)
+        return CameraPipeline::ReadStatus::Ok;
+    return error == SVB_ERROR_TIMEOUT ? CameraPipeline::ReadStatus::Timeout : CameraPipeline::ReadStatus::Failed;
+}
+
+/* In soft trigger mode the exposed frame is read like a video frame */
+CameraPipeline::ReadStatus SVBONYPipelineTraits::readImage(uint8_t *buffer, size_t bytes)
+{
+    return readVideo(buffer, bytes);
+}
+
 void SVBONYBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
 {
     SVB_ERROR_CODE ret;
@@ -114,39 +128,26 @@ void SVBONYBase::workerStreamVideo(const std::atomic_bool &isAboutToQuit)
     ret = SVBStartVideoCapture(mCameraInfo.CameraID);
     if (ret == SVB_SUCCESS)
     {
-        while (!isAboutToQuit)
-        {
-            uint8_t *targetFrame = PrimaryCCD.getFrameBuffer();
-            uint32_t totalBytes  = PrimaryCCD.getFrameBufferSize();
-            int waitMS           = static_cast<int>((ExposureRequest * 2000.0) + 500);
-
-            ret = SVBGetVideoData(mCameraInfo.CameraID, targetFrame, totalBytes, waitMS);
-            if (ret != SVB_SUCCESS)
-            {
-                if (ret != SVB_ERROR_TIMEOUT)
-                {
-                    Streamer->setStream(false);
-                    LOGF_ERROR("Failed to read video data (%s).", Helpers::toString(ret));
-                    break;
-                }
-
-                usleep(100);
-                continue;
-            }
+        SVBONYPipelineTraits &sdk = mPipeline.traits();
+        sdk.cameraID = mCameraInfo.CameraID;
+        sdk.waitMS   = static_cast<int>((ExposureRequest * 2000.0) + 500);
 
-            /*
-                RGB channel data align in targetFrame: 24bit:BGR, 32bit:BGRA
-                RGB channel data align in file: 24bit:RGB, 32bit:RGBA
-            */
-            if (Helpers::isRGB(mCurrentVideoFormat))
-            {
-                int nChannels = Helpers::getNChannels(mCurrentVideoFormat);
-                for (uint32_t i = 0; i < totalBytes; i += nChannels)
-                    std::swap(targetFrame[i], targetFrame[i + 2]); // swap R and B channel.
-            }
-
-            Streamer->newFrame(targetFrame, totalBytes);
+        /*
+            RGB channel data align in the SDK frame: 24bit:BGR, 32bit:BGRA
+            RGB channel data align in file: 24bit:RGB, 32bit:RGBA
+        */
+        int rgbChannels = Helpers::isRGB(mCurrentVideoFormat) ? Helpers::getNChannels(mCurrentVideoFormat) : 0;
+        bool ok = mPipeline.stream(isAboutToQuit, PrimaryCCD.getFrameBufferSize(), rgbChannels,
+                                   [this](const uint8_t *frame, size_t bytes)
+        {
+            Streamer->newFrame(frame, bytes);
+        });
+        if (!ok)
+        {
+            Streamer->setStream(false);
+            LOGF_ERROR("Failed to read video data (%s).", Helpers::toString(sdk.error));
         }
+        LOGF_DEBUG("Stream stopped: %s.", mPipeline.streamStats().summary().c_str());
 
         SVBStopVideoCapture(mCameraInfo.CameraID);
     }
@@ -225,29 +226,22 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
         LOGF_INFO("Taking a %g seconds frame...", duration);
 
     /*
-        Prepare a read buffer for SVB_IMG_RGB24 and SVB_IMG_RGB32
+        SVB_IMG_RGB24 and SVB_IMG_RGB32 are read into the pipeline's staging buffer
     */
     SVB_IMG_TYPE type = getImageType();
 
     std::unique_lock<std::mutex> guard(ccdBufferLock);
     uint8_t *image = PrimaryCCD.getFrameBuffer();
-    uint8_t *buffer = image;
 
     uint16_t subW = PrimaryCCD.getSubW() / PrimaryCCD.getBinX();
     uint16_t subH = PrimaryCCD.getSubH() / PrimaryCCD.getBinY();
     int nChannels = Helpers::getNChannels(type);
+    int rgbChannels = Helpers::isRGB(type) ? nChannels : 0;
     size_t nTotalBytes = subW * subH * nChannels * (PrimaryCCD.getBPP() / 8);
 
-    if (Helpers::isRGB(type))
-    {
-        buffer = static_cast<uint8_t *>(malloc(nTotalBytes));
-        if (buffer == nullptr)
-        {
-            LOGF_ERROR("%s: %d malloc failed (RGB 24/32).", getDeviceName(), nTotalBytes);
-            guard.unlock();
-            return;
-        }
-    }
+    SVBONYPipelineTraits &sdk = mPipeline.traits();
+    sdk.cameraID = mCameraInfo.CameraID;
+    sdk.waitMS   = 1000;
 
     /*
         Perform exposure and image data reading
@@ -257,10 +251,8 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
     {
         if (isAboutToQuit)
         {
-            ret = SVBGetVideoData(mCameraInfo.CameraID, buffer, nTotalBytes,  1000);
+            ret = SVBGetVideoData(mCameraInfo.CameraID, image, nTotalBytes,  1000);
             LOGF_DEBUG("Discard unretrieved exposure data: SVBGetVideoData(%s)", Helpers::toString(ret));
-            if (Helpers::isRGB(type))
-                free(buffer);
             guard.unlock();
             PrimaryCCD.setExposureLeft(0);
             return;
@@ -289,46 +281,12 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
         }
         else
         {
-            ret = SVBGetVideoData(mCameraInfo.CameraID, buffer, nTotalBytes, 1000);
-            LOGF_DEBUG("Retrieved exposure data: SVBGetVideoData(%s)", Helpers::toString(ret));
-            switch (ret)
+            mPipeline.download(image, nTotalBytes, subW * subH, rgbChannels);
+            LOGF_DEBUG("Retrieved exposure data: SVBGetVideoData(%s)", Helpers::toString(sdk.error));
+            switch (sdk.error)
             {
                 case SVB_SUCCESS:
-                    if (Helpers::isRGB(type))
-                    {
-                        uint8_t *dstR = image;
-                        uint8_t *dstG = image + subW * subH;
-                        uint8_t *dstB = image + subW * subH * 2;
-
-                        const uint8_t *src = buffer;
-
-                        /*
-                            To optimize execution speed, RGB32 and RGB24 are discriminated outside of while loop.
-                        */
-                        if (type == SVB_IMG_RGB32)
-                        {
-                            const uint8_t *end = buffer + subW * subH * 4;
-                            uint8_t *dstA = image + subW * subH * 3; // Alpha channel destination address
-                            while (src != end)
-                            {
-                                *dstB++ = *src++;
-                                *dstG++ = *src++;
-                                *dstR++ = *src++;
-                                *dstA++ = *src++;
-                            }
-                        }
-                        else
-                        {
-                            const uint8_t *end = buffer + subW * subH * 3;
-                            while (src != end)
-                            {
-                                *dstB++ = *src++;
-                                *dstG++ = *src++;
-                                *dstR++ = *src++;
-                            }
-                        }
-                        free(buffer);
-                    }
+                    LOGF_DEBUG("Download took %.0f ms.", mPipeline.lastDownloadMS());
                     guard.unlock();
                     sendImage(type, duration);
 
@@ -350,8 +308,6 @@ void SVBONYBase::workerExposure(const std::atomic_bool &isAboutToQuit, float dur
                     }
                 //fall through
                 default: // Cannot continue to retrive image data when ret is any error except timeout.
-                    if (Helpers::isRGB(type))
-                        free(buffer);
                     guard.unlock();
                     PrimaryCCD.setExposureLeft(0);
                     PrimaryCCD.setExposureFailed();
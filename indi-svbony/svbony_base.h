@@ -29,6 +29,7 @@
 #include "indipropertynumber.h"
 #include "indipropertytext.h"
 #include "indisinglethreadpool.h"
+#include "camera_pipeline.h"
 
 #include <vector>
 
@@ -39,6 +40,17 @@
 // If defined following symbol, get buffered image data before to set exposure duration.
 #define WORKAROUND_latest_image_can_be_getten_next_time
 
+/* SDK calls used by the shared download and streaming pipeline */
+struct SVBONYPipelineTraits
+{
+    int cameraID {0};
+    int waitMS {0};
+    SVB_ERROR_CODE error {SVB_SUCCESS};
+
+    CameraPipeline::ReadStatus readVideo(uint8_t *buffer, size_t bytes);
+    CameraPipeline::ReadStatus readImage(uint8_t *buffer, size_t bytes);
+};
+
 class SingleWorker;
 class SVBONYBase : public INDI::CCD
 {
@@ -173,5 +185,6 @@ class SVBONYBase : public INDI::CCD
         SVB_CAMERA_PROPERTY_EX mCameraPropertyExtended;
         uint8_t mExposureRetry {0};
         SVB_IMG_TYPE mCurrentVideoFormat;
+        CameraPipeline::Pipeline<SVBONYPipelineTraits> mPipeline {SVBONYPipelineTraits()};
         std::vector<SVB_CONTROL_CAPS> mControlCaps;
 };
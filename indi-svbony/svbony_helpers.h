@@ -246,4 +246,3 @@ bool hasBayer(SVB_IMG_TYPE type)
 }
 
 }
-
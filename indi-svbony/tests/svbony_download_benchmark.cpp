@@ -0,0 +1,61 @@
+/*
+    SVBONY Camera Driver - download benchmark
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+/*
+    Offline benchmark of the SVBONY download path, see common/ccd_benchmark.h.
+
+    The real SVBONYBase (svbony_base.cpp) is linked against the mock libSVBCameraSDK in mock/,
+    memcpy calls are counted in svbony_base.cpp.
+*/
+
+#include "svbony_base.h"
+#include "svbony_mock.h"
+#include "ccd_benchmark.h"
+
+/**
+ * @brief SVBONYBase on the first mock camera.
+ */
+class BenchmarkSVBONY : public CCDBenchmark::Camera<SVBONYBase>
+{
+    public:
+        BenchmarkSVBONY()
+        {
+            SVBGetCameraInfo(&mCameraInfo, 0);
+            mCameraName = mCameraInfo.FriendlyName;
+            setDeviceName("SVBONY CCD Benchmark");
+        }
+
+        static bool listed()
+        {
+            return SVBGetNumOfConnectedCameras() > 0;
+        }
+};
+
+static const CCDBenchmark::Format formats[] =
+{
+    { "raw8",  "SVB_IMG_RAW8",  1 },
+    { "raw16", "SVB_IMG_RAW16", 2 },
+    { "rgb24", "SVB_IMG_RGB24", 3 },
+    { "rgb32", "SVB_IMG_RGB32", 4 },
+};
+
+int main(int argc, char *argv[])
+{
+    const CCDBenchmark::Driver driver = { "indi_svbony_ccd", "SVBONY", formats, 4, SVBMockGetStats, SVBMockResetStats };
+    return CCDBenchmark::run<BenchmarkSVBONY>(argc, argv, driver);
+}
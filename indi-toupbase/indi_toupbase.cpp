@@ -41,6 +41,8 @@
     | (static_cast<uint32_t>(static_cast<uint8_t>(ch3)) << 24))
 #endif /* defined(MAKEFOURCC) */
 
+// The download benchmark creates its own camera on the mock SDK
+#ifndef TOUPBASE_DOWNLOAD_BENCHMARK
 static class Loader
 {
         std::shared_ptr<ToupbaseCCDHotPlugHandler> hotPlugHandler;
@@ -52,6 +54,7 @@ static class Loader
             INDI::HotPlugManager::getInstance().start(1000); // Start hot-plug checks every 1 second
         }
 } loader;
+#endif
 
 ToupBase::ToupBase(const XP(DeviceV2) *instance, const std::string &name) : m_Instance(instance)
 {
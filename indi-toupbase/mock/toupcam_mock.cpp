@@ -0,0 +1,629 @@
+/*
+ Toupcam & oem CCD Driver - mock libtoupcam
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+/*
+ libtoupcam for toupcam_download_benchmark, see common/README.md. One 12 bit colour camera is
+ enumerated, 1920 x 1080 and 300 MB/s unless set otherwise, without cooler, fan or heater.
+
+ The camera runs in pull mode: an internal thread calls the event callback with
+ TOUPCAM_EVENT_IMAGE whenever a frame has been exposed and has crossed the USB link, and the
+ driver pulls it from that callback. In trigger mode Toupcam_Trigger exposes one frame, in video
+ mode the camera finishes a frame per exposure time (or per transfer time, if longer) whether it
+ is pulled or not. A frame the driver does not pull from its callback is dropped.
+*/
+
+#define TOUPCAM_HRESULT_ERRORCODE_NEEDED
+#include <toupcam.h>
+#include "toupcam_mock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+#define MOCK_CAMERA_ID "tp-mock-0001"
+
+namespace
+{
+struct MockCamera
+{
+    uint32_t width;
+    uint32_t height;
+    double bandwidth;
+    bool color;
+    ToupcamModelV2 model {};
+
+    uint32_t roiX {0}, roiY {0}, roiW {0}, roiH {0};
+    unsigned exposure {10000};
+    unsigned short gain {TOUPCAM_EXPOGAIN_MIN};
+    unsigned short speed {0};
+    int contrast {TOUPCAM_CONTRAST_DEF}, hue {TOUPCAM_HUE_DEF}, saturation {TOUPCAM_SATURATION_DEF};
+    int brightness {TOUPCAM_BRIGHTNESS_DEF}, gamma {TOUPCAM_GAMMA_DEF};
+    int whiteBalance[3] {TOUPCAM_WBGAIN_DEF, TOUPCAM_WBGAIN_DEF, TOUPCAM_WBGAIN_DEF};
+    unsigned short blackBalance[3] {0, 0, 0};
+    unsigned short levelLow[4] {0, 0, 0, 0}, levelHigh[4] {255, 255, 255, 255};
+    std::map<unsigned, int> options;
+    bool opened {false};
+
+    // one frame of the largest format, the SDK's own buffer
+    std::vector<uint8_t> sensor;
+
+    PTOUPCAM_EVENT_CALLBACK callback {nullptr};
+    void *context {nullptr};
+    bool started {false};
+    std::thread events;
+    std::condition_variable changed;
+
+    SDKMock::FrameClock frames;
+    unsigned sequence {0};
+    SDKMock::Counters counters;
+
+    std::mutex lock;
+} camera;
+
+Toupcam_t handle;
+bool configured = false;
+
+void configure()
+{
+    if (configured)
+        return;
+    configured       = true;
+    camera.width     = SDKMock::env("TOUPCAM_MOCK_WIDTH", 1920);
+    camera.height    = SDKMock::env("TOUPCAM_MOCK_HEIGHT", 1080);
+    camera.bandwidth = std::max(SDKMock::env("TOUPCAM_MOCK_BANDWIDTH", 300.0), 0.001);
+    camera.color     = SDKMock::env("TOUPCAM_MOCK_COLOR", 1) != 0;
+    camera.roiW      = camera.width;
+    camera.roiH      = camera.height;
+
+    camera.model.name        = "Toupcam Mock";
+    camera.model.flag        = TOUPCAM_FLAG_RAW16 | TOUPCAM_FLAG_ST4 | TOUPCAM_FLAG_TRIGGER_SOFTWARE |
+                               (camera.color ? 0 : TOUPCAM_FLAG_MONO);
+    camera.model.maxspeed    = 2;
+    camera.model.preview     = 1;
+    camera.model.still       = 1;
+    camera.model.xpixsz      = camera.model.ypixsz = 2.9f;
+    camera.model.res[0].width  = camera.width;
+    camera.model.res[0].height = camera.height;
+
+    camera.options[TOUPCAM_OPTION_TRIGGER]   = 0;
+    camera.options[TOUPCAM_OPTION_RAW]       = 0;
+    camera.options[TOUPCAM_OPTION_BITDEPTH]  = 0;
+    camera.options[TOUPCAM_OPTION_BINNING]   = 1;
+    camera.options[TOUPCAM_OPTION_CG]        = 0;
+    camera.options[TOUPCAM_OPTION_FRAMERATE] = 0;
+}
+
+bool triggerMode()
+{
+    return camera.options[TOUPCAM_OPTION_TRIGGER] != 0;
+}
+
+// RGB24 unless the camera is mono or sends RAW, then 8 or 16 bits
+size_t frameBytes()
+{
+    size_t bin = std::max(camera.options[TOUPCAM_OPTION_BINNING] & 0x7f, 1);
+    size_t bytesPerPixel = (camera.color && camera.options[TOUPCAM_OPTION_RAW] == 0) ? 3 :
+                           camera.options[TOUPCAM_OPTION_BITDEPTH] ? 2 : 1;
+    return (camera.roiW / bin) * (camera.roiH / bin) * bytesPerPixel;
+}
+
+Clock::duration exposureTime()
+{
+    return std::chrono::microseconds(camera.exposure);
+}
+
+HRESULT checkCamera(HToupcam h)
+{
+    return h == &handle && camera.opened ? S_OK : E_INVALIDARG;
+}
+
+// Video mode runs while the camera is started, trigger mode waits for Toupcam_Trigger
+void restartFrames()
+{
+    if (camera.started && !triggerMode())
+        camera.frames.start(std::max(exposureTime(), Clock::duration(SDKMock::transferTime(frameBytes(),
+                                     camera.bandwidth))));
+    else
+        camera.frames.clear();
+    camera.changed.notify_all();
+}
+
+void eventLoop()
+{
+    std::unique_lock<std::mutex> guard(camera.lock);
+    while (camera.started)
+    {
+        if (camera.frames.pending())
+            camera.changed.wait_until(guard, camera.frames.next());
+        else
+            camera.changed.wait(guard);
+        if (!camera.started || !camera.frames.ready())
+            continue;
+
+        // the driver pulls the frame from its callback
+        PTOUPCAM_EVENT_CALLBACK callback = camera.callback;
+        void *context = camera.context;
+        guard.unlock();
+        callback(TOUPCAM_EVENT_IMAGE, context);
+        guard.lock();
+
+        if (camera.frames.ready())
+        {
+            uint64_t skipped = camera.frames.take();
+            if (!triggerMode())
+                camera.counters.videoSkipped += skipped + 1;
+        }
+    }
+}
+}
+
+extern "C" void ToupcamMockGetStats(SDKMock::Stats *stats)
+{
+    camera.counters.get(stats);
+}
+
+extern "C" void ToupcamMockResetStats()
+{
+    camera.counters.reset();
+}
+
+const char *Toupcam_Version()
+{
+    return "59.30281.mock";
+}
+
+unsigned Toupcam_EnumV2(ToupcamDeviceV2 arr[TOUPCAM_MAX])
+{
+    configure();
+    if (arr != nullptr)
+    {
+        memset(&arr[0], 0, sizeof(arr[0]));
+        strcpy(arr[0].displayname, camera.model.name);
+        strcpy(arr[0].id, MOCK_CAMERA_ID);
+        arr[0].model = &camera.model;
+    }
+    return 1;
+}
+
+HToupcam Toupcam_Open(const char *camId)
+{
+    // colour cameras are opened with a leading '@' for RGB gain white balance
+    if (camId != nullptr && camId[0] == '@')
+        camId++;
+    if (camId != nullptr && strcmp(camId, MOCK_CAMERA_ID) != 0)
+        return nullptr;
+    configure();
+
+    std::lock_guard<std::mutex> guard(camera.lock);
+    // a horizontal gradient growing with the line number, so that a wrong flip is visible
+    camera.sensor.resize(static_cast<size_t>(camera.width) * camera.height * 3);
+    for (size_t i = 0; i < camera.sensor.size(); i++)
+        camera.sensor[i] = static_cast<uint8_t>(i % 251 + i / (camera.width * 3));
+    camera.opened = true;
+    return &handle;
+}
+
+HRESULT Toupcam_Stop(HToupcam h)
+{
+    {
+        std::lock_guard<std::mutex> guard(camera.lock);
+        camera.started = false;
+        camera.frames.clear();
+        camera.changed.notify_all();
+    }
+    if (camera.events.joinable())
+        camera.events.join();
+    return checkCamera(h);
+}
+
+void Toupcam_Close(HToupcam h)
+{
+    Toupcam_Stop(h);
+    std::lock_guard<std::mutex> guard(camera.lock);
+    camera.opened = false;
+}
+
+HRESULT Toupcam_StartPullModeWithCallback(HToupcam h, PTOUPCAM_EVENT_CALLBACK funEvent, void *ctxEvent)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (checkCamera(h) != S_OK)
+        return E_INVALIDARG;
+    if (camera.started)
+        return E_BUSY;
+
+    camera.callback = funEvent;
+    camera.context  = ctxEvent;
+    camera.started  = true;
+    restartFrames();
+    camera.events = std::thread(eventLoop);
+    return S_OK;
+}
+
+HRESULT Toupcam_Trigger(HToupcam h, unsigned short nNumber)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (checkCamera(h) != S_OK)
+        return E_INVALIDARG;
+
+    // 0 cancels the exposure
+    if (nNumber == 0)
+    {
+        camera.frames.clear();
+        return S_OK;
+    }
+    if (!camera.started || !triggerMode())
+        return E_UNEXPECTED;
+
+    // the frame is exposed, then sent
+    camera.frames.start(exposureTime() + SDKMock::transferTime(frameBytes(), camera.bandwidth), true);
+    camera.counters.exposures++;
+    camera.changed.notify_all();
+    return S_OK;
+}
+
+HRESULT Toupcam_PullImageWithRowPitchV2(HToupcam h, void *pImageData, int, int, ToupcamFrameInfoV2 *pInfo)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (checkCamera(h) != S_OK)
+        return E_INVALIDARG;
+    if (!camera.frames.ready())
+        return E_PENDING;
+
+    uint64_t skipped = camera.frames.take();
+    size_t length = frameBytes();
+    memcpy(pImageData, camera.sensor.data(), length);
+    camera.counters.bytesCopied += length;
+    if (triggerMode())
+        camera.counters.downloads++;
+    else
+    {
+        camera.counters.videoFrames++;
+        camera.counters.videoSkipped += skipped;
+    }
+
+    if (pInfo != nullptr)
+    {
+        size_t bin = std::max(camera.options[TOUPCAM_OPTION_BINNING] & 0x7f, 1);
+        pInfo->width     = camera.roiW / bin;
+        pInfo->height    = camera.roiH / bin;
+        pInfo->flag      = TOUPCAM_FRAMEINFO_FLAG_SEQ | TOUPCAM_FRAMEINFO_FLAG_TIMESTAMP;
+        pInfo->seq       = camera.sequence++;
+        pInfo->timestamp = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+    }
+    return S_OK;
+}
+
+HRESULT Toupcam_put_Option(HToupcam h, unsigned iOption, int iValue)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (checkCamera(h) != S_OK)
+        return E_INVALIDARG;
+
+    if (iOption == TOUPCAM_OPTION_FLUSH)
+    {
+        if (camera.frames.ready())
+            camera.frames.take();
+        return S_OK;
+    }
+
+    camera.options[iOption] = iValue;
+    if (iOption == TOUPCAM_OPTION_TRIGGER || iOption == TOUPCAM_OPTION_BINNING)
+        restartFrames();
+    return S_OK;
+}
+
+HRESULT Toupcam_get_Option(HToupcam h, unsigned iOption, int *piValue)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (checkCamera(h) != S_OK)
+        return E_INVALIDARG;
+
+    auto option = camera.options.find(iOption);
+    if (option == camera.options.end())
+        return E_NOTIMPL;
+    *piValue = option->second;
+    return S_OK;
+}
+
+HRESULT Toupcam_put_ExpoTime(HToupcam h, unsigned Time)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (checkCamera(h) != S_OK)
+        return E_INVALIDARG;
+
+    camera.exposure = std::max(Time, 1u);
+    if (camera.started && !triggerMode())
+        restartFrames();
+    return S_OK;
+}
+
+HRESULT Toupcam_get_ExpTimeRange(HToupcam h, unsigned *nMin, unsigned *nMax, unsigned *nDef)
+{
+    *nMin = 1;
+    *nMax = 3600000000u;
+    *nDef = 10000;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_Roi(HToupcam h, unsigned xOffset, unsigned yOffset, unsigned xWidth, unsigned yHeight)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (checkCamera(h) != S_OK)
+        return E_INVALIDARG;
+
+    // 0 x 0 is the full frame
+    if (xWidth == 0 && yHeight == 0)
+    {
+        xOffset = yOffset = 0;
+        xWidth  = camera.width;
+        yHeight = camera.height;
+    }
+    if (xWidth == 0 || yHeight == 0 || xOffset + xWidth > camera.width || yOffset + yHeight > camera.height)
+        return E_INVALIDARG;
+
+    camera.roiX = xOffset;
+    camera.roiY = yOffset;
+    camera.roiW = xWidth;
+    camera.roiH = yHeight;
+    restartFrames();
+    return S_OK;
+}
+
+HRESULT Toupcam_put_eSize(HToupcam h, unsigned nResolutionIndex)
+{
+    return nResolutionIndex == 0 ? checkCamera(h) : E_INVALIDARG;
+}
+
+HRESULT Toupcam_get_eSize(HToupcam h, unsigned *pnResolutionIndex)
+{
+    *pnResolutionIndex = 0;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_RawFormat(HToupcam h, unsigned *pFourCC, unsigned *pBitsPerPixel)
+{
+    std::lock_guard<std::mutex> guard(camera.lock);
+    if (pFourCC != nullptr)
+        *pFourCC = 'R' | ('G' << 8) | ('G' << 16) | ('B' << 24);
+    if (pBitsPerPixel != nullptr)
+        *pBitsPerPixel = camera.options[TOUPCAM_OPTION_BITDEPTH] ? 12 : 8;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_MaxBitDepth(HToupcam h)
+{
+    return checkCamera(h) == S_OK ? 12 : E_INVALIDARG;
+}
+
+HRESULT Toupcam_put_AutoExpoEnable(HToupcam h, int)
+{
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_ExpoAGain(HToupcam h, unsigned short *Gain)
+{
+    *Gain = camera.gain;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_ExpoAGain(HToupcam h, unsigned short Gain)
+{
+    camera.gain = Gain;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_ExpoAGainRange(HToupcam h, unsigned short *nMin, unsigned short *nMax, unsigned short *nDef)
+{
+    if (nMin != nullptr)
+        *nMin = TOUPCAM_EXPOGAIN_MIN;
+    if (nMax != nullptr)
+        *nMax = 5000;
+    if (nDef != nullptr)
+        *nDef = TOUPCAM_EXPOGAIN_MIN;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_AwbInit(HToupcam h, PITOUPCAM_WHITEBALANCE_CALLBACK, void *)
+{
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_WhiteBalanceGain(HToupcam h, int aGain[3])
+{
+    std::copy(aGain, aGain + 3, camera.whiteBalance);
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_WhiteBalanceGain(HToupcam h, int aGain[3])
+{
+    std::copy(camera.whiteBalance, camera.whiteBalance + 3, aGain);
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_AbbOnce(HToupcam h, PITOUPCAM_BLACKBALANCE_CALLBACK, void *)
+{
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_BlackBalance(HToupcam h, unsigned short aSub[3])
+{
+    std::copy(aSub, aSub + 3, camera.blackBalance);
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_BlackBalance(HToupcam h, unsigned short aSub[3])
+{
+    std::copy(camera.blackBalance, camera.blackBalance + 3, aSub);
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_Hue(HToupcam h, int Hue)
+{
+    camera.hue = Hue;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_Hue(HToupcam h, int *Hue)
+{
+    *Hue = camera.hue;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_Saturation(HToupcam h, int Saturation)
+{
+    camera.saturation = Saturation;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_Saturation(HToupcam h, int *Saturation)
+{
+    *Saturation = camera.saturation;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_Brightness(HToupcam h, int Brightness)
+{
+    camera.brightness = Brightness;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_Brightness(HToupcam h, int *Brightness)
+{
+    *Brightness = camera.brightness;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_Contrast(HToupcam h, int Contrast)
+{
+    camera.contrast = Contrast;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_Contrast(HToupcam h, int *Contrast)
+{
+    *Contrast = camera.contrast;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_Gamma(HToupcam h, int Gamma)
+{
+    camera.gamma = Gamma;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_Gamma(HToupcam h, int *Gamma)
+{
+    *Gamma = camera.gamma;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_Speed(HToupcam h, unsigned short nSpeed)
+{
+    if (nSpeed > camera.model.maxspeed)
+        return E_INVALIDARG;
+    camera.speed = nSpeed;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_Speed(HToupcam h, unsigned short *pSpeed)
+{
+    *pSpeed = camera.speed;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_HZ(HToupcam h, int)
+{
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_Mode(HToupcam h, int)
+{
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_put_LevelRange(HToupcam h, unsigned short aLow[4], unsigned short aHigh[4])
+{
+    std::copy(aLow, aLow + 4, camera.levelLow);
+    std::copy(aHigh, aHigh + 4, camera.levelHigh);
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_LevelRange(HToupcam h, unsigned short aLow[4], unsigned short aHigh[4])
+{
+    std::copy(camera.levelLow, camera.levelLow + 4, aLow);
+    std::copy(camera.levelHigh, camera.levelHigh + 4, aHigh);
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_Temperature(HToupcam, short *)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT Toupcam_put_Temperature(HToupcam, short)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT Toupcam_get_Revision(HToupcam h, unsigned short *pRevision)
+{
+    *pRevision = 1;
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_SerialNumber(HToupcam h, char sn[32])
+{
+    strcpy(sn, "TPMOCK000000001");
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_FwVersion(HToupcam h, char fwver[16])
+{
+    strcpy(fwver, "1.0.0");
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_HwVersion(HToupcam h, char hwver[16])
+{
+    strcpy(hwver, "1.0");
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_ProductionDate(HToupcam h, char pdate[10])
+{
+    strcpy(pdate, "20250101");
+    return checkCamera(h);
+}
+
+HRESULT Toupcam_get_FpgaVersion(HToupcam, char *)
+{
+    return E_NOTIMPL;
+}
+
+HRESULT Toupcam_ST4PlusGuide(HToupcam h, unsigned, unsigned)
+{
+    return checkCamera(h);
+}
@@ -0,0 +1,64 @@
+/*
+ Toupcam & oem CCD Driver - download benchmark
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+/*
+ Offline benchmark of the Toupcam download path, see common/ccd_benchmark.h.
+
+ The real ToupBase (indi_toupbase.cpp, built for Toupcam without its hot plug loader) is linked
+ against the mock libtoupcam in mock/, memcpy calls are counted in indi_toupbase.cpp.
+*/
+
+#include "indi_toupbase.h"
+#include "toupcam_mock.h"
+#include "ccd_benchmark.h"
+
+/**
+ * @brief ToupBase on the first mock camera.
+ */
+class BenchmarkToupcam : public CCDBenchmark::Camera<ToupBase>
+{
+    public:
+        BenchmarkToupcam() : CCDBenchmark::Camera<ToupBase>(device(), "Benchmark") {}
+
+        static bool listed()
+        {
+            return Toupcam_EnumV2(nullptr) > 0;
+        }
+
+    private:
+        static const ToupcamDeviceV2 *device()
+        {
+            static ToupcamDeviceV2 devices[TOUPCAM_MAX];
+            Toupcam_EnumV2(devices);
+            return &devices[0];
+        }
+};
+
+// RGB is not offered: setupParams() turns RAW on while INDI_RGB is still the current format, so
+// without a saved configuration selecting INDI_RGB leaves the camera sending RAW
+static const CCDBenchmark::Format formats[] =
+{
+    { "raw16", "INDI_RAW", 2 },
+};
+
+int main(int argc, char *argv[])
+{
+    const CCDBenchmark::Driver driver = { "indi_toupcam_ccd", "TOUPCAM", formats, 1, ToupcamMockGetStats, ToupcamMockResetStats };
+    return CCDBenchmark::run<BenchmarkToupcam>(argc, argv, driver);
+}